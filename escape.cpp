@@ -0,0 +1,89 @@
+#include "escape.hpp"
+
+#ifndef MANDELBROT_FIXED_POINT
+#define MANDELBROT_FIXED_POINT 1
+#endif
+
+using namespace escape;
+
+// uma instância por fórmula e tipo numérico, na ordem de `escape_formula_t`
+static const escape_kernel_t float_kernels[ESCAPE_FORMULA_COUNT] = {
+    kernel<mandelbrot, float, ESCAPE_BAILOUT>,
+    kernel<julia, float, ESCAPE_BAILOUT>,
+    kernel<burning_ship, float, ESCAPE_BAILOUT>,
+    kernel<multibrot<3>, float, ESCAPE_BAILOUT>,
+};
+
+static const escape_kernel_t fixed_kernels[ESCAPE_FORMULA_COUNT] = {
+    kernel<mandelbrot, fixed_q28, ESCAPE_BAILOUT>,
+    kernel<julia, fixed_q28, ESCAPE_BAILOUT>,
+    kernel<burning_ship, fixed_q28, ESCAPE_BAILOUT>,
+    kernel<multibrot<3>, fixed_q28, ESCAPE_BAILOUT>,
+};
+
+/*!
+ * @brief Retorna o kernel em float de uma fórmula.
+ */
+escape_kernel_t escape_kernel_float(escape_formula_t formula)
+{
+    return float_kernels[formula];
+}
+
+/*!
+ * @brief Retorna o kernel em ponto fixo Q3.28 de uma fórmula.
+ */
+escape_kernel_t escape_kernel_fixed(escape_formula_t formula)
+{
+    return fixed_kernels[formula];
+}
+
+/*!
+ * @brief Retorna o kernel de uma fórmula no tipo numérico do build (`MANDELBROT_FIXED_POINT`).
+ */
+escape_kernel_t escape_kernel(escape_formula_t formula)
+{
+    return MANDELBROT_FIXED_POINT ? fixed_kernels[formula] : float_kernels[formula];
+}
+
+/*!
+ * @brief Verifica se a órbita de conj(c) é o conjugado da órbita de c (linhas espelháveis em relação ao eixo real).
+ *
+ * @details
+ *  - Mandelbrot e Multibrot: sim, nos dois tipos numéricos (arredondamentos simétricos, ver escape.hpp).
+ *  - Julia: apenas com constante real. Burning Ship: não (o módulo de 2xy descarta o sinal).
+ */
+bool escape_formula_mirrored(escape_formula_t formula, float k_imag)
+{
+    switch (formula)
+    {
+    case ESCAPE_MANDELBROT:
+    case ESCAPE_MULTIBROT3:
+        return true;
+    case ESCAPE_JULIA:
+        return k_imag == 0.0f;
+    default:
+        return false;
+    }
+}
+
+/*!
+ * @brief Verifica se as regiões {n > k} da fórmula são conexas e sem buracos, como exige a subdivisão de retângulos
+ *        (ver render_subdivide.c).
+ *
+ * @details
+ *  - Mandelbrot e Multibrot: sim (conjuntos conexos).
+ *  - Julia: apenas com a constante no conjunto de Mandelbrot, o que não é verificado. Burning Ship: não.
+ */
+bool escape_formula_connected(escape_formula_t formula)
+{
+    return formula == ESCAPE_MANDELBROT || formula == ESCAPE_MULTIBROT3;
+}
+
+/*!
+ * @brief Nome da fórmula (sem espaços).
+ */
+const char *escape_formula_name(escape_formula_t formula)
+{
+    static const char *const names[ESCAPE_FORMULA_COUNT] = {"mandelbrot", "julia", "burning_ship", "multibrot3"};
+    return formula < ESCAPE_FORMULA_COUNT ? names[formula] : "?";
+}
@@ -0,0 +1,69 @@
+/*!
+ * @file escape.h
+ * @brief Interface C do motor genérico de tempo de escape (escape.hpp): Mandelbrot, Julia, Burning Ship e
+ *        Multibrot.
+ *
+ * Cada combinação de fórmula, tipo numérico (float ou ponto fixo Q3.28) e raio de escape é uma instância de
+ * template compilada separadamente, com o laço de iteração próprio; a escolha da fórmula em tempo de execução é
+ * feita uma vez por pixel, pelo ponteiro de `escape_kernel_t`, e nunca dentro do laço.
+ *
+ * A fórmula de Mandelbrot do firmware continua no kernel com atalhos para pontos interiores (`mandelbrot_point()`);
+ * as demais fórmulas utilizam os kernels daqui (ver `mandelbrot_set_formula()`).
+ */
+
+ #ifndef _ESCAPE_
+ #define _ESCAPE_
+
+ #include <stdbool.h>
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /*! @brief Raio de escape dos kernels instanciados (|z| > raio encerra a iteração); no máximo 2 em ponto fixo. */
+ #ifndef ESCAPE_BAILOUT
+ #define ESCAPE_BAILOUT 2
+ #endif
+
+ /*! @brief Bits fracionários do ponto fixo dos kernels (mesmo Q3.28 de `MANDELBROT_FRAC_BITS`). */
+ #define ESCAPE_FRAC_BITS 28
+
+ /*!
+  * @brief Fórmula de iteração.
+  */
+ typedef enum {
+     ESCAPE_MANDELBROT,   /*!< z = z^2 + c, a partir de z = 0. */
+     ESCAPE_JULIA,        /*!< z = z^2 + k, a partir de z = ponto; k fixo, limitado a |Re|, |Im| <= 2. */
+     ESCAPE_BURNING_SHIP, /*!< z = (|Re z| + i |Im z|)^2 + c, a partir de z = 0. */
+     ESCAPE_MULTIBROT3,   /*!< z = z^3 + c, a partir de z = 0. */
+     ESCAPE_FORMULA_COUNT
+ } escape_formula_t;
+
+ /*!
+  * @brief Kernel de uma fórmula: iterações até o escape de um ponto, ou `cap` se não escapar.
+  *
+  * @param real   Parte real do ponto.
+  * @param imag   Parte imaginária do ponto.
+  * @param k_real Parte real da constante de Julia (ignorada pelas demais fórmulas).
+  * @param k_imag Parte imaginária da constante de Julia.
+  * @param cap    Limite de iterações.
+  */
+ typedef int (*escape_kernel_t)(float real, float imag, float k_real, float k_imag, int cap);
+
+ escape_kernel_t escape_kernel_float(escape_formula_t formula);
+
+ escape_kernel_t escape_kernel_fixed(escape_formula_t formula);
+
+ escape_kernel_t escape_kernel(escape_formula_t formula);
+
+ bool escape_formula_mirrored(escape_formula_t formula, float k_imag);
+
+ bool escape_formula_connected(escape_formula_t formula);
+
+ const char *escape_formula_name(escape_formula_t formula);
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif
@@ -0,0 +1,245 @@
+/*!
+ * @file escape.hpp
+ * @brief Motor genérico de tempo de escape: fórmula, tipo numérico e raio de escape como parâmetros de template.
+ *
+ * O laço `escape_time()` é o mesmo para todas as fórmulas; a fórmula entra apenas pelas funções estáticas do seu
+ * tipo (`start()` antes do laço e `step()` a cada iteração), expandidas em linha na instância. Assim cada
+ * combinação compila para um laço próprio, sem desvio pela fórmula a cada iteração.
+ *
+ * Tipos numéricos (`numeric<T>`):
+ *  - `float`: aritmética direta.
+ *  - `fixed_q28`: Q3.28 em inteiros de 32 bits com produtos de 64 bits, com os mesmos arredondamentos de
+ *    `mandelbrot_fixed_ex()`: a parte real de z^2 é truncada para baixo e o termo 2xy em direção a zero, o que
+ *    preserva a simetria da órbita de conj(c).
+ *
+ * @note Em ponto fixo, os componentes de z ficam abaixo de 8 em módulo enquanto |z| <= 2 e |c| < 4 (ver
+ *       `mandelbrot_fixed_ex()`); a potência cúbica pode ultrapassar esse intervalo e é saturada em +-4, valor que
+ *       já escapa na verificação seguinte, sem alterar o número de iterações.
+ */
+
+ #ifndef _ESCAPE_HPP_
+ #define _ESCAPE_HPP_
+
+ #include <stdint.h>
+ #include <math.h>
+ #include "escape.h"
+
+ namespace escape
+ {
+
+ /*! @brief Marcador do tipo numérico de ponto fixo Q3.28. */
+ struct fixed_q28
+ {
+ };
+
+ template <class T> struct numeric;
+
+ /*!
+  * @brief Operações em float: `value` é um componente de z e `wide` um produto de dois componentes.
+  */
+ template <> struct numeric<float>
+ {
+     typedef float value;
+     typedef float wide;
+
+     /*! @brief Maior grau de z^d calculável sem estouro. */
+     static const int max_degree = 16;
+
+     static value from_float(float v) { return v; }
+     static value clamp(value v, float limit) { return v > limit ? limit : v < -limit ? -limit : v; }
+     static wide mul(value a, value b) { return a * b; }
+     static wide abs(wide w) { return fabsf(w); }
+     /*! @brief Produto reduzido a um componente. */
+     static value narrow(wide w) { return w; }
+     /*! @brief Dobro do produto (termo 2xy de z^2). */
+     static value twice(wide w) { return w + w; }
+     /*! @brief Produto somado a um componente, em uma potência maior que 2. */
+     static value narrow_add(wide w, value c) { return w + c; }
+     template <int R> static wide square_radius() { return (wide)(R * R); }
+ };
+
+ /*!
+  * @brief Operações em Q3.28: componentes de 32 bits, produtos Q6.56 de 64 bits.
+  */
+ template <> struct numeric<fixed_q28>
+ {
+     typedef int32_t value;
+     typedef int64_t wide;
+
+     static const int max_degree = 3; // z^2 intermediário cabe em Q3.28; z^3 é reduzido já somado a c
+
+     /*! @brief Mesma conversão de `MANDELBROT_TO_FIXED()`, saturada em +-4. */
+     static value from_float(float v)
+     {
+         return v >= 4.0f    ? (4 << ESCAPE_FRAC_BITS)
+                : v <= -4.0f ? -(4 << ESCAPE_FRAC_BITS)
+                             : (int32_t)(v * (float)(1 << ESCAPE_FRAC_BITS));
+     }
+     static value clamp(value v, float limit)
+     {
+         value l = from_float(limit);
+         return v > l ? l : v < -l ? -l : v;
+     }
+     static wide mul(value a, value b) { return (int64_t)a * b; }
+     static wide abs(wide w) { return w < 0 ? -w : w; }
+     static value narrow(wide w) { return (int32_t)(w >> ESCAPE_FRAC_BITS); }
+     static value twice(wide w)
+     {
+         const int64_t round_to_zero = ((int64_t)1 << (ESCAPE_FRAC_BITS - 1)) - 1;
+         return (int32_t)((w + ((w >> 63) & round_to_zero)) >> (ESCAPE_FRAC_BITS - 1));
+     }
+     /*! @brief Arredondado em direção a zero (simetria) e saturado em +-4 (escape garantido, sem estouro). */
+     static value narrow_add(wide w, value c)
+     {
+         const int64_t round_to_zero = ((int64_t)1 << ESCAPE_FRAC_BITS) - 1;
+         const int64_t limit = (int64_t)4 << ESCAPE_FRAC_BITS;
+         int64_t v = ((w + ((w >> 63) & round_to_zero)) >> ESCAPE_FRAC_BITS) + c;
+         return (int32_t)(v > limit ? limit : v < -limit ? -limit : v);
+     }
+     template <int R> static wide square_radius()
+     {
+         static_assert(R >= 1 && R <= 2, "Q3.28: raio de escape acima de 2 estoura os componentes");
+         return (int64_t)(R * R) << (2 * ESCAPE_FRAC_BITS);
+     }
+ };
+
+ /*!
+  * @brief z = z^2 + c a partir de z = 0.
+  */
+ struct mandelbrot
+ {
+     template <class N>
+     static void start(typename N::value px, typename N::value py, typename N::value, typename N::value,
+                       typename N::value &x, typename N::value &y, typename N::value &cr, typename N::value &ci)
+     {
+         x = 0;
+         y = 0;
+         cr = px;
+         ci = py;
+     }
+
+     template <class N>
+     static void step(typename N::value &x, typename N::value &y, typename N::wide x2, typename N::wide y2,
+                      typename N::value cr, typename N::value ci)
+     {
+         typename N::wide xy = N::mul(x, y);
+         x = N::narrow(x2 - y2) + cr;
+         y = N::twice(xy) + ci;
+     }
+ };
+
+ /*!
+  * @brief z = z^2 + k a partir de z = ponto; a constante é limitada a +-2 por componente (conjuntos conexos estão
+  *        em |k| <= 2, e o limite mantém os componentes de z no intervalo do Q3.28).
+  */
+ struct julia
+ {
+     template <class N>
+     static void start(typename N::value px, typename N::value py, typename N::value kr, typename N::value ki,
+                       typename N::value &x, typename N::value &y, typename N::value &cr, typename N::value &ci)
+     {
+         x = px;
+         y = py;
+         cr = N::clamp(kr, 2.0f);
+         ci = N::clamp(ki, 2.0f);
+     }
+
+     template <class N>
+     static void step(typename N::value &x, typename N::value &y, typename N::wide x2, typename N::wide y2,
+                      typename N::value cr, typename N::value ci)
+     {
+         mandelbrot::step<N>(x, y, x2, y2, cr, ci);
+     }
+ };
+
+ /*!
+  * @brief z = (|Re z| + i |Im z|)^2 + c a partir de z = 0: o termo 2xy é tomado em módulo.
+  */
+ struct burning_ship
+ {
+     template <class N>
+     static void start(typename N::value px, typename N::value py, typename N::value kr, typename N::value ki,
+                       typename N::value &x, typename N::value &y, typename N::value &cr, typename N::value &ci)
+     {
+         mandelbrot::start<N>(px, py, kr, ki, x, y, cr, ci);
+     }
+
+     template <class N>
+     static void step(typename N::value &x, typename N::value &y, typename N::wide x2, typename N::wide y2,
+                      typename N::value cr, typename N::value ci)
+     {
+         typename N::wide xy = N::abs(N::mul(x, y));
+         x = N::narrow(x2 - y2) + cr;
+         y = N::twice(xy) + ci;
+     }
+ };
+
+ /*!
+  * @brief z = z^D + c a partir de z = 0; as D - 2 multiplicações por z após z^2 têm número fixo de passos.
+  */
+ template <int D> struct multibrot
+ {
+     template <class N>
+     static void start(typename N::value px, typename N::value py, typename N::value kr, typename N::value ki,
+                       typename N::value &x, typename N::value &y, typename N::value &cr, typename N::value &ci)
+     {
+         static_assert(D >= 3 && D <= N::max_degree, "grau fora do intervalo do tipo numérico");
+         mandelbrot::start<N>(px, py, kr, ki, x, y, cr, ci);
+     }
+
+     template <class N>
+     static void step(typename N::value &x, typename N::value &y, typename N::wide x2, typename N::wide y2,
+                      typename N::value cr, typename N::value ci)
+     {
+         typename N::value a = N::narrow(x2 - y2), b = N::twice(N::mul(x, y)); // z^2
+         for (int k = 2; k < D - 1; k++)
+         {
+             typename N::value t = N::narrow(N::mul(a, x) - N::mul(b, y));
+             b = N::narrow(N::mul(a, y) + N::mul(b, x));
+             a = t;
+         }
+         typename N::value re = N::narrow_add(N::mul(a, x) - N::mul(b, y), cr);
+         y = N::narrow_add(N::mul(a, y) + N::mul(b, x), ci);
+         x = re;
+     }
+ };
+
+ /*!
+  * @brief Iterações até |z| ultrapassar `R`, ou `cap`.
+  *
+  * @tparam F Fórmula (`start()`/`step()`).
+  * @tparam N Operações do tipo numérico (`numeric<T>`).
+  * @tparam R Raio de escape.
+  */
+ template <class F, class N, int R>
+ static inline int escape_time(typename N::value x, typename N::value y, typename N::value cr, typename N::value ci,
+                               int cap)
+ {
+     const typename N::wide limit = N::template square_radius<R>();
+     int n = 0;
+     while (n < cap)
+     {
+         typename N::wide x2 = N::mul(x, x), y2 = N::mul(y, y);
+         if (x2 + y2 > limit)
+             break;
+         F::template step<N>(x, y, x2, y2, cr, ci);
+         n++;
+     }
+     return n;
+ }
+
+ /*!
+  * @brief Kernel com a assinatura de `escape_kernel_t`: converte o ponto e a constante e itera.
+  */
+ template <class F, class T, int R> int kernel(float real, float imag, float k_real, float k_imag, int cap)
+ {
+     typedef numeric<T> N;
+     typename N::value x, y, cr, ci;
+     F::template start<N>(N::from_float(real), N::from_float(imag), N::from_float(k_real), N::from_float(k_imag), x,
+                          y, cr, ci);
+     return escape_time<F, N, R>(x, y, cr, ci, cap);
+ }
+
+ } // namespace escape
+
+ #endif
@@ -0,0 +1,400 @@
+#include <string.h>
+#include "flash_store.h"
+#include "frame_cache.h"
+
+#define RECORD_MAGIC 0x4d46 // "FM"
+#define RECORD_NONE UINT32_MAX
+
+// tipos de registro
+enum {
+    RECORD_SESSION = 1,      // uint16_t count + count * zoom_op_t
+    RECORD_FRAME_NO_CAP = 2, // formato anterior, sem o limite de iterações: ignorado (expira com o anel)
+    RECORD_FRAME = 3         // render_data_t + uint16_t limite de iterações + frame comprimido (frame_rle_encode)
+};
+
+#define FRAME_META_SIZE (sizeof(render_data_t) + sizeof(uint16_t)) // dados do registro de frame antes do RLE
+
+/*!
+ * @brief Cabeçalho de um registro (16 bytes), no início de uma página.
+ */
+typedef struct {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t len;      // bytes de dados após o cabeçalho
+    uint16_t reserved2;
+    uint32_t seq;
+    uint32_t crc;      // CRC-32 do cabeçalho (com crc = 0) e dos dados
+} record_header_t;
+
+#define HEADER_SIZE sizeof(record_header_t)
+
+// maior registro: a sessão com o histórico cheio, arredondada para páginas inteiras
+#define RECORD_MAX (((HEADER_SIZE + 2 + ZOOM_HISTORY_OPS * sizeof(zoom_op_t)) + FLASH_STORE_PAGE_SIZE - 1) / \
+                    FLASH_STORE_PAGE_SIZE * FLASH_STORE_PAGE_SIZE)
+
+// registro em montagem, lido ou copiado (cabeçalho seguido dos dados)
+static uint8_t record_buf[RECORD_MAX] __attribute__((aligned(4)));
+
+static uint32_t crc32(uint32_t crc, const uint8_t *p, size_t n)
+{
+    // CRC-32 (polinômio refletido 0xEDB88320), tabela de 4 bits
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c};
+    crc = ~crc;
+    while (n--)
+    {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ table[crc & 15];
+        crc = (crc >> 4) ^ table[crc & 15];
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc()
+{
+    record_header_t *header = (record_header_t *)record_buf;
+    uint32_t saved = header->crc;
+    header->crc = 0;
+    uint32_t crc = crc32(0, record_buf, HEADER_SIZE + header->len);
+    header->crc = saved;
+    return crc;
+}
+
+static uint32_t record_size(uint32_t len)
+{
+    return (HEADER_SIZE + len + FLASH_STORE_PAGE_SIZE - 1) / FLASH_STORE_PAGE_SIZE * FLASH_STORE_PAGE_SIZE;
+}
+
+/*!
+ * @brief Lê o registro em `offset` para record_buf.
+ *
+ * @return int 1 se válido, 0 se a posição está apagada (fim do log do setor), -1 se incompleto ou corrompido.
+ */
+static int record_read(flash_store_t *store, uint32_t offset)
+{
+    record_header_t *header = (record_header_t *)record_buf;
+    store->backend->read(offset, record_buf, HEADER_SIZE);
+
+    bool erased = true;
+    for (size_t i = 0; i < HEADER_SIZE; i++)
+        erased &= record_buf[i] == 0xff;
+    if (erased)
+        return 0;
+
+    uint32_t room = FLASH_STORE_SECTOR_SIZE - offset % FLASH_STORE_SECTOR_SIZE;
+    if (header->magic != RECORD_MAGIC || record_size(header->len) > room || record_size(header->len) > RECORD_MAX)
+        return -1;
+    store->backend->read(offset + HEADER_SIZE, record_buf + HEADER_SIZE, header->len);
+    return record_crc() == header->crc ? 1 : -1;
+}
+
+// frame mais recente por janela; entre janelas distintas, apenas os FLASH_STORE_FRAMES mais recentes
+static int frame_slot(flash_store_t *store, const render_data_t *view, uint32_t seq)
+{
+    int slot = -1;
+    for (int i = 0; i < FLASH_STORE_FRAMES; i++)
+    {
+        if (store->frames[i].offset != RECORD_NONE && memcmp(&store->frame_views[i], view, sizeof(*view)) == 0)
+            return seq > store->frames[i].seq ? i : -1;
+        if (slot < 0 || store->frames[i].offset == RECORD_NONE ||
+            (store->frames[slot].offset != RECORD_NONE && store->frames[i].seq < store->frames[slot].seq))
+            slot = i; // vazio ou o mais antigo
+    }
+    return store->frames[slot].offset == RECORD_NONE || seq > store->frames[slot].seq ? slot : -1;
+}
+
+// acrescenta ao índice o registro válido em record_buf, lido de `offset`
+static void record_index(flash_store_t *store, uint32_t offset)
+{
+    const record_header_t *header = (const record_header_t *)record_buf;
+    flash_record_ref_t ref = {offset : offset, seq : header->seq, len : header->len};
+
+    if (header->type == RECORD_SESSION)
+    {
+        if (store->session.offset == RECORD_NONE || ref.seq > store->session.seq)
+            store->session = ref;
+    }
+    else if (header->type == RECORD_FRAME && header->len >= FRAME_META_SIZE)
+    {
+        render_data_t view;
+        memcpy(&view, record_buf + HEADER_SIZE, sizeof(view));
+        int slot = frame_slot(store, &view, ref.seq);
+        if (slot >= 0)
+        {
+            store->frames[slot] = ref;
+            store->frame_views[slot] = view;
+        }
+    }
+}
+
+/*!
+ * @brief Grava o registro montado em record_buf (tipo e tamanho já preenchidos) na posição de escrita.
+ *
+ * @details Se o backend falhar, a página pode ter sido parcialmente programada: o restante do setor é abandonado.
+ */
+static bool record_write(flash_store_t *store, flash_record_ref_t *ref)
+{
+    record_header_t *header = (record_header_t *)record_buf;
+    uint32_t size = record_size(header->len);
+    if (store->used + size > FLASH_STORE_SECTOR_SIZE)
+        return false;
+
+    header->magic = RECORD_MAGIC;
+    header->reserved = 0xff;
+    header->reserved2 = 0xffff;
+    header->seq = store->seq;
+    memset(record_buf + HEADER_SIZE + header->len, 0xff, size - HEADER_SIZE - header->len);
+    header->crc = record_crc();
+
+    uint32_t offset = store->head * FLASH_STORE_SECTOR_SIZE + store->used;
+    if (!store->backend->program(offset, record_buf, size))
+    {
+        store->stats.failed++;
+        store->used = FLASH_STORE_SECTOR_SIZE;
+        return false;
+    }
+    store->seq++;
+    store->used += size;
+    store->stats.records++;
+    *ref = (flash_record_ref_t){offset : offset, seq : header->seq, len : header->len};
+    return true;
+}
+
+// copia para a posição de escrita os registros válidos do setor `sector`; os que não couberem são perdidos
+static void relocate_sector(flash_store_t *store, uint32_t sector)
+{
+    flash_record_ref_t *refs[1 + FLASH_STORE_FRAMES] = {&store->session};
+    for (int i = 0; i < FLASH_STORE_FRAMES; i++)
+        refs[1 + i] = &store->frames[i];
+
+    for (size_t i = 0; i < count_of(refs); i++)
+    {
+        flash_record_ref_t *ref = refs[i];
+        if (ref->offset == RECORD_NONE || ref->offset / FLASH_STORE_SECTOR_SIZE != sector)
+            continue;
+        flash_record_ref_t copy;
+        if (record_read(store, ref->offset) == 1 && record_write(store, &copy))
+        {
+            *ref = copy;
+            store->stats.relocated++;
+        }
+        else
+        {
+            ref->offset = RECORD_NONE;
+            store->stats.lost++;
+        }
+    }
+}
+
+/*!
+ * @brief Passa a gravar no setor seguinte do anel.
+ *
+ * @details
+ *  - O setor seguinte só contém registros válidos se uma cópia anterior foi interrompida; estes são copiados
+ *    para o setor atual, se couberem, antes do apagamento.
+ *  - Após o apagamento, os registros válidos do setor que vem depois (o próximo a ser apagado) são copiados
+ *    para o início do novo setor; como cabiam em um setor, cabem no setor vazio.
+ */
+static bool open_next(flash_store_t *store)
+{
+    uint32_t next = (store->head + 1) % store->sectors;
+    relocate_sector(store, next);
+
+    if (!store->backend->erase(next * FLASH_STORE_SECTOR_SIZE))
+    {
+        store->stats.failed++;
+        return false;
+    }
+    store->stats.erases++;
+    store->head = next;
+    store->used = 0;
+
+    relocate_sector(store, (next + 1) % store->sectors);
+    return true;
+}
+
+// garante `size` bytes livres no setor de escrita; retorna falso se não foi possível
+static bool make_room(flash_store_t *store, uint32_t size, bool *opened)
+{
+    *opened = false;
+    for (uint32_t i = 0; store->used + size > FLASH_STORE_SECTOR_SIZE; i++)
+    {
+        if (i >= store->sectors || !open_next(store))
+            return false;
+        *opened = true;
+    }
+    return true;
+}
+
+/*!
+ * @brief Abre o armazenamento, reconstruindo o índice a partir do conteúdo da região.
+ *
+ * @details
+ *  - Percorre os registros de cada setor até a primeira posição apagada; um registro inválido (gravação
+ *    interrompida) encerra o setor.
+ *  - A escrita continua após o registro de maior número de sequência; se ele é seguido por lixo, ou se a
+ *    região não contém nenhum registro (flash nova), a próxima gravação abre um novo setor.
+ *  - Somente leitura: nada é gravado até a primeira chamada a uma função de gravação.
+ */
+void flash_store_open(flash_store_t *store, const flash_backend_t *backend)
+{
+    memset(store, 0, sizeof(*store));
+    store->backend = backend;
+    store->sectors = backend->size / FLASH_STORE_SECTOR_SIZE;
+    store->session.offset = RECORD_NONE;
+    for (int i = 0; i < FLASH_STORE_FRAMES; i++)
+        store->frames[i].offset = RECORD_NONE;
+    store->head = store->sectors - 1;
+    store->used = FLASH_STORE_SECTOR_SIZE;
+
+    bool found = false;
+    for (uint32_t sector = 0; sector < store->sectors; sector++)
+    {
+        uint32_t offset = 0;
+        bool newest = false;
+        while (offset + HEADER_SIZE <= FLASH_STORE_SECTOR_SIZE)
+        {
+            int status = record_read(store, sector * FLASH_STORE_SECTOR_SIZE + offset);
+            if (status == 0)
+                break;
+            if (status < 0)
+            {
+                store->stats.torn++;
+                offset = FLASH_STORE_SECTOR_SIZE;
+                break;
+            }
+
+            const record_header_t *header = (const record_header_t *)record_buf;
+            if (!found || header->seq >= store->seq)
+            {
+                store->seq = header->seq + 1;
+                newest = true;
+                found = true;
+            }
+            record_index(store, sector * FLASH_STORE_SECTOR_SIZE + offset);
+            offset += record_size(header->len);
+        }
+        if (newest)
+        {
+            store->head = sector;
+            store->used = offset;
+        }
+    }
+}
+
+/*!
+ * @brief Grava o histórico de ampliações (a janela atual é reconstruída a partir dele).
+ */
+bool flash_store_save_session(flash_store_t *store, const zoom_history_t *history)
+{
+    uint16_t count = history->count;
+    uint16_t len = sizeof(count) + count * sizeof(zoom_op_t);
+    bool opened;
+    if (!make_room(store, record_size(len), &opened))
+        return false;
+
+    record_header_t *header = (record_header_t *)record_buf;
+    header->type = RECORD_SESSION;
+    header->len = len;
+    memcpy(record_buf + HEADER_SIZE, &count, sizeof(count));
+    memcpy(record_buf + HEADER_SIZE + sizeof(count), history->ops, count * sizeof(zoom_op_t));
+
+    flash_record_ref_t ref;
+    if (!record_write(store, &ref))
+        return false;
+    store->session = ref;
+    return true;
+}
+
+/*!
+ * @brief Restaura a sessão gravada.
+ *
+ * @param store Armazenamento aberto.
+ * @param history Histórico recém-inicializado na janela inicial (zoom_history_init()).
+ * @param state Janela inicial; recebe a janela da sessão.
+ *
+ * @return bool Falso se não há sessão gravada ou ela é inválida (histórico e janela podem ter sido alterados).
+ */
+bool flash_store_load_session(flash_store_t *store, zoom_history_t *history, zoom_state_t *state)
+{
+    if (store->session.offset == RECORD_NONE || record_read(store, store->session.offset) != 1)
+        return false;
+
+    const record_header_t *header = (const record_header_t *)record_buf;
+    uint16_t count;
+    memcpy(&count, record_buf + HEADER_SIZE, sizeof(count));
+    if (count > ZOOM_HISTORY_OPS || header->len != sizeof(count) + count * sizeof(zoom_op_t))
+        return false;
+    return zoom_history_replay(history, state, (const zoom_op_t *)(record_buf + HEADER_SIZE + sizeof(count)), count);
+}
+
+/*!
+ * @brief Grava o frame (sem o cursor) de uma janela, substituindo o frame anterior da mesma janela ou o mais antigo.
+ *
+ * @param cap Limite de iterações com que o frame foi renderizado (ver `frame_cache_insert()`).
+ */
+bool flash_store_save_frame(flash_store_t *store, const render_data_t *view, int cap, const uint8_t *frame)
+{
+    record_header_t *header = (record_header_t *)record_buf;
+    bool opened = true;
+    while (opened)
+    {
+        // a abertura de um setor copia registros através de record_buf: o frame é comprimido novamente
+        size_t rle = frame_rle_encode(frame, SSD1306_FRAME_LEN, record_buf + HEADER_SIZE + FRAME_META_SIZE,
+                                      RECORD_MAX - HEADER_SIZE - FRAME_META_SIZE);
+        header->type = RECORD_FRAME;
+        header->len = (uint16_t)(FRAME_META_SIZE + rle);
+        if (rle == 0 || !make_room(store, record_size(header->len), &opened))
+            return false;
+    }
+    uint16_t cap16 = (uint16_t)cap;
+    memcpy(record_buf + HEADER_SIZE, view, sizeof(*view));
+    memcpy(record_buf + HEADER_SIZE + sizeof(*view), &cap16, sizeof(cap16));
+
+    flash_record_ref_t ref;
+    if (!record_write(store, &ref))
+        return false;
+    int slot = frame_slot(store, view, ref.seq);
+    store->frames[slot] = ref;
+    store->frame_views[slot] = *view;
+    return true;
+}
+
+/*!
+ * @brief Lê um dos frames gravados.
+ *
+ * @param store Armazenamento aberto.
+ * @param index 0 para o frame gravado mais recentemente, 1 para o anterior, e assim por diante.
+ * @param view Recebe a janela do frame.
+ * @param cap Recebe o limite de iterações com que o frame foi renderizado.
+ * @param frame Recebe o frame (`SSD1306_FRAME_LEN` bytes).
+ *
+ * @return bool Falso se não há frame com este índice.
+ */
+bool flash_store_load_frame(flash_store_t *store, int index, render_data_t *view, int *cap, uint8_t *frame)
+{
+    // o index-ésimo mais recente: frames com número de sequência maior que o dele são exatamente `index`
+    for (int i = 0; i < FLASH_STORE_FRAMES; i++)
+    {
+        if (store->frames[i].offset == RECORD_NONE)
+            continue;
+        int newer = 0;
+        for (int j = 0; j < FLASH_STORE_FRAMES; j++)
+            newer += store->frames[j].offset != RECORD_NONE && store->frames[j].seq > store->frames[i].seq;
+        if (newer != index)
+            continue;
+
+        if (record_read(store, store->frames[i].offset) != 1)
+            return false;
+        const record_header_t *header = (const record_header_t *)record_buf;
+        uint16_t cap16;
+        memcpy(view, record_buf + HEADER_SIZE, sizeof(*view));
+        memcpy(&cap16, record_buf + HEADER_SIZE + sizeof(*view), sizeof(cap16));
+        *cap = cap16;
+        return frame_rle_decode(record_buf + HEADER_SIZE + FRAME_META_SIZE, header->len - FRAME_META_SIZE, frame,
+                                SSD1306_FRAME_LEN) == SSD1306_FRAME_LEN;
+    }
+    return false;
+}
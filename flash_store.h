@@ -0,0 +1,100 @@
+/*!
+ * @file flash_store.h
+ * @brief Armazenamento persistente da sessão (histórico de ampliações) e de frames comprimidos em flash.
+ *
+ * Log estruturado sobre uma região reservada da flash, dividida em setores percorridos em anel: cada gravação
+ * acrescenta um registro (cabeçalho com número de sequência e CRC-32, seguido dos dados) ao setor atual, e o
+ * registro mais recente de cada chave vale. Ao abrir um novo setor, os registros ainda válidos do setor
+ * seguinte (o próximo a ser apagado) são copiados antes, de forma que os apagamentos se distribuem
+ * igualmente por toda a região e uma queda de energia no meio de uma gravação perde apenas o registro
+ * incompleto (rejeitado pelo CRC na próxima inicialização).
+ *
+ * O acesso à flash passa por uma tabela de funções (`flash_backend_t`): a flash do RP2040 no firmware
+ * (flash_store_rp2040.c) ou um arquivo no build nativo (host/flash_file.c), que emula a programação da NOR e
+ * permite simular quedas de energia.
+ */
+
+ #ifndef _FLASH_STORE_
+ #define _FLASH_STORE_
+
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "zoom_history.h"
+
+ /*! @brief Tamanho de um setor (unidade de apagamento), em bytes. */
+ #define FLASH_STORE_SECTOR_SIZE 4096
+
+ /*! @brief Tamanho de uma página (unidade de programação), em bytes; cada registro ocupa páginas inteiras. */
+ #define FLASH_STORE_PAGE_SIZE 256
+
+ /*! @brief Setores da região reservada (64 KB no fim da flash). */
+ #define FLASH_STORE_SECTORS 16
+
+ /*! @brief Frames comprimidos mantidos (os das janelas gravadas mais recentemente). */
+ #define FLASH_STORE_FRAMES 4
+
+ /*! @brief Tempo sem alterações da janela após o qual a sessão é gravada (somente com o laço principal ocioso). */
+ #define FLASH_STORE_IDLE_US 3000000
+
+ /*!
+  * @brief Tabela de funções de acesso à região reservada. Os deslocamentos são relativos ao início da região.
+  */
+ typedef struct {
+     bool (*erase)(uint32_t offset);                                 /*!< Apaga um setor (todos os bytes em 0xFF). */
+     bool (*program)(uint32_t offset, const uint8_t *src, size_t len); /*!< Programa páginas inteiras já apagadas. */
+     void (*read)(uint32_t offset, uint8_t *dst, size_t len);        /*!< Lê bytes quaisquer. */
+     uint32_t size;                                                  /*!< Tamanho da região, em bytes. */
+ } flash_backend_t;
+
+ /*! @brief Flash do RP2040: últimos `FLASH_STORE_SECTORS` setores, com o core1 parado durante as gravações. */
+ extern const flash_backend_t flash_store_rp2040_backend;
+
+ /*!
+  * @brief Localização de um registro válido.
+  */
+ typedef struct {
+     uint32_t offset; /*!< Deslocamento na região (`UINT32_MAX` = nenhum). */
+     uint32_t seq;    /*!< Número de sequência. */
+     uint16_t len;    /*!< Bytes de dados. */
+ } flash_record_ref_t;
+
+ /*!
+  * @brief Contadores do armazenamento.
+  */
+ typedef struct {
+     uint32_t records;   /*!< Registros gravados (incluindo cópias). */
+     uint32_t relocated; /*!< Registros copiados de um setor prestes a ser apagado. */
+     uint32_t erases;    /*!< Setores apagados. */
+     uint32_t torn;      /*!< Registros incompletos ou corrompidos encontrados ao abrir. */
+     uint32_t lost;      /*!< Registros válidos apagados sem cópia (apenas após falhas repetidas). */
+     uint32_t failed;    /*!< Gravações que o backend não concluiu. */
+ } flash_store_stats_t;
+
+ /*!
+  * @brief Estado do armazenamento: índice em RAM dos registros válidos e posição de escrita.
+  */
+ typedef struct {
+     const flash_backend_t *backend;
+     uint32_t sectors;                              /*!< Setores da região. */
+     uint32_t seq;                                  /*!< Próximo número de sequência. */
+     uint32_t head;                                 /*!< Setor em gravação. */
+     uint32_t used;                                 /*!< Bytes ocupados no setor em gravação. */
+     flash_record_ref_t session;                    /*!< Sessão mais recente. */
+     flash_record_ref_t frames[FLASH_STORE_FRAMES]; /*!< Frames mais recentes, de janelas distintas. */
+     render_data_t frame_views[FLASH_STORE_FRAMES]; /*!< Janela de cada frame. */
+     flash_store_stats_t stats;
+ } flash_store_t;
+
+ void flash_store_open(flash_store_t *store, const flash_backend_t *backend);
+
+ bool flash_store_save_session(flash_store_t *store, const zoom_history_t *history);
+
+ bool flash_store_load_session(flash_store_t *store, zoom_history_t *history, zoom_state_t *state);
+
+ bool flash_store_save_frame(flash_store_t *store, const render_data_t *view, int cap, const uint8_t *frame);
+
+ bool flash_store_load_frame(flash_store_t *store, int index, render_data_t *view, int *cap, uint8_t *frame);
+
+ #endif
@@ -0,0 +1,81 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "render_platform.h"
+#include "flash_store.h"
+
+// região reservada: os últimos FLASH_STORE_SECTORS setores da flash, fora da área ocupada pelo programa
+#define REGION_SIZE (FLASH_STORE_SECTORS * FLASH_STORE_SECTOR_SIZE)
+#define REGION_OFFSET (PICO_FLASH_SIZE_BYTES - REGION_SIZE)
+
+static_assert(FLASH_STORE_SECTOR_SIZE == FLASH_SECTOR_SIZE, "setor do armazenamento difere do setor da flash");
+static_assert(FLASH_STORE_PAGE_SIZE == FLASH_PAGE_SIZE, "página do armazenamento difere da página da flash");
+
+static volatile bool core1_parked;
+static volatile bool core1_release;
+
+/*!
+ * @brief Executada no core1 durante uma gravação: aguarda em RAM, com as interrupções desabilitadas, pois a
+ *        flash (XIP) fica inacessível enquanto é apagada ou programada.
+ */
+static void __not_in_flash_func(core1_park)(void *arg)
+{
+    uint32_t irq = save_and_disable_interrupts();
+    core1_parked = true;
+    while (!core1_release)
+        ;
+    restore_interrupts(irq);
+}
+
+/*!
+ * @brief Para o core1 (ocioso entre renderizações) em RAM e desabilita as interrupções do core0.
+ *
+ * @note Utiliza o mesmo canal de trabalho da renderização paralela (render_platform.h): só pode ser chamada
+ *       pelo laço principal, sem renderização em andamento, e após render_platform_init().
+ */
+static uint32_t flash_lockout_begin()
+{
+    core1_release = false;
+    core1_parked = false;
+    render_platform_start_worker(core1_park, NULL);
+    while (!core1_parked)
+        tight_loop_contents();
+    return save_and_disable_interrupts();
+}
+
+static void flash_lockout_end(uint32_t irq)
+{
+    restore_interrupts(irq);
+    core1_release = true;
+    render_platform_wait_worker();
+}
+
+static bool rp2040_erase(uint32_t offset)
+{
+    uint32_t irq = flash_lockout_begin();
+    flash_range_erase(REGION_OFFSET + offset, FLASH_SECTOR_SIZE);
+    flash_lockout_end(irq);
+    return true;
+}
+
+static bool rp2040_program(uint32_t offset, const uint8_t *src, size_t len)
+{
+    uint32_t irq = flash_lockout_begin();
+    flash_range_program(REGION_OFFSET + offset, src, len); // `src` está em RAM (record_buf)
+    flash_lockout_end(irq);
+    return true;
+}
+
+static void rp2040_read(uint32_t offset, uint8_t *dst, size_t len)
+{
+    memcpy(dst, (const uint8_t *)(uintptr_t)(XIP_BASE + REGION_OFFSET + offset), len);
+}
+
+/*! @brief Flash do RP2040: últimos `FLASH_STORE_SECTORS` setores, com o core1 parado durante as gravações. */
+const flash_backend_t flash_store_rp2040_backend = {
+    erase : rp2040_erase,
+    program : rp2040_program,
+    read : rp2040_read,
+    size : REGION_SIZE
+};
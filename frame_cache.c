@@ -0,0 +1,374 @@
+#include <string.h>
+#include "frame_cache.h"
+
+/*!
+ * @brief Entrada do cache: janela e limite de iterações, posições do frame e do campo de iterações comprimidos na
+ *        área de armazenamento (`field_len` 0 = sem campo) e uso mais recente.
+ */
+typedef struct {
+    render_data_t view;
+    uint8_t cap;
+    uint16_t offset;
+    uint16_t len;
+    uint16_t field_offset;
+    uint16_t field_len;
+    uint32_t last_use;
+    bool used;
+} frame_cache_entry_t;
+
+#define FIELD_LEN (SSD1306_WIDTH * SSD1306_HEIGHT)
+
+_Static_assert(FRAME_CACHE_BUDGET <= UINT16_MAX, "as posições na área de armazenamento são de 16 bits");
+_Static_assert(MANDELBROT_ITER_LIMIT <= UINT8_MAX, "o limite de iterações das entradas é de 8 bits");
+
+static uint8_t arena[FRAME_CACHE_BUDGET];            // frames e campos comprimidos, compactados a partir do início
+static frame_cache_entry_t entries[FRAME_CACHE_ENTRIES];
+static size_t budget = FRAME_CACHE_BUDGET;            // orçamento atual (<= FRAME_CACHE_BUDGET)
+static uint32_t use_clock = 0;                        // relógio lógico do LRU
+static frame_cache_stats_t stats;
+static uint8_t scratch[FRAME_RLE_MAX_LEN];            // frame comprimido antes da inserção
+
+/*!
+ * @brief Comprime um bloco de bytes com RLE no estilo PackBits.
+ *
+ * @param src Bytes de entrada.
+ * @param len Número de bytes de entrada.
+ * @param dst Destino dos bytes comprimidos.
+ * @param cap Capacidade de `dst`.
+ *
+ * @return size_t Número de bytes comprimidos, ou 0 se `dst` não comporta o resultado.
+ *
+ * @details
+ *  - Byte de controle n < 128: seguem n + 1 bytes literais.
+ *  - Byte de controle n >= 128: o byte seguinte se repete n - 125 vezes (3 a 130).
+ *  - Frames de 1 bit por pixel têm longas sequências de 0x00 e 0xFF (páginas fora ou dentro do conjunto).
+ */
+size_t frame_rle_encode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+    size_t in = 0, out = 0;
+
+    while (in < len)
+    {
+        size_t run = 1;
+        while (in + run < len && run < 130 && src[in + run] == src[in])
+            run++;
+
+        if (run >= 3)
+        {
+            if (out + 2 > cap)
+                return 0;
+            dst[out++] = (uint8_t)(run + 125);
+            dst[out++] = src[in];
+            in += run;
+            continue;
+        }
+
+        // literais até o início da próxima repetição de 3 bytes (ou 128 literais)
+        size_t lit = 0;
+        while (in + lit < len && lit < 128)
+        {
+            if (in + lit + 2 < len && src[in + lit] == src[in + lit + 1] && src[in + lit] == src[in + lit + 2])
+                break;
+            lit++;
+        }
+        if (out + 1 + lit > cap)
+            return 0;
+        dst[out++] = (uint8_t)(lit - 1);
+        memcpy(&dst[out], &src[in], lit);
+        out += lit;
+        in += lit;
+    }
+    return out;
+}
+
+/*!
+ * @brief Descomprime um bloco gerado por `frame_rle_encode()`.
+ *
+ * @return size_t Número de bytes escritos em `dst`, ou 0 se os dados forem inválidos ou excederem `cap`.
+ */
+size_t frame_rle_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+    size_t in = 0, out = 0;
+
+    while (in < len)
+    {
+        uint8_t ctrl = src[in++];
+        if (ctrl < 128)
+        {
+            size_t lit = (size_t)ctrl + 1;
+            if (in + lit > len || out + lit > cap)
+                return 0;
+            memcpy(&dst[out], &src[in], lit);
+            in += lit;
+            out += lit;
+        }
+        else
+        {
+            size_t run = (size_t)ctrl - 125;
+            if (in >= len || out + run > cap)
+                return 0;
+            memset(&dst[out], src[in++], run);
+            out += run;
+        }
+    }
+    return out;
+}
+
+/*!
+ * @brief Procura a entrada da janela `view` (comparação exata dos quatro limites).
+ */
+static frame_cache_entry_t *find(const render_data_t *view)
+{
+    for (int i = 0; i < FRAME_CACHE_ENTRIES; i++)
+    {
+        const render_data_t *key = &entries[i].view;
+        if (entries[i].used && key->real_start == view->real_start && key->real_end == view->real_end &&
+            key->im_start == view->im_start && key->im_end == view->im_end)
+            return &entries[i];
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Libera uma entrada.
+ */
+static void release(frame_cache_entry_t *entry)
+{
+    entry->used = false;
+    stats.entries--;
+    stats.fields -= entry->field_len > 0;
+    stats.bytes -= entry->len + entry->field_len;
+}
+
+/*!
+ * @brief Descarta o campo de iterações da entrada usada há mais tempo que ainda o guarda (exceto `keep`), mantendo
+ *        o frame.
+ *
+ * @return bool Falso se nenhuma outra entrada guardava um campo.
+ */
+static bool drop_lru_field(const frame_cache_entry_t *keep)
+{
+    frame_cache_entry_t *victim = NULL;
+    for (int i = 0; i < FRAME_CACHE_ENTRIES; i++)
+        if (entries[i].used && entries[i].field_len > 0 && &entries[i] != keep &&
+            (victim == NULL || entries[i].last_use < victim->last_use))
+            victim = &entries[i];
+
+    if (victim == NULL)
+        return false;
+    stats.fields--;
+    stats.bytes -= victim->field_len;
+    victim->field_len = 0;
+    return true;
+}
+
+/*!
+ * @brief Descarta a entrada usada há mais tempo.
+ *
+ * @return bool Falso se o cache já estava vazio.
+ */
+static bool evict_lru()
+{
+    frame_cache_entry_t *victim = NULL;
+    for (int i = 0; i < FRAME_CACHE_ENTRIES; i++)
+        if (entries[i].used && (victim == NULL || entries[i].last_use < victim->last_use))
+            victim = &entries[i];
+
+    if (victim == NULL)
+        return false;
+    release(victim);
+    stats.evictions++;
+    return true;
+}
+
+/*!
+ * @brief Move os frames e campos comprimidos para o início da área de armazenamento, em ordem de posição.
+ *
+ * @return size_t Primeira posição livre após a compactação.
+ */
+static size_t compact()
+{
+    size_t next = 0;
+    for (;;)
+    {
+        // próximo bloco (frame ou campo) em ordem de posição, a partir de `next`
+        uint16_t *offset = NULL;
+        uint16_t len = 0;
+        for (int i = 0; i < FRAME_CACHE_ENTRIES; i++)
+        {
+            frame_cache_entry_t *entry = &entries[i];
+            if (!entry->used)
+                continue;
+            if (entry->offset >= next && (offset == NULL || entry->offset < *offset))
+            {
+                offset = &entry->offset;
+                len = entry->len;
+            }
+            if (entry->field_len > 0 && entry->field_offset >= next &&
+                (offset == NULL || entry->field_offset < *offset))
+            {
+                offset = &entry->field_offset;
+                len = entry->field_len;
+            }
+        }
+
+        if (offset == NULL)
+            return next;
+        if (*offset != next)
+        {
+            memmove(&arena[next], &arena[*offset], len);
+            *offset = (uint16_t)next;
+        }
+        next += len;
+    }
+}
+
+/*!
+ * @brief Esvazia o cache (os contadores de acertos, falhas e descartes são mantidos).
+ */
+void frame_cache_clear()
+{
+    memset(entries, 0, sizeof(entries));
+    stats.entries = 0;
+    stats.fields = 0;
+    stats.bytes = 0;
+}
+
+/*!
+ * @brief Altera o orçamento de memória do cache, descartando campos e depois frames se necessário.
+ *
+ * @param bytes Novo orçamento, limitado a `FRAME_CACHE_BUDGET`.
+ */
+void frame_cache_set_budget(size_t bytes)
+{
+    budget = bytes < FRAME_CACHE_BUDGET ? bytes : FRAME_CACHE_BUDGET;
+    while (stats.bytes > budget && (drop_lru_field(NULL) || evict_lru()))
+        ;
+}
+
+/*!
+ * @brief Verifica se a janela `view` está no cache com o limite `cap`, sem alterar os contadores nem a ordem do LRU.
+ */
+bool frame_cache_contains(const render_data_t *view, int cap)
+{
+    frame_cache_entry_t *entry = find(view);
+    return entry != NULL && entry->cap == cap;
+}
+
+/*!
+ * @brief Procura o frame da janela `view` no cache.
+ *
+ * @param view  Janela procurada.
+ * @param cap   Limite de iterações do frame procurado; a janela armazenada com outro limite é uma falha.
+ * @param frame Recebe o frame descomprimido (`SSD1306_FRAME_LEN` bytes) em caso de acerto.
+ *
+ * @return bool Verdadeiro se o frame estava no cache.
+ */
+bool frame_cache_lookup(const render_data_t *view, int cap, uint8_t *frame)
+{
+    frame_cache_entry_t *entry = find(view);
+    if (entry == NULL || entry->cap != cap)
+    {
+        stats.misses++;
+        return false;
+    }
+
+    frame_rle_decode(&arena[entry->offset], entry->len, frame, SSD1306_FRAME_LEN);
+    entry->last_use = ++use_clock;
+    stats.hits++;
+    return true;
+}
+
+/*!
+ * @brief Copia o campo de iterações guardado com o frame da janela `view`, sem alterar os contadores nem o LRU.
+ *
+ * @param view  Janela procurada.
+ * @param cap   Limite de iterações do frame procurado.
+ * @param field Recebe o campo (`SSD1306_WIDTH * SSD1306_HEIGHT` bytes), se houver.
+ *
+ * @return bool Verdadeiro se o frame está no cache com o limite `cap` e guarda o campo.
+ *
+ * @note Chamada após um acerto de `frame_cache_lookup()`: os campos dos frames usados há mais tempo são
+ *       descartados primeiro quando falta espaço.
+ */
+bool frame_cache_field(const render_data_t *view, int cap, uint8_t *field)
+{
+    frame_cache_entry_t *entry = find(view);
+    if (entry == NULL || entry->cap != cap || entry->field_len == 0)
+        return false;
+
+    return frame_rle_decode(&arena[entry->field_offset], entry->field_len, field, FIELD_LEN) == FIELD_LEN;
+}
+
+/*!
+ * @brief Armazena o frame da janela `view`, substituindo uma entrada existente da mesma janela (com qualquer limite).
+ *
+ * @param view  Janela do frame.
+ * @param cap   Limite de iterações com que o frame foi renderizado.
+ * @param frame Frame completo (`SSD1306_FRAME_LEN` bytes).
+ * @param field Campo de iterações completo do frame (ver `mandelbrot_retain_field()`), ou NULL.
+ *
+ * @details
+ *  - Descarta os campos e depois os frames usados há mais tempo até que haja uma entrada livre e espaço no
+ *    orçamento para o frame.
+ *  - Frames que, comprimidos, excedem o orçamento inteiro não são armazenados.
+ *  - O campo é comprimido diretamente no espaço livre; se não couber, os campos das outras entradas são
+ *    descartados, dos usados há mais tempo, e o frame fica sem campo se ainda assim não couber.
+ */
+void frame_cache_insert(const render_data_t *view, int cap, const uint8_t *frame, const uint8_t *field)
+{
+    frame_cache_entry_t *entry = find(view);
+    if (entry)
+        release(entry);
+
+    size_t len = frame_rle_encode(frame, SSD1306_FRAME_LEN, scratch, sizeof(scratch));
+    if (len == 0 || len > budget)
+    {
+        stats.rejected++;
+        return;
+    }
+
+    while (stats.entries == FRAME_CACHE_ENTRIES)
+        evict_lru();
+    while (stats.bytes + len > budget && (drop_lru_field(NULL) || evict_lru()))
+        ;
+
+    size_t offset = compact();
+    for (entry = entries; entry->used; entry++)
+        ;
+
+    memcpy(&arena[offset], scratch, len);
+    entry->view = *view;
+    entry->cap = (uint8_t)cap;
+    entry->field_len = 0;
+    entry->offset = (uint16_t)offset;
+    entry->len = (uint16_t)len;
+    entry->last_use = ++use_clock;
+    entry->used = true;
+    stats.entries++;
+    stats.bytes += len;
+
+    while (field)
+    {
+        size_t field_offset = compact();
+        size_t field_len = frame_rle_encode(field, FIELD_LEN, &arena[field_offset], budget - field_offset);
+        if (field_len > 0)
+        {
+            entry->field_offset = (uint16_t)field_offset;
+            entry->field_len = (uint16_t)field_len;
+            stats.fields++;
+            stats.bytes += field_len;
+            break;
+        }
+        if (!drop_lru_field(entry))
+            break;
+    }
+}
+
+/*!
+ * @brief Retorna os contadores do cache.
+ */
+const frame_cache_stats_t *frame_cache_stats()
+{
+    return &stats;
+}
@@ -0,0 +1,70 @@
+/*!
+ * @file frame_cache.h
+ * @brief Cache LRU de frames renderizados, indexado pela janela exata do plano complexo e pelo limite de iterações.
+ *
+ * Os frames são armazenados comprimidos (RLE no estilo PackBits sobre o buffer de páginas do SSD1306),
+ * de forma que poucos KB comportam todo o histórico de ampliações e desfazer uma ampliação custa apenas
+ * descomprimir e transmitir o frame.
+ *
+ * O limite de iterações com que o frame foi renderizado é guardado com ele: a mesma janela com outro limite é outra
+ * imagem, e a consulta com um limite diferente é uma falha.
+ *
+ * Os frames podem guardar também o campo de iterações (ver `mandelbrot_retain_field()`), comprimido com o mesmo RLE
+ * e contado no mesmo orçamento: um acerto restaura o sombreamento do frame (desfazer, especulação) sem recalculá-lo.
+ * Os campos ocupam bem mais que as imagens (1 a 2 KB contra 200 bytes) e são descartados primeiro, dos frames
+ * usados há mais tempo: falta de espaço nunca descarta um frame para guardar um campo.
+ */
+
+ #ifndef _FRAME_CACHE_
+ #define _FRAME_CACHE_
+
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Memória reservada para os frames e campos comprimidos, em bytes (orçamento máximo). */
+ #ifndef FRAME_CACHE_BUDGET
+ #define FRAME_CACHE_BUDGET 8192
+ #endif
+
+ /*! @brief Número máximo de frames no cache. */
+ #ifndef FRAME_CACHE_ENTRIES
+ #define FRAME_CACHE_ENTRIES 16
+ #endif
+
+ /*! @brief Tamanho máximo de um frame comprimido (pior caso do RLE: um byte de controle a cada 128 literais). */
+ #define FRAME_RLE_MAX_LEN (SSD1306_FRAME_LEN + (SSD1306_FRAME_LEN + 127) / 128)
+
+ /*!
+  * @brief Contadores do cache.
+  */
+ typedef struct {
+     uint32_t hits;       /*!< Consultas atendidas pelo cache. */
+     uint32_t misses;     /*!< Consultas não encontradas. */
+     uint32_t evictions;  /*!< Frames descartados para liberar espaço ou entradas. */
+     uint32_t rejected;   /*!< Frames maiores que o orçamento, não armazenados. */
+     uint32_t entries;    /*!< Frames armazenados atualmente. */
+     uint32_t fields;     /*!< Frames armazenados com o campo de iterações. */
+     uint32_t bytes;      /*!< Bytes ocupados pelos frames e campos comprimidos. */
+ } frame_cache_stats_t;
+
+ size_t frame_rle_encode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+ size_t frame_rle_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+ void frame_cache_clear();
+
+ void frame_cache_set_budget(size_t bytes);
+
+ bool frame_cache_contains(const render_data_t *view, int cap);
+
+ bool frame_cache_lookup(const render_data_t *view, int cap, uint8_t *frame);
+
+ bool frame_cache_field(const render_data_t *view, int cap, uint8_t *field);
+
+ void frame_cache_insert(const render_data_t *view, int cap, const uint8_t *frame, const uint8_t *field);
+
+ const frame_cache_stats_t *frame_cache_stats();
+
+ #endif
@@ -0,0 +1,345 @@
+#include <string.h>
+#include "frame_stream.h"
+
+static const uint8_t magic[2] = {'M', 'F'};
+
+static uint8_t scratch[FRAME_STREAM_PACKET_MAX]; // quadro-chave comparado com a diferença
+static uint8_t delta[SSD1306_FRAME_LEN];         // XOR entre dois frames (codificação e leitura)
+
+/*!
+ * @brief CRC-16/CCITT (polinômio 0x1021, valor inicial 0xFFFF).
+ */
+static uint16_t crc16(const uint8_t *p, size_t n)
+{
+    uint16_t crc = 0xFFFF;
+    while (n--)
+    {
+        crc ^= (uint16_t)(*p++ << 8);
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+/*!
+ * @brief Monta um pacote (formato em frame_stream.h).
+ *
+ * @param packet    Destino, com ao menos `FRAME_STREAM_PACKET_MAX` bytes.
+ * @param type      Quadro-chave ou diferença.
+ * @param seq       Número do frame.
+ * @param base      Número do frame de referência (diferença); igual a `seq` no quadro-chave.
+ * @param time_ms   Instante do frame.
+ * @param frame     Frame a transmitir.
+ * @param reference Frame `base` (ignorado no quadro-chave).
+ *
+ * @return size_t O tamanho do pacote.
+ */
+size_t frame_stream_encode(uint8_t *packet, frame_stream_type_t type, uint16_t seq, uint16_t base,
+                           uint32_t time_ms, const uint8_t *frame, const uint8_t *reference)
+{
+    const uint8_t *src = frame;
+    if (type == FRAME_STREAM_DELTA)
+    {
+        for (int i = 0; i < SSD1306_FRAME_LEN; i++)
+            delta[i] = frame[i] ^ reference[i];
+        src = delta;
+    }
+
+    // o pior caso do RLE cabe sempre no pacote (FRAME_RLE_MAX_LEN)
+    size_t n = frame_rle_encode(src, SSD1306_FRAME_LEN, packet + FRAME_STREAM_HEADER_LEN, FRAME_RLE_MAX_LEN);
+
+    packet[0] = magic[0];
+    packet[1] = magic[1];
+    packet[2] = (uint8_t)type;
+    packet[3] = 0;
+    put16(&packet[4], seq);
+    put16(&packet[6], base);
+    put16(&packet[8], (uint16_t)time_ms);
+    put16(&packet[10], (uint16_t)(time_ms >> 16));
+    put16(&packet[12], (uint16_t)n);
+    put16(&packet[FRAME_STREAM_HEADER_LEN + n], crc16(&packet[2], FRAME_STREAM_HEADER_LEN - 2 + n));
+    return FRAME_STREAM_HEADER_LEN + n + 2;
+}
+
+/*!
+ * @brief Esvazia a fila, zera os contadores e define a saída; o próximo pacote é um quadro-chave.
+ */
+void frame_stream_init(frame_stream_t *stream, const frame_stream_sink_t *sink)
+{
+    memset(stream, 0, sizeof(*stream));
+    stream->sink = sink;
+}
+
+/*!
+ * @brief Acrescenta um frame à fila (cópia; não transmite nada).
+ *
+ * @param frame   Frame no formato do buffer de páginas do SSD1306.
+ * @param time_ms Instante do frame, transmitido no pacote (taxa de frames medida pelo leitor).
+ *
+ * @details
+ *  - Com a fila cheia, o frame mais antigo ainda não codificado é descartado: o leitor recebe sempre os frames
+ *    mais recentes, e a diferença é calculada na transmissão, em relação ao último frame de fato transmitido.
+ */
+void frame_stream_submit(frame_stream_t *stream, const uint8_t *frame, uint32_t time_ms)
+{
+    if (stream->count == FRAME_STREAM_QUEUE)
+    {
+        stream->head++;
+        stream->count--;
+        stream->stats.dropped++;
+    }
+
+    uint32_t slot = (stream->head + stream->count) % FRAME_STREAM_QUEUE;
+    memcpy(stream->queue[slot], frame, SSD1306_FRAME_LEN);
+    stream->queue_ms[slot] = time_ms;
+    stream->queue_seq[slot] = stream->next_seq++;
+    stream->count++;
+    stream->stats.submitted++;
+}
+
+/*!
+ * @brief Acrescenta texto (mensagens do console) à saída, para ser gravado entre dois pacotes.
+ *
+ * @details
+ *  - O texto é gravado após o pacote em andamento e antes do próximo, sem conversão de "\n" em "\r\n".
+ *  - O que não couber em `FRAME_STREAM_TEXT` bytes é descartado (`text_dropped`).
+ */
+void frame_stream_text(frame_stream_t *stream, const char *text, size_t len)
+{
+    size_t room = FRAME_STREAM_TEXT - stream->text_len;
+    size_t n = len < room ? len : room;
+    memcpy(&stream->text[stream->text_len], text, n);
+    stream->text_len += n;
+    stream->stats.text_dropped += len - n;
+}
+
+/*!
+ * @brief Codifica o frame mais antigo da fila no pacote de transmissão.
+ *
+ * @details
+ *  - Quadro-chave no primeiro pacote e a cada `FRAME_STREAM_KEY_INTERVAL` pacotes; nos demais, a diferença,
+ *    exceto quando o frame inteiro comprimido é menor (mudança de janela, por exemplo).
+ *  - Frames idênticos ao último transmitido são descartados sem pacote.
+ */
+static void encode_next(frame_stream_t *stream)
+{
+    uint32_t slot = stream->head % FRAME_STREAM_QUEUE;
+    const uint8_t *frame = stream->queue[slot];
+    uint16_t seq = stream->queue_seq[slot];
+    uint32_t time_ms = stream->queue_ms[slot];
+    stream->head++;
+    stream->count--;
+
+    bool key = !stream->has_reference || stream->since_key + 1 >= FRAME_STREAM_KEY_INTERVAL;
+    if (!key && memcmp(frame, stream->reference, SSD1306_FRAME_LEN) == 0)
+    {
+        stream->stats.unchanged++;
+        return;
+    }
+
+    size_t len = frame_stream_encode(scratch, FRAME_STREAM_KEY, seq, seq, time_ms, frame, NULL);
+    if (!key)
+    {
+        stream->packet_len = frame_stream_encode(stream->packet, FRAME_STREAM_DELTA, seq, stream->reference_seq,
+                                                 time_ms, frame, stream->reference);
+        key = len < stream->packet_len;
+    }
+    if (key)
+    {
+        memcpy(stream->packet, scratch, len);
+        stream->packet_len = len;
+    }
+    stream->packet_sent = 0;
+    stream->since_key = key ? 0 : stream->since_key + 1;
+
+    memcpy(stream->reference, frame, SSD1306_FRAME_LEN);
+    stream->reference_seq = seq;
+    stream->has_reference = true;
+}
+
+/*!
+ * @brief Grava na saída o que ela aceitar do pacote em andamento, do texto e dos frames da fila, sem esperar.
+ *
+ * @return bool Verdadeiro se algum byte foi gravado ou algum frame foi codificado.
+ *
+ * @details O pacote em andamento é concluído antes do texto, e o texto antes do próximo pacote: um nunca é
+ *          gravado no meio do outro.
+ *
+ * @note Chamada a cada volta do laço principal; o custo sem frames nem texto é uma comparação.
+ */
+bool frame_stream_poll(frame_stream_t *stream)
+{
+    bool progressed = false;
+
+    while (true)
+    {
+        if (stream->packet_sent < stream->packet_len)
+        {
+            size_t n = stream->sink->write(stream->packet + stream->packet_sent,
+                                           stream->packet_len - stream->packet_sent);
+            stream->packet_sent += n;
+            progressed |= n > 0;
+            if (stream->packet_sent < stream->packet_len)
+                return progressed; // saída cheia: continua na próxima chamada
+
+            frame_stream_stats_t *stats = &stream->stats;
+            uint32_t time_ms = get16(&stream->packet[8]) | (uint32_t)get16(&stream->packet[10]) << 16;
+            if (stats->packets == 0)
+                stats->first_ms = time_ms;
+            stats->last_ms = time_ms;
+            stats->packets++;
+            stats->keyframes += stream->packet[2] == FRAME_STREAM_KEY;
+            stats->raw_bytes += SSD1306_FRAME_LEN;
+            stats->wire_bytes += stream->packet_len;
+        }
+
+        if (stream->text_sent < stream->text_len)
+        {
+            size_t n = stream->sink->write((const uint8_t *)stream->text + stream->text_sent,
+                                           stream->text_len - stream->text_sent);
+            stream->text_sent += n;
+            stream->stats.text_bytes += n;
+            progressed |= n > 0;
+            if (stream->text_sent < stream->text_len)
+                return progressed;
+            stream->text_len = stream->text_sent = 0;
+        }
+
+        if (stream->count == 0)
+            return progressed;
+        encode_next(stream);
+        progressed = true;
+    }
+}
+
+/*!
+ * @brief Verifica se não há pacote em transmissão, texto pendente nem frames na fila.
+ */
+bool frame_stream_idle(const frame_stream_t *stream)
+{
+    return stream->count == 0 && stream->packet_sent == stream->packet_len && stream->text_sent == stream->text_len;
+}
+
+/*!
+ * @brief Inicializa o leitor: sem frame de referência até o primeiro quadro-chave.
+ */
+void frame_stream_reader_init(frame_stream_reader_t *reader)
+{
+    memset(reader, 0, sizeof(*reader));
+}
+
+/*!
+ * @brief Descarta bytes do início do buffer até o próximo início de pacote possível.
+ */
+static void reader_skip(frame_stream_reader_t *reader, size_t count)
+{
+    while (count < reader->len && reader->buf[count] != magic[0])
+        count++;
+    memmove(reader->buf, reader->buf + count, reader->len - count);
+    reader->len -= count;
+    reader->skipped += count;
+}
+
+/*!
+ * @brief Reconstrói o frame de um pacote com CRC válido.
+ *
+ * @return bool Falso se for uma diferença sem o frame base ou se os dados forem inválidos.
+ */
+static bool reader_apply(frame_stream_reader_t *reader, const uint8_t *packet)
+{
+    uint8_t type = packet[2];
+    uint16_t seq = get16(&packet[4]);
+    uint16_t base = get16(&packet[6]);
+    size_t n = get16(&packet[12]);
+
+    if (type == FRAME_STREAM_DELTA && (!reader->valid || base != reader->seq))
+    {
+        reader->orphans++; // pacote anterior perdido: aguarda o próximo quadro-chave
+        reader->valid = false;
+        return false;
+    }
+
+    uint8_t *dst = type == FRAME_STREAM_KEY ? reader->frame : delta;
+    if (frame_rle_decode(&packet[FRAME_STREAM_HEADER_LEN], n, dst, SSD1306_FRAME_LEN) != SSD1306_FRAME_LEN)
+    {
+        reader->corrupt++;
+        reader->valid = false;
+        return false;
+    }
+    if (type == FRAME_STREAM_DELTA)
+        for (int i = 0; i < SSD1306_FRAME_LEN; i++)
+            reader->frame[i] ^= delta[i];
+    else
+        reader->keyframes++;
+
+    reader->valid = true;
+    reader->seq = seq;
+    reader->time_ms = get16(&packet[8]) | (uint32_t)get16(&packet[10]) << 16;
+    reader->type = type;
+    return true;
+}
+
+/*!
+ * @brief Entrega um byte recebido ao leitor.
+ *
+ * @return bool Verdadeiro se um frame foi reconstruído (em `reader->frame`, com `seq`, `time_ms` e `type`).
+ *
+ * @details
+ *  - Os bytes fora de pacotes (mensagens de texto) são descartados até o início de pacote `'M' 'F'`.
+ *  - Um cabeçalho inválido ou um CRC incorreto descarta apenas o primeiro byte do suposto pacote: o início
+ *    verdadeiro pode estar entre os bytes já recebidos.
+ */
+bool frame_stream_reader_push(frame_stream_reader_t *reader, uint8_t byte)
+{
+    reader->buf[reader->len++] = byte;
+
+    while (reader->len > 0)
+    {
+        if (reader->buf[0] != magic[0] || (reader->len >= 2 && reader->buf[1] != magic[1]))
+        {
+            reader_skip(reader, 1);
+            continue;
+        }
+        if (reader->len < FRAME_STREAM_HEADER_LEN)
+            return false;
+
+        uint8_t type = reader->buf[2];
+        size_t n = get16(&reader->buf[12]);
+        if ((type != FRAME_STREAM_KEY && type != FRAME_STREAM_DELTA) || reader->buf[3] != 0 || n > FRAME_RLE_MAX_LEN)
+        {
+            reader->corrupt++;
+            reader_skip(reader, 1);
+            continue;
+        }
+
+        size_t total = FRAME_STREAM_HEADER_LEN + n + 2;
+        if (reader->len < total)
+            return false;
+        if (crc16(&reader->buf[2], total - 4) != get16(&reader->buf[total - 2]))
+        {
+            reader->corrupt++;
+            reader_skip(reader, 1);
+            continue;
+        }
+
+        reader->packets++;
+        reader->wire_bytes += total;
+        bool decoded = reader_apply(reader, reader->buf);
+        memmove(reader->buf, reader->buf + total, reader->len - total);
+        reader->len -= total;
+        if (decoded)
+            return true; // os bytes restantes (apenas após um descarte) são examinados no próximo byte
+    }
+    return false;
+}
@@ -0,0 +1,156 @@
+/*!
+ * @file frame_stream.h
+ * @brief Transmissão dos frames exibidos pela USB (CDC) em pacotes binários comprimidos.
+ *
+ * Cada frame enviado ao display é copiado para uma fila limitada; o laço principal esvazia a fila pela saída
+ * não bloqueante (`frame_stream_sink_t`), gravando apenas os bytes que a USB aceita no momento. O frame é
+ * codificado apenas quando a saída fica livre: como diferença (XOR) em relação ao último frame transmitido e em
+ * seguida com o RLE do cache de frames (`frame_rle_encode()`), ou inteiro (quadro-chave) periodicamente, quando
+ * a diferença não é menor ou sem frame de referência. Com a saída lenta ou desconectada, os frames mais antigos
+ * da fila são descartados: a renderização nunca espera pela USB.
+ *
+ * Formato do pacote (inteiros little-endian):
+ *
+ *     'M' 'F' | tipo (1) | 0 (1) | seq (2) | base (2) | instante_ms (4) | n (2) | dados (n) | CRC-16 (2)
+ *
+ *  - `tipo`: `FRAME_STREAM_KEY` (dados = RLE do frame) ou `FRAME_STREAM_DELTA` (dados = RLE do XOR com o frame
+ *    `base`).
+ *  - `seq`: número do frame na ordem em que foi submetido; saltos correspondem a frames descartados.
+ *  - O CRC-16 (CCITT) cobre do tipo ao último byte dos dados.
+ *
+ * A saída da USB é compartilhada com as mensagens de texto do console. Com a transmissão ligada, o texto passa
+ * pelo transmissor (`frame_stream_text()`) e é gravado apenas entre dois pacotes, nunca no meio de um: um pacote
+ * interrompido por texto falharia no CRC, e as diferenças seguintes seriam perdidas até o próximo quadro-chave. O
+ * leitor (`frame_stream_reader_t`) ignora os bytes fora de pacotes; se um pacote ainda assim chegar corrompido
+ * (ruído, texto de outra origem), procura o início de pacote seguinte e ignora as diferenças cuja base não
+ * reconstruiu, até o próximo quadro-chave.
+ *
+ * O leitor é utilizado pelo visualizador do build nativo (host/stream_view.c) e pelo benchmark.
+ */
+
+ #ifndef _FRAME_STREAM_
+ #define _FRAME_STREAM_
+
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "frame_cache.h"
+
+ /*! @brief Habilita a transmissão dos frames pela USB (0 remove o código do firmware). */
+ #ifndef MANDELBROT_STREAM
+ #define MANDELBROT_STREAM 1
+ #endif
+
+ /*! @brief Frames aguardando a transmissão; ao submeter com a fila cheia, o mais antigo é descartado. */
+ #ifndef FRAME_STREAM_QUEUE
+ #define FRAME_STREAM_QUEUE 2
+ #endif
+
+ /*! @brief Pacotes entre quadros-chave: limita a espera de um leitor conectado no meio da transmissão. */
+ #ifndef FRAME_STREAM_KEY_INTERVAL
+ #define FRAME_STREAM_KEY_INTERVAL 32
+ #endif
+
+ /*! @brief Bytes de texto aguardando a transmissão entre pacotes; o excedente é descartado. */
+ #ifndef FRAME_STREAM_TEXT
+ #define FRAME_STREAM_TEXT 512
+ #endif
+
+ /*! @brief Bytes do cabeçalho, antes dos dados. */
+ #define FRAME_STREAM_HEADER_LEN 14
+
+ /*! @brief Tamanho máximo de um pacote: cabeçalho, frame comprimido no pior caso e CRC. */
+ #define FRAME_STREAM_PACKET_MAX (FRAME_STREAM_HEADER_LEN + FRAME_RLE_MAX_LEN + 2)
+
+ /*! @brief Tipo de pacote. */
+ typedef enum {
+     FRAME_STREAM_KEY = 1,  /*!< Frame inteiro. */
+     FRAME_STREAM_DELTA = 2 /*!< Diferença em relação ao frame `base`. */
+ } frame_stream_type_t;
+
+ /*!
+  * @brief Saída não bloqueante dos pacotes.
+  */
+ typedef struct {
+     size_t (*write)(const uint8_t *src, size_t len); /*!< Grava até `len` bytes sem esperar; retorna os aceitos. */
+ } frame_stream_sink_t;
+
+ /*! @brief USB (CDC) do firmware: apenas o espaço livre no buffer de transmissão; nada sem um host conectado. */
+ extern const frame_stream_sink_t frame_stream_usb_sink;
+
+ /*!
+  * @brief Contadores da transmissão.
+  */
+ typedef struct {
+     uint32_t submitted;  /*!< Frames submetidos. */
+     uint32_t dropped;    /*!< Frames descartados da fila antes da transmissão. */
+     uint32_t unchanged;  /*!< Frames idênticos ao último transmitido, não enviados. */
+     uint32_t packets;    /*!< Pacotes transmitidos por completo. */
+     uint32_t keyframes;  /*!< Quadros-chave entre os pacotes. */
+     uint64_t raw_bytes;  /*!< Bytes dos frames transmitidos, sem compressão. */
+     uint64_t wire_bytes; /*!< Bytes dos pacotes transmitidos (cabeçalho e CRC incluídos). */
+     uint32_t first_ms;   /*!< Instante do primeiro frame transmitido. */
+     uint32_t last_ms;    /*!< Instante do último frame transmitido. */
+     uint32_t text_bytes;   /*!< Bytes de texto gravados entre os pacotes. */
+     uint32_t text_dropped; /*!< Bytes de texto descartados com o buffer de texto cheio. */
+ } frame_stream_stats_t;
+
+ /*!
+  * @brief Estado do transmissor; produtor e consumidor são o laço principal.
+  */
+ typedef struct {
+     const frame_stream_sink_t *sink;
+     uint8_t queue[FRAME_STREAM_QUEUE][SSD1306_FRAME_LEN]; /*!< Frames aguardando, em ordem a partir de `head`. */
+     uint32_t queue_ms[FRAME_STREAM_QUEUE];
+     uint16_t queue_seq[FRAME_STREAM_QUEUE];
+     uint32_t head, count;
+     uint8_t reference[SSD1306_FRAME_LEN]; /*!< Último frame transmitido (base das diferenças). */
+     bool has_reference;
+     uint16_t reference_seq;
+     uint32_t since_key;                   /*!< Pacotes desde o último quadro-chave. */
+     uint16_t next_seq;
+     uint8_t packet[FRAME_STREAM_PACKET_MAX]; /*!< Pacote em transmissão. */
+     size_t packet_len, packet_sent;
+     char text[FRAME_STREAM_TEXT];            /*!< Texto aguardando o fim do pacote em transmissão. */
+     size_t text_len, text_sent;
+     frame_stream_stats_t stats;
+ } frame_stream_t;
+
+ /*!
+  * @brief Estado do leitor: monta os pacotes a partir dos bytes recebidos e reconstrói os frames.
+  */
+ typedef struct {
+     uint8_t buf[FRAME_STREAM_PACKET_MAX]; /*!< Bytes recebidos desde o último início de pacote. */
+     size_t len;
+     uint8_t frame[SSD1306_FRAME_LEN];     /*!< Último frame reconstruído. */
+     bool valid;                           /*!< `frame` é a base das próximas diferenças. */
+     uint16_t seq;                         /*!< Número do último frame reconstruído. */
+     uint32_t time_ms;                     /*!< Instante do último frame reconstruído, no relógio da placa. */
+     uint8_t type;                         /*!< Tipo do último pacote reconstruído. */
+     uint32_t packets;                     /*!< Pacotes com CRC válido. */
+     uint32_t keyframes;                   /*!< Quadros-chave entre os pacotes válidos. */
+     uint32_t orphans;                     /*!< Diferenças ignoradas por falta do frame base. */
+     uint32_t corrupt;                     /*!< Pacotes rejeitados (CRC ou conteúdo inválido). */
+     uint64_t skipped;                     /*!< Bytes descartados fora de pacotes (texto ou ruído). */
+     uint64_t wire_bytes;                  /*!< Bytes dos pacotes válidos. */
+ } frame_stream_reader_t;
+
+ void frame_stream_init(frame_stream_t *stream, const frame_stream_sink_t *sink);
+
+ void frame_stream_submit(frame_stream_t *stream, const uint8_t *frame, uint32_t time_ms);
+
+ void frame_stream_text(frame_stream_t *stream, const char *text, size_t len);
+
+ bool frame_stream_poll(frame_stream_t *stream);
+
+ bool frame_stream_idle(const frame_stream_t *stream);
+
+ size_t frame_stream_encode(uint8_t *packet, frame_stream_type_t type, uint16_t seq, uint16_t base,
+                            uint32_t time_ms, const uint8_t *frame, const uint8_t *reference);
+
+ void frame_stream_reader_init(frame_stream_reader_t *reader);
+
+ bool frame_stream_reader_push(frame_stream_reader_t *reader, uint8_t byte);
+
+ #endif
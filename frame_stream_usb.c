@@ -0,0 +1,29 @@
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#include "frame_stream.h"
+
+/*!
+ * @brief Grava na USB (CDC) apenas os bytes que cabem no buffer de transmissão, sem esperar.
+ *
+ * @details
+ *  - A escrita passa pelo driver de stdio da USB (`stdio_usb.out_chars`), que serializa o acesso ao TinyUSB com
+ *    o printf e com a tarefa da USB, e nunca espera porque a quantidade não excede o espaço livre. O driver não
+ *    converte "\n" em "\r\n" (a conversão é feita pela camada de stdio, acima dele).
+ *  - Sem host conectado nada é aceito: o pacote em andamento fica pendente e os frames novos substituem os
+ *    antigos na fila.
+ */
+static size_t usb_write(const uint8_t *src, size_t len)
+{
+    if (!stdio_usb_connected())
+        return 0;
+
+    size_t n = MIN(len, (size_t)tud_cdc_write_available());
+    if (n)
+        stdio_usb.out_chars((const char *)src, (int)n);
+    return n;
+}
+
+const frame_stream_sink_t frame_stream_usb_sink = {
+    write : usb_write
+};
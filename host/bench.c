@@ -0,0 +1,2763 @@
+/*!
+ * @file bench.c
+ * @brief Benchmark do núcleo de renderização com verificação contra frames de referência.
+ *
+ * Renderiza um catálogo fixo de janelas do plano complexo, mede o desempenho do kernel e compara cada
+ * frame, bit a bit, com o arquivo PBM correspondente em golden/.
+ *
+ * Uso: mandelbrot_bench [--update-golden] [--golden-dir DIR] [--dump-i2c ARQUIVO] [--adc-trace ARQUIVO]
+ *                        [--trace-dump ARQUIVO]
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "render_parallel.h"
+#include "render_progressive.h"
+#include "render_pan.h"
+#include "viewport.h"
+#include "frame_cache.h"
+#include "speculate.h"
+#include "render_deep.h"
+#include "render_budget.h"
+#include "input_queue.h"
+#include "joystick.h"
+#include "zoom_history.h"
+#include "flash_store.h"
+#include "render_platform.h"
+#include "ssd1306_transport.h"
+#include "ssd1306_tx.h"
+#include "hal_host.h"
+#include "transport_host.h"
+#include "flash_file.h"
+#include "render_tiles.h"
+#include "kernel_simd.h"
+#include "transport_record.h"
+#include "pbm.h"
+#include "raster.h"
+#include "shade.h"
+#include "trace.h"
+#include "frame_stream.h"
+#include "escape.h"
+
+#ifndef MANDELBROT_GOLDEN_DIR
+#define MANDELBROT_GOLDEN_DIR "golden"
+#endif
+
+/*! @brief Tempo mínimo de medição por janela (ns). */
+#define BENCH_MIN_TIME_NS 200000000ull
+
+/*!
+ * @brief Entrada do catálogo de janelas.
+ */
+typedef struct {
+    const char *name;   /*!< Nome da janela (também nome do arquivo de referência). */
+    render_data_t view; /*!< Limites do plano complexo. */
+} bench_view_t;
+
+static const bench_view_t catalogue[] = {
+    {"home", {-2.0f, 1.0f, -1.5f, 1.5f}},
+    {"seahorse_valley", {-0.80f, -0.70f, 0.05f, 0.15f}},
+    {"deep_boundary", {-0.7454f, -0.7446f, 0.1126f, 0.1134f}},
+    {"all_interior", {-0.3f, 0.1f, -0.15f, 0.15f}},
+};
+
+/*!
+ * @brief Renderiza a janela com a iteração completa, sem nenhum atalho, e retorna o total de iterações.
+ *
+ * Réplica direta do laço de `mandelbrot_fixed()` / `mandelbrot()` anterior aos atalhos, usada como referência.
+ */
+static uint64_t render_full_iteration(uint8_t *buf, const render_data_t *view)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    uint64_t total = 0;
+
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+    {
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            float real = view->real_start + x * stepX;
+            float imag = view->im_start + y * stepY;
+            int n = 0;
+#if MANDELBROT_FIXED_POINT
+            int32_t cr = MANDELBROT_TO_FIXED(real), ci = MANDELBROT_TO_FIXED(imag);
+            int32_t zx = 0, zy = 0;
+            const int64_t round_to_zero = ((int64_t)1 << (MANDELBROT_FRAC_BITS - 1)) - 1;
+            while (n < MAX_ITER)
+            {
+                int64_t x2 = (int64_t)zx * zx, y2 = (int64_t)zy * zy, xy = (int64_t)zx * zy;
+                if (x2 + y2 > ((int64_t)4 << (2 * MANDELBROT_FRAC_BITS)))
+                    break;
+                zx = (int32_t)((x2 - y2) >> MANDELBROT_FRAC_BITS) + cr;
+                zy = (int32_t)((xy + ((xy >> 63) & round_to_zero)) >> (MANDELBROT_FRAC_BITS - 1)) + ci;
+                n++;
+            }
+#else
+            float complex c = real + imag * I, z = 0;
+            while (cabsf(z) <= 2 && n < MAX_ITER)
+            {
+                z = z * z + c;
+                n++;
+            }
+#endif
+            set_pixel(buf, x, y, n == MAX_ITER);
+            total += n;
+        }
+    }
+    return total;
+}
+
+/*!
+ * @brief Mede a renderização progressiva e verifica que o resultado final é idêntico ao frame completo.
+ *
+ * @details
+ *  - A passada final é a renderização completa (`draw_mandelbrot_frame()`) a partir das amostras das
+ *    pré-visualizações: a imagem e o campo de iterações finais são os dela, e nenhuma amostra é reavaliada.
+ *  - Avaliando todos os pixels (`MANDELBROT_RENDER_FULL`), a renderização progressiva avalia no máximo os pixels da
+ *    renderização completa; nos modos de subdivisão, as pré-visualizações também amostram pixels que a
+ *    renderização completa preenche sem avaliar.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_progressive()
+{
+    static uint8_t full[SSD1306_BUF_LEN];
+    static uint8_t full_field[SSD1306_WIDTH * SSD1306_HEIGHT], field[sizeof(full_field)];
+    mandelbrot_render_mode_t initial_mode = mandelbrot_get_render_mode();
+    int failures = 0;
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        mandelbrot_set_render_mode(mode == 0 ? initial_mode : MANDELBROT_RENDER_FULL);
+        printf("\n%-16s %10s %10s %10s %10s %10s %10s %s\n", mode == 0 ? "progressiva" : "progr. (todos)",
+               "previa(us)", "final(us)", "completo", "avaliados", "na final", "completo", "final == completo");
+        for (size_t i = 0; i < count_of(catalogue); i++)
+        {
+            const bench_view_t *entry = &catalogue[i];
+            memset(full, 0, sizeof(full));
+            mandelbrot_retain_field(full, full_field);
+            uint64_t t0 = hal_host_time_ns();
+            draw_mandelbrot_frame(full, &entry->view);
+            uint64_t full_ns = hal_host_time_ns() - t0;
+            uint32_t full_evaluated = mandelbrot_frame_stats()->evaluated;
+
+            mandelbrot_retain_field(progressive_image(), field);
+            progressive_start(&entry->view);
+            while (progressive_step() != PROGRESSIVE_FINISHED)
+                ;
+            mandelbrot_retain_field(NULL, NULL);
+            const progressive_stats_t *stats = progressive_stats();
+            uint32_t final_evaluated = mandelbrot_frame_stats()->evaluated; // a passada final é o último frame
+
+            bool same = memcmp(progressive_image(), full, SSD1306_FRAME_LEN) == 0 &&
+                        memcmp(field, full_field, sizeof(field)) == 0;
+            bool counts = stats->passes == 4 && final_evaluated < full_evaluated &&
+                          (mode == 0 || stats->kernel.evaluated <= full_evaluated);
+            failures += !same || !counts;
+
+            printf("%-16s %10llu %10llu %10.1f %10u %10u %10u %s\n", entry->name,
+                   (unsigned long long)stats->preview_us, (unsigned long long)stats->final_us, full_ns / 1e3,
+                   stats->kernel.evaluated, final_evaluated, full_evaluated, same && counts ? "sim" : "NAO");
+        }
+    }
+    mandelbrot_set_render_mode(initial_mode);
+
+    // nova janela entre passadas: as passadas restantes da anterior são abandonadas, e a nova é renderizada inteira
+    progressive_start(&catalogue[0].view);
+    bool ok = progressive_step() == PROGRESSIVE_PASS_DONE && progressive_block() == 8;
+    progressive_start(&catalogue[1].view);
+    ok &= progressive_block() == 0;
+    while (progressive_step() != PROGRESSIVE_FINISHED)
+        ;
+    // sem linhas espelhadas, as pré-visualizações avaliam todas as amostras, uma única vez
+    ok &= progressive_stats()->passes == 4 &&
+          progressive_stats()->kernel.evaluated == MANDELBROT_SEED_LEN + mandelbrot_frame_stats()->evaluated;
+    memset(full, 0, sizeof(full));
+    draw_mandelbrot_frame(full, &catalogue[1].view);
+    ok &= memcmp(progressive_image(), full, SSD1306_FRAME_LEN) == 0;
+    printf("nova janela entre passadas: %s\n", ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    return failures;
+}
+
+/*!
+ * @brief Renderiza todos os pixels na posição atual da grade (referência do deslocamento).
+ */
+static void render_grid(uint8_t *buf, const viewport_grid_t *grid)
+{
+    mandelbrot_stats_t ignored = {0};
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+    {
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            float real = grid->real_base + (grid->ox + x) * grid->step_x;
+            float imag = grid->im_base + (grid->oy + y) * grid->step_y;
+            set_pixel(buf, x, y, mandelbrot_point(real, imag, &ignored, NULL) == MAX_ITER);
+        }
+    }
+}
+
+/*!
+ * @brief Mede o deslocamento da janela e verifica que o frame deslocado é idêntico à renderização completa.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_pan()
+{
+    static const int moves[][2] = {{1, 0}, {0, 1}, {-3, 2}, {4, -4}, {-1, -1}, {16, 0}, {0, -20}};
+    static uint8_t frame[SSD1306_BUF_LEN];
+    static uint8_t reference[SSD1306_BUF_LEN];
+    const render_data_t home = VIEWPORT_HOME;
+    viewport_grid_t grid;
+    render_data_t view;
+    int failures = 0;
+
+    viewport_grid_anchor(&grid, &home);
+    memset(frame, 0, sizeof(frame));
+    draw_mandelbrot_block(frame, &home, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+
+    printf("\n%-12s %10s %10s %10s %s\n", "pan (dx,dy)", "avaliados", "esperados", "tempo(us)", "== completo");
+    for (size_t i = 0; i < count_of(moves); i++)
+    {
+        int dx = moves[i][0], dy = moves[i][1];
+        mandelbrot_stats_t stats = {0};
+
+        uint64_t t0 = hal_host_time_ns();
+        pan_frame(frame, &grid, dx, dy, &view, &stats);
+        uint64_t ns = hal_host_time_ns() - t0;
+
+        memset(reference, 0, sizeof(reference));
+        render_grid(reference, &grid);
+
+        uint32_t adx = dx < 0 ? -dx : dx, ady = dy < 0 ? -dy : dy;
+        uint32_t expected = adx * SSD1306_HEIGHT + ady * (SSD1306_WIDTH - adx);
+        bool same = memcmp(frame, reference, SSD1306_FRAME_LEN) == 0;
+        failures += !same || stats.evaluated != expected;
+
+        printf("(%3d,%3d)    %10u %10u %10.1f %s\n", dx, dy, stats.evaluated, expected, ns / 1e3, same ? "sim" : "NAO");
+    }
+
+    printf("janela final: [%g, %g] x [%g, %g], deslocamento (%d, %d) pixels\n", view.real_start, view.real_end,
+           view.im_start, view.im_end, (int)grid.ox, (int)grid.oy);
+
+    return failures;
+}
+
+/*!
+ * @brief Simula 10 ampliações seguidas e o retorno pela pilha de janelas através de `draw_mandelbrot()`.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_frame_cache()
+{
+    enum { DEPTH = 10 };
+    static uint8_t frames[DEPTH + 1][SSD1306_FRAME_LEN];
+    static uint8_t fields[DEPTH + 1][SSD1306_WIDTH * SSD1306_HEIGHT];
+    static uint8_t buf[SSD1306_BUF_LEN];
+    static uint8_t field[SSD1306_WIDTH * SSD1306_HEIGHT];
+    static uint8_t packed[FRAME_RLE_MAX_LEN];
+    render_data_t stack[DEPTH + 1] = {VIEWPORT_HOME};
+    int failures = 0;
+
+    // taxa de compressão dos frames de referência
+    printf("\n%-16s %10s\n", "RLE", "bytes");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        memset(buf, 0, sizeof(buf));
+        draw_mandelbrot_frame(buf, &catalogue[i].view);
+        size_t len = frame_rle_encode(buf, SSD1306_FRAME_LEN, packed, sizeof(packed));
+        size_t out = frame_rle_decode(packed, len, frames[0], SSD1306_FRAME_LEN);
+        bool ok = out == SSD1306_FRAME_LEN && memcmp(frames[0], buf, SSD1306_FRAME_LEN) == 0;
+        printf("%-16s %10zu%s\n", catalogue[i].name, len, ok ? "" : "  (FALHA na descompressao)");
+        failures += !ok;
+    }
+
+    // descendo: cada janela é ampliada no centro com um cursor de 32x16 e renderizada (falha no cache), retendo o
+    // campo de iterações, que o cache guarda comprimido enquanto couber no orçamento
+    frame_cache_clear();
+    frame_cache_stats_t before = *frame_cache_stats();
+    for (int level = 0; level <= DEPTH; level++)
+    {
+        if (level > 0)
+        {
+            stack[level] = stack[level - 1];
+            viewport_zoom_in(&stack[level], 48, 24, 32, 16);
+        }
+        mandelbrot_retain_field(frames[level], fields[level]);
+        draw_mandelbrot(frames[level], stack[level].real_start, stack[level].real_end, stack[level].im_start,
+                        stack[level].im_end);
+    }
+
+    // subindo: cada desfazer deve ser atendido pelo cache, sem nenhuma iteração; os níveis com campo guardado o
+    // restauram igual ao calculado
+    uint64_t worst_ns = 0;
+    int restored = 0, stale = 0;
+    mandelbrot_retain_field(buf, field);
+    for (int level = DEPTH - 1; level >= 0; level--)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        draw_mandelbrot(buf, stack[level].real_start, stack[level].real_end, stack[level].im_start, stack[level].im_end);
+        uint64_t ns = hal_host_time_ns() - t0;
+        worst_ns = ns > worst_ns ? ns : worst_ns;
+        failures += memcmp(buf, frames[level], SSD1306_FRAME_LEN) != 0;
+        if (frame_cache_field(&stack[level], mandelbrot_get_max_iter(), field))
+        {
+            restored++;
+            stale += memcmp(field, fields[level], sizeof(field)) != 0;
+        }
+    }
+    mandelbrot_retain_field(NULL, NULL);
+
+    const frame_cache_stats_t *stats = frame_cache_stats();
+    uint32_t hits = stats->hits - before.hits, misses = stats->misses - before.misses;
+    printf("pilha de %d ampliacoes: %u acertos, %u falhas, %u descartes, %u frames (%u com campo) em %u bytes "
+           "(orcamento %d), pior desfazer %.1f us\n",
+           DEPTH, hits, misses, stats->evictions - before.evictions, stats->entries, stats->fields, stats->bytes,
+           FRAME_CACHE_BUDGET, worst_ns / 1e3);
+    // os campos dividem o orçamento com os frames: ao menos um desfazer o restaura, e nunca diferente do calculado
+    printf("campos de iteracoes: %d restaurados, %d divergentes\n", restored, stale);
+    failures += hits != DEPTH || misses != DEPTH + 1 || restored == 0 || stale != 0;
+    failures += stats->bytes > FRAME_CACHE_BUDGET;
+
+    // orçamento reduzido: os frames menos usados são descartados primeiro
+    uint32_t reduced = stats->bytes / 2;
+    frame_cache_set_budget(reduced);
+    printf("orcamento reduzido a %u bytes: %u frames em %u bytes, %u descartes\n", reduced, stats->entries, stats->bytes,
+           stats->evictions - before.evictions);
+    failures += stats->bytes > reduced;
+    frame_cache_set_budget(FRAME_CACHE_BUDGET);
+
+    return failures;
+}
+
+/*!
+ * @brief Executa a especulação até não haver mais trabalho, retornando o número de unidades renderizadas.
+ */
+static int speculate_drain(uint64_t now_us)
+{
+    int units = 0;
+    while (speculate_poll(now_us))
+        units++;
+    return units;
+}
+
+/*!
+ * @brief Simula o cursor parado, em movimento e a ampliação, com um relógio controlado pelo teste.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_speculate()
+{
+    static uint8_t expected[SSD1306_BUF_LEN];
+    static uint8_t cached[SSD1306_BUF_LEN];
+    static uint8_t shown_field[SSD1306_WIDTH * SSD1306_HEIGHT], expected_field[sizeof(shown_field)];
+    static uint8_t cached_field[sizeof(shown_field)];
+    const render_data_t home = VIEWPORT_HOME;
+    render_data_t first = home, second = home, third = home;
+    viewport_zoom_in(&first, 48, 24, 32, 16);
+    viewport_zoom_in(&second, 20, 10, 16, 16);
+    viewport_zoom_in(&third, 80, 30, 24, 24);
+    int failures = 0;
+    bool ok;
+
+    frame_cache_clear();
+    budget_reset();
+    speculate_stats_t before = *speculate_stats();
+
+    // o frame exibido usa outro limite: a especulação usa o do alvo e restaura o do frame exibido
+    int shown_cap = BUDGET_MIN_ITER;
+    int first_cap = budget_choose_cap((first.real_end - first.real_start) / SSD1306_WIDTH);
+    int third_cap = budget_choose_cap((third.real_end - third.real_start) / SSD1306_WIDTH);
+    mandelbrot_set_max_iter(shown_cap);
+
+    // cursor parado: nada antes do tempo de permanência, depois o alvo inteiro em unidades de trabalho; as iterações
+    // retidas do frame exibido não são alteradas, e o cache guarda as do frame especulado
+    mandelbrot_retain_field(cached, shown_field);
+    speculate_request(&first, 0);
+    ok = speculate_drain(SPECULATE_DWELL_US / 2) == 0;
+    int unit_cols, unit_pages;
+    ok &= speculate_drain(SPECULATE_DWELL_US) == render_frame_units(&unit_cols, &unit_pages);
+    ok &= mandelbrot_get_max_iter() == shown_cap && mandelbrot_field(cached) == shown_field;
+    mandelbrot_set_max_iter(first_cap);
+    memset(expected, 0, sizeof(expected));
+    mandelbrot_retain_field(expected, expected_field);
+    draw_mandelbrot_frame(expected, &first); // as mesmas unidades e linhas espelhadas, com o limite do alvo
+    mandelbrot_retain_field(NULL, NULL);
+    mandelbrot_set_max_iter(shown_cap);
+    bool same_cap = frame_cache_lookup(&first, first_cap, cached) && memcmp(cached, expected, SSD1306_FRAME_LEN) == 0;
+    bool same_field = frame_cache_field(&first, first_cap, cached_field) &&
+                      memcmp(cached_field, expected_field, sizeof(cached_field)) == 0;
+    bool other_cap = frame_cache_lookup(&first, shown_cap, cached); // outro limite: falha
+    ok &= same_cap && same_field && !other_cap;
+    speculate_note_zoom(&first);
+
+    // cursor em movimento: o trabalho é abandonado na unidade seguinte e o novo alvo espera a permanência
+    uint64_t now = 10 * SPECULATE_DWELL_US;
+    speculate_request(&second, now);
+    for (int i = 0; i < 10; i++)
+        speculate_poll(now + SPECULATE_DWELL_US);
+    speculate_request(&third, now + SPECULATE_DWELL_US);
+    ok &= !speculate_poll(now + SPECULATE_DWELL_US) && !frame_cache_contains(&second, shown_cap) &&
+          !frame_cache_contains(&second, first_cap);
+    speculate_drain(now + 2 * SPECULATE_DWELL_US);
+    ok &= frame_cache_contains(&third, third_cap) && mandelbrot_get_max_iter() == shown_cap;
+    speculate_note_zoom(&second); // a ampliação aconteceu em outro ponto: falha da especulação
+
+    const speculate_stats_t *stats = speculate_stats();
+    uint32_t hits = stats->hits - before.hits, misses = stats->misses - before.misses;
+    ok &= hits == 1 && misses == 1 && stats->cancelled - before.cancelled == 1;
+    printf("\nespeculacao: %u iniciadas, %u concluidas, %u canceladas, acertos %u/%u, iteracoes uteis %llu, "
+           "desperdicadas %llu: %s\n",
+           stats->started - before.started, stats->completed - before.completed, stats->cancelled - before.cancelled,
+           hits, hits + misses, (unsigned long long)(stats->useful_iterations - before.useful_iterations),
+           (unsigned long long)(stats->wasted_iterations - before.wasted_iterations), ok ? "ok" : "FALHA");
+    printf("especulacao: limite do alvo %d (exibido %d), frame igual ao renderizado com ele: %s, campo: %s, consulta "
+           "com o limite exibido: %s\n",
+           first_cap, shown_cap, same_cap ? "sim" : "NAO", same_field ? "sim" : "NAO", other_cap ? "ACERTO" : "falha");
+    failures += !ok;
+
+    speculate_cancel();
+    mandelbrot_set_max_iter(MAX_ITER);
+    return failures;
+}
+
+/*!
+ * @brief Iteração direta em precisão quádrupla (__float128, 113 bits), referência da renderização por perturbação.
+ */
+static int mandelbrot_quad(__float128 cr, __float128 ci)
+{
+    __float128 zr = 0, zi = 0;
+    int n = 0;
+
+    while (zr * zr + zi * zi <= 4 && n < MAX_ITER)
+    {
+        __float128 t = zr * zr - zi * zi + cr;
+        zi = 2 * zr * zi + ci;
+        zr = t;
+        n++;
+    }
+    return n;
+}
+
+/*!
+ * @brief Janela profunda com centro (re_hi + re_lo, im_hi + im_lo), largura `width` e pixels duas vezes mais altos
+ *        que largos, como a janela inicial.
+ */
+static deep_view_t deep_window(double re_hi, double re_lo, double im_hi, double im_lo, double width)
+{
+    deep_view_t deep = {
+        center_re : {re_hi, re_lo},
+        center_im : {im_hi, im_lo},
+        step_x : (float)(width / SSD1306_WIDTH),
+        step_y : (float)(2.0 * width / SSD1306_WIDTH),
+        step_exp : 0,
+    };
+    return deep;
+}
+
+/*!
+ * @brief Compara a renderização por perturbação com a iteração direta em precisão quádrupla.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_deep()
+{
+    static uint8_t deep_buf[SSD1306_BUF_LEN];
+    static uint8_t counts[SSD1306_WIDTH * SSD1306_HEIGHT];
+    // ponto de Misiurewicz real c^3 + 2c^2 + 2c + 2 = 0 (órbita pré-periódica para um ponto fixo repulsor
+    // interno ao raio de escape): estrutura em todas as escalas, alcançada em poucas dezenas de iterações
+    __float128 m = -1.5;
+    for (int k = 0; k < 20; k++)
+        m -= (((m + 2) * m + 2) * m + 2) / ((3 * m + 4) * m + 2);
+    double m_hi = (double)m, m_lo = (double)(m - m_hi);
+    const struct
+    {
+        const char *name;
+        double re_hi, re_lo, im_hi, im_lo, width;
+    } windows[] = {
+        {"misiurewicz_1e-9", m_hi, m_lo, 0.0, 0.0, 1e-9},
+        {"misiurewicz_1e-14", m_hi, m_lo, 0.0, 0.0, 1e-14},
+        {"i_1e-20", 0.0, 0.0, 1.0, 0.0, 1e-20},
+        {"i_1e-25", 0.0, 0.0, 1.0, 0.0, 1e-25},
+        {"i_1e-30", 0.0, 0.0, 1.0, 0.0, 1e-30},
+    };
+    int failures = 0;
+
+    printf("\n%-18s %10s %10s %8s %6s %8s %8s %10s %10s %s\n", "profunda", "frame(us)", "float(us)", "conjunto",
+           "refs", "falhas", "n.resolv", "iter.dif", "bits dif.", "ok");
+    for (size_t i = 0; i < count_of(windows); i++)
+    {
+        deep_view_t deep = deep_window(windows[i].re_hi, windows[i].re_lo, windows[i].im_hi, windows[i].im_lo,
+                                       windows[i].width);
+        deep_stats_t stats;
+
+        uint64_t best = UINT64_MAX;
+        for (int run = 0; run < 5; run++)
+        {
+            uint64_t t0 = hal_host_time_ns();
+            draw_mandelbrot_deep(deep_buf, &deep, counts, &stats);
+            uint64_t ns = hal_host_time_ns() - t0;
+            best = ns < best ? ns : best;
+        }
+
+        // custo por pixel do kernel float na mesma quantidade de iterações (a janela float em si é degenerada)
+        render_data_t home = VIEWPORT_HOME;
+        uint64_t float_ns = UINT64_MAX;
+        for (int run = 0; run < 5; run++)
+        {
+            uint64_t t0 = hal_host_time_ns();
+            uint64_t work = 0;
+            for (int y = 0; y < SSD1306_HEIGHT; y++)
+                for (int x = 0; x < SSD1306_WIDTH; x++)
+                    work += mandelbrot(home.real_start + x * 3.0f / SSD1306_WIDTH +
+                                       (home.im_start + y * 3.0f / SSD1306_HEIGHT) * I);
+            uint64_t ns = (hal_host_time_ns() - t0) * stats.iterations / (work ? work : 1);
+            float_ns = ns < float_ns ? ns : float_ns;
+        }
+
+        int count_diff = 0, bit_diff = 0, inside = 0;
+        __float128 cr = (__float128)deep.center_re.hi + deep.center_re.lo;
+        __float128 ci = (__float128)deep.center_im.hi + deep.center_im.lo;
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            for (int x = 0; x < SSD1306_WIDTH; x++)
+            {
+                __float128 pr = cr + (__float128)ldexp(deep.step_x, deep.step_exp) * (x - SSD1306_WIDTH / 2);
+                __float128 pi = ci + (__float128)ldexp(deep.step_y, deep.step_exp) * (y - SSD1306_HEIGHT / 2);
+                int ref = mandelbrot_quad(pr, pi);
+                int got = counts[y * SSD1306_WIDTH + x];
+                inside += got == MAX_ITER;
+                count_diff += ref != got;
+                bit_diff += (ref == MAX_ITER) != (got == MAX_ITER);
+            }
+        }
+
+        // diferenças de contagem só são aceitas em poucos pixels (bordas caóticas, precisão float dos deltas)
+        bool ok = bit_diff <= 2 && count_diff <= SSD1306_WIDTH * SSD1306_HEIGHT / 100;
+        printf("%-18s %10.1f %10.1f %8d %6u %8u %8u %10d %10d %s\n", windows[i].name, best / 1e3, float_ns / 1e3,
+               inside, stats.references, stats.glitched, stats.unresolved, count_diff, bit_diff, ok ? "sim" : "NAO");
+        failures += !ok;
+    }
+
+    // ampliações sucessivas a partir da janela inicial: a janela estendida segue viewport_zoom_in() enquanto o
+    // float tem resolução, e continua além dela
+    render_data_t view = VIEWPORT_HOME;
+    deep_view_t deep;
+    deep_view_from_render_data(&deep, &view);
+    int zooms = 0, shallow_zooms = 0;
+    float max_error = 0.0f;
+    while (zooms < 200)
+    {
+        deep_view_t before = deep;
+        deep_view_zoom_in(&deep, 56, 24, 16, 16);
+        if (memcmp(&before, &deep, sizeof(deep)) == 0)
+            break;
+        zooms++;
+        if (!deep_view_needs_perturbation(&deep))
+        {
+            viewport_zoom_in(&view, 56, 24, 16, 16);
+            render_data_t approx;
+            deep_view_to_render_data(&deep, &approx);
+            float width = view.real_end - view.real_start;
+            float error = fabsf(approx.real_start - view.real_start) / width;
+            max_error = error > max_error ? error : max_error;
+            shallow_zooms++;
+        }
+    }
+    draw_mandelbrot_deep(deep_buf, &deep, NULL, NULL);
+    bool ok = shallow_zooms > 0 && zooms > shallow_zooms && ldexpf(deep.step_x, deep.step_exp) < 1e-30f &&
+              max_error < 1e-3f;
+    printf("ampliacoes: %d (%d no float, erro max %.2g da largura), passo final %.3g: %s\n", zooms, shallow_zooms,
+           max_error, ldexp(deep.step_x, deep.step_exp), ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    return failures;
+}
+
+static uint64_t fake_clock_us;  /*!< Tempo do relógio simulado do orçamento. */
+static uint32_t fake_clock_tick; /*!< Avanço do relógio simulado a cada leitura. */
+
+static uint64_t fake_clock()
+{
+    fake_clock_us += fake_clock_tick;
+    return fake_clock_us;
+}
+
+/*!
+ * @brief Prazo de perturbação sempre esgotado.
+ */
+static bool deep_expired_now()
+{
+    return true;
+}
+
+/*!
+ * @brief Verifica a política de limite de iterações e o orçamento de tempo com um relógio simulado.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_budget()
+{
+    static uint8_t buf[SSD1306_BUF_LEN];
+    static uint8_t expected[SSD1306_BUF_LEN];
+    static uint8_t field[SSD1306_WIDTH * SSD1306_HEIGHT], expected_field[sizeof(field)];
+    const render_data_t home = VIEWPORT_HOME;
+    float home_step = (home.real_end - home.real_start) / SSD1306_WIDTH;
+    int failures = 0;
+
+    budget_reset();
+    budget_set_clock(fake_clock);
+    fake_clock_tick = 0;
+
+    // profundidade: limite base na janela inicial, crescendo por oitava até o teto
+    int shallow = budget_choose_cap(home_step);
+    int ten = budget_choose_cap(home_step / 1024);
+    int deep = budget_choose_cap(home_step * 1e-20f);
+    bool ok = shallow == BUDGET_BASE_ITER && ten == BUDGET_BASE_ITER + 10 * BUDGET_ITER_PER_OCTAVE &&
+              deep == MANDELBROT_ITER_LIMIT;
+    printf("\nlimite por profundidade: %d (inicial), %d (2^-10), %d (1e-20): %s\n", shallow, ten, deep,
+           ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // relógio parado: cada frame alcança o limite escolhido e é idêntico à renderização completa com ele
+    printf("%-16s %8s %8s %8s %10s %s\n", "janela", "escolhido", "alcanc.", "passadas", "frame(us)", "igual");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        budget_reset();
+        const budget_frame_t *frame = budget_render(buf, &catalogue[i].view);
+
+        memset(expected, 0, sizeof(expected));
+        draw_mandelbrot_block(expected, &catalogue[i].view, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+        bool same = frame->cap_reached == frame->cap_chosen && memcmp(buf, expected, SSD1306_FRAME_LEN) == 0;
+        printf("%-16s %8d %8d %8u %10llu %s\n", catalogue[i].name, frame->cap_chosen, frame->cap_reached,
+               frame->passes, (unsigned long long)frame->frame_us, same ? "sim" : "NAO");
+        failures += !same;
+    }
+
+    // histograma: muitos escapes perto do limite na borda profunda elevam o limite do frame seguinte
+    budget_reset();
+    const render_data_t *boundary = &catalogue[2].view;
+    int first = budget_render(buf, boundary)->cap_reached;
+    int next = budget_choose_cap((boundary->real_end - boundary->real_start) / SSD1306_WIDTH);
+    ok = next >= 3 * first / 2;
+    printf("histograma: limite %d -> %d: %s\n", first, next, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // relógio lento: 1 ms por leitura esgota o orçamento no meio do aprofundamento; a passada interrompida é
+    // desfeita, e o frame e o campo são os da renderização completa com o limite alcançado (sem emenda)
+    budget_reset();
+    fake_clock_tick = 1000;
+    mandelbrot_retain_field(buf, field);
+    const budget_frame_t *slow = budget_render(buf, boundary);
+    int after = budget_choose_cap((boundary->real_end - boundary->real_start) / SSD1306_WIDTH);
+    memset(expected, 0, sizeof(expected));
+    mandelbrot_retain_field(expected, expected_field);
+    draw_mandelbrot_block(expected, boundary, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+    mandelbrot_retain_field(NULL, NULL);
+    bool seamless = memcmp(buf, expected, SSD1306_FRAME_LEN) == 0 && memcmp(field, expected_field, sizeof(field)) == 0;
+    ok = slow->over_budget && slow->cap_reached < slow->cap_chosen && slow->cap_reached >= BUDGET_FIRST_ITER &&
+         mandelbrot_get_max_iter() == slow->cap_reached && after < slow->cap_chosen && seamless;
+    printf("orcamento %u us: escolhido %d, alcancado %d em %u passadas, %llu us; proximo limite %d; frame igual ao "
+           "do limite alcancado: %s: %s\n",
+           slow->budget_us, slow->cap_chosen, slow->cap_reached, slow->passes, (unsigned long long)slow->frame_us,
+           after, seamless ? "sim" : "NAO", ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // em passadas (renderização progressiva): o mesmo frame de budget_render(), com o prazo descontando apenas o
+    // tempo gasto nas passadas, e não o das chamadas intercaladas (100 ms simulados entre elas)
+    static uint8_t stepped[SSD1306_BUF_LEN];
+    budget_reset();
+    uint64_t t0 = fake_clock();
+    budget_start(budget_choose_cap((boundary->real_end - boundary->real_start) / SSD1306_WIDTH));
+    draw_mandelbrot_frame(stepped, boundary);
+    bool more = budget_first_done(mandelbrot_frame_stats(), fake_clock() - t0);
+    while (more)
+    {
+        fake_clock_us += 100000;
+        more = budget_deepen(stepped, boundary, NULL);
+    }
+    const budget_frame_t *step = budget_last_frame();
+    ok = step->cap_reached == slow->cap_reached && step->cap_chosen == slow->cap_chosen &&
+         step->passes == slow->passes && mandelbrot_get_max_iter() == step->cap_reached &&
+         memcmp(stepped, expected, SSD1306_FRAME_LEN) == 0;
+    printf("em passadas: alcancado %d/%d em %u passadas, %llu us: %s\n", step->cap_reached, step->cap_chosen,
+           step->passes, (unsigned long long)step->frame_us, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // perturbação: relógio parado alcança o limite escolhido; com orçamento esgotado, a busca de referências da
+    // primeira passada é encerrada e o aprofundamento, desfeito (os pixels acesos ficam dentro no campo)
+    deep_view_t window = deep_window(-1.5436890126920764, 0.0, 0.0, 0.0, 1e-14);
+    deep_stats_t deep_stats;
+    budget_reset();
+    fake_clock_tick = 0;
+    const budget_frame_t *report = budget_render_deep(buf, &window, &deep_stats);
+    ok = report->cap_reached == report->cap_chosen && !report->over_budget && report->passes > 1;
+    printf("perturbacao: alcancado %d/%d em %u passadas, %u referencias: %s\n", report->cap_reached,
+           report->cap_chosen, report->passes, deep_stats.references, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    budget_reset();
+    fake_clock_tick = 1000;
+    budget_set_limit(1);
+    mandelbrot_retain_field(buf, field);
+    report = budget_render_deep(buf, &window, &deep_stats);
+    mandelbrot_retain_field(NULL, NULL);
+    bool inside = true;
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            if (buf[(y / SSD1306_PAGE_HEIGHT) * SSD1306_WIDTH + x] >> (y % SSD1306_PAGE_HEIGHT) & 1)
+                inside &= field[y * SSD1306_WIDTH + x] == MANDELBROT_FIELD_INSIDE;
+    ok = report->over_budget && report->cap_reached == BUDGET_FIRST_ITER && report->passes == 2 &&
+         deep_stats.references <= 2 && mandelbrot_get_max_iter() == report->cap_reached && inside;
+    printf("perturbacao no prazo: alcancado %d/%d em %u passadas, %u referencias, %u nao resolvidos: %s\n",
+           report->cap_reached, report->cap_chosen, report->passes, deep_stats.references, deep_stats.unresolved,
+           ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // prazo esgotado desde o início, com o limite escolhido: a segunda referência é a última
+    deep_stats_t unbounded;
+    mandelbrot_set_max_iter(report->cap_chosen);
+    draw_mandelbrot_deep(buf, &window, NULL, &unbounded);
+    bool complete = draw_mandelbrot_deep_pass(buf, &window, NULL, false, deep_expired_now, &deep_stats);
+    ok = complete && unbounded.references > 2 && deep_stats.references == 2 && deep_stats.unresolved > 0;
+    printf("perturbacao sem prazo: %u referencias; com prazo esgotado: %u referencias, %u nao resolvidos: %s\n",
+           unbounded.references, deep_stats.references, deep_stats.unresolved, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    budget_set_limit(BUDGET_FRAME_US);
+    budget_set_clock(NULL);
+    budget_reset();
+    mandelbrot_set_max_iter(MAX_ITER);
+    return failures;
+}
+
+/*! @brief Eventos produzidos pela thread produtora do teste de concorrência da fila. */
+#define BENCH_QUEUE_EVENTS 200000
+
+/*!
+ * @brief Produtor do teste de concorrência: eventos numerados em `time_us`, repetidos até serem aceitos.
+ */
+static void *queue_producer(void *arg)
+{
+    input_queue_t *queue = arg;
+    for (uint32_t i = 1; i <= BENCH_QUEUE_EVENTS; i++)
+    {
+        input_event_type_t type = (i % 4 == 0) ? INPUT_EVENT_BUTTON : INPUT_EVENT_TICK;
+        while (!input_queue_push(queue, type, (uint8_t)(i & 0xFF), 1, i))
+            sched_yield(); // fila cheia: cede o processador ao consumidor
+    }
+    return NULL;
+}
+
+/*!
+ * @brief Verifica a reserva de posições para os botões e a fila com produtor e consumidor concorrentes.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_input_queue()
+{
+    static input_queue_t queue;
+    input_event_t event;
+    int failures = 0;
+
+    // amostras do joystick ocupam no máximo SIZE - RESERVE posições; os botões usam a fila inteira
+    input_queue_init(&queue);
+    int ticks = 0, buttons = 0;
+    while (input_queue_push(&queue, INPUT_EVENT_TICK, 0, 1, ticks))
+        ticks++;
+    while (input_queue_push(&queue, INPUT_EVENT_BUTTON, 14, buttons & 1, 1000 + buttons))
+        buttons++;
+    bool ok = ticks == INPUT_QUEUE_SIZE - INPUT_QUEUE_BUTTON_RESERVE && buttons == INPUT_QUEUE_BUTTON_RESERVE &&
+              queue.stats.dropped == 2 && queue.stats.max_depth == INPUT_QUEUE_SIZE &&
+              input_queue_contains(&queue, INPUT_EVENT_BUTTON);
+    int popped = 0;
+    while (input_queue_pop(&queue, &event))
+    {
+        ok &= event.time_us == (uint32_t)(popped < ticks ? popped : 1000 + popped - ticks);
+        ok &= popped < ticks || event.level == ((popped - ticks) & 1); // o nível amostrado na borda acompanha o botão
+        popped++;
+    }
+    ok &= popped == ticks + buttons && !input_queue_contains(&queue, INPUT_EVENT_BUTTON);
+    printf("\nfila de entrada: %d amostras + %d botoes aceitos, %u descartados: %s\n", ticks, buttons,
+           queue.stats.dropped, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // produtor em outra thread: todos os eventos chegam, na ordem, sem duplicação
+    input_queue_init(&queue);
+    pthread_t producer;
+    pthread_create(&producer, NULL, queue_producer, &queue);
+    uint32_t expected = 1;
+    bool in_order = true;
+    while (expected <= BENCH_QUEUE_EVENTS)
+    {
+        if (!input_queue_pop(&queue, &event))
+        {
+            sched_yield();
+            continue;
+        }
+        input_event_type_t type = (expected % 4 == 0) ? INPUT_EVENT_BUTTON : INPUT_EVENT_TICK;
+        in_order &= event.time_us == expected && event.type == type && event.gpio == (expected & 0xFF);
+        expected++;
+    }
+    pthread_join(producer, NULL);
+    ok = in_order && !input_queue_pop(&queue, &event);
+    printf("fila concorrente: %u eventos, %u recusados com a fila cheia, ocupacao maxima %u: %s\n",
+           BENCH_QUEUE_EVENTS, queue.stats.dropped, queue.stats.max_depth, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    return failures;
+}
+
+/*! @brief Pontos de medição da medição de custo e cópias não vazias do teste de leitura concorrente do anel. */
+#define BENCH_TRACE_EVENTS 200000
+#define BENCH_TRACE_SNAPSHOTS 2000
+
+static volatile bool trace_reader_done;
+static uint32_t trace_written; /*!< Eventos gravados pela thread escritora. */
+
+/*!
+ * @brief Escritor do teste de leitura concorrente: eventos com início e valor derivados do mesmo contador, até o
+ *        leitor terminar.
+ */
+static void *trace_writer(void *arg)
+{
+    (void)arg;
+    uint32_t i;
+    for (i = 0; !__atomic_load_n(&trace_reader_done, __ATOMIC_ACQUIRE); i++)
+        trace_record(TRACE_BUTTON, 3 * i, i & 0xFF, i);
+    trace_written = i;
+    return NULL;
+}
+
+/*!
+ * @brief Verifica as estatísticas por etapa, o anel com sobrescrita e leitura concorrente, e mede o custo de um
+ *        ponto de medição. Com `dump`, grava o despejo de uma sequência de frames instrumentada (comando `d`).
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_trace(FILE *dump)
+{
+    static trace_event_t events[TRACE_RING_SIZE];
+    uint32_t lost;
+    int failures = 0;
+
+    // durações de 1 a 1000 us: mínimo, média e máximo exatos, percentis com a resolução do histograma
+    trace_reset();
+    for (uint32_t d = 1; d <= 1000; d++)
+        trace_record(TRACE_KERNEL, d * 10, d, d % 7);
+    const trace_stage_stats_t *stats = trace_stats(TRACE_KERNEL);
+    uint32_t p50 = trace_percentile(TRACE_KERNEL, 50), p99 = trace_percentile(TRACE_KERNEL, 99);
+    bool ok = stats->count == 1000 && stats->min_us == 1 && stats->max_us == 1000 && stats->total_us == 500500 &&
+              stats->value_min == 0 && stats->value_max == 6 && p50 >= 500 && p50 <= 500 + 500 / TRACE_HIST_STEPS &&
+              p99 >= 990 && p99 <= 1000;
+    printf("\ntrace: 1000 duracoes de 1 a 1000 us: min %u, media %llu, p50 %u, p99 %u, max %u: %s\n", stats->min_us,
+           (unsigned long long)(stats->total_us / stats->count), p50, p99, stats->max_us, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // anel: os TRACE_RING_SIZE eventos mais recentes, em ordem, e os demais contados como perdidos
+    int count = trace_snapshot(events, TRACE_RING_SIZE, &lost);
+    ok = count == TRACE_RING_SIZE && lost == 1000 - TRACE_RING_SIZE;
+    for (int i = 0; i < count; i++)
+        ok &= events[i].seq == lost + (uint32_t)i && events[i].duration_us == events[i].seq + 1 &&
+              events[i].start_us == 10 * events[i].duration_us && events[i].stage == TRACE_KERNEL;
+    printf("trace: anel de %d eventos apos 1000 gravados: %d copiados, %u perdidos, em ordem: %s\n", TRACE_RING_SIZE,
+           count, lost, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // leitura concorrente com a escrita: nenhum evento copiado pela metade (o papel das interrupções na placa)
+    // (com uma única CPU, a preempção das threads faz o papel das interrupções na placa)
+    trace_reset();
+    trace_reader_done = false;
+    pthread_t writer;
+    pthread_create(&writer, NULL, trace_writer, NULL);
+    uint32_t snapshots = 0, torn = 0, copied = 0;
+    uint64_t deadline = hal_host_time_ns() + 2000000000ull;
+    while (snapshots < BENCH_TRACE_SNAPSHOTS && hal_host_time_ns() < deadline)
+    {
+        count = trace_snapshot(events, TRACE_RING_SIZE, NULL);
+        for (int i = 0; i < count; i++)
+            torn += events[i].start_us != 3 * events[i].value || events[i].duration_us != (events[i].value & 0xFF) ||
+                    events[i].seq != events[i].value || (i > 0 && events[i].seq <= events[i - 1].seq);
+        copied += (uint32_t)count;
+        snapshots += count > 0;
+    }
+    __atomic_store_n(&trace_reader_done, true, __ATOMIC_RELEASE);
+    pthread_join(writer, NULL);
+    ok = torn == 0 && snapshots == BENCH_TRACE_SNAPSHOTS && trace_stats(TRACE_BUTTON)->count == trace_written;
+    printf("trace: %u copias do anel durante %u gravacoes, %u eventos copiados, %u inconsistentes: %s\n", snapshots,
+           trace_written, copied, torn, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // custo de um ponto de medição (TRACE_BEGIN/TRACE_END) e de um evento instantâneo
+    trace_reset();
+    uint64_t t0 = hal_host_time_ns();
+    for (int i = 0; i < BENCH_TRACE_EVENTS; i++)
+    {
+        TRACE_BEGIN(t);
+        TRACE_END(TRACE_COMPOSE, t, i);
+    }
+    uint64_t t1 = hal_host_time_ns();
+    for (int i = 0; i < BENCH_TRACE_EVENTS; i++)
+        TRACE_MARK(TRACE_BUTTON, i);
+    uint64_t t2 = hal_host_time_ns();
+    printf("trace: custo por ponto de medicao %.1f ns, por evento instantaneo %.1f ns\n",
+           (double)(t1 - t0) / BENCH_TRACE_EVENTS, (double)(t2 - t1) / BENCH_TRACE_EVENTS);
+
+    // sequência instrumentada como no laço principal: consulta ao cache, frame, composição e botões
+    static uint8_t image[SSD1306_BUF_LEN], frame[SSD1306_BUF_LEN];
+    trace_reset();
+    frame_cache_clear();
+    for (int round = 0; round < 2; round++)
+    {
+        for (size_t i = 0; i < count_of(catalogue); i++)
+        {
+            const render_data_t *view = &catalogue[i].view;
+            TRACE_BEGIN(lookup);
+            bool hit = frame_cache_lookup(view, mandelbrot_get_max_iter(), image);
+            TRACE_END(TRACE_CACHE, lookup, hit);
+            if (!hit)
+            {
+                TRACE_BEGIN(kernel);
+                draw_mandelbrot_frame(image, view);
+                TRACE_END(TRACE_KERNEL, kernel, mandelbrot_frame_stats()->iterations);
+                TRACE_RECORD(TRACE_FRAME, kernel, trace_now() - kernel, mandelbrot_frame_stats()->iterations);
+                frame_cache_insert(view, mandelbrot_get_max_iter(), image, NULL);
+            }
+            TRACE_BEGIN(compose);
+            memcpy(frame, image, SSD1306_FRAME_LEN);
+            TRACE_END(TRACE_COMPOSE, compose, 0);
+            TRACE_MARK(TRACE_BUTTON, 5);
+        }
+    }
+    trace_print_stats(stdout);
+    ok = trace_stats(TRACE_CACHE)->value_total == count_of(catalogue) &&
+         trace_stats(TRACE_FRAME)->count == count_of(catalogue);
+    printf("trace: %zu consultas ao cache, %llu acertos, %u frames: %s\n", 2 * count_of(catalogue),
+           (unsigned long long)trace_stats(TRACE_CACHE)->value_total, trace_stats(TRACE_FRAME)->count,
+           ok ? "ok" : "FALHA");
+    failures += !ok;
+    if (dump)
+        trace_dump(dump);
+
+    trace_reset();
+    return failures;
+}
+
+/*! @brief Níveis de ampliação e movimentos do cursor por nível da sessão transmitida no teste. */
+#define BENCH_STREAM_LEVELS 8
+#define BENCH_STREAM_MOVES 16
+#define BENCH_STREAM_FRAMES (BENCH_STREAM_LEVELS * (BENCH_STREAM_MOVES + 1))
+
+static uint8_t stream_capture[BENCH_STREAM_FRAMES * FRAME_STREAM_PACKET_MAX]; /*!< Bytes gravados pela saída. */
+static size_t stream_captured;
+static size_t stream_budget; /*!< Bytes aceitos pela saída na próxima chamada (simula a USB). */
+
+/*!
+ * @brief Saída em memória: aceita até `stream_budget` bytes por chamada.
+ */
+static size_t stream_sink_write(const uint8_t *src, size_t len)
+{
+    size_t n = len < stream_budget ? len : stream_budget;
+    memcpy(&stream_capture[stream_captured], src, n);
+    stream_captured += n;
+    stream_budget -= n;
+    return n;
+}
+
+static const frame_stream_sink_t stream_sink = {
+    write : stream_sink_write
+};
+
+/*!
+ * @brief Entrega `len` bytes ao leitor e confere cada frame reconstruído com o frame submetido com o mesmo número.
+ *
+ * @return int O número de frames reconstruídos; `wrong` recebe os diferentes do submetido.
+ */
+static int stream_replay(frame_stream_reader_t *reader, const uint8_t *bytes, size_t len,
+                         const uint8_t (*frames)[SSD1306_FRAME_LEN], int *wrong, int *last_seq)
+{
+    int decoded = 0;
+    frame_stream_reader_init(reader);
+    *wrong = 0;
+    *last_seq = -1;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!frame_stream_reader_push(reader, bytes[i]))
+            continue;
+        decoded++;
+        *wrong += reader->seq >= BENCH_STREAM_FRAMES ||
+                  memcmp(reader->frame, frames[reader->seq], SSD1306_FRAME_LEN) != 0;
+        *last_seq = reader->seq;
+    }
+    return decoded;
+}
+
+/*!
+ * @brief Verifica a transmissão dos frames (frame_stream.h) em uma sessão de ampliações e movimentos do cursor.
+ *
+ * @details
+ *  - Saída sem limite: todos os frames alterados transmitidos e reconstruídos bit a bit; taxa de compressão.
+ *  - Saída lenta (bytes por milissegundo simulado, um frame a cada 16 ms): a fila descarta os frames antigos, os
+ *    reconstruídos continuam idênticos aos submetidos e o último frame chega ao leitor.
+ *  - Texto gravado direto na saída, no meio dos pacotes, e bytes corrompidos: nenhum frame reconstruído errado, e
+ *    o leitor volta a reconstruir no quadro-chave seguinte.
+ *  - Texto entregue ao transmissor (`frame_stream_text()`) com pacotes em andamento, na saída lenta: gravado
+ *    entre os pacotes, sem nenhum pacote rejeitado nem diferença sem base.
+ *  - Com `capture`, grava os bytes da saída sem limite (entrada de host/stream_view.c).
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_stream(FILE *capture)
+{
+    static uint8_t frames[BENCH_STREAM_FRAMES][SSD1306_FRAME_LEN];
+    static uint8_t image[SSD1306_BUF_LEN];
+    static frame_stream_t stream;
+    static frame_stream_reader_t reader;
+    int failures = 0, wrong, last_seq;
+
+    // sessão: a cada nível o cursor percorre 16 pixels até um ponto da borda do conjunto (vale dos cavalos-marinhos)
+    // e a janela é ampliada para a área do cursor
+    render_data_t view = catalogue[0].view;
+    int count = 0;
+    for (int level = 0; level < BENCH_STREAM_LEVELS; level++)
+    {
+        int x = (int)((-0.7453f - view.real_start) / (view.real_end - view.real_start) * SSD1306_WIDTH) - 16;
+        int y = (int)((0.1127f - view.im_start) / (view.im_end - view.im_start) * SSD1306_HEIGHT) - 16;
+        draw_mandelbrot_frame(image, &view);
+        for (int move = 0; move <= BENCH_STREAM_MOVES; move++)
+        {
+            memcpy(frames[count], image, SSD1306_FRAME_LEN);
+            draw_cursor(frames[count++], (uint8_t)y, (uint8_t)(x - BENCH_STREAM_MOVES + move), 32, 32, true);
+        }
+        viewport_zoom_in(&view, (uint8_t)x, (uint8_t)y, 32, 32);
+    }
+
+    // saída sem limite: cada frame é transmitido antes do seguinte
+    frame_stream_init(&stream, &stream_sink);
+    stream_captured = 0;
+    uint64_t t0 = hal_host_time_ns();
+    for (int i = 0; i < count; i++)
+    {
+        frame_stream_submit(&stream, frames[i], (uint32_t)i * 16);
+        stream_budget = SIZE_MAX;
+        frame_stream_poll(&stream);
+    }
+    uint64_t t1 = hal_host_time_ns();
+    const frame_stream_stats_t *stats = &stream.stats;
+    size_t full_len = stream_captured;
+    int decoded = stream_replay(&reader, stream_capture, full_len, frames, &wrong, &last_seq);
+    bool ok = stats->dropped == 0 && stats->packets + stats->unchanged == (uint32_t)count &&
+              decoded == (int)stats->packets && wrong == 0 && last_seq == count - 1 &&
+              stats->wire_bytes == full_len && reader.corrupt == 0 && reader.skipped == 0;
+    printf("\ntransmissao: %d frames, %u pacotes (%u chave), %llu -> %llu bytes (%.1fx), %.1f us/frame, "
+           "%d reconstruidos, %d diferentes: %s\n",
+           count, stats->packets, stats->keyframes, (unsigned long long)stats->raw_bytes,
+           (unsigned long long)stats->wire_bytes, (double)stats->raw_bytes / (double)stats->wire_bytes,
+           (double)(t1 - t0) / 1e3 / count, decoded, wrong, ok ? "ok" : "FALHA");
+    failures += !ok;
+    if (capture)
+        fwrite(stream_capture, 1, full_len, capture);
+
+    // saída lenta: um frame a cada 16 ms e poucos bytes por milissegundo; a fila nunca espera pela saída
+    static const size_t rates[] = {2, 8, 64};
+    for (size_t r = 0; r < count_of(rates); r++)
+    {
+        frame_stream_init(&stream, &stream_sink);
+        stream_captured = 0;
+        uint32_t ms = 0;
+        for (int i = 0; i < count || !frame_stream_idle(&stream); ms++)
+        {
+            if (i < count && ms % 16 == 0)
+            {
+                frame_stream_submit(&stream, frames[i], ms);
+                i++;
+            }
+            stream_budget = rates[r];
+            frame_stream_poll(&stream);
+        }
+        decoded = stream_replay(&reader, stream_capture, stream_captured, frames, &wrong, &last_seq);
+        ok = wrong == 0 && last_seq == count - 1 && decoded == (int)stats->packets &&
+             stats->packets + stats->unchanged + stats->dropped == (uint32_t)count;
+        printf("transmissao: %4zu bytes/ms, %3u descartados, %3u pacotes (%2u chave), %.1fx, %.1f fps: %s\n", rates[r],
+               stats->dropped, stats->packets, stats->keyframes,
+               (double)stats->raw_bytes / (double)stats->wire_bytes,
+               stats->last_ms > stats->first_ms ? (stats->packets - 1) * 1000.0 / (stats->last_ms - stats->first_ms)
+                                                : 0.0,
+               ok ? "ok" : "FALHA");
+        failures += !ok;
+    }
+
+    // texto gravado direto na saída (sem o transmissor), no meio dos pacotes, e bytes corrompidos na primeira
+    // metade da captura da saída sem limite
+    static uint8_t noisy[sizeof(stream_capture) + 64 * 1024];
+    static const char text[] = "limite 64/64, 3 passadas, 812 us\n";
+    size_t noisy_len = 0;
+    unsigned seed = 7;
+    for (size_t i = 0; i < full_len; i++)
+    {
+        if (i < full_len / 2 && i % 997 == 0)
+        {
+            memcpy(&noisy[noisy_len], text, sizeof(text) - 1);
+            noisy_len += sizeof(text) - 1;
+        }
+        seed = seed * 1103515245u + 12345u;
+        bool flip = i < full_len / 2 && (seed >> 16) % 1500 == 0;
+        noisy[noisy_len++] = stream_capture[i] ^ (flip ? 0x10 : 0);
+    }
+    decoded = stream_replay(&reader, noisy, noisy_len, frames, &wrong, &last_seq);
+    ok = wrong == 0 && last_seq == count - 1 && reader.corrupt > 0;
+    printf("transmissao: texto direto e bytes corrompidos: %d reconstruidos, %u rejeitados, %u sem base, %llu bytes "
+           "ignorados, %d diferentes: %s\n",
+           decoded, reader.corrupt, reader.orphans, (unsigned long long)reader.skipped, wrong, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // mensagens do console a cada 40 ms, entregues ao transmissor com um pacote em andamento sempre que houver
+    frame_stream_init(&stream, &stream_sink);
+    stream_captured = 0;
+    uint32_t texts = 0, mid_packet = 0;
+    for (int i = 0, ms = 0; i < count || !frame_stream_idle(&stream); ms++)
+    {
+        if (i < count && ms % 16 == 0)
+            frame_stream_submit(&stream, frames[i++], ms);
+        if (i < count && ms % 40 == 0)
+        {
+            mid_packet += stream.packet_sent < stream.packet_len;
+            frame_stream_text(&stream, text, sizeof(text) - 1);
+            texts++;
+        }
+        stream_budget = 8;
+        frame_stream_poll(&stream);
+    }
+    decoded = stream_replay(&reader, stream_capture, stream_captured, frames, &wrong, &last_seq);
+    ok = wrong == 0 && last_seq == count - 1 && decoded == (int)stats->packets && mid_packet > 0 &&
+         reader.corrupt == 0 && reader.orphans == 0 && stats->text_dropped == 0 &&
+         stats->text_bytes == texts * (sizeof(text) - 1) && reader.skipped == stats->text_bytes;
+    printf("transmissao: %u mensagens (%u com pacote em andamento), %d reconstruidos, %u rejeitados, %u sem base, "
+           "%llu bytes ignorados: %s\n",
+           texts, mid_packet, decoded, reader.corrupt, reader.orphans, (unsigned long long)reader.skipped,
+           ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    return failures;
+}
+
+/*! @brief Ações aleatórias (ampliar, deslocar, desfazer) do teste do histórico. */
+#define BENCH_HISTORY_ACTIONS 4000
+
+/*!
+ * @brief Verifica o histórico de ampliações contra uma pilha de janelas completas (como o vetor anterior).
+ *
+ * @details
+ *  - Sequência aleatória de ampliações, deslocamentos e desfazer: cada desfazer deve restaurar, bit a bit,
+ *    a janela exibida antes da ampliação correspondente.
+ *  - Cadeia de ampliações 4x até o limite de precisão da janela estendida e volta à janela inicial.
+ *  - Histórico cheio: a ampliação é recusada sem alterar a janela.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_zoom_history()
+{
+    static zoom_history_t history;
+    static zoom_state_t reference[ZOOM_HISTORY_OPS];
+    render_data_t home_view = VIEWPORT_HOME;
+    zoom_state_t home = {view : home_view};
+#if MANDELBROT_DEEP_ZOOM
+    deep_view_from_render_data(&home.deep, &home.view);
+#endif
+    int failures = 0;
+
+    zoom_history_init(&history, &home);
+    zoom_state_t state = home;
+    int depth = 0, undos = 0, mismatches = 0, max_depth = 0;
+    uint32_t rng = 12345;
+    for (int i = 0; i < BENCH_HISTORY_ACTIONS; i++)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        int action = (rng >> 24) % 8;
+        if (action < 3 && depth < 40)
+        {
+            uint8_t size = 2 + (rng >> 8) % 61;
+            uint8_t left = (rng >> 4) % (128 - size), top = (rng >> 12) % (64 - size);
+            zoom_state_t before = state;
+            if (zoom_history_zoom(&history, &state, left, top, size))
+                reference[depth++] = before;
+        }
+        else if (action < 6)
+        {
+            viewport_grid_t *grid = zoom_history_pan_begin(&history, &state);
+            if (grid)
+            {
+                render_data_t view;
+                grid->ox += (int)((rng >> 8) % 17) - 8; // como em pan_frame()
+                grid->oy += (int)((rng >> 16) % 9) - 4;
+                viewport_grid_window(grid, &view);
+                zoom_history_pan_end(&history, &state);
+                mismatches += memcmp(&view, &state.view, sizeof(view)) != 0;
+            }
+        }
+        else if (zoom_history_undo(&history, &state) != (depth > 0))
+        {
+            mismatches++;
+        }
+        else if (depth > 0)
+        {
+            mismatches += memcmp(&state, &reference[--depth], sizeof(state)) != 0;
+            undos++;
+        }
+        max_depth = MAX(max_depth, depth);
+    }
+    bool ok = mismatches == 0 && zoom_history_depth(&history) == depth;
+    printf("\nhistorico de ampliacoes: %zu bytes fixos (%zu por operacao), %d desfazer, profundidade maxima %d: %s\n",
+           sizeof(history), sizeof(zoom_op_t), undos, max_depth, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // cadeia de ampliações 4x no centro: a profundidade útil é limitada pela precisão, não pelo histórico
+    zoom_history_init(&history, &home);
+    state = home;
+    int levels = 0, effective = 0;
+    while (true)
+    {
+        zoom_state_t before = state;
+        if (!zoom_history_zoom(&history, &state, 48, 16, 32))
+            break;
+        reference[levels++] = before;
+        if (memcmp(&state, &before, sizeof(state)) == 0)
+            break; // janela inalterada: limite de precisão
+        effective++;
+    }
+    mismatches = 0;
+    while (levels > 0 && zoom_history_undo(&history, &state))
+        mismatches += memcmp(&state, &reference[--levels], sizeof(state)) != 0;
+    ok = mismatches == 0 && levels == 0 && memcmp(&state, &home, sizeof(state)) == 0 && effective > 10;
+    printf("cadeia de ampliacoes 4x: %d niveis ate o limite de precisao, retorno exato a janela inicial: %s\n", effective,
+           ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // histórico cheio
+    zoom_history_init(&history, &home);
+    state = home;
+    int pushed = 0;
+    while (zoom_history_zoom(&history, &state, 0, 0, 62))
+        pushed++;
+    zoom_state_t full = state;
+    ok = pushed == ZOOM_HISTORY_OPS && !zoom_history_zoom(&history, &state, 0, 0, 62) &&
+         memcmp(&state, &full, sizeof(state)) == 0 && zoom_history_pan_begin(&history, &state) == NULL;
+    printf("historico cheio apos %d operacoes, ampliacao recusada: %s\n", pushed, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    return failures;
+}
+
+/*! @brief Gravações da carga de trabalho dos testes de desgaste e de queda de energia. */
+#define BENCH_STORE_SAVES 240
+
+/*! @brief Quedas de energia simuladas, distribuídas pelos bytes gravados pela carga de trabalho. */
+#define BENCH_STORE_CUTS 300
+
+/*!
+ * @brief Sessão de número `version`: ampliações e deslocamentos determinísticos, em quantidade variável.
+ */
+static void store_session(int version, zoom_history_t *history, zoom_state_t *state, const zoom_state_t *home)
+{
+    zoom_history_init(history, home);
+    *state = *home;
+    for (int i = 0; i < 1 + (version * 7) % 60; i++)
+    {
+        if ((version + i) % 5 == 0)
+        {
+            viewport_grid_t *grid = zoom_history_pan_begin(history, state);
+            grid->ox += (version + i) % 9 - 4;
+            zoom_history_pan_end(history, state);
+        }
+        else
+        {
+            zoom_history_zoom(history, state, (uint8_t)((version * 13 + i * 5) % 64), (uint8_t)((version + i * 3) % 32),
+                              (uint8_t)(24 + (version + i) % 32));
+        }
+    }
+}
+
+/*!
+ * @brief Frame e janela de número `version`: padrão com trechos repetidos e literais (compressão variável).
+ */
+static void store_frame(int version, render_data_t *view, uint8_t *frame)
+{
+    *view = (render_data_t){(float)version, (float)version + 1.0f, -1.0f, 1.0f};
+    uint32_t rng = 0x9e3779b9u * (uint32_t)(version + 1);
+    for (int i = 0; i < SSD1306_FRAME_LEN; i++)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        frame[i] = (i / 64 + version) % 3 == 0 ? (uint8_t)(rng >> 24) : (uint8_t)(version * (i / 128));
+    }
+}
+
+/*!
+ * @brief Carga de trabalho: a cada passo, grava a sessão e, a cada 3 passos, um frame de uma de 6 janelas.
+ *
+ * @return int Passo interrompido por uma falha de gravação (`BENCH_STORE_SAVES` se nenhum); `*session_ok`
+ *         recebe o último passo cuja sessão foi gravada.
+ */
+static int store_workload(flash_store_t *store, const zoom_state_t *home, int *session_ok)
+{
+    static zoom_history_t history;
+    static uint8_t frame[SSD1306_FRAME_LEN];
+    zoom_state_t state;
+    render_data_t view;
+    for (int step = 0; step < BENCH_STORE_SAVES; step++)
+    {
+        store_session(step, &history, &state, home);
+        if (!flash_store_save_session(store, &history))
+            return step;
+        *session_ok = step;
+        store_frame(step % 6, &view, frame);
+        if (step % 3 == 0 && !flash_store_save_frame(store, &view, BUDGET_MIN_ITER + step % 6, frame))
+            return step;
+    }
+    return BENCH_STORE_SAVES;
+}
+
+/*!
+ * @brief Verifica a sessão e os frames gravados: a sessão deve ser a do passo `expected` ou, se este foi
+ *        interrompido durante a gravação da própria sessão, `alternative`; os frames devem corresponder às janelas.
+ */
+static bool store_check(flash_store_t *store, const zoom_state_t *home, int expected, int alternative)
+{
+    static zoom_history_t loaded, reference;
+    static uint8_t frame[SSD1306_FRAME_LEN], original[SSD1306_FRAME_LEN];
+    zoom_state_t state = *home, reference_state;
+
+    zoom_history_init(&loaded, home);
+    if (!flash_store_load_session(store, &loaded, &state))
+        return expected < 0;
+    bool session = false;
+    int candidates[2] = {expected, alternative};
+    for (int i = 0; i < 2 && !session; i++)
+    {
+        if (candidates[i] < 0)
+            continue;
+        store_session(candidates[i], &reference, &reference_state, home);
+        session = loaded.count == reference.count &&
+                  memcmp(loaded.ops, reference.ops, loaded.count * sizeof(zoom_op_t)) == 0 &&
+                  memcmp(&state, &reference_state, sizeof(state)) == 0;
+    }
+
+    bool frames = true;
+    render_data_t view, original_view;
+    int cap;
+    for (int i = 0; i < FLASH_STORE_FRAMES && flash_store_load_frame(store, i, &view, &cap, frame); i++)
+    {
+        store_frame((int)view.real_start, &original_view, original);
+        frames &= memcmp(&view, &original_view, sizeof(view)) == 0 && memcmp(frame, original, sizeof(frame)) == 0 &&
+                  cap == BUDGET_MIN_ITER + (int)view.real_start;
+    }
+    return session && frames;
+}
+
+/*!
+ * @brief Verifica o armazenamento persistente sobre a flash emulada em arquivo (host/flash_file.c).
+ *
+ * @details
+ *  - Sessão e frames sobrevivem a um reinício, com a janela da sessão reconstruída bit a bit.
+ *  - Desgaste: os apagamentos se distribuem igualmente entre os setores.
+ *  - Quedas de energia em pontos distribuídos pela carga de trabalho (inclusive durante apagamentos e cópias):
+ *    após religar, a sessão é a última gravada por completo (ou a interrompida, se completou), os frames
+ *    são íntegros, e as gravações seguintes continuam funcionando.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_flash_store()
+{
+    static flash_store_t store;
+    render_data_t home_view = VIEWPORT_HOME;
+    zoom_state_t home = {view : home_view};
+#if MANDELBROT_DEEP_ZOOM
+    deep_view_from_render_data(&home.deep, &home.view);
+#endif
+    int failures = 0;
+
+    if (!flash_file_open(NULL))
+    {
+        printf("\nflash: falha ao criar o arquivo\n");
+        return 1;
+    }
+    flash_store_open(&store, &flash_file_backend);
+    int session_ok = -1;
+    int steps = store_workload(&store, &home, &session_ok);
+    flash_store_open(&store, &flash_file_backend); // reinício
+    const flash_file_stats_t *stats = flash_file_stats();
+    uint32_t min_erases = UINT32_MAX, max_erases = 0;
+    for (int i = 0; i < FLASH_STORE_SECTORS; i++)
+    {
+        min_erases = MIN(min_erases, stats->erases[i]);
+        max_erases = MAX(max_erases, stats->erases[i]);
+    }
+    bool ok = steps == BENCH_STORE_SAVES && store_check(&store, &home, session_ok, -1) && stats->violations == 0 &&
+              max_erases - min_erases <= 1;
+    uint64_t workload_bytes = stats->bytes;
+    printf("\nflash: %d gravacoes, %llu bytes, apagamentos por setor %u a %u, reinicio exato: %s\n", steps,
+           (unsigned long long)workload_bytes, min_erases, max_erases, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    // quedas de energia
+    int recovered = 0, torn = 0, resumed = 0;
+    uint32_t lost = 0;
+    for (int cut = 0; cut < BENCH_STORE_CUTS; cut++)
+    {
+        flash_file_open(NULL);
+        flash_file_cut_after((int64_t)(workload_bytes * (cut + 1) / (BENCH_STORE_CUTS + 1)) + cut % 7);
+        flash_store_open(&store, &flash_file_backend);
+        session_ok = -1;
+        int step = store_workload(&store, &home, &session_ok);
+
+        flash_file_power_on();
+        flash_store_open(&store, &flash_file_backend);
+        torn += store.stats.torn > 0;
+        recovered += store_check(&store, &home, session_ok, step);
+
+        // as gravações continuam após a recuperação
+        session_ok = -1;
+        if (store_workload(&store, &home, &session_ok) == BENCH_STORE_SAVES)
+        {
+            flash_store_open(&store, &flash_file_backend);
+            resumed += store_check(&store, &home, session_ok, -1);
+        }
+        lost += store.stats.lost;
+    }
+    ok = recovered == BENCH_STORE_CUTS && resumed == BENCH_STORE_CUTS && flash_file_stats()->violations == 0;
+    printf("flash: %d quedas de energia, %d com registro incompleto, %d recuperadas, %d retomadas, %u perdidos: %s\n",
+           BENCH_STORE_CUTS, torn, recovered, resumed, lost, ok ? "ok" : "FALHA");
+    failures += !ok;
+
+    flash_file_close();
+    return failures;
+}
+
+/*! @brief Resolução da renderização em tiles usada para verificar a cobertura e o determinismo. */
+#define BENCH_TILES_WIDTH 1024
+#define BENCH_TILES_HEIGHT 512
+
+/*!
+ * @brief Renderizador em tiles do host: bit a bit igual ao frame da placa em 128 x 64, e cada pixel da imagem grande
+ *        calculado exatamente uma vez, com o mesmo resultado para qualquer número de threads.
+ */
+static int bench_render_tiles()
+{
+    static uint8_t counts[SSD1306_WIDTH * SSD1306_HEIGHT];
+    static uint8_t buf[SSD1306_BUF_LEN];
+    static uint8_t big[BENCH_TILES_WIDTH * BENCH_TILES_HEIGHT], single[BENCH_TILES_WIDTH * BENCH_TILES_HEIGHT];
+    uint8_t tiles_rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    uint8_t device_rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    const int threads[] = {1, 3, 8};
+    render_tiles_stats_t stats;
+    int failures = 0, mismatches = 0;
+
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        draw_mandelbrot_block(buf, &catalogue[i].view, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+        pbm_from_framebuffer(buf, device_rows);
+        for (size_t t = 0; t < count_of(threads); t++)
+        {
+            render_tiles(&catalogue[i].view, SSD1306_WIDTH, SSD1306_HEIGHT, threads[t], counts, &stats);
+            render_tiles_to_pbm(counts, SSD1306_WIDTH, SSD1306_HEIGHT, tiles_rows);
+            mismatches += memcmp(tiles_rows, device_rows, sizeof(tiles_rows)) != 0;
+        }
+    }
+    printf("\ntiles: %zu janelas x %zu contagens de threads, diferentes do frame da placa: %d\n", count_of(catalogue),
+           count_of(threads), mismatches);
+    failures += mismatches != 0;
+
+    // cobertura: nenhuma contagem válida chega a 255 (limite de iterações <= MANDELBROT_ITER_LIMIT)
+    render_tiles(&catalogue[0].view, BENCH_TILES_WIDTH, BENCH_TILES_HEIGHT, 1, single, &stats);
+    double base = stats.seconds;
+    int wrong = 0;
+    uint32_t tiles = 0;
+    for (size_t t = 1; t < count_of(threads); t++)
+    {
+        memset(big, 0xff, sizeof(big));
+        render_tiles(&catalogue[0].view, BENCH_TILES_WIDTH, BENCH_TILES_HEIGHT, threads[t], big, &stats);
+        tiles = 0;
+        for (int k = 0; k < threads[t]; k++)
+            tiles += stats.done[k];
+        wrong += memcmp(big, single, sizeof(big)) != 0 || tiles != stats.tiles;
+        printf("tiles: %dx%d com %d threads: %u tiles, %u roubos, %.1f ms (1 thread: %.1f ms)\n", BENCH_TILES_WIDTH,
+               BENCH_TILES_HEIGHT, threads[t], tiles, stats.steals, stats.seconds * 1e3, base * 1e3);
+    }
+    printf("tiles: imagem identica para qualquer numero de threads: %s\n", wrong ? "FALHA" : "ok");
+    failures += wrong != 0;
+    return failures;
+}
+
+/*! @brief Resolução das janelas do catálogo no microbenchmark do kernel vetorizado. */
+#define BENCH_SIMD_WIDTH 512
+#define BENCH_SIMD_HEIGHT 256
+
+/*!
+ * @brief Calcula as janelas do catálogo com um nível do kernel vetorizado.
+ *
+ * @return uint64_t O menor tempo de três execuções (ns).
+ */
+static uint64_t simd_render(kernel_simd_level_t level, uint8_t *counts)
+{
+    uint64_t best = UINT64_MAX;
+    int cap = mandelbrot_get_max_iter();
+    for (int run = 0; run < 3; run++)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        for (size_t i = 0; i < count_of(catalogue); i++)
+        {
+            const render_data_t *view = &catalogue[i].view;
+            float stepX = (view->real_end - view->real_start) / BENCH_SIMD_WIDTH;
+            float stepY = (view->im_end - view->im_start) / BENCH_SIMD_HEIGHT;
+            for (int y = 0; y < BENCH_SIMD_HEIGHT; y++)
+                kernel_simd_row(level, view->real_start, stepX, 0, BENCH_SIMD_WIDTH, view->im_start + y * stepY, cap,
+                                &counts[(i * BENCH_SIMD_HEIGHT + y) * BENCH_SIMD_WIDTH]);
+        }
+        best = MIN(best, hal_host_time_ns() - t0);
+    }
+    return best;
+}
+
+/*!
+ * @brief Kernel vetorizado: pontos/s de cada nível suportado, igualdade bit a bit com o nível escalar e diferença
+ *        em relação a `mandelbrot_ex()` dentro de `KERNEL_SIMD_TOLERANCE_PPM`.
+ */
+static int bench_simd()
+{
+    static uint8_t reference[count_of(catalogue) * BENCH_SIMD_WIDTH * BENCH_SIMD_HEIGHT];
+    static uint8_t counts[count_of(catalogue) * BENCH_SIMD_WIDTH * BENCH_SIMD_HEIGHT];
+    const double points = (double)sizeof(counts);
+    int failures = 0;
+
+    uint64_t scalar_ns = simd_render(KERNEL_SIMD_SCALAR, reference);
+    uint32_t off = 0;
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const render_data_t *view = &catalogue[i].view;
+        float stepX = (view->real_end - view->real_start) / BENCH_SIMD_WIDTH;
+        float stepY = (view->im_end - view->im_start) / BENCH_SIMD_HEIGHT;
+        for (int y = 0; y < BENCH_SIMD_HEIGHT; y++)
+            for (int x = 0; x < BENCH_SIMD_WIDTH; x++)
+            {
+                mandelbrot_result_t result;
+                float real = view->real_start + x * stepX;
+                float imag = view->im_start + y * stepY;
+                off += mandelbrot_ex(real + imag * I, &result) !=
+                       reference[(i * BENCH_SIMD_HEIGHT + y) * BENCH_SIMD_WIDTH + x];
+            }
+    }
+    double ppm = off * 1e6 / points;
+    printf("\nkernel vetorizado: %dx%d por janela, limite %d, %u pontos diferentes de mandelbrot_ex() (%.1f ppm, "
+           "tolerancia %d)\n",
+           BENCH_SIMD_WIDTH, BENCH_SIMD_HEIGHT, mandelbrot_get_max_iter(), off, ppm, KERNEL_SIMD_TOLERANCE_PPM);
+    failures += ppm > KERNEL_SIMD_TOLERANCE_PPM;
+
+    printf("%-8s %12s %10s %18s\n", "nivel", "Mpontos/s", "aceleracao", "diferentes/escalar");
+    for (int level = KERNEL_SIMD_SCALAR; level < KERNEL_SIMD_COUNT; level++)
+    {
+        if (!kernel_simd_supported(level))
+        {
+            printf("%-8s %12s\n", kernel_simd_name(level), "-");
+            continue;
+        }
+        uint64_t ns = level == KERNEL_SIMD_SCALAR ? scalar_ns : simd_render(level, counts);
+        int diff = 0;
+        if (level != KERNEL_SIMD_SCALAR)
+            for (size_t i = 0; i < sizeof(counts); i++)
+                diff += counts[i] != reference[i];
+        printf("%-8s %12.1f %10.2f %18d%s\n", kernel_simd_name(level), points * 1e3 / ns, (double)scalar_ns / ns, diff,
+               level == (int)kernel_simd_detect() ? "  (auto)" : "");
+        failures += diff != 0;
+    }
+    return failures;
+}
+
+/*!
+ * @brief Laço de Mandelbrot em ponto fixo escrito à mão (mesmo de `render_full_iteration()`), com limite `cap`.
+ */
+static int escape_reference_fixed(float real, float imag, int cap)
+{
+    int32_t cr = MANDELBROT_TO_FIXED(real), ci = MANDELBROT_TO_FIXED(imag);
+    int32_t zx = 0, zy = 0;
+    const int64_t round_to_zero = ((int64_t)1 << (MANDELBROT_FRAC_BITS - 1)) - 1;
+    int n = 0;
+    while (n < cap)
+    {
+        int64_t x2 = (int64_t)zx * zx, y2 = (int64_t)zy * zy, xy = (int64_t)zx * zy;
+        if (x2 + y2 > ((int64_t)4 << (2 * MANDELBROT_FRAC_BITS)))
+            break;
+        zx = (int32_t)((x2 - y2) >> MANDELBROT_FRAC_BITS) + cr;
+        zy = (int32_t)((xy + ((xy >> 63) & round_to_zero)) >> (MANDELBROT_FRAC_BITS - 1)) + ci;
+        n++;
+    }
+    return n;
+}
+
+/*!
+ * @brief Laço de Mandelbrot em float escrito à mão, com o teste |z|^2 > 4.
+ */
+static int escape_reference_float(float real, float imag, int cap)
+{
+    float x = 0, y = 0;
+    int n = 0;
+    while (n < cap)
+    {
+        float x2 = x * x, y2 = y * y;
+        if (x2 + y2 > 4.0f)
+            break;
+        float xy = x * y;
+        x = x2 - y2 + real;
+        y = xy + xy + imag;
+        n++;
+    }
+    return n;
+}
+
+/*!
+ * @brief Percorre as janelas do catálogo na resolução do microbenchmark vetorizado e compara um kernel do motor
+ *        genérico com um laço de referência.
+ *
+ * @return uint32_t Pontos com contagens diferentes; `ns` recebe os tempos do kernel e da referência.
+ */
+static uint32_t escape_compare(escape_kernel_t kernel, int (*reference)(float, float, int), uint64_t ns[2])
+{
+    const int cap = mandelbrot_get_max_iter();
+    uint32_t diff = 0;
+    volatile int sink = 0;
+    ns[0] = ns[1] = UINT64_MAX;
+    for (int run = 0; run < 3; run++)
+    {
+        int sum[2] = {0, 0};
+        for (int k = 0; k < 2; k++)
+        {
+            uint64_t t0 = hal_host_time_ns();
+            for (size_t i = 0; i < count_of(catalogue); i++)
+            {
+                const render_data_t *view = &catalogue[i].view;
+                float stepX = (view->real_end - view->real_start) / BENCH_SIMD_WIDTH;
+                float stepY = (view->im_end - view->im_start) / BENCH_SIMD_HEIGHT;
+                for (int y = 0; y < BENCH_SIMD_HEIGHT; y++)
+                    for (int x = 0; x < BENCH_SIMD_WIDTH; x++)
+                    {
+                        float real = view->real_start + x * stepX, imag = view->im_start + y * stepY;
+                        sum[k] += k == 0 ? kernel(real, imag, 0, 0, cap) : reference(real, imag, cap);
+                    }
+            }
+            ns[k] = MIN(ns[k], hal_host_time_ns() - t0);
+        }
+        sink += sum[0] - sum[1];
+    }
+
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const render_data_t *view = &catalogue[i].view;
+        float stepX = (view->real_end - view->real_start) / BENCH_SIMD_WIDTH;
+        float stepY = (view->im_end - view->im_start) / BENCH_SIMD_HEIGHT;
+        for (int y = 0; y < BENCH_SIMD_HEIGHT; y++)
+            for (int x = 0; x < BENCH_SIMD_WIDTH; x++)
+            {
+                float real = view->real_start + x * stepX, imag = view->im_start + y * stepY;
+                diff += kernel(real, imag, 0, 0, cap) != reference(real, imag, cap);
+            }
+    }
+    return diff;
+}
+
+/*!
+ * @brief Motor genérico de tempo de escape (escape.hpp):
+ *  - Mandelbrot do motor idêntico, ponto a ponto, aos laços escritos à mão em float e em Q3.28, com os tempos;
+ *  - identidades entre fórmulas: Julia com z0 = 0 e k = c é Mandelbrot em c; Burning Ship coincide com Mandelbrot
+ *    no eixo real; Multibrot é simétrico em relação ao eixo real;
+ *  - frames de cada fórmula (`mandelbrot_set_formula()`) idênticos à avaliação do kernel pixel a pixel, o que
+ *    confere o espelhamento de linhas e a subdivisão apenas onde são válidos.
+ */
+static int bench_escape()
+{
+    static const struct {
+        const char *name;
+        escape_kernel_t (*get)(escape_formula_t);
+        int (*reference)(float, float, int);
+    } types[] = {
+        {"float", escape_kernel_float, escape_reference_float},
+        {"q3.28", escape_kernel_fixed, escape_reference_fixed},
+    };
+    const double points = (double)count_of(catalogue) * BENCH_SIMD_WIDTH * BENCH_SIMD_HEIGHT;
+    const int cap = mandelbrot_get_max_iter();
+    int failures = 0;
+
+    printf("\nmotor de escape: Mandelbrot, %dx%d por janela, limite %d\n", BENCH_SIMD_WIDTH, BENCH_SIMD_HEIGHT, cap);
+    printf("%-8s %16s %16s %12s\n", "tipo", "motor Mpontos/s", "a mao Mpontos/s", "diferentes");
+    for (size_t t = 0; t < count_of(types); t++)
+    {
+        uint64_t ns[2];
+        uint32_t diff = escape_compare(types[t].get(ESCAPE_MANDELBROT), types[t].reference, ns);
+        printf("%-8s %16.1f %16.1f %12u\n", types[t].name, points * 1e3 / ns[0], points * 1e3 / ns[1], diff);
+        failures += diff != 0;
+    }
+
+    // identidades entre as fórmulas, nos pontos do catálogo e em 1024 pontos do eixo real
+    uint32_t julia = 0, ship = 0, conj = 0;
+    for (size_t t = 0; t < count_of(types); t++)
+    {
+        escape_kernel_t mandel = types[t].get(ESCAPE_MANDELBROT), julia_k = types[t].get(ESCAPE_JULIA);
+        escape_kernel_t ship_k = types[t].get(ESCAPE_BURNING_SHIP), multi = types[t].get(ESCAPE_MULTIBROT3);
+        for (size_t i = 0; i < count_of(catalogue); i++)
+        {
+            const render_data_t *view = &catalogue[i].view;
+            float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+            float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+            for (int y = 0; y < SSD1306_HEIGHT; y++)
+                for (int x = 0; x < SSD1306_WIDTH; x++)
+                {
+                    float real = view->real_start + x * stepX, imag = view->im_start + y * stepY;
+                    julia += julia_k(0, 0, real, imag, cap) != mandel(real, imag, 0, 0, cap);
+                    conj += multi(real, imag, 0, 0, cap) != multi(real, -imag, 0, 0, cap);
+                }
+        }
+        for (int x = 0; x < 1024; x++)
+        {
+            float real = -2.0f + x * (3.0f / 1024);
+            ship += ship_k(real, 0, 0, 0, cap) != mandel(real, 0, 0, 0, cap);
+        }
+    }
+    printf("julia(z0 = 0, k = c) != mandelbrot(c): %u; burning ship != mandelbrot no eixo real: %u; "
+           "multibrot3(c) != multibrot3(conj(c)): %u\n",
+           julia, ship, conj);
+    failures += julia != 0 || ship != 0 || conj != 0;
+
+    // frames de cada fórmula, no modo completo e no modo inicial, contra o kernel avaliado pixel a pixel
+    static const struct {
+        escape_formula_t formula;
+        float k_real, k_imag;
+    } formulas[] = {
+        {ESCAPE_MANDELBROT, 0, 0},
+        {ESCAPE_JULIA, -0.8f, 0.156f},
+        {ESCAPE_JULIA, -1.0f, 0},
+        {ESCAPE_BURNING_SHIP, 0, 0},
+        {ESCAPE_MULTIBROT3, 0, 0},
+    };
+    static uint8_t buf[SSD1306_BUF_LEN], reference[SSD1306_BUF_LEN];
+    mandelbrot_render_mode_t initial_mode = mandelbrot_get_render_mode();
+    escape_kernel_t (*build)(escape_formula_t) = MANDELBROT_FIXED_POINT ? escape_kernel_fixed : escape_kernel_float;
+    printf("%-14s %9s %9s %10s %14s\n", "formula", "k_real", "k_imag", "espelhadas", "frames iguais");
+    for (size_t f = 0; f < count_of(formulas); f++)
+    {
+        escape_kernel_t kernel = build(formulas[f].formula);
+        mandelbrot_set_formula(formulas[f].formula, formulas[f].k_real, formulas[f].k_imag);
+        int same = 0, total = 0;
+        uint32_t mirrored = 0;
+        for (size_t i = 0; i < count_of(catalogue); i++)
+        {
+            const render_data_t *view = &catalogue[i].view;
+            float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+            float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+            memset(reference, 0, sizeof(reference));
+            for (int y = 0; y < SSD1306_HEIGHT; y++)
+                for (int x = 0; x < SSD1306_WIDTH; x++)
+                {
+                    float real = view->real_start + x * stepX, imag = view->im_start + y * stepY;
+                    set_pixel(reference, x, y,
+                              kernel(real, imag, formulas[f].k_real, formulas[f].k_imag, cap) == cap);
+                }
+
+            // o modo inicial só é exato para as fórmulas que não são subdivididas
+            bool subdivided = initial_mode != MANDELBROT_RENDER_FULL && escape_formula_connected(formulas[f].formula);
+            for (int m = 0; m < (subdivided ? 1 : 2); m++)
+            {
+                mandelbrot_set_render_mode(m == 0 ? MANDELBROT_RENDER_FULL : initial_mode);
+                memset(buf, 0, sizeof(buf));
+                draw_mandelbrot_frame(buf, view);
+                mirrored += mandelbrot_frame_stats()->mirrored;
+                same += memcmp(buf, reference, SSD1306_FRAME_LEN) == 0;
+                total++;
+            }
+        }
+        printf("%-14s %9.3f %9.3f %10u %8d de %d\n", escape_formula_name(formulas[f].formula), formulas[f].k_real,
+               formulas[f].k_imag, mirrored, same, total);
+        failures += same != total;
+    }
+    mandelbrot_set_render_mode(initial_mode);
+    mandelbrot_set_formula(ESCAPE_MANDELBROT, 0, 0);
+    return failures;
+}
+
+/*! @brief Retângulos aleatórios comparados com o desenho pixel a pixel. */
+#define BENCH_RASTER_RECTS 2000
+
+/*! @brief Repetições das medidas de tempo da montagem do frame e do cursor. */
+#define BENCH_RASTER_RUNS 200
+
+/*!
+ * @brief Referência pixel a pixel das primitivas de raster.h, com `set_pixel()` e recorte por pixel.
+ */
+static void raster_reference(uint8_t *buf, int left, int top, int width, int height, raster_op_t op, bool outline)
+{
+    for (int y = top; y < top + height; y++)
+        for (int x = left; x < left + width; x++)
+        {
+            bool edge = y == top || y == top + height - 1 || x == left || x == left + width - 1;
+            if (x < 0 || x >= SSD1306_WIDTH || y < 0 || y >= SSD1306_HEIGHT || (outline && !edge))
+                continue;
+            bool lit = buf[(y / 8) * SSD1306_WIDTH + x] & (1 << (y % 8));
+            set_pixel(buf, x, y, op == RASTER_SET || (op == RASTER_XOR && !lit));
+        }
+}
+
+/*!
+ * @brief Montagem do frame anterior ao rasterizador por páginas: x e depois y, um `set_pixel()` por pixel.
+ */
+static void assemble_per_pixel(uint8_t *buf, const render_data_t *view, mandelbrot_stats_t *stats)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    int cap = mandelbrot_get_max_iter();
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+            set_pixel(buf, x, y, mandelbrot_point(view->real_start + x * stepX, view->im_start + y * stepY, stats,
+                                                  NULL) == cap);
+}
+
+/*!
+ * @brief Monta o frame a partir de pixels já calculados (`lit`, linha a linha): um `set_pixel()` por pixel ou, com
+ *        `paged`, um byte por coluna da página montado em registrador, como em `draw_mandelbrot_block()`.
+ */
+static void assemble_from(uint8_t *buf, const bool *lit, bool paged)
+{
+    if (!paged)
+    {
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            for (int y = 0; y < SSD1306_HEIGHT; y++)
+                set_pixel(buf, x, y, lit[y * SSD1306_WIDTH + x]);
+        return;
+    }
+    for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+        {
+            uint8_t bits = 0;
+            for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+                bits |= lit[(page * SSD1306_PAGE_HEIGHT + bit) * SSD1306_WIDTH + x] << bit;
+            buf[page * SSD1306_WIDTH + x] = bits;
+        }
+}
+
+/*!
+ * @brief Rasterizador por páginas: primitivas iguais ao desenho pixel a pixel, e o custo de montagem do frame e do
+ *        cursor (fora do kernel) comparado com o de um `set_pixel()` por pixel.
+ */
+static int bench_raster()
+{
+    static uint8_t buf[SSD1306_BUF_LEN], reference[SSD1306_BUF_LEN], before[SSD1306_BUF_LEN];
+    uint32_t rng = 2024;
+    int wrong = 0, xor_wrong = 0, failures = 0;
+
+    for (int i = 0; i < BENCH_RASTER_RECTS; i++)
+    {
+        for (size_t k = 0; k < sizeof(buf); k++)
+            buf[k] = (uint8_t)((rng = rng * 1103515245u + 12345u) >> 16);
+        memcpy(reference, buf, sizeof(buf));
+        memcpy(before, buf, sizeof(buf));
+        int left = (int)((rng = rng * 1103515245u + 12345u) >> 16) % (SSD1306_WIDTH + 16) - 8;
+        int top = (int)((rng = rng * 1103515245u + 12345u) >> 16) % (SSD1306_HEIGHT + 16) - 8;
+        int width = (int)((rng = rng * 1103515245u + 12345u) >> 16) % 48;
+        int height = (int)((rng = rng * 1103515245u + 12345u) >> 16) % 40;
+        raster_op_t op = (raster_op_t)(i % 3);
+        bool outline = i % 2;
+
+        if (outline)
+            raster_outline(buf, left, top, width, height, op);
+        else if (height == 1)
+            raster_hspan(buf, left, left + width, top, op);
+        else if (width == 1)
+            raster_vspan(buf, left, top, top + height, op);
+        else
+            raster_fill(buf, left, top, width, height, op);
+        raster_reference(reference, left, top, width, height, op, outline);
+        wrong += memcmp(buf, reference, sizeof(buf)) != 0;
+
+        if (op == RASTER_XOR)
+        {
+            outline ? raster_outline(buf, left, top, width, height, op) : raster_fill(buf, left, top, width, height, op);
+            xor_wrong += memcmp(buf, before, sizeof(buf)) != 0;
+        }
+    }
+    printf("\nraster: %d retangulos (spans, blocos e contornos, com recorte): %d diferentes do desenho por pixel, "
+           "%d XOR sem restaurar: %s\n",
+           BENCH_RASTER_RECTS, wrong, xor_wrong, wrong || xor_wrong ? "FALHA" : "ok");
+    failures += wrong != 0 || xor_wrong != 0;
+
+    // cursor: mesma imagem, tempo por desenho
+    uint64_t cursor_pixel = UINT64_MAX, cursor_raster = UINT64_MAX;
+    for (int run = 0; run < BENCH_RASTER_RUNS; run++)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        raster_reference(reference, 20, 10, 64, 32, RASTER_SET, true);
+        uint64_t t1 = hal_host_time_ns();
+        draw_cursor(buf, 10, 20, 64, 32, true);
+        uint64_t t2 = hal_host_time_ns();
+        cursor_pixel = MIN(cursor_pixel, t1 - t0);
+        cursor_raster = MIN(cursor_raster, t2 - t1);
+    }
+
+    // montagem do frame fora do kernel, a partir dos pixels já calculados
+    const render_data_t *view = &catalogue[0].view;
+    static bool lit[SSD1306_WIDTH * SSD1306_HEIGHT];
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    int cap = mandelbrot_get_max_iter();
+    mandelbrot_stats_t ignored = {0};
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            lit[y * SSD1306_WIDTH + x] =
+                mandelbrot_point(view->real_start + x * stepX, view->im_start + y * stepY, &ignored, NULL) == cap;
+
+    uint64_t per_pixel = UINT64_MAX, paged = UINT64_MAX, frame_pixel = UINT64_MAX, frame_paged = UINT64_MAX;
+    for (int run = 0; run < BENCH_RASTER_RUNS; run++)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        assemble_from(reference, lit, false);
+        uint64_t t1 = hal_host_time_ns();
+        assemble_from(buf, lit, true);
+        uint64_t t2 = hal_host_time_ns();
+        per_pixel = MIN(per_pixel, t1 - t0);
+        paged = MIN(paged, t2 - t1);
+    }
+    bool same = memcmp(buf, reference, SSD1306_FRAME_LEN) == 0;
+
+    // frame completo com limite 1, em que a montagem pesa mais em relação ao kernel
+    mandelbrot_set_max_iter(1);
+    for (int run = 0; run < BENCH_RASTER_RUNS; run++)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        assemble_per_pixel(reference, view, &ignored);
+        uint64_t t1 = hal_host_time_ns();
+        draw_mandelbrot_block(buf, view, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, &ignored);
+        uint64_t t2 = hal_host_time_ns();
+        frame_pixel = MIN(frame_pixel, t1 - t0);
+        frame_paged = MIN(frame_paged, t2 - t1);
+    }
+    mandelbrot_set_max_iter(cap);
+    same &= memcmp(buf, reference, SSD1306_FRAME_LEN) == 0;
+
+    printf("raster: montagem do frame fora do kernel: por pixel %.1f us, por pagina %.1f us (%.2f ns/pixel)\n",
+           per_pixel / 1e3, paged / 1e3, (double)paged / (SSD1306_WIDTH * SSD1306_HEIGHT));
+    printf("raster: frame com limite 1: por pixel %.1f us, por pagina %.1f us, mesma imagem: %s\n", frame_pixel / 1e3,
+           frame_paged / 1e3, same ? "sim" : "NAO");
+    printf("raster: cursor 64x32: por pixel %llu ns, por pagina %llu ns\n", (unsigned long long)cursor_pixel,
+           (unsigned long long)cursor_raster);
+    failures += !same;
+    return failures;
+}
+
+/*! @brief Repetições da medição de cada sombreamento (a menor é reportada). */
+#define BENCH_SHADE_RUNS 200
+
+/*!
+ * @brief Verifica o campo retido de um frame: o limiar deve reproduzir o frame e, se `counts` não for NULL, o campo
+ *        deve conter as iterações de `counts` (`MANDELBROT_FIELD_INSIDE` onde atingiram `cap`).
+ */
+static bool shade_check(const char *name, const char *renderer, const uint8_t *frame, const uint8_t *field,
+                        const uint8_t *counts, int cap)
+{
+    static uint8_t shaded[SSD1306_BUF_LEN];
+    shade_frame(shaded, field, cap, SHADE_THRESHOLD);
+    bool same = memcmp(shaded, frame, SSD1306_FRAME_LEN) == 0;
+
+    int wrong = 0;
+    for (int i = 0; counts && i < SSD1306_WIDTH * SSD1306_HEIGHT; i++)
+        wrong += field[i] != (counts[i] == cap ? MANDELBROT_FIELD_INSIDE : counts[i]);
+
+    const char *status = counts ? (wrong ? "DIFERENTES" : "iguais") : "-";
+    printf("%-16s %-14s %-6s %s\n", name, renderer, same ? "sim" : "NAO", status);
+    return same && wrong == 0;
+}
+
+/*!
+ * @brief Iterações de cada pixel da janela, avaliadas diretamente pelo kernel (referência do campo retido).
+ */
+static void field_reference(uint8_t *counts, const render_data_t *view)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    mandelbrot_stats_t ignored = {0};
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            counts[y * SSD1306_WIDTH + x] =
+                (uint8_t)mandelbrot_point(view->real_start + x * stepX, view->im_start + y * stepY, &ignored, NULL);
+}
+
+/*!
+ * @brief Verifica o campo de iterações retido por todos os renderizadores e mede o sombreamento a partir dele.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_shade()
+{
+    static uint8_t buf[SSD1306_BUF_LEN], shaded[SSD1306_BUF_LEN];
+    static uint8_t field[SSD1306_WIDTH * SSD1306_HEIGHT], counts[SSD1306_WIDTH * SSD1306_HEIGHT];
+    mandelbrot_render_mode_t initial_mode = mandelbrot_get_render_mode();
+    int cap = mandelbrot_get_max_iter();
+    bool ok = true;
+
+    printf("\n%-16s %-14s %-6s %s\n", "janela", "renderizador", "limiar", "iteracoes");
+    mandelbrot_retain_field(buf, field);
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const bench_view_t *entry = &catalogue[i];
+
+        // completo: as iterações de cada pixel, exceto os espelhados (cópia da linha simétrica)
+        mandelbrot_set_render_mode(MANDELBROT_RENDER_FULL);
+        draw_mandelbrot_frame(buf, &entry->view);
+        field_reference(counts, &entry->view);
+        ok &= shade_check(entry->name, "completo", buf, field, mandelbrot_frame_stats()->mirrored ? NULL : counts, cap);
+
+        // subdivisão: os retângulos preenchidos recebem a contagem da borda
+        mandelbrot_set_render_mode(MANDELBROT_RENDER_SUBDIVIDE);
+        draw_mandelbrot_frame(buf, &entry->view);
+        ok &= shade_check(entry->name, "subdiv.", buf, field, NULL, cap);
+    }
+    mandelbrot_set_render_mode(MANDELBROT_RENDER_FULL);
+
+    // orçamento: concluído e interrompido no meio do aprofundamento (os pixels acesos ficam dentro)
+    const render_data_t *boundary = &catalogue[2].view;
+    budget_set_clock(fake_clock);
+    for (int tick = 0; tick <= 1000; tick += 1000)
+    {
+        budget_reset();
+        fake_clock_tick = tick;
+        const budget_frame_t *report = budget_render(buf, boundary);
+        ok &= shade_check(catalogue[2].name, tick ? "orcam. interr." : "orcamento", buf, field, NULL,
+                          report->cap_reached);
+    }
+    budget_set_clock(NULL);
+    budget_reset();
+    mandelbrot_set_max_iter(cap);
+
+    // deslocamento: o campo é deslocado junto com o frame e completado nas faixas expostas
+    static const int moves[][2] = {{5, 0}, {0, -7}, {-13, 9}, {40, 30}};
+    const render_data_t home = VIEWPORT_HOME;
+    viewport_grid_t grid;
+    render_data_t view;
+    viewport_grid_anchor(&grid, &home);
+    draw_mandelbrot_block(buf, &home, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+    for (size_t i = 0; i < count_of(moves); i++)
+    {
+        mandelbrot_stats_t ignored = {0};
+        pan_frame(buf, &grid, moves[i][0], moves[i][1], &view, &ignored);
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+            for (int x = 0; x < SSD1306_WIDTH; x++)
+                counts[y * SSD1306_WIDTH + x] = (uint8_t)mandelbrot_point(
+                    grid.real_base + (grid.ox + x) * grid.step_x, grid.im_base + (grid.oy + y) * grid.step_y,
+                    &ignored, NULL);
+        char name[24];
+        snprintf(name, sizeof(name), "pan (%d,%d)", moves[i][0], moves[i][1]);
+        ok &= shade_check(name, "deslocamento", buf, field, counts, cap);
+    }
+
+    // progressivo: cada pixel é amostrado uma vez ao longo das passadas
+    progressive_start(&catalogue[1].view);
+    mandelbrot_retain_field(progressive_image(), field);
+    while (progressive_step() != PROGRESSIVE_FINISHED)
+        ;
+    field_reference(counts, &catalogue[1].view);
+    ok &= shade_check(catalogue[1].name, "progressivo", progressive_image(), field, counts, cap);
+
+    // perturbação: o campo deve coincidir com as contagens retornadas por draw_mandelbrot_deep()
+    deep_view_t deep;
+    deep_stats_t deep_stats;
+    deep_view_from_render_data(&deep, &catalogue[2].view);
+    for (int i = 0; i < 12; i++)
+        deep_view_zoom_in(&deep, 56, 24, 16, 16);
+    mandelbrot_retain_field(buf, field);
+    draw_mandelbrot_deep(buf, &deep, counts, &deep_stats);
+    ok &= shade_check("profunda", "perturbacao", buf, field, counts, cap);
+
+    // pontilhados: com o campo constante, o nível L acende exatamente L dos 256 limiares de cada bloco 16 x 16
+    bool ramp = true;
+    for (int mode = SHADE_BAYER; mode <= SHADE_BLUE_NOISE; mode++)
+    {
+        int previous = -1;
+        for (int n = 0; n <= cap; n++)
+        {
+            memset(counts, n == cap ? MANDELBROT_FIELD_INSIDE : n, sizeof(counts));
+            shade_frame(shaded, counts, cap, (shade_mode_t)mode);
+            int lit = 0;
+            for (int b = 0; b < SSD1306_FRAME_LEN; b++)
+                lit += __builtin_popcount(shaded[b]);
+            ramp &= lit >= previous && lit % (SSD1306_WIDTH * SSD1306_HEIGHT / 256) == 0 &&
+                    (n != 0 || lit == 0) && (n != cap || lit == SSD1306_WIDTH * SSD1306_HEIGHT);
+            previous = lit;
+        }
+    }
+    printf("pontilhados com campo constante: tons crescentes, de apagado a aceso: %s\n", ramp ? "ok" : "FALHA");
+    ok &= ramp;
+
+    // tempo de cada sombreamento, comparado ao de renderizar o frame
+    mandelbrot_retain_field(buf, field);
+    uint64_t render_ns = UINT64_MAX;
+    for (int run = 0; run < 5; run++)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        draw_mandelbrot_frame(buf, &catalogue[1].view);
+        render_ns = MIN(render_ns, hal_host_time_ns() - t0);
+    }
+    printf("%-16s %10s %10s\n", "sombreamento", "tempo(us)", "x frame");
+    for (int mode = 0; mode < SHADE_MODE_COUNT; mode++)
+    {
+        uint64_t best = UINT64_MAX;
+        for (int run = 0; run < BENCH_SHADE_RUNS; run++)
+        {
+            uint64_t t0 = hal_host_time_ns();
+            shade_frame(shaded, field, cap, (shade_mode_t)mode);
+            best = MIN(best, hal_host_time_ns() - t0);
+        }
+        printf("%-16s %10.1f %10.3f\n", shade_mode_name((shade_mode_t)mode), best / 1e3, (double)best / render_ns);
+    }
+
+    mandelbrot_retain_field(NULL, NULL);
+    mandelbrot_set_render_mode(initial_mode);
+    return !ok;
+}
+
+/*! @brief Pares de amostras (X, Y) por tick de 48 ms, com o ADC a JOYSTICK_SAMPLE_RATE amostras/s no total. */
+#define BENCH_JOYSTICK_PAIRS_PER_TICK (JOYSTICK_SAMPLE_RATE / 2 * 48 / 1000)
+
+/*! @brief Maior traço aceito (pares de amostras). */
+#define BENCH_JOYSTICK_MAX_PAIRS 65536
+
+/*!
+ * @brief Traço do joystick: pares de amostras (vrx, vry) e, nos traços sintéticos, a posição pretendida.
+ */
+typedef struct {
+    uint16_t vrx[BENCH_JOYSTICK_MAX_PAIRS], vry[BENCH_JOYSTICK_MAX_PAIRS];
+    uint16_t intended_vrx[BENCH_JOYSTICK_MAX_PAIRS], intended_vry[BENCH_JOYSTICK_MAX_PAIRS]; /*!< Sem ruído. */
+    int pairs;
+    bool synthetic;
+} joystick_trace_t;
+
+static uint32_t trace_rng = 0x2545F491u;
+
+// ruído do ADC: triangular de +-4 unidades, com picos isolados de até +-120 (1 a cada 250 amostras)
+static uint16_t adc_noise(int value)
+{
+    trace_rng = trace_rng * 1664525u + 1013904223u;
+    int noise = (int)((trace_rng >> 8) % 5) + (int)((trace_rng >> 16) % 5) - 4;
+    if ((trace_rng >> 24) % 250 == 0)
+        noise += ((trace_rng & 1) ? 1 : -1) * (40 + (int)((trace_rng >> 4) % 81));
+    value += noise;
+    return (uint16_t)(value < 0 ? 0 : value > JOYSTICK_ADC_MAX ? JOYSTICK_ADC_MAX : value);
+}
+
+// acrescenta um trecho ao traço: movimento linear de (x0, y0) a (x1, y1) em `move_ms`, seguido de repouso por `rest_ms`
+static void trace_segment(joystick_trace_t *trace, int x0, int y0, int x1, int y1, int move_ms, int rest_ms)
+{
+    int move = move_ms * JOYSTICK_SAMPLE_RATE / 2 / 1000, rest = rest_ms * JOYSTICK_SAMPLE_RATE / 2 / 1000;
+    for (int i = 0; i < move + rest && trace->pairs < BENCH_JOYSTICK_MAX_PAIRS; i++)
+    {
+        int x = i < move ? x0 + (x1 - x0) * i / move : x1;
+        int y = i < move ? y0 + (y1 - y0) * i / move : y1;
+        trace->intended_vrx[trace->pairs] = (uint16_t)x;
+        trace->intended_vry[trace->pairs] = (uint16_t)y;
+        trace->vrx[trace->pairs] = adc_noise(x);
+        trace->vry[trace->pairs] = adc_noise(y);
+        trace->pairs++;
+    }
+}
+
+/*!
+ * @brief Traço sintético determinístico: repouso no centro, repouso sobre a borda entre dois pixels (o pior caso
+ *        para a leitura direta), movimentos lentos e rápidos e os extremos dos dois eixos.
+ */
+static void trace_synthetic(joystick_trace_t *trace)
+{
+    trace->pairs = 0;
+    trace->synthetic = true;
+    int edge = (4084 * 80 + 126) / 127; // vry na borda entre as colunas 79 e 80
+    trace_segment(trace, 2010, 2075, 2010, 2075, 0, 4000);
+    trace_segment(trace, 2010, 2075, 2010, edge, 400, 4000);
+    trace_segment(trace, 2010, edge, 3500, edge, 2000, 2000);
+    trace_segment(trace, 3500, edge, 3500, 100, 300, 2000);
+    trace_segment(trace, 3500, 100, 0, JOYSTICK_ADC_MAX, 300, 1500);
+    trace_segment(trace, 0, JOYSTICK_ADC_MAX, JOYSTICK_ADC_MAX, 0, 300, 1500);
+    trace_segment(trace, JOYSTICK_ADC_MAX, 0, 2010, 2075, 500, 3000);
+}
+
+/*!
+ * @brief Lê um traço gravado: um par "vrx vry" (0-4095) por linha, a JOYSTICK_SAMPLE_RATE / 2 pares por segundo;
+ *        linhas iniciadas por '#' são ignoradas.
+ */
+static bool trace_load(joystick_trace_t *trace, const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    char line[128];
+    trace->pairs = 0;
+    trace->synthetic = false;
+    while (fgets(line, sizeof(line), f) && trace->pairs < BENCH_JOYSTICK_MAX_PAIRS)
+    {
+        unsigned x, y;
+        if (line[0] == '#' || sscanf(line, "%u %u", &x, &y) != 2)
+            continue;
+        trace->vrx[trace->pairs] = (uint16_t)MIN(x, JOYSTICK_ADC_MAX);
+        trace->vry[trace->pairs] = (uint16_t)MIN(y, JOYSTICK_ADC_MAX);
+        trace->pairs++;
+    }
+    fclose(f);
+    return trace->pairs > 0;
+}
+
+/*!
+ * @brief Reproduz um traço do joystick tick a tick, comparando a leitura direta anterior (uma amostra por eixo a
+ *        cada tick, sem filtro) com o filtro e a histerese de joystick_filter.c.
+ *
+ * @details Nos traços sintéticos, um redesenho é espúrio quando a posição pretendida não mudou no tick nem nos
+ *          2 ticks anteriores. São verificados: nenhum redesenho espúrio com o filtro, cursor a no máximo 1 pixel
+ *          da posição pretendida ao fim de cada repouso, extremos alcançados e, terminado um movimento, no máximo
+ *          2 ticks até o cursor chegar à posição pretendida.
+ *
+ * @return int 0 se todas as verificações passaram.
+ */
+static int bench_joystick(const char *trace_path)
+{
+    static joystick_trace_t trace;
+    if (trace_path ? !trace_load(&trace, trace_path) : (trace_synthetic(&trace), false))
+        return 1;
+
+    axis_filter_t fx, fy;
+    axis_filter_reset(&fx);
+    axis_filter_reset(&fy);
+    joystick_cursor_t cursor = {0};
+    uint8_t raw_x = 0, raw_y = 0;
+    int ticks = 0, raw_moves = 0, raw_spurious = 0, filtered_spurious = 0, far = 0, lag_ticks = 0, max_lag = 0;
+    bool rails[4] = {false};
+    int still = 0; // ticks consecutivos sem mudança da posição pretendida
+
+    for (int start = 0; start + BENCH_JOYSTICK_PAIRS_PER_TICK <= trace.pairs; start += BENCH_JOYSTICK_PAIRS_PER_TICK)
+    {
+        int end = start + BENCH_JOYSTICK_PAIRS_PER_TICK;
+        for (int i = start; i < end; i++)
+        {
+            axis_filter_push(&fx, trace.vrx[i]);
+            axis_filter_push(&fy, trace.vry[i]);
+        }
+
+        // leitura direta: uma amostra de cada eixo no instante do tick
+        uint8_t x, y;
+        joystick_cursor_map(trace.vrx[end - 1], trace.vry[end - 1], 0, &x, &y);
+        bool raw_moved = ticks > 0 && (x != raw_x || y != raw_y);
+        raw_x = x;
+        raw_y = y;
+        raw_moves += raw_moved;
+
+        bool moved = joystick_cursor_update(&cursor, axis_filter_value(&fx), axis_filter_value(&fy), 0) && ticks > 0;
+        ticks++;
+        if (!trace.synthetic)
+            continue;
+
+        uint8_t ix, iy;
+        joystick_cursor_map(trace.intended_vrx[end - 1], trace.intended_vry[end - 1], 0, &ix, &iy);
+        still = (trace.intended_vrx[start] == trace.intended_vrx[end - 1] &&
+                 trace.intended_vry[start] == trace.intended_vry[end - 1]) ? still + 1 : 0;
+        if (still > 2)
+        {
+            raw_spurious += raw_moved;
+            filtered_spurious += moved;
+        }
+
+        // atraso: ticks, após o fim de um movimento, até o cursor filtrado chegar a 1 pixel da posição pretendida
+        bool near = abs(cursor.x - ix) <= 1 && abs(cursor.y - iy) <= 1;
+        lag_ticks = near || still == 0 ? 0 : lag_ticks + 1;
+        max_lag = MAX(max_lag, lag_ticks);
+        bool rest_end = still > 2 && (end + BENCH_JOYSTICK_PAIRS_PER_TICK > trace.pairs ||
+                                      trace.intended_vrx[end] != trace.intended_vrx[end - 1] ||
+                                      trace.intended_vry[end] != trace.intended_vry[end - 1]);
+        if (rest_end)
+            far += !near;
+        rails[0] |= cursor.x == 0;
+        rails[1] |= cursor.x == 127;
+        rails[2] |= cursor.y == 0;
+        rails[3] |= cursor.y == 63;
+    }
+
+    printf("\njoystick (%s, %d ticks de 48 ms, %d amostras por eixo e tick):\n", trace_path ? trace_path : "traco sintetico",
+           ticks, BENCH_JOYSTICK_PAIRS_PER_TICK);
+    printf("  redesenhos do cursor: leitura direta %d, filtrado %u\n", raw_moves, cursor.moves - 1);
+    if (!trace.synthetic)
+        return 0;
+
+    bool ok = filtered_spurious == 0 && far == 0 && rails[0] && rails[1] && rails[2] && rails[3] && max_lag <= 2;
+    printf("  redesenhos espurios (joystick parado): leitura direta %d, filtrado %d (%d eliminados)\n", raw_spurious,
+           filtered_spurious, raw_spurious - filtered_spurious);
+    printf("  atraso maximo %d ms, repousos fora da posicao %d, extremos %s: %s\n", max_lag * 48, far,
+           rails[0] && rails[1] && rails[2] && rails[3] ? "alcancados" : "NAO alcancados", ok ? "ok" : "FALHA");
+    return !ok;
+}
+
+/*!
+ * @brief Soma as iterações do kernel ativo sobre todos os pixels da janela.
+ */
+static uint64_t count_iterations(const render_data_t *view)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    uint64_t total = 0;
+
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+    {
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            float real = view->real_start + x * stepX;
+            float imag = view->im_start + y * stepY;
+#if MANDELBROT_FIXED_POINT
+            total += mandelbrot_fixed(MANDELBROT_TO_FIXED(real), MANDELBROT_TO_FIXED(imag));
+#else
+            total += mandelbrot(real + imag * I);
+#endif
+        }
+    }
+    return total;
+}
+
+/*!
+ * @brief Compara as iterações por pixel do kernel em ponto fixo com o kernel float de referência.
+ *
+ * @param count_diff Recebe o número de pixels com contagens de iteração diferentes.
+ * @param bit_diff   Recebe o número de pixels com valor de 1 bit (pertence / não pertence) diferente.
+ */
+static void compare_kernels(const render_data_t *view, int *count_diff, int *bit_diff)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+
+    *count_diff = 0;
+    *bit_diff = 0;
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+    {
+        for (int y = 0; y < SSD1306_HEIGHT; y++)
+        {
+            float real = view->real_start + x * stepX;
+            float imag = view->im_start + y * stepY;
+            int ref = mandelbrot(real + imag * I);
+            int fixed = mandelbrot_fixed(MANDELBROT_TO_FIXED(real), MANDELBROT_TO_FIXED(imag));
+            *count_diff += ref != fixed;
+            *bit_diff += (ref == MAX_ITER) != (fixed == MAX_ITER);
+        }
+    }
+}
+
+/*!
+ * @brief Mede o tempo de renderização de um frame, repetindo até `BENCH_MIN_TIME_NS`.
+ *
+ * @return O menor tempo observado (ns).
+ */
+static uint64_t time_frame(uint8_t *buf, const render_data_t *view)
+{
+    uint64_t best = UINT64_MAX;
+    uint64_t elapsed = 0;
+    int runs = 0;
+
+    while (elapsed < BENCH_MIN_TIME_NS || runs < 3)
+    {
+        uint64_t t0 = hal_host_time_ns();
+        draw_mandelbrot_frame(buf, view);
+        uint64_t dt = hal_host_time_ns() - t0;
+        if (dt < best)
+            best = dt;
+        elapsed += dt;
+        runs++;
+    }
+    return best;
+}
+
+/*!
+ * @brief Verifica (ou atualiza) o frame de referência da janela.
+ *
+ * @return 0 se o frame confere (ou foi atualizado), -1 caso contrário.
+ */
+static int check_golden(const char *dir, const char *name, const uint8_t *buf, bool update, const char **status)
+{
+    static uint8_t rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    static uint8_t golden[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    char path[512];
+
+    snprintf(path, sizeof(path), "%s/%s.pbm", dir, name);
+    pbm_from_framebuffer(buf, rows);
+
+    if (update)
+    {
+        *status = pbm_write(path, SSD1306_WIDTH, SSD1306_HEIGHT, rows) == 0 ? "atualizado" : "ERRO-ESCRITA";
+        return **status == 'a' ? 0 : -1;
+    }
+    if (pbm_read(path, SSD1306_WIDTH, SSD1306_HEIGHT, golden) != 0)
+    {
+        *status = "AUSENTE";
+        return -1;
+    }
+    if (memcmp(rows, golden, sizeof(rows)) != 0)
+    {
+        *status = "DIFERENTE";
+        return -1;
+    }
+    *status = "ok";
+    return 0;
+}
+
+/*!
+ * @brief Mede o tráfego I2C de um movimento de 1 pixel do cursor, com e sem o envio diferencial.
+ *
+ * @return 0 se o envio diferencial for mais barato que o frame completo, -1 caso contrário.
+ */
+static int bench_transport()
+{
+    static uint8_t frame[SSD1306_BUF_LEN];
+    render_area_t full = {start_col : 0, end_col : SSD1306_WIDTH - 1, start_page : 0, end_page : SSD1306_NUM_PAGES - 1};
+    render_data_t home = catalogue[0].view;
+    calc_render_area_buflen(&full);
+
+    // estado inicial: fractal e cursor (8x8 em 60,28) já exibidos
+    draw_mandelbrot_frame(frame, &home);
+    draw_cursor(frame, 28, 60, 8, 8, true);
+    SSD1306_invalidate_shadow();
+    SSD1306_render_dirty(frame);
+
+    // cursor deslocado 1 pixel para a direita
+    draw_mandelbrot_frame(frame, &home);
+    draw_cursor(frame, 28, 61, 8, 8, true);
+
+    // envio anterior: buffer limpo seguido do frame completo
+    static uint8_t cleared[SSD1306_BUF_LEN];
+    hal_host_reset();
+    render(cleared, &full);
+    render(frame, &full);
+    hal_host_i2c_stats_t before = hal_host_i2c_stats();
+
+    // restaura o display ao estado inicial e envia apenas as diferenças
+    draw_cursor(frame, 28, 61, 8, 8, false);
+    draw_cursor(frame, 28, 60, 8, 8, true);
+    render(frame, &full);
+    draw_mandelbrot_frame(frame, &home);
+    draw_cursor(frame, 28, 61, 8, 8, true);
+    hal_host_reset();
+    int data = SSD1306_render_dirty(frame);
+    hal_host_i2c_stats_t dirty = hal_host_i2c_stats();
+
+    bool exact = memcmp(hal_host_panel(), frame, SSD1306_FRAME_LEN) == 0;
+
+    hal_host_reset();
+    SSD1306_render_dirty(frame);
+    hal_host_i2c_stats_t unchanged = hal_host_i2c_stats();
+
+    printf("\n%-24s %10s %12s\n", "cursor +1 pixel", "bytes I2C", "transacoes");
+    printf("%-24s %10zu %12zu\n", "frame limpo + completo", before.bytes, before.transactions);
+    printf("%-24s %10zu %12zu  (%d bytes de imagem)\n", "diferencial", dirty.bytes, dirty.transactions, data);
+    printf("%-24s %10zu %12zu\n", "sem alteracao", unchanged.bytes, unchanged.transactions);
+    printf("display emulado == frame: %s\n", exact ? "sim" : "NAO");
+
+    return (exact && dirty.bytes < before.bytes && unchanged.bytes == 0) ? 0 : -1;
+}
+
+/*!
+ * @brief Exercita o motor de transmissão com buffer duplo sobre o transporte substituto.
+ *
+ * @details
+ *  - Desenha cada frame no buffer de trás enquanto o anterior ainda está em transmissão e verifica, ao final
+ *    de cada transmissão, que o display emulado exibe o frame submetido e que nenhum buffer em transmissão
+ *    foi alterado.
+ *
+ * @return 0 em caso de sucesso, -1 caso contrário.
+ */
+static int bench_tx()
+{
+    static uint8_t expected[SSD1306_FRAME_LEN];
+    bool ok = true;
+
+    SSD1306_set_transport(&transport_host);
+    transport_host_reset(4);
+    SSD1306_tx_init();
+
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        uint8_t *frame = SSD1306_tx_back();
+        draw_mandelbrot_frame(frame, &catalogue[i].view);
+        draw_cursor(frame, 28, 60, 8, 8, true);
+        memcpy(expected, frame, SSD1306_FRAME_LEN);
+
+        SSD1306_tx_submit();
+        SSD1306_tx_swap();
+        ok = ok && !SSD1306_tx_poll(); // transmissão ainda em andamento
+
+        // desenha no novo buffer de trás durante a transmissão
+        memset(SSD1306_tx_back(), 0xA5, SSD1306_FRAME_LEN);
+
+        SSD1306_tx_wait();
+        ok = ok && memcmp(hal_host_panel(), expected, SSD1306_FRAME_LEN) == 0;
+    }
+
+    transport_host_stats_t stats = transport_host_stats();
+    ok = ok && stats.transfers == count_of(catalogue) && stats.overlapped_starts == 0 && stats.modified_in_flight == 0;
+    printf("\nbuffer duplo: %zu transmissoes, %zu sobrepostas, %zu buffers alterados em transmissao: %s\n",
+           stats.transfers, stats.overlapped_starts, stats.modified_in_flight, ok ? "ok" : "FALHA");
+
+    SSD1306_set_transport(&ssd1306_i2c_blocking_transport);
+    return ok ? 0 : -1;
+}
+
+/*!
+ * @brief Mede bytes e transações por atualização com o transporte de gravação.
+ *
+ * @param dump Arquivo que recebe o fluxo de bytes registrado (NULL para não gravar).
+ *
+ * @return 0 se o display emulado exibir o frame esperado, -1 caso contrário.
+ */
+static int bench_cmd_stream(FILE *dump)
+{
+    static uint8_t frame[SSD1306_FRAME_LEN];
+    render_area_t full = {start_col : 0, end_col : SSD1306_WIDTH - 1, start_page : 0, end_page : SSD1306_NUM_PAGES - 1};
+    calc_render_area_buflen(&full);
+    SSD1306_set_transport(&transport_record);
+
+    printf("\n%-24s %12s %10s\n", "atualizacao", "transacoes", "bytes");
+
+    transport_record_reset();
+    SSD1306_init();
+    printf("%-24s %12zu %10zu\n", "SSD1306_init", transport_record_transactions(), transport_record_bytes());
+    if (dump)
+        transport_record_dump(dump);
+
+    draw_mandelbrot_frame(frame, &catalogue[0].view);
+    draw_cursor(frame, 28, 60, 8, 8, true);
+    transport_record_reset();
+    render(frame, &full);
+    printf("%-24s %12zu %10zu\n", "frame completo", transport_record_transactions(), transport_record_bytes());
+    if (dump)
+        transport_record_dump(dump);
+
+    draw_cursor(frame, 28, 60, 8, 8, false);
+    draw_cursor(frame, 28, 61, 8, 8, true);
+    transport_record_reset();
+    SSD1306_render_dirty(frame);
+    printf("%-24s %12zu %10zu\n", "cursor +1 pixel", transport_record_transactions(), transport_record_bytes());
+    if (dump)
+        transport_record_dump(dump);
+
+    SSD1306_set_transport(&ssd1306_i2c_blocking_transport);
+    return memcmp(hal_host_panel(), frame, SSD1306_FRAME_LEN) == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *golden_dir = MANDELBROT_GOLDEN_DIR;
+    bool update = false;
+    FILE *dump = NULL;
+    const char *adc_trace = NULL;
+    FILE *trace_out = NULL;
+    FILE *stream_out = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--update-golden") == 0)
+            update = true;
+        else if (strcmp(argv[i], "--golden-dir") == 0 && i + 1 < argc)
+            golden_dir = argv[++i];
+        else if (strcmp(argv[i], "--dump-i2c") == 0 && i + 1 < argc)
+        {
+            dump = fopen(argv[++i], "w");
+            if (dump == NULL)
+            {
+                perror(argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--adc-trace") == 0 && i + 1 < argc)
+            adc_trace = argv[++i];
+        else if (strcmp(argv[i], "--trace-dump") == 0 && i + 1 < argc)
+        {
+            trace_out = fopen(argv[++i], "w");
+            if (trace_out == NULL)
+            {
+                perror(argv[i]);
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--stream-capture") == 0 && i + 1 < argc)
+        {
+            stream_out = fopen(argv[++i], "wb");
+            if (stream_out == NULL)
+            {
+                perror(argv[i]);
+                return 2;
+            }
+        }
+        else
+        {
+            fprintf(stderr,
+                    "uso: %s [--update-golden] [--golden-dir DIR] [--dump-i2c ARQUIVO] [--adc-trace ARQUIVO]\n"
+                    "          [--trace-dump ARQUIVO] [--stream-capture ARQUIVO]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    static uint8_t buf[SSD1306_BUF_LEN];
+    static uint8_t single[SSD1306_BUF_LEN];
+    int failures = 0;
+
+    render_platform_init();
+
+    printf("kernel: %s, %s\n\n", MANDELBROT_FIXED_POINT ? "ponto fixo Q3.28" : "float complex",
+           MANDELBROT_DUAL_CORE ? "dois trabalhadores" : "um trabalhador");
+    printf("%-16s %10s %12s %12s %10s %s\n", "janela", "frame(us)", "pixels/s", "iteracoes", "ns/iter", "referencia");
+
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const bench_view_t *entry = &catalogue[i];
+        memset(buf, 0, sizeof(buf));
+
+        uint64_t ns = time_frame(buf, &entry->view);
+        uint64_t iterations = count_iterations(&entry->view);
+        double pixels_per_s = (double)(SSD1306_WIDTH * SSD1306_HEIGHT) * 1e9 / (double)ns;
+
+        const char *status;
+        failures += check_golden(golden_dir, entry->name, buf, update, &status) != 0;
+
+        printf("%-16s %10.1f %12.0f %12llu %10.2f %s\n", entry->name, ns / 1e3, pixels_per_s,
+               (unsigned long long)iterations, (double)ns / (double)iterations, status);
+    }
+
+    // atalhos para pontos interiores: o frame deve ser idêntico ao da iteração completa
+    mandelbrot_render_mode_t initial_mode = mandelbrot_get_render_mode();
+    mandelbrot_set_render_mode(MANDELBROT_RENDER_FULL);
+    printf("\n%-16s %10s %10s %10s %10s %10s %10s %8s %s\n", "janela", "avaliados", "executadas", "cardioide",
+           "bulbo", "periodico", "espelhados", "reducao", "igual");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const bench_view_t *entry = &catalogue[i];
+        memset(buf, 0, sizeof(buf));
+        draw_mandelbrot_frame(buf, &entry->view);
+        mandelbrot_stats_t stats = *mandelbrot_frame_stats();
+
+        memset(single, 0, sizeof(single));
+        uint64_t full = render_full_iteration(single, &entry->view);
+        bool same = memcmp(buf, single, SSD1306_FRAME_LEN) == 0;
+        failures += !same;
+
+        printf("%-16s %10u %10u %10u %10u %10u %10u %7.1fx %s\n", entry->name, stats.evaluated, stats.iterations,
+               stats.exits[MANDELBROT_EXIT_CARDIOID], stats.exits[MANDELBROT_EXIT_BULB],
+               stats.exits[MANDELBROT_EXIT_PERIODIC], stats.mirrored,
+               stats.iterations ? (double)full / (double)stats.iterations : 0.0, same ? "sim" : "NAO");
+    }
+
+    // subdivisão de retângulos: avaliações do kernel e pixels diferentes do modo completo
+    static const struct
+    {
+        const char *name;
+        mandelbrot_render_mode_t mode;
+    } modes[] = {
+        {"completo", MANDELBROT_RENDER_FULL},
+        {"subdiv.", MANDELBROT_RENDER_SUBDIVIDE},
+        {"conservador", MANDELBROT_RENDER_SUBDIVIDE_CONSERVATIVE},
+    };
+    printf("\n%-16s %-12s %10s %10s %10s %8s %10s\n", "janela", "modo", "frame(us)", "avaliados", "preenchid.", "reducao",
+           "bits difer.");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        const bench_view_t *entry = &catalogue[i];
+        uint32_t full_evaluated = 0;
+
+        memset(single, 0, sizeof(single));
+        mandelbrot_set_render_mode(MANDELBROT_RENDER_FULL);
+        draw_mandelbrot_frame(single, &entry->view);
+
+        for (size_t m = 0; m < count_of(modes); m++)
+        {
+            mandelbrot_set_render_mode(modes[m].mode);
+            memset(buf, 0, sizeof(buf));
+            uint64_t ns = time_frame(buf, &entry->view);
+            mandelbrot_stats_t stats = *mandelbrot_frame_stats();
+            if (modes[m].mode == MANDELBROT_RENDER_FULL)
+                full_evaluated = stats.evaluated;
+
+            int diff = 0;
+            for (int b = 0; b < SSD1306_FRAME_LEN; b++)
+                diff += __builtin_popcount(buf[b] ^ single[b]);
+
+            printf("%-16s %-12s %10.1f %10u %10u %7.1fx %10d\n", entry->name, modes[m].name, ns / 1e3, stats.evaluated,
+                   stats.filled, stats.evaluated ? (double)full_evaluated / (double)stats.evaluated : 0.0, diff);
+
+            // o modo conservador não pode apagar o conjunto nas janelas de referência
+            if (modes[m].mode == MANDELBROT_RENDER_SUBDIVIDE_CONSERVATIVE && diff != 0)
+                failures++;
+        }
+    }
+
+    // o kernel em ponto fixo deve reproduzir o kernel float de referência (diferenças só em pixels caóticos da borda)
+    printf("\n%-16s %16s %16s\n", "janela", "iteracoes difer.", "bits diferentes");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        int count_diff, bit_diff;
+        compare_kernels(&catalogue[i].view, &count_diff, &bit_diff);
+        printf("%-16s %16d %16d\n", catalogue[i].name, count_diff, bit_diff);
+        if (strcmp(catalogue[i].name, "home") == 0 && bit_diff != 0)
+            failures++;
+    }
+
+    // a renderização paralela deve ser idêntica à renderização em um único trabalhador
+    mandelbrot_set_render_mode(MANDELBROT_RENDER_FULL);
+    printf("\n%-16s %12s %s\n", "janela", "unidades", "paralelo == sequencial");
+    for (size_t i = 0; i < count_of(catalogue); i++)
+    {
+        memset(buf, 0, sizeof(buf));
+        memset(single, 0, sizeof(single));
+        mandelbrot_stats_t ignored = {0};
+        render_frame_parallel(buf, &catalogue[i].view, 0, &ignored);
+        draw_mandelbrot_block(single, &catalogue[i].view, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+        bool same = memcmp(buf, single, sizeof(buf)) == 0;
+        const render_parallel_stats_t *stats = render_parallel_stats();
+        printf("%-16s %5u + %-4u %s\n", catalogue[i].name, stats->units[0], stats->units[1], same ? "sim" : "NAO");
+        failures += !same;
+    }
+
+    mandelbrot_set_render_mode(initial_mode);
+
+    failures += bench_progressive() != 0;
+    failures += bench_pan() != 0;
+    failures += bench_raster() != 0;
+    failures += bench_shade() != 0;
+    failures += bench_frame_cache() != 0;
+    failures += bench_speculate() != 0;
+    failures += bench_deep() != 0;
+    failures += bench_budget() != 0;
+    failures += bench_input_queue() != 0;
+    failures += bench_trace(trace_out) != 0;
+    failures += bench_stream(stream_out) != 0;
+    failures += bench_joystick(NULL) != 0;
+    failures += bench_zoom_history() != 0;
+    failures += bench_flash_store() != 0;
+    failures += bench_render_tiles() != 0;
+    failures += bench_simd() != 0;
+    failures += bench_escape() != 0;
+    if (adc_trace)
+        failures += bench_joystick(adc_trace) != 0;
+    failures += bench_transport() != 0;
+    failures += bench_tx() != 0;
+    failures += bench_cmd_stream(dump) != 0;
+
+    if (dump)
+        fclose(dump);
+    if (trace_out)
+        fclose(trace_out);
+    if (stream_out)
+        fclose(stream_out);
+
+    if (failures)
+        printf("\n%d falha(s)\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include "flash_file.h"
+
+#define REGION_SIZE (FLASH_STORE_SECTORS * FLASH_STORE_SECTOR_SIZE)
+
+static uint8_t image[REGION_SIZE]; // conteúdo da região, gravado também no arquivo
+static FILE *file;
+static int64_t budget = -1;        // bytes até a queda de energia (-1 = sem queda)
+static flash_file_stats_t stats;
+
+// consome o limite de bytes: retorna quantos dos `len` bytes são gravados antes da queda
+static size_t consume(size_t len)
+{
+    if (!stats.powered)
+        return 0;
+    if (budget >= 0 && (int64_t)len > budget)
+    {
+        len = (size_t)budget;
+        budget = 0;
+        stats.powered = false;
+    }
+    else if (budget >= 0)
+    {
+        budget -= len;
+    }
+    stats.bytes += len;
+    return len;
+}
+
+static void sync_file(uint32_t offset, size_t len)
+{
+    fseek(file, offset, SEEK_SET);
+    fwrite(image + offset, 1, len, file);
+    fflush(file);
+}
+
+static bool file_erase(uint32_t offset)
+{
+    if (offset % FLASH_STORE_SECTOR_SIZE != 0 || offset >= REGION_SIZE)
+        return false;
+    size_t done = consume(FLASH_STORE_SECTOR_SIZE);
+    memset(image + offset, 0xff, done); // apagamento interrompido: apenas o início do setor
+    sync_file(offset, done);
+    if (done < FLASH_STORE_SECTOR_SIZE)
+        return false;
+    stats.erases[offset / FLASH_STORE_SECTOR_SIZE]++;
+    return true;
+}
+
+static bool file_program(uint32_t offset, const uint8_t *src, size_t len)
+{
+    if (offset % FLASH_STORE_PAGE_SIZE != 0 || len % FLASH_STORE_PAGE_SIZE != 0 || offset + len > REGION_SIZE)
+        return false;
+    size_t done = consume(len);
+    for (size_t i = 0; i < done; i++)
+    {
+        if ((image[offset + i] & src[i]) != src[i])
+            stats.violations++;
+        image[offset + i] &= src[i];
+    }
+    sync_file(offset, done);
+    return done == len;
+}
+
+static void file_read(uint32_t offset, uint8_t *dst, size_t len)
+{
+    memcpy(dst, image + offset, len);
+}
+
+/*! @brief Região de `FLASH_STORE_SECTORS` setores mantida em arquivo. */
+const flash_backend_t flash_file_backend = {
+    erase : file_erase,
+    program : file_program,
+    read : file_read,
+    size : REGION_SIZE
+};
+
+/*!
+ * @brief Abre o arquivo da região, criando-o apagado (0xFF) se não existir.
+ *
+ * @param path Caminho do arquivo, ou NULL para um arquivo temporário (região apagada).
+ */
+bool flash_file_open(const char *path)
+{
+    flash_file_close();
+    memset(image, 0xff, sizeof(image));
+    file = path ? fopen(path, "r+b") : NULL;
+    if (file)
+    {
+        fread(image, 1, sizeof(image), file);
+    }
+    else
+    {
+        file = path ? fopen(path, "w+b") : tmpfile();
+        if (file == NULL)
+            return false;
+        sync_file(0, sizeof(image));
+    }
+    memset(&stats, 0, sizeof(stats));
+    stats.powered = true;
+    budget = -1;
+    return true;
+}
+
+void flash_file_close()
+{
+    if (file)
+        fclose(file);
+    file = NULL;
+}
+
+/*!
+ * @brief Programa uma queda de energia após mais `bytes` bytes apagados ou programados (-1 = nenhuma).
+ */
+void flash_file_cut_after(int64_t bytes)
+{
+    budget = bytes;
+}
+
+/*!
+ * @brief Religa a flash após a queda de energia simulada (o conteúdo é o deixado pela operação interrompida).
+ */
+void flash_file_power_on()
+{
+    stats.powered = true;
+    budget = -1;
+}
+
+const flash_file_stats_t *flash_file_stats()
+{
+    return &stats;
+}
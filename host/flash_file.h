@@ -0,0 +1,40 @@
+/*!
+ * @file flash_file.h
+ * @brief Substituto da flash do armazenamento persistente para o build nativo (Linux), mantido em um arquivo.
+ *
+ * Emula uma flash NOR: o apagamento leva um setor a 0xFF e a programação só pode levar bits de 1 para 0
+ * (uma programação que exigiria 0 -> 1 é contabilizada como violação). Um limite de bytes gravados simula
+ * uma queda de energia: a operação em andamento é interrompida no meio e todas as seguintes falham até
+ * `flash_file_power_on()`.
+ */
+
+ #ifndef _FLASH_FILE_
+ #define _FLASH_FILE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "flash_store.h"
+
+ /*!
+  * @brief Estatísticas do substituto.
+  */
+ typedef struct {
+     uint32_t erases[FLASH_STORE_SECTORS]; /*!< Apagamentos por setor (desgaste). */
+     uint64_t bytes;                       /*!< Bytes apagados ou programados. */
+     uint32_t violations;                  /*!< Programações sobre bytes não apagados com valor diferente. */
+     bool powered;                         /*!< Falso após a queda de energia simulada. */
+ } flash_file_stats_t;
+
+ extern const flash_backend_t flash_file_backend;
+
+ bool flash_file_open(const char *path);
+
+ void flash_file_close();
+
+ void flash_file_cut_after(int64_t bytes);
+
+ void flash_file_power_on();
+
+ const flash_file_stats_t *flash_file_stats();
+
+ #endif
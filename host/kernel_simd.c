@@ -0,0 +1,306 @@
+#include <string.h>
+#include "kernel_simd.h"
+#include "ssd1306.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNEL_SIMD_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define KERNEL_SIMD_ARM 1
+#endif
+
+/*!
+ * @brief Referência escalar: mesmas operações de cada pista dos kernels vetoriais.
+ */
+static uint64_t row_scalar(float real_start, float step, int first, int count, float imag, int cap, uint8_t *counts)
+{
+    uint64_t work = 0;
+    const float ci = imag;
+    for (int i = 0; i < count; i++)
+    {
+        const float cr = real_start + (first + i) * step;
+#if MANDELBROT_SHORTCUTS
+        // cardioide principal e bulbo de período 2, como em mandelbrot_ex()
+        bool interior = false;
+        if (cr > -0.75f && cr < 0.375f && ci > -0.66f && ci < 0.66f)
+        {
+            float xm = cr - 0.25f;
+            float q = xm * xm + ci * ci;
+            interior = q * (q + xm) <= 0.25f * ci * ci;
+        }
+        if (interior || (cr + 1.0f) * (cr + 1.0f) + ci * ci <= 0.0625f)
+        {
+            counts[i] = (uint8_t)cap;
+            continue;
+        }
+#endif
+        float x = 0, y = 0;
+        int n = 0;
+        while (n < cap)
+        {
+            float x2 = x * x, y2 = y * y;
+            if (!(x2 + y2 <= 4.0f))
+                break;
+            float xy = x * y;
+            x = x2 - y2 + cr;
+            y = xy + xy + ci;
+            n++;
+        }
+        counts[i] = (uint8_t)n;
+        work += n;
+    }
+    return work;
+}
+
+#if KERNEL_SIMD_X86
+
+static uint64_t row_sse2(float real_start, float step, int first, int count, float imag, int cap, uint8_t *counts)
+{
+    uint64_t work = 0;
+    const __m128 ci = _mm_set1_ps(imag), four = _mm_set1_ps(4.0f);
+    for (int i = 0; i < count; i += 4)
+    {
+        const __m128i index = _mm_setr_epi32(i, i + 1, i + 2, i + 3);
+        __m128 point = _mm_cvtepi32_ps(_mm_add_epi32(index, _mm_set1_epi32(first)));
+        const __m128 cr = _mm_add_ps(_mm_set1_ps(real_start), _mm_mul_ps(point, _mm_set1_ps(step)));
+        __m128 active = _mm_castsi128_ps(_mm_cmplt_epi32(index, _mm_set1_epi32(count)));
+        __m128i n = _mm_setzero_si128();
+#if MANDELBROT_SHORTCUTS
+        __m128 box = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(cr, _mm_set1_ps(-0.75f)),
+                                           _mm_cmplt_ps(cr, _mm_set1_ps(0.375f))),
+                                _mm_and_ps(_mm_cmpgt_ps(ci, _mm_set1_ps(-0.66f)),
+                                           _mm_cmplt_ps(ci, _mm_set1_ps(0.66f))));
+        __m128 xm = _mm_sub_ps(cr, _mm_set1_ps(0.25f));
+        __m128 q = _mm_add_ps(_mm_mul_ps(xm, xm), _mm_mul_ps(ci, ci));
+        __m128 cardioid = _mm_and_ps(box, _mm_cmple_ps(_mm_mul_ps(q, _mm_add_ps(q, xm)),
+                                                       _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.25f), ci), ci)));
+        __m128 xb = _mm_add_ps(cr, _mm_set1_ps(1.0f));
+        __m128 bulb = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(xb, xb), _mm_mul_ps(ci, ci)), _mm_set1_ps(0.0625f));
+        __m128 interior = _mm_or_ps(cardioid, bulb);
+        active = _mm_andnot_ps(interior, active);
+#endif
+        __m128 x = _mm_setzero_ps(), y = _mm_setzero_ps();
+        for (int k = 0; k < cap; k++)
+        {
+            __m128 x2 = _mm_mul_ps(x, x), y2 = _mm_mul_ps(y, y);
+            active = _mm_and_ps(active, _mm_cmple_ps(_mm_add_ps(x2, y2), four));
+            if (_mm_movemask_ps(active) == 0)
+                break; // todas as pistas escaparam
+            __m128 xy = _mm_mul_ps(x, y);
+            x = _mm_add_ps(_mm_sub_ps(x2, y2), cr);
+            y = _mm_add_ps(_mm_add_ps(xy, xy), ci);
+            n = _mm_sub_epi32(n, _mm_castps_si128(active)); // máscara = -1
+        }
+
+        int32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, n);
+#if MANDELBROT_SHORTCUTS
+        int inside = _mm_movemask_ps(interior);
+#else
+        int inside = 0;
+#endif
+        for (int j = 0; j < 4 && i + j < count; j++)
+        {
+            counts[i + j] = (uint8_t)(inside >> j & 1 ? cap : lanes[j]);
+            work += inside >> j & 1 ? 0 : lanes[j];
+        }
+    }
+    return work;
+}
+
+__attribute__((target("avx2"))) static uint64_t row_avx2(float real_start, float step, int first, int count, float imag,
+                                                          int cap, uint8_t *counts)
+{
+    uint64_t work = 0;
+    const __m256 ci = _mm256_set1_ps(imag), four = _mm256_set1_ps(4.0f);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (int i = 0; i < count; i += 8)
+    {
+        __m256i index = _mm256_add_epi32(_mm256_set1_epi32(i), lane);
+        __m256 point = _mm256_cvtepi32_ps(_mm256_add_epi32(index, _mm256_set1_epi32(first)));
+        const __m256 cr = _mm256_add_ps(_mm256_set1_ps(real_start), _mm256_mul_ps(point, _mm256_set1_ps(step)));
+        __m256 active = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(count), index));
+        __m256i n = _mm256_setzero_si256();
+#if MANDELBROT_SHORTCUTS
+        __m256 box = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(cr, _mm256_set1_ps(-0.75f), _CMP_GT_OQ),
+                                                 _mm256_cmp_ps(cr, _mm256_set1_ps(0.375f), _CMP_LT_OQ)),
+                                   _mm256_and_ps(_mm256_cmp_ps(ci, _mm256_set1_ps(-0.66f), _CMP_GT_OQ),
+                                                 _mm256_cmp_ps(ci, _mm256_set1_ps(0.66f), _CMP_LT_OQ)));
+        __m256 xm = _mm256_sub_ps(cr, _mm256_set1_ps(0.25f));
+        __m256 q = _mm256_add_ps(_mm256_mul_ps(xm, xm), _mm256_mul_ps(ci, ci));
+        __m256 cardioid = _mm256_and_ps(box, _mm256_cmp_ps(_mm256_mul_ps(q, _mm256_add_ps(q, xm)),
+                                                           _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.25f), ci), ci),
+                                                           _CMP_LE_OQ));
+        __m256 xb = _mm256_add_ps(cr, _mm256_set1_ps(1.0f));
+        __m256 bulb = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(xb, xb), _mm256_mul_ps(ci, ci)),
+                                    _mm256_set1_ps(0.0625f), _CMP_LE_OQ);
+        __m256 interior = _mm256_or_ps(cardioid, bulb);
+        active = _mm256_andnot_ps(interior, active);
+#endif
+        __m256 x = _mm256_setzero_ps(), y = _mm256_setzero_ps();
+        for (int k = 0; k < cap; k++)
+        {
+            __m256 x2 = _mm256_mul_ps(x, x), y2 = _mm256_mul_ps(y, y);
+            active = _mm256_and_ps(active, _mm256_cmp_ps(_mm256_add_ps(x2, y2), four, _CMP_LE_OQ));
+            if (_mm256_movemask_ps(active) == 0)
+                break;
+            __m256 xy = _mm256_mul_ps(x, y);
+            x = _mm256_add_ps(_mm256_sub_ps(x2, y2), cr);
+            y = _mm256_add_ps(_mm256_add_ps(xy, xy), ci);
+            n = _mm256_sub_epi32(n, _mm256_castps_si256(active));
+        }
+
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i *)lanes, n);
+#if MANDELBROT_SHORTCUTS
+        int inside = _mm256_movemask_ps(interior);
+#else
+        int inside = 0;
+#endif
+        for (int j = 0; j < 8 && i + j < count; j++)
+        {
+            counts[i + j] = (uint8_t)(inside >> j & 1 ? cap : lanes[j]);
+            work += inside >> j & 1 ? 0 : lanes[j];
+        }
+    }
+    return work;
+}
+
+#endif
+
+#if KERNEL_SIMD_ARM
+
+static uint64_t row_neon(float real_start, float step, int first, int count, float imag, int cap, uint8_t *counts)
+{
+    uint64_t work = 0;
+    const float32x4_t ci = vdupq_n_f32(imag), four = vdupq_n_f32(4.0f);
+    const int32_t lane_init[4] = {0, 1, 2, 3};
+    const int32x4_t lane = vld1q_s32(lane_init);
+    for (int i = 0; i < count; i += 4)
+    {
+        int32x4_t index = vaddq_s32(vdupq_n_s32(i), lane);
+        // vmulq + vaddq separados: sem FMA, como na referência escalar
+        float32x4_t point = vcvtq_f32_s32(vaddq_s32(index, vdupq_n_s32(first)));
+        const float32x4_t cr = vaddq_f32(vdupq_n_f32(real_start), vmulq_f32(point, vdupq_n_f32(step)));
+        uint32x4_t active = vcltq_s32(index, vdupq_n_s32(count));
+        uint32x4_t n = vdupq_n_u32(0);
+#if MANDELBROT_SHORTCUTS
+        uint32x4_t box = vandq_u32(vandq_u32(vcgtq_f32(cr, vdupq_n_f32(-0.75f)), vcltq_f32(cr, vdupq_n_f32(0.375f))),
+                                   vandq_u32(vcgtq_f32(ci, vdupq_n_f32(-0.66f)), vcltq_f32(ci, vdupq_n_f32(0.66f))));
+        float32x4_t xm = vsubq_f32(cr, vdupq_n_f32(0.25f));
+        float32x4_t q = vaddq_f32(vmulq_f32(xm, xm), vmulq_f32(ci, ci));
+        uint32x4_t cardioid = vandq_u32(box, vcleq_f32(vmulq_f32(q, vaddq_f32(q, xm)),
+                                                       vmulq_f32(vmulq_f32(vdupq_n_f32(0.25f), ci), ci)));
+        float32x4_t xb = vaddq_f32(cr, vdupq_n_f32(1.0f));
+        uint32x4_t bulb = vcleq_f32(vaddq_f32(vmulq_f32(xb, xb), vmulq_f32(ci, ci)), vdupq_n_f32(0.0625f));
+        uint32x4_t interior = vorrq_u32(cardioid, bulb);
+        active = vbicq_u32(active, interior);
+#else
+        uint32x4_t interior = vdupq_n_u32(0);
+#endif
+        float32x4_t x = vdupq_n_f32(0), y = vdupq_n_f32(0);
+        for (int k = 0; k < cap; k++)
+        {
+            float32x4_t x2 = vmulq_f32(x, x), y2 = vmulq_f32(y, y);
+            active = vandq_u32(active, vcleq_f32(vaddq_f32(x2, y2), four));
+            if (vmaxvq_u32(active) == 0)
+                break;
+            float32x4_t xy = vmulq_f32(x, y);
+            x = vaddq_f32(vsubq_f32(x2, y2), cr);
+            y = vaddq_f32(vaddq_f32(xy, xy), ci);
+            n = vsubq_u32(n, active);
+        }
+
+        uint32_t lanes[4], inside[4];
+        vst1q_u32(lanes, n);
+        vst1q_u32(inside, interior);
+        for (int j = 0; j < 4 && i + j < count; j++)
+        {
+            counts[i + j] = (uint8_t)(inside[j] ? cap : lanes[j]);
+            work += inside[j] ? 0 : lanes[j];
+        }
+    }
+    return work;
+}
+
+#endif
+
+/*!
+ * @brief Retorna o nível mais largo suportado pela CPU.
+ */
+kernel_simd_level_t kernel_simd_detect()
+{
+    for (int level = KERNEL_SIMD_COUNT - 1; level > KERNEL_SIMD_SCALAR; level--)
+        if (kernel_simd_supported(level))
+            return level;
+    return KERNEL_SIMD_SCALAR;
+}
+
+/*!
+ * @brief Informa se o nível foi compilado para esta arquitetura e é suportado pela CPU.
+ */
+bool kernel_simd_supported(kernel_simd_level_t level)
+{
+    switch (level)
+    {
+    case KERNEL_SIMD_SCALAR:
+        return true;
+#if KERNEL_SIMD_X86
+    case KERNEL_SIMD_SSE2:
+        return __builtin_cpu_supports("sse2");
+    case KERNEL_SIMD_AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+#if KERNEL_SIMD_ARM
+    case KERNEL_SIMD_NEON:
+        return true; // obrigatório em AArch64
+#endif
+    default:
+        return false;
+    }
+}
+
+/*!
+ * @brief Nome do nível, como aceito por `mandelbrot_render --kernel`.
+ */
+const char *kernel_simd_name(kernel_simd_level_t level)
+{
+    static const char *const names[KERNEL_SIMD_COUNT] = {"scalar", "sse2", "avx2", "neon"};
+    return level >= 0 && level < KERNEL_SIMD_COUNT ? names[level] : "?";
+}
+
+/*!
+ * @brief Calcula as iterações de `count` pontos de uma linha.
+ *
+ * @param level Nível do kernel (deve ser suportado; ver `kernel_simd_supported()`).
+ * @param real_start Parte real do ponto de índice 0 da linha.
+ * @param step Distância entre os pontos: o ponto i é `real_start + (first + i) * step`, como em
+ *             `draw_mandelbrot_block()`.
+ * @param first Índice do primeiro ponto na linha da imagem.
+ * @param count Pontos calculados.
+ * @param imag Parte imaginária da linha.
+ * @param cap Limite de iterações (até `MANDELBROT_ITER_LIMIT`).
+ * @param counts Recebe as iterações de cada ponto (`cap` = no conjunto).
+ *
+ * @return uint64_t Iterações úteis: a soma das iterações dos pontos que não foram resolvidos pelos atalhos.
+ */
+uint64_t kernel_simd_row(kernel_simd_level_t level, float real_start, float step, int first, int count, float imag,
+                         int cap, uint8_t *counts)
+{
+    switch (level)
+    {
+#if KERNEL_SIMD_X86
+    case KERNEL_SIMD_SSE2:
+        return row_sse2(real_start, step, first, count, imag, cap, counts);
+    case KERNEL_SIMD_AVX2:
+        return row_avx2(real_start, step, first, count, imag, cap, counts);
+#endif
+#if KERNEL_SIMD_ARM
+    case KERNEL_SIMD_NEON:
+        return row_neon(real_start, step, first, count, imag, cap, counts);
+#endif
+    default:
+        return row_scalar(real_start, step, first, count, imag, cap, counts);
+    }
+}
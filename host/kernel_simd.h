@@ -0,0 +1,44 @@
+/*!
+ * @file kernel_simd.h
+ * @brief Kernel de escape vetorizado do build nativo (SSE2, AVX2, NEON), escolhido em tempo de execução.
+ *
+ * Cada grupo de 4 ou 8 pontos de uma linha itera junto: os pontos que escapam são mascarados e o grupo só
+ * termina quando todos escaparam ou atingiram o limite. Todos os níveis, inclusive o escalar, executam as mesmas
+ * operações IEEE em float, na mesma ordem e sem FMA, e produzem as mesmas iterações bit a bit.
+ *
+ * Política de tolerância em relação a `mandelbrot_ex()` (kernel `float complex` de referência): a órbita é a mesma,
+ * mas o teste de escape é |z|^2 > 4 em vez de `cabsf(z) > 2`, que arredonda de outra forma quando |z| está a poucos
+ * ulps de 2. Um ponto pode então divergir da referência; o benchmark exige no máximo
+ * `KERNEL_SIMD_TOLERANCE_PPM` pontos por milhão diferentes no catálogo de janelas.
+ */
+
+ #ifndef _KERNEL_SIMD_
+ #define _KERNEL_SIMD_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+
+ /*! @brief Máximo de pontos por milhão com iterações diferentes de `mandelbrot_ex()`. */
+ #define KERNEL_SIMD_TOLERANCE_PPM 10
+
+ /*!
+  * @brief Níveis do kernel; `KERNEL_SIMD_SCALAR` é a referência dos demais.
+  */
+ typedef enum {
+     KERNEL_SIMD_SCALAR,
+     KERNEL_SIMD_SSE2, /*!< 4 pontos por grupo (x86-64). */
+     KERNEL_SIMD_AVX2, /*!< 8 pontos por grupo (x86-64 com AVX2). */
+     KERNEL_SIMD_NEON, /*!< 4 pontos por grupo (AArch64). */
+     KERNEL_SIMD_COUNT
+ } kernel_simd_level_t;
+
+ kernel_simd_level_t kernel_simd_detect();
+
+ bool kernel_simd_supported(kernel_simd_level_t level);
+
+ const char *kernel_simd_name(kernel_simd_level_t level);
+
+ uint64_t kernel_simd_row(kernel_simd_level_t level, float real_start, float step, int first, int count, float imag,
+                          int cap, uint8_t *counts);
+
+ #endif
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+#include "pbm.h"
+
+/*!
+ * @brief Grava uma imagem de 1 bit no formato PBM binário (P4).
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser escrito.
+ */
+int pbm_write(const char *path, int width, int height, const uint8_t *rows)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+
+    size_t len = (size_t)PBM_ROW_BYTES(width) * height;
+    fprintf(f, "P4\n%d %d\n", width, height);
+    int ok = fwrite(rows, 1, len, f) == len;
+    return (fclose(f) == 0 && ok) ? 0 : -1;
+}
+
+/*!
+ * @brief Lê uma imagem PBM binária (P4) com as dimensões esperadas.
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não existir, estiver truncado ou tiver outras dimensões.
+ */
+int pbm_read(const char *path, int width, int height, uint8_t *rows)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+        return -1;
+
+    int w, h;
+    int ok = fscanf(f, "P4 %d %d", &w, &h) == 2 && w == width && h == height && fgetc(f) != EOF;
+    size_t len = (size_t)PBM_ROW_BYTES(width) * height;
+    ok = ok && fread(rows, 1, len, f) == len;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+/*!
+ * @brief Grava uma imagem em tons de cinza de 8 bits no formato PGM binário (P5).
+ *
+ * @return 0 em caso de sucesso, -1 se o arquivo não puder ser escrito.
+ */
+int pgm_write(const char *path, int width, int height, const uint8_t *pixels)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+
+    size_t len = (size_t)width * height;
+    fprintf(f, "P5\n%d %d\n255\n", width, height);
+    int ok = fwrite(pixels, 1, len, f) == len;
+    return (fclose(f) == 0 && ok) ? 0 : -1;
+}
+
+/*!
+ * @brief Converte o buffer do display (páginas de 8 linhas, bit 0 no topo) para linhas de 1 bit.
+ *
+ * @param buf  Buffer do display (`SSD1306_WIDTH` x `SSD1306_HEIGHT`).
+ * @param rows Destino com `PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT` bytes.
+ */
+void pbm_from_framebuffer(const uint8_t *buf, uint8_t *rows)
+{
+    memset(rows, 0, PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT);
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            if (buf[(y / 8) * SSD1306_WIDTH + x] & (1 << (y % 8)))
+                rows[y * PBM_ROW_BYTES(SSD1306_WIDTH) + x / 8] |= 0x80 >> (x % 8);
+}
@@ -0,0 +1,25 @@
+/*!
+ * @file pbm.h
+ * @brief Leitura e escrita de imagens PBM (P4) e PGM (P5) para as ferramentas do build nativo.
+ *
+ * As imagens de 1 bit são armazenadas linha a linha, 8 pixels por byte com o bit mais significativo à
+ * esquerda (formato nativo do P4). Pixels do conjunto são gravados como 1 (preto).
+ */
+
+ #ifndef _PBM_
+ #define _PBM_
+
+ #include <stdint.h>
+
+ /*! @brief Bytes por linha de uma imagem de 1 bit com a largura informada. */
+ #define PBM_ROW_BYTES(width) (((width) + 7) / 8)
+
+ int pbm_write(const char *path, int width, int height, const uint8_t *rows);
+
+ int pbm_read(const char *path, int width, int height, uint8_t *rows);
+
+ int pgm_write(const char *path, int width, int height, const uint8_t *pixels);
+
+ void pbm_from_framebuffer(const uint8_t *buf, uint8_t *rows);
+
+ #endif
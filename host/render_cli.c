@@ -0,0 +1,240 @@
+/*!
+ * @file render_cli.c
+ * @brief Renderização em alta resolução, no Linux, de uma janela vista na placa.
+ *
+ * A janela é dada pelos quatro limites de `render_data_t` (aceitam ponto flutuante hexadecimal, como impresso
+ * pela própria ferramenta, para reproduzir a janela exata) ou lida da sessão gravada na flash (cópia da região
+ * do armazenamento persistente, flash_store.h). A imagem é gravada em PBM (conjunto em preto) ou PGM (tons de
+ * cinza pelo número de iterações), conforme a extensão do arquivo de saída. `--kernel` troca o kernel do firmware
+ * pelo kernel vetorizado em float (kernel_simd.h): `auto` escolhe o nível mais largo suportado pela CPU.
+ *
+ * Uso: mandelbrot_render [--view RE0 RE1 IM0 IM1 | --session ARQUIVO] [--size LxA] [--threads N] [--iter N]
+ *                        [--kernel device|auto|scalar|sse2|avx2|neon] [--scaling] [--check]
+ *                        [-o ARQUIVO.pbm|ARQUIVO.pgm]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ssd1306.h"
+#include "viewport.h"
+#include "zoom_history.h"
+#include "flash_store.h"
+#include "flash_file.h"
+#include "render_tiles.h"
+#include "pbm.h"
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "uso: %s [--view RE0 RE1 IM0 IM1 | --session ARQUIVO] [--size LxA] [--threads N] [--iter N]\n"
+            "          [--kernel device|auto|scalar|sse2|avx2|neon] [--scaling] [--check] [-o ARQUIVO.pbm|ARQUIVO.pgm]\n",
+            name);
+}
+
+/*!
+ * @brief Converte o nome do kernel em `RENDER_TILES_DEVICE_KERNEL` ou em um nível suportado; -2 se inválido.
+ */
+static int parse_kernel(const char *name)
+{
+    if (strcmp(name, "device") == 0)
+        return RENDER_TILES_DEVICE_KERNEL;
+    if (strcmp(name, "auto") == 0)
+        return kernel_simd_detect();
+    for (int level = 0; level < KERNEL_SIMD_COUNT; level++)
+        if (strcmp(name, kernel_simd_name(level)) == 0)
+            return kernel_simd_supported(level) ? level : -2;
+    return -2;
+}
+
+/*!
+ * @brief Lê a janela da sessão gravada em uma cópia da região do armazenamento persistente.
+ */
+static int load_session(const char *path, render_data_t *view)
+{
+    FILE *f = fopen(path, "rb"); // flash_file_open() criaria um arquivo inexistente
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fclose(f);
+
+    static flash_store_t store;
+    static zoom_history_t history;
+    render_data_t home_view = VIEWPORT_HOME;
+    zoom_state_t state = {view : home_view};
+#if MANDELBROT_DEEP_ZOOM
+    deep_view_from_render_data(&state.deep, &state.view);
+#endif
+    zoom_history_init(&history, &state);
+
+    flash_file_open(path);
+    flash_store_open(&store, &flash_file_backend);
+    bool ok = flash_store_load_session(&store, &history, &state);
+    flash_file_close();
+    if (!ok)
+    {
+        fprintf(stderr, "%s: nenhuma sessão válida\n", path);
+        return -1;
+    }
+#if MANDELBROT_DEEP_ZOOM
+    if (deep_view_needs_perturbation(&state.deep))
+        fprintf(stderr, "aviso: janela abaixo da resolução do kernel; renderizada pela aproximação em float\n");
+#endif
+    printf("sessao: %d ampliacoes\n", zoom_history_depth(&history));
+    *view = state.view;
+    return 0;
+}
+
+/*!
+ * @brief Compara a renderização em 128 x 64 com o frame da placa (draw_mandelbrot_block()).
+ */
+static int check_device(const render_data_t *view, int threads)
+{
+    static uint8_t counts[SSD1306_WIDTH * SSD1306_HEIGHT];
+    static uint8_t buf[SSD1306_BUF_LEN];
+    uint8_t tiles_rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    uint8_t device_rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+    render_tiles_stats_t stats;
+
+    if (render_tiles(view, SSD1306_WIDTH, SSD1306_HEIGHT, threads, counts, &stats) != 0)
+        return -1;
+    render_tiles_to_pbm(counts, SSD1306_WIDTH, SSD1306_HEIGHT, tiles_rows);
+    draw_mandelbrot_block(buf, view, 0, SSD1306_WIDTH, 0, SSD1306_NUM_PAGES, 0, NULL);
+    pbm_from_framebuffer(buf, device_rows);
+
+    int diff = 0;
+    for (size_t i = 0; i < sizeof(tiles_rows); i++)
+        diff += __builtin_popcount(tiles_rows[i] ^ device_rows[i]);
+    printf("128x64 com %d threads: %d pixels diferentes do frame da placa\n", threads, diff);
+    return diff == 0 ? 0 : -1;
+}
+
+/*!
+ * @brief Mede o tempo com 1, 2, 4, ... threads até `threads` e relata aceleração e eficiência.
+ */
+static void report_scaling(const render_data_t *view, int width, int height, int threads, uint8_t *counts)
+{
+    printf("%8s %10s %10s %10s %8s %12s\n", "threads", "tempo(ms)", "aceleracao", "eficiencia", "roubos", "tiles min-max");
+    double base = 0;
+    for (int n = 1; n <= threads; n = n < threads && n * 2 > threads ? threads : n * 2)
+    {
+        render_tiles_stats_t stats;
+        if (render_tiles(view, width, height, n, counts, &stats) != 0)
+            break;
+        if (n == 1)
+            base = stats.seconds;
+        uint32_t lo = UINT32_MAX, hi = 0;
+        for (int i = 0; i < n; i++)
+        {
+            lo = MIN(lo, stats.done[i]);
+            hi = MAX(hi, stats.done[i]);
+        }
+        double speedup = base / stats.seconds;
+        printf("%8d %10.1f %10.2f %9.0f%% %8u %6u-%-5u\n", n, stats.seconds * 1e3, speedup, 100.0 * speedup / n,
+               stats.steals, lo, hi);
+        if (n == threads)
+            break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    render_data_t view = VIEWPORT_HOME;
+    int width = SSD1306_WIDTH, height = SSD1306_HEIGHT;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    const char *output = NULL, *session = NULL;
+    bool scaling = false, check = false;
+    int kernel = RENDER_TILES_DEVICE_KERNEL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--view") == 0 && i + 4 < argc)
+        {
+            view.real_start = strtof(argv[++i], NULL);
+            view.real_end = strtof(argv[++i], NULL);
+            view.im_start = strtof(argv[++i], NULL);
+            view.im_end = strtof(argv[++i], NULL);
+        }
+        else if (strcmp(argv[i], "--session") == 0 && i + 1 < argc)
+            session = argv[++i];
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc && sscanf(argv[i + 1], "%dx%d", &width, &height) == 2)
+            i++;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--iter") == 0 && i + 1 < argc)
+            mandelbrot_set_max_iter(atoi(argv[++i]));
+        else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc && (kernel = parse_kernel(argv[i + 1])) != -2)
+            i++;
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+        else if (strcmp(argv[i], "--check") == 0)
+            check = true;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    threads = MAX(1, MIN(threads, RENDER_TILES_MAX_THREADS));
+    if (width <= 0 || height <= 0 || (session && load_session(session, &view) != 0))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    render_tiles_set_kernel(kernel);
+    printf("janela %a %a %a %a, %dx%d, limite %d, %d threads, kernel %s\n", view.real_start, view.real_end,
+           view.im_start, view.im_end, width, height, mandelbrot_get_max_iter(), threads,
+           kernel == RENDER_TILES_DEVICE_KERNEL ? "device" : kernel_simd_name(kernel));
+
+    int result = 0;
+    if (check && check_device(&view, threads) != 0)
+        result = 1;
+
+    uint8_t *counts = malloc((size_t)width * height);
+    if (counts == NULL)
+    {
+        fprintf(stderr, "imagem grande demais\n");
+        return 1;
+    }
+
+    if (scaling)
+        report_scaling(&view, width, height, threads, counts);
+
+    if (output)
+    {
+        render_tiles_stats_t stats;
+        render_tiles(&view, width, height, threads, counts, &stats);
+        printf("%u tiles em %.1f ms, %llu iteracoes, %u roubos\n", stats.tiles, stats.seconds * 1e3,
+               (unsigned long long)stats.kernel.iterations, stats.steals);
+
+        size_t len = strlen(output);
+        bool gray = len > 4 && strcmp(output + len - 4, ".pgm") == 0;
+        uint8_t *image = malloc(gray ? (size_t)width * height : (size_t)PBM_ROW_BYTES(width) * height);
+        int written = -1;
+        if (image && gray)
+        {
+            render_tiles_to_pgm(counts, width, height, image);
+            written = pgm_write(output, width, height, image);
+        }
+        else if (image)
+        {
+            render_tiles_to_pbm(counts, width, height, image);
+            written = pbm_write(output, width, height, image);
+        }
+        free(image);
+        if (written != 0)
+        {
+            perror(output);
+            result = 1;
+        }
+    }
+
+    free(counts);
+    return result;
+}
@@ -0,0 +1,36 @@
+#include <pthread.h>
+#include "render_platform.h"
+
+// implementação Linux de render_platform.h: o segundo trabalhador é uma thread POSIX
+
+static pthread_t worker_thread;
+static render_worker_fn worker_fn;
+static void *worker_arg;
+
+static void *worker_entry(void *unused)
+{
+    (void)unused;
+    worker_fn(worker_arg);
+    return NULL;
+}
+
+void render_platform_init()
+{
+}
+
+void render_platform_start_worker(render_worker_fn fn, void *arg)
+{
+    worker_fn = fn;
+    worker_arg = arg;
+    pthread_create(&worker_thread, NULL, worker_entry, NULL);
+}
+
+void render_platform_wait_worker()
+{
+    pthread_join(worker_thread, NULL);
+}
+
+uint32_t render_platform_fetch_add(volatile uint32_t *counter)
+{
+    return __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+}
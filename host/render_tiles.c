@@ -0,0 +1,224 @@
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "render_tiles.h"
+#include "pbm.h"
+
+/*!
+ * @brief Fila de tiles de uma thread: faixa [top, bottom) empacotada em 64 bits, alterada por CAS.
+ *
+ * A dona retira da base (bottom - 1); os ladrões retiram a metade superior (a partir de top). Como todas as
+ * alterações são CAS sobre a palavra inteira, nunca dois consumidores obtêm o mesmo tile.
+ */
+typedef struct {
+    uint64_t range;
+    char pad[64 - sizeof(uint64_t)]; // uma fila por linha de cache
+} tile_deque_t;
+
+typedef struct {
+    const render_data_t *view;
+    int width, height, cols;
+    int threads;
+    uint8_t *counts;
+    tile_deque_t deques[RENDER_TILES_MAX_THREADS];
+    uint32_t steals;
+    render_tiles_stats_t *stats;
+    pthread_mutex_t stats_lock;
+} tile_job_t;
+
+static int tile_kernel = RENDER_TILES_DEVICE_KERNEL; // ver render_tiles_set_kernel()
+
+typedef struct {
+    tile_job_t *job;
+    int id;
+} tile_worker_t;
+
+#define PACK(top, bottom) (((uint64_t)(top) << 32) | (uint32_t)(bottom))
+#define TOP(range) ((uint32_t)((range) >> 32))
+#define BOTTOM(range) ((uint32_t)(range))
+
+// retira um tile da base da própria fila; -1 se vazia
+static int64_t pop_bottom(tile_deque_t *deque)
+{
+    uint64_t range = __atomic_load_n(&deque->range, __ATOMIC_ACQUIRE);
+    while (TOP(range) < BOTTOM(range))
+    {
+        if (__atomic_compare_exchange_n(&deque->range, &range, PACK(TOP(range), BOTTOM(range) - 1), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+            return BOTTOM(range) - 1;
+    }
+    return -1;
+}
+
+// rouba a metade superior da fila da vítima para a fila (vazia) do ladrão; retorna o primeiro tile ou -1
+static int64_t steal_half(tile_deque_t *victim, tile_deque_t *thief)
+{
+    uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+    while (TOP(range) < BOTTOM(range))
+    {
+        uint32_t top = TOP(range), take = (BOTTOM(range) - top + 1) / 2;
+        if (__atomic_compare_exchange_n(&victim->range, &range, PACK(top + take, BOTTOM(range)), false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+            __atomic_store_n(&thief->range, PACK(top + 1, top + take), __ATOMIC_RELEASE);
+            return top;
+        }
+    }
+    return -1;
+}
+
+static void render_tile(tile_job_t *job, int tile, mandelbrot_stats_t *stats)
+{
+    const render_data_t *view = job->view;
+    // mesmas operações de draw_mandelbrot_block(), com a largura e a altura da imagem
+    float stepX = (view->real_end - view->real_start) / job->width;
+    float stepY = (view->im_end - view->im_start) / job->height;
+
+    int x0 = (tile % job->cols) * RENDER_TILES_SIZE, y0 = (tile / job->cols) * RENDER_TILES_SIZE;
+    int x1 = MIN(x0 + RENDER_TILES_SIZE, job->width), y1 = MIN(y0 + RENDER_TILES_SIZE, job->height);
+    int cap = mandelbrot_get_max_iter();
+    for (int y = y0; y < y1; y++)
+    {
+        float imag = view->im_start + y * stepY;
+        if (tile_kernel != RENDER_TILES_DEVICE_KERNEL)
+        {
+            stats->iterations += kernel_simd_row(tile_kernel, view->real_start, stepX, x0, x1 - x0, imag, cap,
+                                                 &job->counts[(size_t)y * job->width + x0]);
+            stats->evaluated += x1 - x0;
+            continue;
+        }
+        for (int x = x0; x < x1; x++)
+        {
+            float real = view->real_start + x * stepX;
+            job->counts[(size_t)y * job->width + x] = (uint8_t)mandelbrot_point(real, imag, stats, NULL);
+        }
+    }
+}
+
+static void *tile_worker(void *arg)
+{
+    tile_worker_t *worker = arg;
+    tile_job_t *job = worker->job;
+    tile_deque_t *own = &job->deques[worker->id];
+    mandelbrot_stats_t local = {0};
+    uint32_t done = 0, steals = 0;
+
+    while (true)
+    {
+        int64_t tile = pop_bottom(own);
+        for (int i = 1; tile < 0 && i < job->threads; i++)
+        {
+            tile = steal_half(&job->deques[(worker->id + i) % job->threads], own);
+            steals += tile >= 0;
+        }
+        if (tile < 0)
+            break; // nenhuma fila com tiles: como não surgem tiles novos, o trabalho restante já tem dono
+        render_tile(job, (int)tile, &local);
+        done++;
+    }
+
+    pthread_mutex_lock(&job->stats_lock);
+    mandelbrot_stats_add(&job->stats->kernel, &local);
+    job->stats->done[worker->id] = done;
+    job->stats->steals += steals;
+    pthread_mutex_unlock(&job->stats_lock);
+    return NULL;
+}
+
+/*!
+ * @brief Renderiza a janela em uma imagem de `width` x `height` pixels.
+ *
+ * @param view Janela do plano complexo.
+ * @param width Largura da imagem.
+ * @param height Altura da imagem.
+ * @param threads Threads (1 a `RENDER_TILES_MAX_THREADS`).
+ * @param counts Recebe as iterações de cada pixel, linha a linha (`mandelbrot_get_max_iter()` = no conjunto).
+ * @param stats Recebe o tempo, a distribuição dos tiles e as estatísticas do kernel.
+ *
+ * @return int 0 em caso de sucesso, -1 se os parâmetros são inválidos ou uma thread não pôde ser criada.
+ */
+int render_tiles(const render_data_t *view, int width, int height, int threads, uint8_t *counts,
+                 render_tiles_stats_t *stats)
+{
+    if (width <= 0 || height <= 0 || threads < 1 || threads > RENDER_TILES_MAX_THREADS)
+        return -1;
+
+    static tile_job_t job;
+    memset(&job, 0, sizeof(job));
+    memset(stats, 0, sizeof(*stats));
+    job.view = view;
+    job.width = width;
+    job.height = height;
+    job.cols = (width + RENDER_TILES_SIZE - 1) / RENDER_TILES_SIZE;
+    job.threads = threads;
+    job.counts = counts;
+    job.stats = stats;
+    pthread_mutex_init(&job.stats_lock, NULL);
+
+    // faixas contíguas de tiles (linhas de tiles vizinhas têm custo parecido; o roubo corrige o restante)
+    uint32_t tiles = job.cols * ((height + RENDER_TILES_SIZE - 1) / RENDER_TILES_SIZE);
+    for (int i = 0; i < threads; i++)
+        job.deques[i].range = PACK(tiles * i / threads, tiles * (i + 1) / threads);
+    stats->tiles = tiles;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    pthread_t handles[RENDER_TILES_MAX_THREADS];
+    tile_worker_t workers[RENDER_TILES_MAX_THREADS];
+    int started = 0, result = 0;
+    for (int i = 1; i < threads; i++, started++)
+    {
+        workers[i] = (tile_worker_t){&job, i};
+        if (pthread_create(&handles[i], NULL, tile_worker, &workers[i]) != 0)
+        {
+            result = -1; // as threads já criadas e a thread atual calculam todos os tiles
+            break;
+        }
+    }
+    workers[0] = (tile_worker_t){&job, 0};
+    tile_worker(&workers[0]);
+    for (int i = 1; i <= started; i++)
+        pthread_join(handles[i], NULL);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    stats->seconds = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    pthread_mutex_destroy(&job.stats_lock);
+    return result;
+}
+
+/*!
+ * @brief Seleciona o kernel das próximas renderizações.
+ *
+ * @param kernel `RENDER_TILES_DEVICE_KERNEL` (padrão) ou um nível suportado de `kernel_simd_level_t`.
+ *
+ * @note O kernel vetorizado itera em float; com `MANDELBROT_FIXED_POINT`, a placa itera em Q3.28 e alguns pixels
+ *       da borda podem diferir do frame da placa. Só `evaluated` e `iterations` são somados às estatísticas.
+ */
+void render_tiles_set_kernel(int kernel)
+{
+    tile_kernel = kernel;
+}
+
+/*!
+ * @brief Converte as iterações em uma imagem de 1 bit (pixels do conjunto em 1, como em pbm.h).
+ */
+void render_tiles_to_pbm(const uint8_t *counts, int width, int height, uint8_t *rows)
+{
+    int cap = mandelbrot_get_max_iter();
+    memset(rows, 0, (size_t)PBM_ROW_BYTES(width) * height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            if (counts[(size_t)y * width + x] == cap)
+                rows[(size_t)y * PBM_ROW_BYTES(width) + x / 8] |= 0x80 >> (x % 8);
+}
+
+/*!
+ * @brief Converte as iterações em tons de cinza: conjunto em preto, pontos que escapam mais tarde mais escuros.
+ */
+void render_tiles_to_pgm(const uint8_t *counts, int width, int height, uint8_t *pixels)
+{
+    int cap = mandelbrot_get_max_iter();
+    for (size_t i = 0; i < (size_t)width * height; i++)
+        pixels[i] = counts[i] == cap ? 0 : (uint8_t)(255 - counts[i] * 255 / cap);
+}
@@ -0,0 +1,50 @@
+/*!
+ * @file render_tiles.h
+ * @brief Renderização em resolução arbitrária no build nativo, dividida em tiles entre várias threads.
+ *
+ * Cada thread recebe uma faixa contígua de tiles em uma fila própria: consome da base e, quando a sua fila
+ * esvazia, rouba a metade superior da fila de outra thread. O pixel (x, y) de uma imagem de W x H é avaliado
+ * no ponto (real_start + x * (real_end - real_start) / W, im_start + y * (im_end - im_start) / H), com as
+ * mesmas operações em float de `draw_mandelbrot_block()`: em 128 x 64, a imagem é idêntica ao frame da placa.
+ *
+ * Por padrão os pixels são calculados por `mandelbrot_point()`, o kernel do firmware; `render_tiles_set_kernel()`
+ * troca para o kernel vetorizado em float de kernel_simd.h.
+ */
+
+ #ifndef _RENDER_TILES_
+ #define _RENDER_TILES_
+
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "kernel_simd.h"
+
+ /*! @brief Lado dos tiles, em pixels. */
+ #define RENDER_TILES_SIZE 32
+
+ /*! @brief Máximo de threads. */
+ #define RENDER_TILES_MAX_THREADS 64
+
+ /*! @brief Seleciona, em `render_tiles_set_kernel()`, o kernel do firmware (`mandelbrot_point()`). */
+ #define RENDER_TILES_DEVICE_KERNEL -1
+
+ /*!
+  * @brief Resultado de uma renderização.
+  */
+ typedef struct {
+     double seconds;                                 /*!< Tempo total. */
+     uint32_t tiles;                                 /*!< Tiles da imagem. */
+     uint32_t steals;                                /*!< Roubos bem-sucedidos. */
+     uint32_t done[RENDER_TILES_MAX_THREADS];        /*!< Tiles calculados por thread. */
+     mandelbrot_stats_t kernel;                      /*!< Estatísticas do kernel (somadas entre as threads). */
+ } render_tiles_stats_t;
+
+ int render_tiles(const render_data_t *view, int width, int height, int threads, uint8_t *counts,
+                  render_tiles_stats_t *stats);
+
+ void render_tiles_set_kernel(int kernel);
+
+ void render_tiles_to_pbm(const uint8_t *counts, int width, int height, uint8_t *rows);
+
+ void render_tiles_to_pgm(const uint8_t *counts, int width, int height, uint8_t *pixels);
+
+ #endif
@@ -0,0 +1,163 @@
+#include <time.h>
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "hal_host.h"
+
+static hal_host_i2c_stats_t i2c_stats;
+
+// estado do display emulado: memória de imagem e janela de endereçamento horizontal
+static uint8_t panel_ram[SSD1306_FRAME_LEN];
+static uint8_t col_start = 0, col_end = SSD1306_WIDTH - 1, page_start = 0, page_end = SSD1306_NUM_PAGES - 1;
+static uint8_t col = 0, page = 0;
+static uint8_t cmd = 0;      // comando aguardando argumentos
+static int cmd_args = 0;     // argumentos recebidos do comando atual
+static int cmd_expected = 0; // argumentos esperados do comando atual
+
+/*!
+ * @brief Número de bytes de argumento de um comando do SSD1306.
+ */
+static int command_arg_count(uint8_t c)
+{
+    switch (c)
+    {
+    case SSD1306_SET_COL_ADDR:
+    case SSD1306_SET_PAGE_ADDR:
+        return 2;
+    case SSD1306_SET_MEM_MODE:
+    case SSD1306_SET_CONTRAST:
+    case SSD1306_SET_CHARGE_PUMP:
+    case SSD1306_SET_MUX_RATIO:
+    case SSD1306_SET_DISP_OFFSET:
+    case SSD1306_SET_DISP_CLK_DIV:
+    case SSD1306_SET_PRECHARGE:
+    case SSD1306_SET_COM_PIN_CFG:
+    case SSD1306_SET_VCOM_DESEL:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/*!
+ * @brief Interpreta um byte de comando (ou argumento de comando) recebido pelo display emulado.
+ */
+static void panel_command(uint8_t byte)
+{
+    if (cmd_expected == 0)
+    {
+        cmd = byte;
+        cmd_args = 0;
+        cmd_expected = command_arg_count(byte);
+        return;
+    }
+
+    if (cmd == SSD1306_SET_COL_ADDR)
+    {
+        if (cmd_args == 0)
+            col_start = col = byte;
+        else
+            col_end = byte;
+    }
+    else if (cmd == SSD1306_SET_PAGE_ADDR)
+    {
+        if (cmd_args == 0)
+            page_start = page = byte;
+        else
+            page_end = byte;
+    }
+    cmd_args++;
+    if (cmd_args == cmd_expected)
+        cmd_expected = 0;
+}
+
+/*!
+ * @brief Grava um byte de imagem na posição atual e avança no modo de endereçamento horizontal.
+ */
+static void panel_data(uint8_t byte)
+{
+    panel_ram[page * SSD1306_WIDTH + col] = byte;
+    if (col++ == col_end)
+    {
+        col = col_start;
+        page = (page == page_end) ? page_start : page + 1;
+    }
+}
+
+i2c_inst_t *i2c1 = NULL;
+
+/*!
+ * @brief Escrita I2C simulada: contabiliza os bytes e as transações e as aplica ao display emulado.
+ *
+ * @details
+ *  - Cada byte de controle do SSD1306 define, pelo bit D/C (0x40), se o byte seguinte é comando ou dado.
+ *  - Com Co = 1 (0x80) apenas um byte segue antes do próximo byte de controle; com Co = 0 todos os
+ *    bytes restantes da transação seguem o mesmo bit D/C.
+ */
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)i2c;
+    (void)nostop;
+    i2c_stats.bytes += len;
+    i2c_stats.transactions++;
+
+    if (addr != SSD1306_I2C_ADDR)
+        return (int)len;
+
+    size_t i = 0;
+    while (i < len)
+    {
+        uint8_t control = src[i++];
+        size_t end = (control & 0x80) ? MIN(i + 1, len) : len;
+        for (; i < end; i++)
+        {
+            if (control & 0x40)
+                panel_data(src[i]);
+            else
+                panel_command(src[i]);
+        }
+    }
+    return (int)len;
+}
+
+/*!
+ * @brief Conteúdo atual da memória de imagem do display emulado (`SSD1306_FRAME_LEN` bytes).
+ */
+const uint8_t *hal_host_panel()
+{
+    return panel_ram;
+}
+
+/*!
+ * @brief Zera os contadores de tráfego I2C.
+ */
+void hal_host_reset()
+{
+    i2c_stats.bytes = 0;
+    i2c_stats.transactions = 0;
+}
+
+/*!
+ * @brief Retorna o tráfego I2C registrado desde o último `hal_host_reset()`.
+ */
+hal_host_i2c_stats_t hal_host_i2c_stats()
+{
+    return i2c_stats;
+}
+
+/*!
+ * @brief Relógio monotônico em nanossegundos.
+ */
+uint64_t hal_host_time_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*!
+ * @brief Substituto de `time_us_64()` do Pico SDK.
+ */
+uint64_t time_us_64()
+{
+    return hal_host_time_ns() / 1000u;
+}
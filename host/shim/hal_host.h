@@ -0,0 +1,31 @@
+/*!
+ * @file hal_host.h
+ * @brief Contadores da camada de abstração de hardware do build nativo (Linux).
+ *
+ * As escritas I2C endereçadas ao SSD1306 são aplicadas a um display emulado, cuja memória de imagem
+ * pode ser comparada com o frame que deveria estar sendo exibido.
+ */
+
+ #ifndef _HAL_HOST_
+ #define _HAL_HOST_
+
+ #include <stddef.h>
+ #include <stdint.h>
+
+ /*!
+  * @brief Tráfego I2C registrado desde o último `hal_host_reset()`.
+  */
+ typedef struct {
+     size_t bytes;        /*!< Bytes escritos (incluindo bytes de controle). */
+     size_t transactions; /*!< Número de chamadas a `i2c_write_blocking()`. */
+ } hal_host_i2c_stats_t;
+
+ void hal_host_reset();
+
+ hal_host_i2c_stats_t hal_host_i2c_stats();
+
+ const uint8_t *hal_host_panel();
+
+ uint64_t hal_host_time_ns();
+
+ #endif
@@ -0,0 +1,19 @@
+/*!
+ * @file i2c.h
+ * @brief Substituto de hardware/i2c.h para o build nativo (Linux).
+ *
+ * As escritas I2C não acessam hardware: são contabilizadas por hal_host.c (ver hal_host.h).
+ */
+
+ #ifndef _HOST_HARDWARE_I2C_
+ #define _HOST_HARDWARE_I2C_
+
+ #include "pico/stdlib.h"
+
+ typedef struct i2c_inst i2c_inst_t;
+
+ extern i2c_inst_t *i2c1;
+
+ int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+
+ #endif
@@ -0,0 +1,17 @@
+/*!
+ * @file sync.h
+ * @brief Substituto de hardware/sync.h para o build nativo (Linux).
+ *
+ * O build nativo não tem interrupções: as seções críticas entre interrupção e laço principal são vazias.
+ */
+
+ #ifndef _HOST_HARDWARE_SYNC_
+ #define _HOST_HARDWARE_SYNC_
+
+ #include "pico/stdlib.h"
+
+ static inline uint32_t save_and_disable_interrupts() { return 0; }
+
+ static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+ #endif
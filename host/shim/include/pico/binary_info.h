@@ -0,0 +1,8 @@
+/*!
+ * @file binary_info.h
+ * @brief Substituto vazio de pico/binary_info.h para o build nativo (Linux).
+ */
+
+ #ifndef _HOST_PICO_BINARY_INFO_
+ #define _HOST_PICO_BINARY_INFO_
+ #endif
@@ -0,0 +1,33 @@
+/*!
+ * @file stdlib.h
+ * @brief Substituto mínimo de pico/stdlib.h para o build nativo (Linux).
+ *
+ * Fornece apenas os tipos e macros do Pico SDK utilizados pelo código de renderização.
+ */
+
+ #ifndef _HOST_PICO_STDLIB_
+ #define _HOST_PICO_STDLIB_
+
+ #include <assert.h>
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+
+ #define _u(x) x##u
+ #define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+ #ifndef MIN
+ #define MIN(a, b) ((b) < (a) ? (b) : (a))
+ #endif
+
+ #ifndef MAX
+ #define MAX(a, b) ((a) < (b) ? (b) : (a))
+ #endif
+
+ typedef unsigned int uint;
+
+ static inline void tight_loop_contents() {}
+
+ uint64_t time_us_64(); // relógio monotônico do host, em microssegundos (ver hal_host.c)
+
+ #endif
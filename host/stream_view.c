@@ -0,0 +1,160 @@
+/*!
+ * @file stream_view.c
+ * @brief Reconstrói os frames transmitidos pela placa pela USB (comando `f`, frame_stream.h).
+ *
+ * A entrada é a captura binária da USB (stdio) ou o próprio dispositivo (por exemplo /dev/ttyACM0, configurado
+ * com `stty -F /dev/ttyACM0 raw -echo`); as mensagens de texto misturadas aos pacotes são ignoradas. Cada frame
+ * reconstruído pode ser gravado em PBM (`-o PREFIXO`, arquivos PREFIXO00000.pbm, ...) ou desenhado no terminal
+ * (`--ascii`); `--record` copia os bytes recebidos para reprodução posterior. Ao final (fim da entrada ou Ctrl-C)
+ * são escritos os contadores: taxa de compressão em relação aos frames brutos e frames por segundo no relógio
+ * da placa.
+ *
+ * Uso: mandelbrot_stream [ARQUIVO] [-o PREFIXO] [--ascii] [--record SAIDA.bin]
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include "frame_stream.h"
+#include "pbm.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop = 1;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "uso: %s [ARQUIVO] [-o PREFIXO] [--ascii] [--record SAIDA.bin]\n", name);
+}
+
+/*!
+ * @brief Desenha o frame no terminal, reduzido a 2x2 pixels por caractere.
+ */
+static void draw_ascii(const frame_stream_reader_t *reader)
+{
+    static const char shades[] = " .:o#";
+
+    printf("\033[H");
+    for (int y = 0; y < SSD1306_HEIGHT; y += 2)
+    {
+        char line[SSD1306_WIDTH / 2 + 1];
+        for (int x = 0; x < SSD1306_WIDTH; x += 2)
+        {
+            int on = 0;
+            for (int dy = 0; dy < 2; dy++)
+                for (int dx = 0; dx < 2; dx++)
+                    on += (reader->frame[((y + dy) / 8) * SSD1306_WIDTH + x + dx] >> ((y + dy) % 8)) & 1;
+            line[x / 2] = shades[on];
+        }
+        line[SSD1306_WIDTH / 2] = '\0';
+        printf("%s\n", line);
+    }
+    printf("seq %5u  %s  %10lu ms\n", (unsigned)reader->seq, reader->type == FRAME_STREAM_KEY ? "chave" : "delta",
+           (unsigned long)reader->time_ms);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv)
+{
+    const char *input = NULL, *prefix = NULL, *record = NULL;
+    bool ascii = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+            prefix = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            record = argv[++i];
+        else if (strcmp(argv[i], "--ascii") == 0)
+            ascii = true;
+        else if (argv[i][0] != '-' && input == NULL)
+            input = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *in = input ? fopen(input, "rb") : stdin;
+    if (in == NULL)
+    {
+        perror(input);
+        return 2;
+    }
+    FILE *rec = record ? fopen(record, "wb") : NULL;
+    if (record && rec == NULL)
+    {
+        perror(record);
+        return 2;
+    }
+
+    // Ctrl-C interrompe a leitura (sem reiniciar o read() bloqueado no dispositivo) e escreve os contadores
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    sigaction(SIGINT, &action, NULL);
+
+    static frame_stream_reader_t reader;
+    frame_stream_reader_init(&reader);
+
+    uint32_t frames = 0, gaps = 0, first_ms = 0, last_ms = 0;
+    uint16_t last_seq = 0;
+    uint8_t chunk[4096];
+    size_t n;
+    if (ascii)
+        printf("\033[2J");
+
+    while (!stop && (n = fread(chunk, 1, sizeof(chunk), in)) > 0)
+    {
+        if (rec)
+            fwrite(chunk, 1, n, rec);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!frame_stream_reader_push(&reader, chunk[i]))
+                continue;
+
+            if (frames == 0)
+                first_ms = reader.time_ms;
+            else
+                gaps += (uint16_t)(reader.seq - last_seq - 1); // descartados ou iguais ao anterior na placa
+            last_ms = reader.time_ms;
+            last_seq = reader.seq;
+
+            if (prefix)
+            {
+                static uint8_t rows[PBM_ROW_BYTES(SSD1306_WIDTH) * SSD1306_HEIGHT];
+                char path[1024];
+                snprintf(path, sizeof(path), "%s%05lu.pbm", prefix, (unsigned long)frames);
+                pbm_from_framebuffer(reader.frame, rows);
+                if (pbm_write(path, SSD1306_WIDTH, SSD1306_HEIGHT, rows) != 0)
+                    perror(path);
+            }
+            if (ascii)
+                draw_ascii(&reader);
+            frames++;
+        }
+    }
+    if (in != stdin)
+        fclose(in);
+    if (rec)
+        fclose(rec);
+
+    uint64_t raw = (uint64_t)reader.packets * SSD1306_FRAME_LEN;
+    uint32_t span_ms = last_ms - first_ms;
+    printf("%lu pacotes (%lu chave), %lu frames reconstruidos, %lu sem base, %lu rejeitados, %llu bytes fora de "
+           "pacotes\n",
+           (unsigned long)reader.packets, (unsigned long)reader.keyframes, (unsigned long)frames,
+           (unsigned long)reader.orphans, (unsigned long)reader.corrupt, (unsigned long long)reader.skipped);
+    printf("%llu bytes em pacotes para %llu bytes de frames (%.1fx); %lu frames nao transmitidos pela placa\n",
+           (unsigned long long)reader.wire_bytes, (unsigned long long)raw,
+           reader.wire_bytes ? (double)raw / (double)reader.wire_bytes : 0.0, (unsigned long)gaps);
+    if (frames > 1 && span_ms)
+        printf("%.1f fps em %.3f s (relogio da placa)\n", (frames - 1) * 1000.0 / span_ms, span_ms / 1e3);
+    return frames ? 0 : 1;
+}
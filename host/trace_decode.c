@@ -0,0 +1,223 @@
+/*!
+ * @file trace_decode.c
+ * @brief Converte o despejo do anel de instrumentação da placa (comando `d`, trace.h) em uma linha do tempo.
+ *
+ * A entrada é a captura da USB (stdio) da placa, que pode conter outras mensagens: é usado o último despejo
+ * completo (`trace begin` ... `trace end`). Os instantes são relativos ao momento do despejo, o que dispensa
+ * tratar a volta do relógio de 32 bits. A saída é uma linha do tempo em texto, com uma barra por evento e o resumo
+ * por etapa; `--json` grava também o formato de eventos do chrome://tracing (Perfetto).
+ *
+ * Uso: mandelbrot_trace [ARQUIVO] [--json SAIDA.json] [--width N]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+/*!
+ * @brief Evento decodificado; `start_us` é negativo (anterior ao despejo).
+ */
+typedef struct {
+    uint32_t seq;
+    int64_t start_us;
+    uint32_t duration_us;
+    uint32_t value;
+    int stage;
+} decoded_event_t;
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "uso: %s [ARQUIVO] [--json SAIDA.json] [--width N]\n", name);
+}
+
+/*!
+ * @brief Converte o nome da etapa no despejo em `trace_stage_t`; -1 se desconhecido.
+ */
+static int parse_stage(const char *name)
+{
+    for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+        if (strcmp(name, trace_stage_name((trace_stage_t)stage)) == 0)
+            return stage;
+    return -1;
+}
+
+/*!
+ * @brief Lê o último despejo completo da captura.
+ *
+ * @return int O número de eventos lidos, ou -1 se não houver despejo completo.
+ */
+static int read_dump(FILE *in, decoded_event_t *events, uint32_t *lost)
+{
+    static decoded_event_t pending[TRACE_RING_SIZE];
+    char line[256];
+    int count = -1, found = -1;
+    unsigned long now = 0, lost_in_dump = 0;
+
+    while (fgets(line, sizeof(line), in))
+    {
+        unsigned long seq, start, duration, value, announced;
+        char name[32];
+
+        if (sscanf(line, "trace begin %lu %lu %lu", &now, &announced, &lost_in_dump) == 3)
+        {
+            count = 0;
+        }
+        else if (count >= 0 && strncmp(line, "trace end", 9) == 0)
+        {
+            memcpy(events, pending, (size_t)count * sizeof(pending[0]));
+            *lost = (uint32_t)lost_in_dump;
+            found = count;
+            count = -1;
+        }
+        else if (count >= 0 && count < TRACE_RING_SIZE &&
+                 sscanf(line, "T %lu %lu %lu %31s %lu", &seq, &start, &duration, name, &value) == 5)
+        {
+            int stage = parse_stage(name);
+            if (stage < 0)
+                continue;
+            decoded_event_t *event = &pending[count++];
+            event->seq = (uint32_t)seq;
+            event->start_us = -(int64_t)(uint32_t)((uint32_t)now - (uint32_t)start); // idade no instante do despejo
+            event->duration_us = (uint32_t)duration;
+            event->value = (uint32_t)value;
+            event->stage = stage;
+        }
+    }
+    return found;
+}
+
+static int compare_start(const void *a, const void *b)
+{
+    const decoded_event_t *x = a, *y = b;
+    if (x->start_us != y->start_us)
+        return x->start_us < y->start_us ? -1 : 1;
+    return x->seq < y->seq ? -1 : x->seq > y->seq;
+}
+
+/*!
+ * @brief Grava os eventos no formato de eventos do chrome://tracing: uma linha (tid) por etapa.
+ */
+static int write_json(const char *path, const decoded_event_t *events, int count, int64_t origin)
+{
+    FILE *out = fopen(path, "w");
+    if (out == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(out, "{\"traceEvents\":[\n");
+    for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                stage, trace_stage_name((trace_stage_t)stage));
+    for (int i = 0; i < count; i++)
+    {
+        const decoded_event_t *e = &events[i];
+        const char *name = trace_stage_name((trace_stage_t)e->stage);
+        long long ts = (long long)(e->start_us - origin);
+        if (e->duration_us)
+            fprintf(out, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lu,\"pid\":0,\"tid\":%d,"
+                         "\"args\":{\"valor\":%lu,\"seq\":%lu}}%s\n",
+                    name, ts, (unsigned long)e->duration_us, e->stage, (unsigned long)e->value,
+                    (unsigned long)e->seq, i + 1 < count ? "," : "");
+        else
+            fprintf(out, "{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lld,\"pid\":0,\"tid\":%d,"
+                         "\"args\":{\"valor\":%lu,\"seq\":%lu}}%s\n",
+                    name, ts, e->stage, (unsigned long)e->value, (unsigned long)e->seq, i + 1 < count ? "," : "");
+    }
+    fprintf(out, "]}\n");
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    const char *input = NULL, *json = NULL;
+    int width = 60;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json = argv[++i];
+        else if (strcmp(argv[i], "--width") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0)
+            width = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && input == NULL)
+            input = argv[i];
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *in = input ? fopen(input, "r") : stdin;
+    if (in == NULL)
+    {
+        perror(input);
+        return 2;
+    }
+
+    static decoded_event_t events[TRACE_RING_SIZE];
+    uint32_t lost = 0;
+    int count = read_dump(in, events, &lost);
+    if (in != stdin)
+        fclose(in);
+    if (count < 0)
+    {
+        fprintf(stderr, "nenhum despejo completo (trace begin ... trace end) na entrada\n");
+        return 1;
+    }
+    if (count == 0)
+    {
+        printf("despejo vazio (%lu eventos perdidos)\n", (unsigned long)lost);
+        return 0;
+    }
+
+    qsort(events, (size_t)count, sizeof(events[0]), compare_start);
+    int64_t origin = events[0].start_us, end = 0;
+    for (int i = 0; i < count; i++)
+        end = events[i].start_us + events[i].duration_us > end ? events[i].start_us + events[i].duration_us : end;
+    double span = (double)(end - origin > 0 ? end - origin : 1);
+
+    // linha do tempo: instante relativo ao primeiro evento, duração, valor e a barra na janela do despejo
+    printf("%d eventos (%lu perdidos), janela de %.3f ms\n\n", count, (unsigned long)lost, span / 1e3);
+    printf("%10s  %-10s %10s %10s  %s\n", "t(ms)", "etapa", "dur(us)", "valor", "linha do tempo");
+    char *bar = malloc((size_t)width + 1);
+    for (int i = 0; i < count; i++)
+    {
+        const decoded_event_t *e = &events[i];
+        int from = (int)((double)(e->start_us - origin) / span * width);
+        int to = (int)((double)(e->start_us + e->duration_us - origin) / span * width);
+        from = from >= width ? width - 1 : from;
+        to = to <= from ? from + 1 : to > width ? width : to;
+        for (int c = 0; c < width; c++)
+            bar[c] = c < from || c >= to ? ' ' : e->duration_us ? '#' : '|';
+        bar[width] = '\0';
+
+        printf("%10.3f  %-10s %10lu %10lu  [%s]\n", (double)(e->start_us - origin) / 1e3,
+               trace_stage_name((trace_stage_t)e->stage), (unsigned long)e->duration_us, (unsigned long)e->value, bar);
+    }
+    free(bar);
+
+    // resumo: tempo de cada etapa na janela do despejo
+    printf("\n%-10s %8s %12s %8s\n", "etapa", "eventos", "total(us)", "janela");
+    for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+    {
+        uint64_t total = 0;
+        int n = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (events[i].stage != stage)
+                continue;
+            total += events[i].duration_us;
+            n++;
+        }
+        if (n)
+            printf("%-10s %8d %12llu %7.1f%%\n", trace_stage_name((trace_stage_t)stage), n, (unsigned long long)total,
+                   100.0 * (double)total / span);
+    }
+
+    if (json && write_json(json, events, count, origin) != 0)
+        return 1;
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include <string.h>
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "transport_host.h"
+
+static transport_host_stats_t stats;
+static int latency = 0;                             // consultas a busy() até o término de uma escrita
+static int remaining = 0;                           // consultas restantes da escrita em andamento
+static bool in_flight = false;
+static const uint8_t *flight_src;                   // buffer da escrita em andamento
+static size_t flight_len;
+static uint8_t flight_copy[SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN]; // conteúdo do buffer no início da escrita
+
+/*!
+ * @brief Conclui a escrita em andamento, verificando o buffer e entregando os bytes ao display emulado.
+ */
+static void complete()
+{
+    if (memcmp(flight_src, flight_copy, flight_len) != 0)
+        stats.modified_in_flight++;
+    i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, flight_copy, flight_len, false);
+    stats.transfers++;
+    in_flight = false;
+}
+
+static bool host_busy()
+{
+    if (!in_flight)
+        return false;
+    if (remaining-- > 0)
+        return true;
+    complete();
+    return false;
+}
+
+static void host_start_write(const uint8_t *src, size_t len)
+{
+    if (in_flight)
+    {
+        stats.overlapped_starts++;
+        complete();
+    }
+    memcpy(flight_copy, src, len);
+    flight_src = src;
+    flight_len = len;
+    remaining = latency;
+    in_flight = true;
+}
+
+static int host_write(const uint8_t *src, size_t len)
+{
+    while (host_busy())
+        ;
+    return i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, src, len, false);
+}
+
+/*! @brief Transporte substituto com escritas em segundo plano simuladas. */
+const ssd1306_transport_t transport_host = {
+    write : host_write,
+    start_write : host_start_write,
+    busy : host_busy,
+};
+
+/*!
+ * @brief Zera as estatísticas e define quantas consultas a `busy()` cada escrita em segundo plano leva.
+ */
+void transport_host_reset(int latency_polls)
+{
+    memset(&stats, 0, sizeof(stats));
+    latency = latency_polls;
+    in_flight = false;
+}
+
+/*!
+ * @brief Retorna as estatísticas desde o último `transport_host_reset()`.
+ */
+transport_host_stats_t transport_host_stats()
+{
+    return stats;
+}
@@ -0,0 +1,31 @@
+/*!
+ * @file transport_host.h
+ * @brief Substituto do transporte com DMA para o build nativo (Linux).
+ *
+ * As escritas em segundo plano só terminam após um número configurável de consultas a `busy()`, e o buffer
+ * é verificado no término: qualquer alteração feita pela CPU durante a transmissão é contabilizada.
+ * Os bytes são entregues ao display emulado de hal_host.c.
+ */
+
+ #ifndef _TRANSPORT_HOST_
+ #define _TRANSPORT_HOST_
+
+ #include <stddef.h>
+ #include "ssd1306_transport.h"
+
+ /*!
+  * @brief Estatísticas do transporte substituto.
+  */
+ typedef struct {
+     size_t transfers;          /*!< Escritas em segundo plano concluídas. */
+     size_t overlapped_starts;  /*!< Escritas iniciadas com outra ainda em andamento (erro de ordenação). */
+     size_t modified_in_flight; /*!< Escritas cujo buffer foi alterado durante a transmissão (erro de posse). */
+ } transport_host_stats_t;
+
+ extern const ssd1306_transport_t transport_host;
+
+ void transport_host_reset(int latency_polls);
+
+ transport_host_stats_t transport_host_stats();
+
+ #endif
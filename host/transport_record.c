@@ -0,0 +1,100 @@
+#include "hardware/i2c.h"
+#include "ssd1306.h"
+#include "transport_record.h"
+
+static uint8_t log_bytes[TRANSPORT_RECORD_MAX_BYTES];           // bytes de todas as transações registradas
+static size_t log_start[TRANSPORT_RECORD_MAX_TRANSACTIONS + 1]; // início de cada transação em `log_bytes`
+static size_t transactions = 0;                                  // transações enviadas
+static size_t bytes = 0;                                         // bytes enviados
+
+/*!
+ * @brief Registra a transação (enquanto houver espaço) e a repassa ao display emulado.
+ */
+static int record_write(const uint8_t *src, size_t len)
+{
+    size_t used = log_start[MIN(transactions, TRANSPORT_RECORD_MAX_TRANSACTIONS)];
+    if (transactions < TRANSPORT_RECORD_MAX_TRANSACTIONS && used + len <= TRANSPORT_RECORD_MAX_BYTES)
+    {
+        for (size_t i = 0; i < len; i++)
+            log_bytes[used + i] = src[i];
+        log_start[transactions + 1] = used + len;
+    }
+    else if (transactions < TRANSPORT_RECORD_MAX_TRANSACTIONS)
+        log_start[transactions + 1] = used; // registro cheio: a transação é contada, mas não armazenada
+
+    transactions++;
+    bytes += len;
+    return i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, src, len, false);
+}
+
+static void record_start_write(const uint8_t *src, size_t len)
+{
+    record_write(src, len);
+}
+
+static bool record_busy()
+{
+    return false;
+}
+
+/*! @brief Transporte de gravação (síncrono). */
+const ssd1306_transport_t transport_record = {
+    write : record_write,
+    start_write : record_start_write,
+    busy : record_busy,
+};
+
+/*!
+ * @brief Descarta o registro e zera os contadores.
+ */
+void transport_record_reset()
+{
+    transactions = 0;
+    bytes = 0;
+    log_start[0] = 0;
+}
+
+/*!
+ * @brief Número de transações desde o último `transport_record_reset()`.
+ */
+size_t transport_record_transactions()
+{
+    return transactions;
+}
+
+/*!
+ * @brief Número de bytes (incluindo bytes de controle) desde o último `transport_record_reset()`.
+ */
+size_t transport_record_bytes()
+{
+    return bytes;
+}
+
+/*!
+ * @brief Retorna os bytes registrados de uma transação.
+ *
+ * @return Ponteiro para os bytes, ou NULL se a transação não foi registrada.
+ */
+const uint8_t *transport_record_transaction(size_t index, size_t *len)
+{
+    if (index >= transactions || index >= TRANSPORT_RECORD_MAX_TRANSACTIONS)
+        return NULL;
+    *len = log_start[index + 1] - log_start[index];
+    return &log_bytes[log_start[index]];
+}
+
+/*!
+ * @brief Escreve o registro em hexadecimal, uma transação por linha.
+ */
+void transport_record_dump(FILE *f)
+{
+    for (size_t t = 0; t < transactions && t < TRANSPORT_RECORD_MAX_TRANSACTIONS; t++)
+    {
+        size_t len;
+        const uint8_t *data = transport_record_transaction(t, &len);
+        fprintf(f, "%4zu [%4zu]", t, len);
+        for (size_t i = 0; i < len; i++)
+            fprintf(f, " %02x", data[i]);
+        fputc('\n', f);
+    }
+}
@@ -0,0 +1,35 @@
+/*!
+ * @file transport_record.h
+ * @brief Transporte de gravação para o build nativo (Linux).
+ *
+ * Registra o fluxo exato de bytes de cada transação enviada ao display, além do total de bytes e de
+ * transações, e repassa as escritas ao display emulado de hal_host.c.
+ */
+
+ #ifndef _TRANSPORT_RECORD_
+ #define _TRANSPORT_RECORD_
+
+ #include <stddef.h>
+ #include <stdint.h>
+ #include <stdio.h>
+ #include "ssd1306_transport.h"
+
+ /*! @brief Capacidade do registro, em bytes. */
+ #define TRANSPORT_RECORD_MAX_BYTES 65536
+
+ /*! @brief Capacidade do registro, em transações. */
+ #define TRANSPORT_RECORD_MAX_TRANSACTIONS 1024
+
+ extern const ssd1306_transport_t transport_record;
+
+ void transport_record_reset();
+
+ size_t transport_record_transactions();
+
+ size_t transport_record_bytes();
+
+ const uint8_t *transport_record_transaction(size_t index, size_t *len);
+
+ void transport_record_dump(FILE *f);
+
+ #endif
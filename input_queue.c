@@ -0,0 +1,78 @@
+#include <string.h>
+#include "input_queue.h"
+
+/*!
+ * @brief Esvazia a fila e zera as estatísticas; chamada antes de habilitar as interrupções produtoras.
+ */
+void input_queue_init(input_queue_t *queue)
+{
+    memset(queue, 0, sizeof(*queue));
+}
+
+/*!
+ * @brief Acrescenta um evento ao fim da fila (produtor; seguro em interrupção, sem bloquear).
+ *
+ * @return bool Falso se o evento foi descartado por falta de espaço.
+ *
+ * @details
+ *  - Amostras do joystick (`INPUT_EVENT_TICK`) são descartadas quando restam apenas `INPUT_QUEUE_BUTTON_RESERVE`
+ *    posições livres: durante uma renderização longa, as amostras acumuladas seriam agrupadas de qualquer forma,
+ *    e as posições restantes garantem que nenhuma borda de botão seja perdida.
+ *  - O evento é escrito antes da publicação de `head` (ordem de liberação).
+ */
+bool input_queue_push(input_queue_t *queue, input_event_type_t type, uint8_t gpio, uint8_t level, uint32_t time_us)
+{
+    uint32_t head = queue->head;
+    uint32_t used = head - __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    uint32_t limit = (type == INPUT_EVENT_TICK) ? INPUT_QUEUE_SIZE - INPUT_QUEUE_BUTTON_RESERVE : INPUT_QUEUE_SIZE;
+
+    if (used >= limit)
+    {
+        queue->stats.dropped++;
+        return false;
+    }
+
+    input_event_t *event = &queue->events[head & (INPUT_QUEUE_SIZE - 1)];
+    event->type = (uint8_t)type;
+    event->gpio = gpio;
+    event->level = level;
+    event->time_us = time_us;
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    queue->stats.pushed++;
+    if (used + 1 > queue->stats.max_depth)
+        queue->stats.max_depth = used + 1;
+    return true;
+}
+
+/*!
+ * @brief Retira o evento mais antigo da fila (consumidor).
+ *
+ * @return bool Falso se a fila está vazia.
+ */
+bool input_queue_pop(input_queue_t *queue, input_event_t *event)
+{
+    uint32_t tail = queue->tail;
+    if (tail == __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+        return false;
+
+    *event = queue->events[tail & (INPUT_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*!
+ * @brief Verifica, sem retirar, se há um evento do tipo na fila (consumidor).
+ *
+ * @details Utilizada pelas renderizações longas para abandonar o trabalho quando um botão foi pressionado.
+ */
+bool input_queue_contains(const input_queue_t *queue, input_event_type_t type)
+{
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    for (uint32_t i = queue->tail; i != head; i++)
+    {
+        if (queue->events[i & (INPUT_QUEUE_SIZE - 1)].type == type)
+            return true;
+    }
+    return false;
+}
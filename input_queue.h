@@ -0,0 +1,70 @@
+/*!
+ * @file input_queue.h
+ * @brief Fila de eventos de entrada entre as interrupções e o laço principal.
+ *
+ * As interrupções (timer de amostragem do joystick e botões) apenas registram eventos com o instante em que
+ * ocorreram; o laço principal os consome, agrupa e executa toda a renderização. A fila é circular, sem
+ * travas, com um único produtor e um único consumidor.
+ *
+ * @note O produtor é o contexto de interrupção do core0: o alarme do timer e o GPIO têm a mesma prioridade
+ *       no NVIC e não se interrompem mutuamente, portanto nunca executam `input_queue_push()` ao mesmo tempo.
+ */
+
+ #ifndef _INPUT_QUEUE_
+ #define _INPUT_QUEUE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+
+ /*! @brief Capacidade da fila, em eventos (potência de 2). */
+ #define INPUT_QUEUE_SIZE 32
+
+ /*! @brief Posições sempre reservadas aos botões: amostras do joystick não ocupam as últimas posições livres. */
+ #define INPUT_QUEUE_BUTTON_RESERVE 8
+
+ _Static_assert((INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) == 0, "INPUT_QUEUE_SIZE deve ser potência de 2");
+
+ /*! @brief Tipo de evento de entrada. */
+ typedef enum {
+     INPUT_EVENT_TICK,  /*!< Instante de amostrar o joystick (timer de controle). */
+     INPUT_EVENT_BUTTON /*!< Borda de descida de um botão; `gpio` identifica o botão e `level` o outro botão. */
+ } input_event_type_t;
+
+ /*!
+  * @brief Evento de entrada.
+  */
+ typedef struct {
+     uint8_t type;     /*!< `input_event_type_t`. */
+     uint8_t gpio;     /*!< Pino do botão (INPUT_EVENT_BUTTON). */
+     uint8_t level;    /*!< Nível do outro botão da combinação na borda (INPUT_EVENT_BUTTON; 0 = pressionado). */
+     uint32_t time_us; /*!< Instante do evento (`time_us_32()`). */
+ } input_event_t;
+
+ /*!
+  * @brief Estatísticas da fila.
+  */
+ typedef struct {
+     uint32_t pushed;    /*!< Eventos aceitos. */
+     uint32_t dropped;   /*!< Eventos descartados por falta de espaço. */
+     uint32_t max_depth; /*!< Maior ocupação observada pelo produtor. */
+ } input_queue_stats_t;
+
+ /*!
+  * @brief Fila circular; `head` é escrito apenas pelo produtor e `tail` apenas pelo consumidor.
+  */
+ typedef struct {
+     input_event_t events[INPUT_QUEUE_SIZE];
+     uint32_t head;
+     uint32_t tail;
+     input_queue_stats_t stats; // escrito apenas pelo produtor
+ } input_queue_t;
+
+ void input_queue_init(input_queue_t *queue);
+
+ bool input_queue_push(input_queue_t *queue, input_event_type_t type, uint8_t gpio, uint8_t level, uint32_t time_us);
+
+ bool input_queue_pop(input_queue_t *queue, input_event_t *event);
+
+ bool input_queue_contains(const input_queue_t *queue, input_event_type_t type);
+
+ #endif
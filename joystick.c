@@ -0,0 +1,86 @@
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "setup.h"
+#include "joystick.h"
+
+// o anel de escrita do DMA exige o buffer alinhado ao próprio tamanho (em bytes)
+static uint16_t ring[JOYSTICK_RING_SAMPLES] __attribute__((aligned(JOYSTICK_RING_SAMPLES * sizeof(uint16_t))));
+
+static int dma_channel = -1;
+static uint32_t consumed; // amostras já entregues aos filtros desde o último (re)início do DMA
+
+// log2 do tamanho do buffer em bytes, para channel_config_set_ring()
+static uint ring_size_bits(void)
+{
+    uint bits = 0;
+    while ((1u << bits) < JOYSTICK_RING_SAMPLES * sizeof(uint16_t))
+        bits++;
+    return bits;
+}
+
+// (re)inicia a conversão a partir do eixo X, para que a paridade do índice identifique o eixo
+static void sampling_arm(void)
+{
+    adc_run(false);
+    adc_fifo_drain();
+    adc_select_input(ADC_CHANNEL_0);
+
+    dma_channel_config config = dma_channel_get_default_config(dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, ring_size_bits()); // anel no endereço de escrita
+    channel_config_set_dreq(&config, DREQ_ADC);
+    dma_channel_configure(dma_channel, &config, ring, &adc_hw->fifo, 0xffffffffu, true);
+
+    consumed = 0;
+    adc_run(true);
+}
+
+/*!
+ * @brief Inicia a amostragem contínua dos dois eixos do joystick.
+ *
+ * @details
+ *  - Round-robin entre os canais 0 (VRX) e 1 (VRY), a `JOYSTICK_SAMPLE_RATE` amostras/s no total
+ *    (500 por eixo, cerca de 24 por tick de 48 ms).
+ *  - FIFO do ADC com DREQ a cada amostra; o DMA lê sempre o FIFO e grava no buffer circular de
+ *    `JOYSTICK_RING_SAMPLES` amostras (128 ms de histórico), com a contagem máxima de transferências (~49 dias).
+ *
+ * @note Deve ser chamada após setup_joystick(), que inicializa o ADC e os pinos.
+ */
+void joystick_sampling_start(void)
+{
+    adc_set_round_robin((1u << ADC_CHANNEL_0) | (1u << ADC_CHANNEL_1));
+    adc_fifo_setup(true, true, 1, false, false); // FIFO habilitado, DREQ com 1 amostra, sem deslocamento (12 bits)
+    adc_set_clkdiv(48000000.0f / JOYSTICK_SAMPLE_RATE - 1.0f); // clock do ADC de 48 MHz
+
+    dma_channel = dma_claim_unused_channel(true);
+    sampling_arm();
+}
+
+/*!
+ * @brief Entrega aos filtros as amostras convertidas desde a chamada anterior.
+ *
+ * @details A contagem de transferências restantes do DMA dá o total de amostras gravadas. Se o laço principal
+ *          ficou ocupado por mais tempo do que o buffer cobre (renderização longa), apenas as amostras ainda
+ *          presentes no buffer são usadas, mantendo a paridade entre os eixos.
+ */
+void joystick_poll(axis_filter_t *vrx, axis_filter_t *vry)
+{
+    if (dma_channel < 0)
+        return;
+
+    uint32_t written = 0xffffffffu - dma_channel_hw_addr(dma_channel)->transfer_count;
+    if (written - consumed > JOYSTICK_RING_SAMPLES)
+        consumed = (written - JOYSTICK_RING_SAMPLES + 8) & ~1u; // descarta as sobrescritas (e as prestes a ser), mantendo a paridade
+
+    for (; consumed + 2 <= written; consumed += 2)
+    {
+        axis_filter_push(vrx, ring[consumed % JOYSTICK_RING_SAMPLES]);
+        axis_filter_push(vry, ring[(consumed + 1) % JOYSTICK_RING_SAMPLES]);
+    }
+
+    if (!dma_channel_is_busy(dma_channel))
+        sampling_arm(); // contagem esgotada: reinicia a partir do eixo X
+}
@@ -0,0 +1,25 @@
+/*!
+ * @file joystick.h
+ * @brief Amostragem contínua do joystick pelo ADC (round-robin) com DMA em buffer circular.
+ *
+ * O ADC converte alternadamente os dois eixos, sem intervenção da CPU, e o DMA grava as amostras em um buffer
+ * circular. O laço principal consome as amostras novas a cada tick e as passa aos filtros (joystick_filter.h),
+ * substituindo as leituras avulsas com adc_read() a cada 48 ms.
+ */
+
+ #ifndef _JOYSTICK_
+ #define _JOYSTICK_
+
+ #include "joystick_filter.h"
+
+ /*! @brief Taxa total de conversão do ADC (as duas entradas somadas), em amostras por segundo. */
+ #define JOYSTICK_SAMPLE_RATE 1000
+
+ /*! @brief Amostras no buffer circular do DMA (potência de 2; pares = eixo X, ímpares = eixo Y). */
+ #define JOYSTICK_RING_SAMPLES 128
+
+ void joystick_sampling_start(void);
+
+ void joystick_poll(axis_filter_t *vrx, axis_filter_t *vry);
+
+ #endif
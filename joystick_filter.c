@@ -0,0 +1,142 @@
+#include "joystick_filter.h"
+
+/*!
+ * @brief Reinicia o filtro; a próxima amostra o inicializa diretamente.
+ */
+void axis_filter_reset(axis_filter_t *filter)
+{
+    filter->history[0] = filter->history[1] = 0;
+    filter->smooth = 0;
+    filter->samples = 0;
+}
+
+static uint16_t median3(uint16_t a, uint16_t b, uint16_t c)
+{
+    if (a > b)
+    {
+        uint16_t t = a;
+        a = b;
+        b = t;
+    }
+    // a <= b: a mediana é b limitado ao intervalo [a, c] quando c está entre eles
+    return c < a ? a : c > b ? b : c;
+}
+
+/*!
+ * @brief Acrescenta uma amostra do ADC ao filtro do eixo.
+ *
+ * @details
+ *  - Mediana das três últimas amostras: um pico isolado (interferência na conversão) não chega ao IIR.
+ *  - IIR de primeira ordem em inteiros, s += (m - s) >> JOYSTICK_IIR_SHIFT, com o estado em ponto fixo para
+ *    não perder a resolução do ADC; com 500 amostras/s por eixo, a constante de tempo é de cerca de 16 ms.
+ *  - As duas primeiras amostras inicializam o estado diretamente (sem rampa a partir de zero).
+ */
+void axis_filter_push(axis_filter_t *filter, uint16_t sample)
+{
+    uint16_t m = sample;
+    if (filter->samples >= 2)
+        m = median3(filter->history[0], filter->history[1], sample);
+
+    int32_t target = (int32_t)m << JOYSTICK_IIR_FRAC_BITS;
+    if (filter->samples < 2)
+        filter->smooth = target;
+    else
+        filter->smooth += (target - filter->smooth) >> JOYSTICK_IIR_SHIFT;
+
+    filter->history[0] = filter->history[1];
+    filter->history[1] = sample;
+    filter->samples++;
+}
+
+/*!
+ * @brief Retorna o valor filtrado do eixo, na escala do ADC (0-4095).
+ */
+uint16_t axis_filter_value(const axis_filter_t *filter)
+{
+    int32_t v = (filter->smooth + (1 << (JOYSTICK_IIR_FRAC_BITS - 1))) >> JOYSTICK_IIR_FRAC_BITS;
+    return (uint16_t)(v < 0 ? 0 : v > JOYSTICK_ADC_MAX ? JOYSTICK_ADC_MAX : v);
+}
+
+/*!
+ * @brief Posição do cursor em 1/256 de pixel (x em `*px`, y em `*py`), com a mesma escala do mapeamento original.
+ *
+ * @note ATENÇÃO: os eixos da placa estão invertidos (vry -> horizontal, vrx -> vertical invertido).
+ */
+static void cursor_position_q8(uint16_t vrx, uint16_t vry, int cursor_size, int32_t *px, int32_t *py)
+{
+    // ajuste de 4095 -> 4084 e 4095 -> 4082, como no mapeamento original
+    *px = (int32_t)((int64_t)vry * (127 - cursor_size) * 256 / 4084);
+    *py = (63 - cursor_size) * 256 - (int32_t)((int64_t)vrx * (63 - cursor_size) * 256 / 4082);
+    if (*py < 0)
+        *py = 0; // vrx acima de 4082
+}
+
+/*!
+ * @brief Converte os valores dos eixos na posição do cursor, sem histerese.
+ */
+void joystick_cursor_map(uint16_t vrx, uint16_t vry, int cursor_size, uint8_t *x, uint8_t *y)
+{
+    int32_t px, py;
+    cursor_position_q8(vrx, vry, cursor_size, &px, &py);
+    *x = (uint8_t)(px >> 8);
+    *y = (uint8_t)(py >> 8);
+}
+
+/*!
+ * @brief Pixel de uma posição; a última coluna/linha é aceita a meia histerese de distância, pois o mapeamento
+ *        só a alcança com o eixo exatamente no extremo, que o ruído do ADC raramente mantém.
+ */
+static uint8_t cursor_pixel(int32_t position, int max_pixel)
+{
+    if (position >= max_pixel * 256 - JOYSTICK_HYSTERESIS_Q8 / 2)
+        return (uint8_t)max_pixel;
+    return (uint8_t)(position >> 8);
+}
+
+/*!
+ * @brief Aplica a histerese a uma coordenada do cursor.
+ *
+ * @details O pixel só muda quando a posição sai do pixel atual por mais de `JOYSTICK_HYSTERESIS_Q8`.
+ */
+static uint8_t hysteresis(uint8_t current, int32_t position, int max_pixel)
+{
+    uint8_t candidate = cursor_pixel(position, max_pixel);
+    if (candidate == current || candidate == 0 || candidate == max_pixel)
+        return candidate;
+    if (position < current * 256 - JOYSTICK_HYSTERESIS_Q8 || position >= (current + 1) * 256 + JOYSTICK_HYSTERESIS_Q8)
+        return candidate;
+    return current;
+}
+
+/*!
+ * @brief Atualiza a posição do cursor a partir dos valores filtrados dos eixos.
+ *
+ * @return bool Verdadeiro se a posição mudou (o cursor deve ser redesenhado).
+ *
+ * @details Uma mudança do tamanho do cursor altera a escala do mapeamento; a posição é então recalculada sem histerese.
+ */
+bool joystick_cursor_update(joystick_cursor_t *cursor, uint16_t vrx, uint16_t vry, int cursor_size)
+{
+    int32_t px, py;
+    cursor_position_q8(vrx, vry, cursor_size, &px, &py);
+    int max_x = 127 - cursor_size, max_y = 63 - cursor_size;
+
+    uint8_t x, y;
+    if (!cursor->valid || cursor->x > max_x || cursor->y > max_y)
+    {
+        x = cursor_pixel(px, max_x);
+        y = cursor_pixel(py, max_y);
+    }
+    else
+    {
+        x = hysteresis(cursor->x, px, max_x);
+        y = hysteresis(cursor->y, py, max_y);
+    }
+
+    bool moved = !cursor->valid || x != cursor->x || y != cursor->y;
+    cursor->x = x;
+    cursor->y = y;
+    cursor->valid = true;
+    cursor->moves += moved;
+    return moved;
+}
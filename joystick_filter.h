@@ -0,0 +1,62 @@
+/*!
+ * @file joystick_filter.h
+ * @brief Filtragem das amostras do joystick e posicionamento do cursor com histerese.
+ *
+ * Cada amostra do ADC passa por uma mediana de 3 (remove picos isolados) e por um filtro IIR de primeira
+ * ordem em aritmética inteira. O valor filtrado é convertido na posição do cursor com uma histerese em torno
+ * das bordas de cada pixel: o ruído de poucas unidades do ADC perto de uma borda não move o cursor, e o
+ * cursor só é redesenhado quando o joystick é de fato movido.
+ *
+ * Independente do hardware: utilizado pelo firmware (joystick.c) e pelo benchmark de host com traços gravados.
+ */
+
+ #ifndef _JOYSTICK_FILTER_
+ #define _JOYSTICK_FILTER_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+
+ /*! @brief Maior valor do ADC de 12 bits. */
+ #define JOYSTICK_ADC_MAX 4095
+
+ /*! @brief Constante do filtro IIR: s += (x - s) / 2^JOYSTICK_IIR_SHIFT, por amostra. */
+ #define JOYSTICK_IIR_SHIFT 3
+
+ /*! @brief Bits fracionários do estado do filtro IIR. */
+ #define JOYSTICK_IIR_FRAC_BITS 4
+
+ /*!
+  * @brief Histerese do cursor, em 1/256 de pixel: o cursor só passa a um pixel vizinho quando a posição
+  *        filtrada ultrapassa a borda entre eles por esta margem.
+  */
+ #define JOYSTICK_HYSTERESIS_Q8 80
+
+ /*!
+  * @brief Estado do filtro de um eixo.
+  */
+ typedef struct {
+     uint16_t history[2]; /*!< As duas amostras anteriores (mediana de 3). */
+     int32_t smooth;      /*!< Saída do IIR, com `JOYSTICK_IIR_FRAC_BITS` bits fracionários. */
+     uint32_t samples;    /*!< Amostras recebidas desde `axis_filter_reset()`. */
+ } axis_filter_t;
+
+ /*!
+  * @brief Posição do cursor com histerese.
+  */
+ typedef struct {
+     uint8_t x, y;   /*!< Posição atual. */
+     bool valid;     /*!< Falso até a primeira atualização. */
+     uint32_t moves; /*!< Atualizações que mudaram a posição. */
+ } joystick_cursor_t;
+
+ void axis_filter_reset(axis_filter_t *filter);
+
+ void axis_filter_push(axis_filter_t *filter, uint16_t sample);
+
+ uint16_t axis_filter_value(const axis_filter_t *filter);
+
+ void joystick_cursor_map(uint16_t vrx, uint16_t vry, int cursor_size, uint8_t *x, uint8_t *y);
+
+ bool joystick_cursor_update(joystick_cursor_t *cursor, uint16_t vrx, uint16_t vry, int cursor_size);
+
+ #endif
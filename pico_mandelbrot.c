@@ -2,47 +2,133 @@
 #include "pico/stdlib.h"  // Inclui a biblioteca SDK padrão do Raspberry Pi Pico, que fornece funcionalidades para programação básica.
 #include <stdlib.h>       // Inclui a biblioteca para definições de tipos, variáveis e funções comuns.
 #include <string.h>       // Inclui a biblioteca com funções para manipulação de strings e memória
+#include <math.h>         // Inclui a biblioteca matemática (NAN).
+#include <stdarg.h>       // Inclui a biblioteca de argumentos variáveis (mensagens do console).
 #include "hardware/irq.h" // Inclui a biblioteca com funções para manipulação de interrupções de hardware.
 #include "hardware/adc.h" // Inclui a biblioteca com funções para controlar o ADC do microcontrolador.
 #include "ssd1306.h"      // Inclui a biblioteca que com definições e funções específicas para controlar o display OLED SSD1306.
 #include "setup.h"        // Inclui a biblioteca com funções de configuração específicas de configuração e inicialização do hardware embarcado
-
-uint32_t last_time = 0;        // variável de tempo, auxiliar À comtramedida deboucing
+#include "render_platform.h" // Inclui a interface de plataforma da renderização paralela (core1).
+#include "viewport.h"        // Inclui as operações sobre a janela do plano complexo (ampliação).
+#include "ssd1306_tx.h"      // Inclui a transmissão assíncrona de frames com buffer duplo.
+#include "render_progressive.h" // Inclui a renderização progressiva (pré-visualização em blocos e refinamento).
+#include "render_pan.h"         // Inclui o deslocamento da janela por pixels inteiros (modo pan).
+#include "frame_cache.h"        // Inclui o cache LRU de frames comprimidos (desfazer sem recalcular).
+#include "speculate.h"          // Inclui a pré-renderização especulativa da próxima ampliação.
+#include "render_deep.h"        // Inclui a renderização por perturbação das ampliações profundas.
+#include "render_budget.h"      // Inclui a escolha do limite de iterações por frame (orçamento de tempo).
+#include "input_queue.h"        // Inclui a fila de eventos de entrada entre as interrupções e o laço principal.
+#include "joystick.h"           // Inclui a amostragem do joystick por DMA e a filtragem dos eixos.
+#include "zoom_history.h"       // Inclui o histórico das ampliações em memória fixa.
+#include "flash_store.h"        // Inclui o armazenamento persistente da sessão e de frames na flash.
+#include "shade.h"              // Inclui o sombreamento do frame a partir do campo de iterações retido.
+#include "trace.h"              // Inclui a instrumentação de desempenho (anel de eventos e estatísticas por etapa).
+#include "frame_stream.h"       // Inclui a transmissão dos frames exibidos pela USB em pacotes comprimidos.
+
+#define BUTTON_DEBOUNCE_US 200000 // intervalo mínimo entre duas bordas aceitas do mesmo botão
+uint32_t last_time[NUM_BANK0_GPIOS]; // instante da última borda aceita de cada botão (debouncing por pino: o segundo
+                                     // botão de uma combinação não é descartado pelo primeiro)
 uint16_t vrx_value, vry_value; // variáveis para armazenar os valores do joystick (eixos X e Y) e botão
 uint8_t buf[SSD1306_BUF_LEN];  // buffer com tamanho representa a área do display
 
-volatile float real_start = -2.0; //  valor inicial da parte real do plano complexo para o cálculo do conjunto de Mandelbrot; este valor define o ponto de partida no eixo real para o desenho do fractal.
-volatile float real_end = 1.0;    // valor final da parte real do plano complexo; este valor define o limite no eixo real até onde o cálculo do conjunto de Mandelbrot será realizado.
-volatile float im_start = -1.5;   // valor inicial da parte imaginária do plano complexo; define o ponto de partida no eixo imaginário para o desenho do conjunto de Mandelbrot.
-volatile float im_end = 1.5;      // valor final da parte imaginária do plano complexo; define o limite no eixo imaginário até onde o cálculo do conjunto de Mandelbrot será realizado
+// eventos registrados pelas interrupções (timer e botões) e consumidos pelo laço principal, que é o único
+// contexto a ler e alterar as variáveis abaixo e a renderizar
+input_queue_t input_queue;
+
+float real_start = -2.0; //  valor inicial da parte real do plano complexo para o cálculo do conjunto de Mandelbrot; este valor define o ponto de partida no eixo real para o desenho do fractal.
+float real_end = 1.0;    // valor final da parte real do plano complexo; este valor define o limite no eixo real até onde o cálculo do conjunto de Mandelbrot será realizado.
+float im_start = -1.5;   // valor inicial da parte imaginária do plano complexo; define o ponto de partida no eixo imaginário para o desenho do conjunto de Mandelbrot.
+float im_end = 1.5;      // valor final da parte imaginária do plano complexo; define o limite no eixo imaginário até onde o cálculo do conjunto de Mandelbrot será realizado
 
 // variaveis auxiliares às variáveis acima declaradas
-volatile float temp_real_start = 0;
-volatile float temp_real_end = 0;
-volatile float temp_im_start = 0;
-volatile float temp_im_end = 0;
+float temp_real_start = 0;
+float temp_real_end = 0;
+float temp_im_start = 0;
+float temp_im_end = 0;
 
 // variáveis que correspondem as coordenadas do cursor
-volatile uint8_t new_x_position = 0;
-volatile uint8_t new_y_position = 0;
-volatile uint8_t temp_cursor_x_position = 0;
-volatile uint8_t temp_cursor_y_position = 0;
+uint8_t new_x_position = 0;
+uint8_t new_y_position = 0;
+uint8_t temp_cursor_x_position = 0;
+uint8_t temp_cursor_y_position = 0;
 
 // variavés que correspondem ao tamanho do cursor
-volatile uint8_t new_height = 0;
-volatile uint8_t new_width = 0;
-volatile int new_cursor_size = 0;
-volatile uint8_t temp_cursor_size = 0;
+uint8_t new_height = 0;
+uint8_t new_width = 0;
+int new_cursor_size = 0;
+uint8_t temp_cursor_size = 0;
 
 // variável que define o comportamento dos botões A e B.
 // true = dimensionamento do cursor
 // false = renderização do conjunto de Mandelbrot
-volatile bool cursor_button_status = true;
+bool cursor_button_status = true;
+
+// última ação simples de A ou B no modo de tamanho do cursor (botão e tamanho anterior), desfeita se o botão ainda
+// pressionado se revelar o primeiro de uma combinação (A+B, B+A); -1 após qualquer outra ação
+int chord_first_gpio = -1;
+int chord_first_size = 0;
+
+// variável que define o comportamento do joystick.
+// true = desloca a janela do plano complexo (pan), mantendo o cursor parado
+// false = movimenta o cursor
+bool pan_mode = false;
+
+uint8_t image_buf[SSD1306_FRAME_LEN];    // frame sem o cursor: deslocado no próprio buffer (pan) ou lido do cache
+uint32_t pan_led_ticks = 0;              // contador para piscar o LED no modo pan
+uint64_t frame_render_us = 0;            // tempo gasto nas passadas do frame progressivo em andamento
+bool deepening = false;                  // frame progressivo concluído, ainda aprofundado (ver `budget_deepen()`)
+
+// iterações por pixel do frame da janela atual (ver `mandelbrot_retain_field()`): trocar o sombreamento
+// apenas recompõe o frame a partir delas, sem recalcular o fractal
+uint8_t field[SSD1306_WIDTH * SSD1306_HEIGHT];
+bool field_valid = false;                // campo completo para o frame exibido (falso para frames do cache sem campo)
+int field_cap = MANDELBROT_ITER_LIMIT;   // limite de iterações com que o campo foi calculado
+shade_mode_t shade_mode = SHADE_THRESHOLD;
+bool shade_changed = false;              // sombreamento alterado pelos botões, ainda não exibido
+
+#if MANDELBROT_DEEP_ZOOM
+deep_view_t deep_view;                       // janela em precisão estendida, mantida junto com a janela float
+uint32_t deep_generation = 0;       // incrementado a cada alteração de deep_view
+uint32_t deep_shown_generation = UINT32_MAX; // geração do frame profundo exibido (UINT32_MAX = nenhum)
+#endif
 
 render_area_t *render_area;
 
-render_data_t *render_data;          // ponteiro de armazenamento dos dados do plano complexo que utilizados nos cálculos de renderização do conjunto de Mandelbrot
-volatile int render_data_count = -1; // contador do ponteiro de armazenamento de dados de renderização
+// histórico das ampliações (zoom_history.c): operações compactas em memória fixa, sem alocação dinâmica
+zoom_history_t zoom_history;
+
+// sessão e frames persistidos na flash (flash_store.c), gravados com a janela parada e o laço principal ocioso
+flash_store_t flash_store;
+bool session_dirty = false;        // janela alterada desde a última gravação
+uint64_t session_changed_us = 0;   // instante da última alteração da janela
+
+#if MANDELBROT_STREAM
+// transmissão dos frames exibidos pela USB (frame_stream.c), ligada e desligada pelo comando `f` do console
+frame_stream_t frame_stream;
+bool streaming = false;
+#define STREAM_DRAIN_US 200000 // espera máxima pelo fim da transmissão ao desligá-la
+#endif
+
+// função que escreve as mensagens do console; com a transmissão ligada, o texto é entregue ao transmissor, que o
+// grava entre dois pacotes (um printf direto cairia no meio de um pacote, corrompendo-o)
+void console_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+#if MANDELBROT_STREAM
+    if (streaming)
+    {
+        char line[160];
+        int len = vsnprintf(line, sizeof(line), format, args);
+        if (len > 0)
+            frame_stream_text(&frame_stream, line, len < (int)sizeof(line) ? (size_t)len : sizeof(line) - 1);
+        va_end(args);
+        return;
+    }
+#endif
+    vprintf(format, args);
+    va_end(args);
+}
 
 render_area_t frame_area = {
     start_col : 0,
@@ -51,19 +137,166 @@ render_area_t frame_area = {
     end_page : SSD1306_NUM_PAGES - 1
 };
 
-// função para ler os eixos X e Y do joystick.
+// filtros dos eixos e posição do cursor com histerese (joystick_filter.c); alimentados pela amostragem por DMA (joystick.c)
+axis_filter_t vrx_filter, vry_filter;
+joystick_cursor_t joystick_cursor;
+
+// função para ler os eixos X e Y do joystick: entrega aos filtros as amostras acumuladas no buffer do DMA
+// desde a leitura anterior e retorna os valores filtrados.
 void joystick_read_axis(uint16_t *vrx_value, uint16_t *vry_value)
 {
-    // leitura do valor do eixo X do joystick
-    adc_select_input(ADC_CHANNEL_0); // seleciona o canal ADC para o eixo X do joystick
-    sleep_us(2);                     // pequeno delay para garantir estabilidade da leitura do ADC
-    *vrx_value = adc_read();         // lê o valor do eixo X (0-4095)
-
-    // leitura do valor do eixo Y do joystick
-    adc_select_input(ADC_CHANNEL_1); // seleciona o canal ADC para o eixo Y do joystick
-    sleep_us(2);                     // pequeno delay para estabilidade
-    *vry_value = adc_read();         // lê o valor do eixo Y (0-4095)
+    joystick_poll(&vrx_filter, &vry_filter);
+    *vrx_value = axis_filter_value(&vrx_filter); // valor filtrado do eixo X (0-4095)
+    *vry_value = axis_filter_value(&vry_filter); // valor filtrado do eixo Y (0-4095)
+}
+
+// verdadeiro se a janela atual está abaixo da resolução do kernel e é renderizada por perturbação
+// (apenas Mandelbrot: as demais fórmulas ficam limitadas à resolução do kernel)
+static bool view_is_deep()
+{
+#if MANDELBROT_DEEP_ZOOM
+    return mandelbrot_get_formula() == ESCAPE_MANDELBROT && deep_view_needs_perturbation(&deep_view);
+#else
+    return false;
+#endif
+}
+
+// janela atual, no formato do histórico de ampliações
+static zoom_state_t current_state()
+{
+    zoom_state_t state = {view : {real_start, real_end, im_start, im_end}};
+#if MANDELBROT_DEEP_ZOOM
+    state.deep = deep_view;
+#endif
+    return state;
+}
+
+// adota a janela produzida pelo histórico de ampliações
+static void set_state(const zoom_state_t *state)
+{
+    real_start = state->view.real_start;
+    real_end = state->view.real_end;
+    im_start = state->view.im_start;
+    im_end = state->view.im_end;
+#if MANDELBROT_DEEP_ZOOM
+    deep_view = state->deep;
+    deep_generation++;
+#endif
+    session_dirty = true;
+    session_changed_us = time_us_64();
+}
+
+// função que compõe o frame sem o cursor: a imagem renderizada (limiar) ou o campo de iterações sombreado
+static void compose(uint8_t *frame, const uint8_t *image)
+{
+    TRACE_BEGIN(t);
+    if (shade_mode != SHADE_THRESHOLD && field_valid)
+        shade_frame(frame, field, field_cap, shade_mode);
+    else
+        memcpy(frame, image, SSD1306_FRAME_LEN);
+    TRACE_END(TRACE_COMPOSE, t, shade_mode);
+}
+
+// função que recalcula o campo de iterações de um frame completo que veio sem ele (flash, ou cache após o descarte
+// do campo) quando o sombreamento o exige; a imagem recalculada com o mesmo limite é a mesma, e volta ao cache com
+// o campo
+static void ensure_field(uint8_t *image, const render_data_t *view)
+{
+    if (shade_mode == SHADE_THRESHOLD || field_valid)
+        return;
+    mandelbrot_retain_field(image, field);
+    draw_mandelbrot_frame(image, view);
+    field_valid = true;
+    field_cap = mandelbrot_get_max_iter();
+    frame_cache_insert(view, field_cap, image, field);
+}
+
+// função que copia o frame exibido para a fila da transmissão pela USB, se estiver ligada
+static void stream_frame(const uint8_t *frame)
+{
+#if MANDELBROT_STREAM
+    if (streaming)
+        frame_stream_submit(&frame_stream, frame, to_ms_since_boot(get_absolute_time()));
+#endif
+    (void)frame;
+}
+
+// função que transmite o frame de trás inteiro em segundo plano (DMA) e troca os buffers
+static void send_frame()
+{
+    stream_frame(SSD1306_tx_back());
+    SSD1306_tx_submit();
+    SSD1306_tx_swap();
+}
+
+// função que envia ao display apenas as regiões alteradas do frame (cursor ou sombreamento), de forma bloqueante
+static void send_dirty(const uint8_t *frame)
+{
+    TRACE_BEGIN(t);
+    int sent = SSD1306_render_dirty(frame);
+    TRACE_END(TRACE_I2C, t, sent);
+    (void)sent;
+    stream_frame(frame);
+}
+
+// função que consulta o cache de frames (janela e limite de iterações), registrando a consulta na instrumentação;
+// em um acerto, restaura também o campo de iterações, se o cache o guardou (ver `ensure_field()`)
+static bool cache_lookup(const render_data_t *view, int cap, uint8_t *frame)
+{
+    TRACE_BEGIN(t);
+    bool hit = frame_cache_lookup(view, cap, frame);
+    TRACE_END(TRACE_CACHE, t, hit);
+    field_valid = hit && frame_cache_field(view, cap, field);
+    field_cap = cap;
+    return hit;
+}
+
+#if MANDELBROT_DEEP_ZOOM
+// função que desenha a janela profunda: o frame inteiro é renderizado por perturbação a cada nova janela
+static void controller_deep(bool cursor_changed)
+{
+    uint8_t *frame = SSD1306_tx_back();
+
+    if (deep_shown_generation != deep_generation)
+    {
+        deep_view_t view = deep_view;
+        uint32_t generation = deep_generation;
+        deep_stats_t stats;
+
+        // o limite vem do orçamento, como nas janelas float; o prazo é verificado entre as órbitas de referência
+        TRACE_BEGIN(t);
+        mandelbrot_retain_field(image_buf, field);
+        const budget_frame_t *report = budget_render_deep(image_buf, &view, &stats);
+        TRACE_END(TRACE_KERNEL, t, report->iterations);
+        TRACE_RECORD(TRACE_FRAME, t, (uint32_t)report->frame_us, report->iterations);
+        deep_shown_generation = generation;
+        field_valid = true;
+        field_cap = report->cap_reached;
+
+        compose(frame, image_buf);
+        draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+        send_frame();
+
+        console_printf("perturbacao: passo 2^%d, limite %d/%d, %u passadas, %u referencias, %u falhas, %llu us\n",
+                       (int)view.step_exp, report->cap_reached, report->cap_chosen, report->passes, stats.references,
+                       stats.glitched, (unsigned long long)report->frame_us);
+    }
+    else if (cursor_changed)
+    {
+        compose(frame, image_buf);
+        draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+        send_dirty(frame); // apenas o cursor ou o sombreamento mudou: envia somente as regiões alteradas
+    }
+    else
+    {
+        return;
+    }
+
+    temp_cursor_x_position = new_x_position;
+    temp_cursor_y_position = new_y_position;
+    temp_cursor_size = new_cursor_size;
 }
+#endif
 
 // função que desenha o fractal e o cursor no centro do display
 void controller(uint8_t x0, uint8_t y0)
@@ -79,17 +312,191 @@ void controller(uint8_t x0, uint8_t y0)
     int check_cursor_x_position = memcmp(&x0, (int *)&temp_cursor_x_position, sizeof(uint8_t));
     int check_cursor_y_position = memcmp(&y0, (int *)&temp_cursor_y_position, sizeof(uint8_t));
 
+#if MANDELBROT_DEEP_ZOOM
+    if (view_is_deep())
+    {
+        controller_deep(check_cursor_x_position != 0 || check_cursor_y_position != 0 ||
+                        new_cursor_size != temp_cursor_size || shade_changed);
+        shade_changed = false;
+        return;
+    }
+    if (deep_shown_generation != UINT32_MAX)
+    {
+        // de volta à resolução do kernel: a janela float pode coincidir com a anterior, força um novo frame
+        deep_shown_generation = UINT32_MAX;
+        temp_real_start = NAN;
+    }
+#endif
+
+#if MANDELBROT_PROGRESSIVE
+    bool viewport_changed = real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end;
+    bool cursor_changed = check_cursor_x_position != 0 || check_cursor_y_position != 0 ||
+                          new_cursor_size != temp_cursor_size || shade_changed;
+
+    if (viewport_changed)
+    {
+        // nova janela: em cache (por exemplo, ao desfazer uma ampliação), o frame é apenas descomprimido;
+        // caso contrário, descarta o refinamento em andamento e recomeça pela pré-visualização. O limite de
+        // iterações vem da profundidade e do histograma do frame anterior (render_budget.c), e um frame em cache
+        // só é aproveitado se tiver sido renderizado com ele. As passadas usam até BUDGET_FIRST_ITER iterações;
+        // concluída a final, o frame é aprofundado até o limite escolhido, uma passada por chamada
+        render_data_t view = {real_start, real_end, im_start, im_end};
+        int cap = budget_choose_cap((view.real_end - view.real_start) / SSD1306_WIDTH);
+        mandelbrot_set_max_iter(cap);
+        deepening = false;
+        if (cache_lookup(&view, cap, image_buf))
+        {
+            ensure_field(image_buf, &view);
+            progressive_adopt(&view, image_buf);
+
+            uint8_t *frame = SSD1306_tx_back();
+            compose(frame, image_buf);
+            draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+            send_frame();
+        }
+        else
+        {
+            frame_render_us = 0;
+            budget_start(cap);
+            progressive_start(&view);
+        }
+
+        temp_real_start = real_start;
+        temp_real_end = real_end;
+        temp_im_start = im_start;
+        temp_im_end = im_end;
+    }
+
+    if (!progressive_done() || deepening)
+    {
+        // uma passada por chamada: os botões pendentes são tratados antes de cada chamada, e uma nova janela
+        // recomeça a renderização sem as passadas restantes
+        uint64_t t0 = time_us_64();
+        uint32_t iterations;
+        if (!progressive_done())
+        {
+            iterations = progressive_stats()->kernel.iterations;
+            mandelbrot_retain_field(progressive_image(), field);
+            progressive_step();
+            iterations = progressive_stats()->kernel.iterations - iterations;
+            frame_render_us += time_us_64() - t0;
+            if (progressive_done())
+                deepening = budget_first_done(&progressive_stats()->kernel, frame_render_us);
+        }
+        else
+        {
+            // aprofundamento: desfeito e encerrado pelo orçamento se o prazo do frame se esgotar no meio
+            mandelbrot_stats_t pass;
+            memcpy(image_buf, progressive_image(), SSD1306_FRAME_LEN);
+            mandelbrot_retain_field(image_buf, field);
+            deepening = budget_deepen(image_buf, progressive_view(), &pass);
+            progressive_adopt(progressive_view(), image_buf);
+            iterations = pass.iterations;
+            frame_render_us += time_us_64() - t0;
+        }
+#if MANDELBROT_TRACE
+        trace_span(TRACE_KERNEL, (uint32_t)t0, iterations);
+#else
+        (void)iterations;
+#endif
+        if (progressive_done())
+        {
+            field_valid = true; // cada pixel foi amostrado em alguma das passadas
+            field_cap = mandelbrot_get_max_iter();
+        }
+
+        uint8_t *frame = SSD1306_tx_back(); // framebuffer de trás, livre enquanto o anterior é transmitido
+        compose(frame, progressive_image()); // pré-visualizações (campo incompleto) com o limiar
+        draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+
+        // cada passada é transmitida inteira em segundo plano (DMA) e os buffers são trocados
+        send_frame();
+
+        if (progressive_done() && !deepening)
+        {
+            // guarda para desfazer sem recalcular, com o limite alcançado (registrado pelo orçamento)
+            const budget_frame_t *report = budget_last_frame();
+            frame_cache_insert(progressive_view(), report->cap_reached, progressive_image(), field);
+
+            const progressive_stats_t *stats = progressive_stats();
+            TRACE_RECORD(TRACE_FRAME, trace_now() - (uint32_t)frame_render_us, (uint32_t)frame_render_us,
+                         report->iterations); // duração: soma das passadas
+            console_printf("pre-visualizacao %llu us, final %llu us, limite %d/%d, %u passadas, renderizacao %llu us\n",
+                           (unsigned long long)stats->preview_us, (unsigned long long)stats->final_us,
+                           report->cap_reached, report->cap_chosen, report->passes,
+                           (unsigned long long)frame_render_us);
+        }
+    }
+    else if (cursor_changed)
+    {
+        if (shade_mode != SHADE_THRESHOLD && !field_valid)
+        {
+            // sombreamento ligado sobre um frame sem campo: recalculado fora do frame progressivo e adotado
+            memcpy(image_buf, progressive_image(), SSD1306_FRAME_LEN);
+            ensure_field(image_buf, progressive_view());
+            progressive_adopt(progressive_view(), image_buf);
+        }
+        uint8_t *frame = SSD1306_tx_back();
+        compose(frame, progressive_image());
+        draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+        send_dirty(frame); // apenas o cursor ou o sombreamento mudou: envia somente as regiões alteradas
+    }
+    else
+    {
+        return;
+    }
+
+    shade_changed = false;
+
+    // variáveis auxliares do cursor - coordenadas e tamanho
+    temp_cursor_x_position = new_x_position;
+    temp_cursor_y_position = new_y_position;
+    temp_cursor_size = new_cursor_size;
+#else
     if (check_cursor_x_position != 0 || check_cursor_y_position != 0 || new_cursor_size != temp_cursor_size ||
-        real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end)
+        shade_changed || real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end)
     {
 
-        memset(buf, 0, SSD1306_BUF_LEN); // limpa o buffer
-        render(buf, &frame_area);        // renderiza o buffer limpo no display
+        uint8_t *frame = SSD1306_tx_back(); // framebuffer de trás, livre enquanto o anterior é transmitido
+        render_data_t view = {real_start, real_end, im_start, im_end};
 
-        draw_mandelbrot(buf, real_start, real_end, im_start, im_end);
-        draw_cursor(buf, new_y_position, new_x_position, new_width, new_height, true);
+        if (real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end)
+        {
+            // janela nova: limite de iterações escolhido pelo orçamento, concluído no prazo (render_budget.c); um
+            // frame em cache só é aproveitado se tiver sido renderizado com o limite escolhido
+            int cap = budget_choose_cap((view.real_end - view.real_start) / SSD1306_WIDTH);
+            if (cache_lookup(&view, cap, image_buf))
+            {
+                mandelbrot_set_max_iter(cap); // o deslocamento sobre o frame usa o mesmo limite
+            }
+            else
+            {
+                mandelbrot_retain_field(image_buf, field);
+                TRACE_BEGIN(t);
+                const budget_frame_t *report = budget_render(image_buf, &view);
+                TRACE_END(TRACE_KERNEL, t, report->iterations);
+                TRACE_RECORD(TRACE_FRAME, t, (uint32_t)report->frame_us, report->iterations);
+                frame_cache_insert(&view, report->cap_reached, image_buf, field);
+                field_valid = true; // inclusive se o prazo interromper o aprofundamento: os pixels acesos ficam dentro
+                field_cap = report->cap_reached;
+                console_printf("limite %d/%d, %u passadas, %llu us\n", report->cap_reached, report->cap_chosen,
+                               report->passes, (unsigned long long)report->frame_us);
+            }
+        }
+        ensure_field(image_buf, &view); // sombreamento ligado sobre um frame sem campo
+        compose(frame, image_buf); // image_buf guarda o frame da janela atual, sem o cursor
+        draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
 
-        render(buf, &frame_area); // renderiza o buffer atualizado
+        if (real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end)
+        {
+            // fractal novo: o frame inteiro é transmitido em segundo plano (DMA) e os buffers são trocados
+            send_frame();
+        }
+        else
+        {
+            send_dirty(frame); // apenas o cursor ou o sombreamento mudou: envia somente as regiões alteradas
+        }
+        shade_changed = false;
 
         // variáveis auxliares do cursor - coordenadas e tamanho
         temp_cursor_x_position = new_x_position;
@@ -102,136 +509,362 @@ void controller(uint8_t x0, uint8_t y0)
         temp_im_start = im_start;
         temp_im_end = im_end;
     }
+#endif
 }
 
-void zoom_in(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+// converte a deflexão de um eixo do joystick (0-4095, centro ~2048) em pixels de deslocamento por chamada
+int joystick_pan_step(uint16_t value)
 {
-    // calcula o centro do cursor
-    uint8_t x0 = left + width / 2;
-    uint8_t y0 = top + height / 2;
-
-    int new_height_zoom = height / 2;
-    int new_width_zoom = width / 2;
-
-    // printf("%d %d %d %d\n", x0, y0, new_width_zoom, new_height_zoom);
-
-    float real_range = real_end - real_start;
-    float im_range = im_end - im_start;
+    int deflection = (int)value - 2048;
+    if (deflection > -PAN_DEADZONE && deflection < PAN_DEADZONE)
+        return 0; // zona morta em torno do centro
+    return deflection / PAN_PIXELS_DIVISOR + (deflection > 0 ? 1 : -1);
+}
 
-    // printf("%f %f\n", real_range, im_range);
+// função que desloca a janela por (dx, dy) pixels, reaproveitando o frame atual e calculando só as faixas expostas
+void controller_pan(int dx, int dy)
+{
+    if ((dx == 0 && dy == 0) || view_is_deep()) // a grade de pixels do deslocamento é float
+        return;
+
+    render_data_t view = {real_start, real_end, im_start, im_end};
+
+#if MANDELBROT_PROGRESSIVE
+    // só é possível deslocar um frame completo da janela atual
+    if (!progressive_done() || real_start != temp_real_start || real_end != temp_real_end ||
+        im_start != temp_im_start || im_end != temp_im_end)
+        return;
+    // o deslocamento encerra o aprofundamento: o frame segue com o limite já alcançado
+    deepening = false;
+    memcpy(image_buf, progressive_image(), SSD1306_FRAME_LEN);
+#endif
+    // o campo acompanha o frame: deslocado junto e completado nas faixas expostas (ver `pan_shift()`)
+    mandelbrot_retain_field(image_buf, field);
+#if !MANDELBROT_PROGRESSIVE
+    draw_mandelbrot(image_buf, real_start, real_end, im_start, im_end); // em cache, exceto na primeira chamada
+#endif
+
+    // a grade é a do pan em andamento no histórico; uma ampliação ou um desfazer inicia uma nova grade
+    zoom_state_t state = current_state();
+    viewport_grid_t *grid = zoom_history_pan_begin(&zoom_history, &state);
+    if (grid == NULL)
+        return; // histórico cheio
+
+    mandelbrot_stats_t stats = {0};
+    TRACE_BEGIN(t);
+    pan_frame(image_buf, grid, dx, dy, &view, &stats);
+    TRACE_END(TRACE_KERNEL, t, stats.iterations);
+    zoom_history_pan_end(&zoom_history, &state);
+
+#if MANDELBROT_PROGRESSIVE
+    progressive_adopt(&view, image_buf);
+#endif
+    frame_cache_insert(&view, mandelbrot_get_max_iter(), image_buf, field_valid ? field : NULL);
+
+    set_state(&state); // state.view == view
+    temp_real_start = view.real_start;
+    temp_real_end = view.real_end;
+    temp_im_start = view.im_start;
+    temp_im_end = view.im_end;
+
+    uint8_t *frame = SSD1306_tx_back();
+    compose(frame, image_buf);
+    draw_cursor(frame, new_y_position, new_x_position, new_width, new_height, true);
+    send_frame();
+}
 
-    float left_point = x0 - new_width_zoom;
-    float right_point = x0 + new_width_zoom;
-    float top_point = y0 - new_height_zoom;
-    float bottom_point = y0 + new_height_zoom;
+// função que amplia a janela para a área do cursor, registrando a ampliação no histórico
+bool zoom_in(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+{
+    zoom_state_t state = current_state();
+    // o cursor é quadrado: o histórico guarda apenas o canto e o lado
+    if (!zoom_history_zoom(&zoom_history, &state, left, top, width))
+    {
+        console_printf("historico de ampliacoes cheio\n");
+        return false;
+    }
+    set_state(&state);
+    return true;
+}
 
-    // printf("%f %f %f %f\n", left_point, right_point, top_point, bottom_point);
+// função que desfaz a última ampliação, restaurando exatamente a janela anterior
+void undo_zoom_in()
+{
+    zoom_state_t state = current_state();
+    if (zoom_history_undo(&zoom_history, &state))
+        set_state(&state);
+}
 
-    real_start = real_start + (real_range * left_point / SSD1306_WIDTH);
-    real_end = real_start + (right_point - left_point) * real_range / SSD1306_WIDTH;
-    im_start = im_start + (im_range * top_point / SSD1306_HEIGHT);
-    im_end = im_start + (bottom_point - top_point) * im_range / SSD1306_HEIGHT;
+// função que grava a sessão e o frame exibido na flash, após FLASH_STORE_IDLE_US sem alterações da janela;
+// retorna verdadeiro se gravou (o laço principal só a chama quando está ocioso)
+bool storage_poll(uint64_t now)
+{
+    if (!session_dirty || now - session_changed_us < FLASH_STORE_IDLE_US)
+        return false;
+
+    render_data_t view = {real_start, real_end, im_start, im_end};
+    const uint8_t *frame = NULL;
+    // o frame profundo não é identificado pela janela float, e a sessão não registra a fórmula: apenas a sessão
+    // é gravada
+    if (!view_is_deep() && mandelbrot_get_formula() == ESCAPE_MANDELBROT)
+    {
+#if MANDELBROT_PROGRESSIVE
+        if (!progressive_done() || deepening || memcmp(progressive_view(), &view, sizeof(view)) != 0)
+            return false; // aguarda o frame completo
+        frame = progressive_image();
+#else
+        if (real_start != temp_real_start || real_end != temp_real_end || im_start != temp_im_start || im_end != temp_im_end)
+            return false;
+        frame = image_buf;
+#endif
+    }
 
-    // printf("%f %f %f %f\n", real_start, real_end, im_start, im_end);
+    session_dirty = false;
+    flash_store_save_session(&flash_store, &zoom_history);
+    if (frame)
+        flash_store_save_frame(&flash_store, &view, mandelbrot_get_max_iter(), frame);
+    return true;
 }
 
-void undo_zoom_in(uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+#if MANDELBROT_STREAM
+// função que escreve os contadores da transmissão dos frames: taxa de compressão e frames por segundo
+void stream_print_stats()
 {
+    const frame_stream_stats_t *stats = &frame_stream.stats;
+    uint32_t span_ms = stats->last_ms - stats->first_ms;
+    console_printf("transmissao: %lu frames, %lu descartados, %lu iguais, %lu pacotes (%lu chave), %llu -> %llu bytes "
+                   "(%.1fx), %.1f fps\n",
+                   (unsigned long)stats->submitted, (unsigned long)stats->dropped, (unsigned long)stats->unchanged,
+                   (unsigned long)stats->packets, (unsigned long)stats->keyframes, (unsigned long long)stats->raw_bytes,
+                   (unsigned long long)stats->wire_bytes,
+                   stats->wire_bytes ? (double)stats->raw_bytes / (double)stats->wire_bytes : 0.0,
+                   span_ms ? (stats->packets - 1) * 1000.0 / span_ms : 0.0);
+}
+#endif
 
-    // printf("%f %f %f %f\n",
-    //        render_data[render_data_count].real_start,
-    //        render_data[render_data_count].real_end,
-    //        render_data[render_data_count].im_start,
-    //        render_data[render_data_count].im_end);
-
-    if (render_data_count >= 0 && render_data_count <= 10) // condicional que limita o decremento e quantidade de itens no ponteiro
+#if MANDELBROT_TRACE || MANDELBROT_STREAM
+// função que atende os comandos recebidos pela USB: transmissão dos frames (`f` liga e desliga, `v` contadores) e
+// instrumentação (ver `trace_command()`); retorna verdadeiro se havia um caractere (o laço principal só a chama
+// quando está ocioso)
+bool console_poll()
+{
+    int c = getchar_timeout_us(0);
+    if (c == PICO_ERROR_TIMEOUT)
+        return false;
+#if MANDELBROT_STREAM
+    if (c == 'f')
     {
-        // coletando os dados anteriores a última ampliação para renderização retroativa fidedigna
-        real_start = render_data[render_data_count].real_start;
-        real_end = render_data[render_data_count].real_end;
-        im_start = render_data[render_data_count].im_start;
-        im_end = render_data[render_data_count].im_end;
-
-        render_data = realloc(render_data, render_data_count * sizeof(render_data_t));
-        if (render_data == NULL)
+        streaming = !streaming;
+        if (streaming)
         {
-            // erro de alocação de memória
-            printf("falha ao alocar memória para render_data\n");
-            return;
+            frame_stream_init(&frame_stream, &frame_stream_usb_sink);
+            const uint8_t *shown = SSD1306_displayed();
+            if (shown)
+                stream_frame(shown); // o leitor recebe de imediato o frame exibido (quadro-chave)
         }
-        render_data_count--; // decrementa total de itens no ponteiro de renderizaçoes
+        else
+        {
+            // conclui o pacote e o texto em andamento antes de voltar ao printf direto (com limite de tempo: sem
+            // leitor conectado, a USB não aceita mais nada)
+            uint64_t until = time_us_64() + STREAM_DRAIN_US;
+            while (!frame_stream_idle(&frame_stream) && time_us_64() < until)
+                frame_stream_poll(&frame_stream);
+            stream_print_stats();
+        }
+        return true;
+    }
+    if (c == 'v')
+    {
+        stream_print_stats();
+        return true;
+    }
+    if (c == '?')
+        console_printf("transmissao: f = ligar/desligar, v = contadores\n");
+#endif
+#if MANDELBROT_TRACE
+#if MANDELBROT_STREAM
+    if (streaming && (c == 's' || c == 'd' || c == 'r' || c == '?'))
+    {
+        // as respostas do trace são escritas diretamente no stdout e cairiam no meio dos pacotes
+        console_printf("trace: comandos disponiveis com a transmissao desligada (f)\n");
+        return true;
     }
+#endif
+    trace_command(c);
+#endif
+    return true;
 }
+#endif
 
-bool controller_repeating_timer_callback(struct repeating_timer *t)
+// função executada pelo laço principal a cada amostragem do joystick (agrupando as amostras acumuladas)
+void controller_tick()
 {
+    TRACE_BEGIN(t);
     joystick_read_axis(&vrx_value, &vry_value); // lê os valores dos eixos do joystick
 
-    // ajuste de 4095 -> 4084 e new_cursor_size é o tamanha atual do cursor
-    // ATENÇÃO: os eixos da minha placa estão invertidos
-    uint8_t x_cursor = (int)(((float)vry_value / 4084.0) * (127.0 - new_cursor_size));
+    // o cursor só muda de pixel quando o joystick é de fato movido (histerese nas bordas dos pixels), evitando
+    // redesenhos causados pelo ruído do ADC com o joystick parado
+    joystick_cursor_update(&joystick_cursor, vrx_value, vry_value, new_cursor_size);
+    uint8_t x_cursor = joystick_cursor.x;
+    uint8_t y_cursor = joystick_cursor.y;
+    TRACE_END(TRACE_INPUT, t, 0);
 
-    // ajuste de 4095 -> 4082 e new_cursor_size é o tamanho atual do cursor
-    uint8_t y_cursor = (int)((63 - new_cursor_size) - (((float)vrx_value / 4082.0) * (63.0 - new_cursor_size)));
+    if (pan_mode)
+    {
+        // ATENÇÃO: mesma inversão de eixos do cursor (vry -> horizontal, vrx -> vertical invertido)
+        controller_pan(joystick_pan_step(vry_value), -joystick_pan_step(vrx_value));
+        x_cursor = new_x_position; // o cursor permanece parado enquanto a janela é deslocada
+        y_cursor = new_y_position;
+
+        if (++pan_led_ticks % 8 == 0)
+            gpio_put(LED, !gpio_get(LED)); // LED piscando indica o modo pan
+    }
 
     // printf("%d %d\n", vrx_value, vry_value);
     controller(x_cursor, y_cursor);
+
+    if (!cursor_button_status && !view_is_deep())
+    {
+        // modo de ampliação: a janela que o botão A produziria é pré-renderizada pelo laço principal
+        render_data_t target = {real_start, real_end, im_start, im_end};
+        viewport_zoom_in(&target, new_x_position, new_y_position, new_width, new_height);
+        speculate_request(&target, time_us_64());
+    }
+    else
+    {
+        speculate_cancel(); // inclui as janelas profundas, cujo frame não é chaveado pela janela float
+    }
+}
+
+// timer de controle: apenas registra o instante de amostrar o joystick; a leitura e a renderização ficam no laço principal
+bool controller_repeating_timer_callback(struct repeating_timer *t)
+{
+    input_queue_push(&input_queue, INPUT_EVENT_TICK, 0, 1, time_us_32());
+    return true; // mantém o timer repetindo
 }
 
-// handler de interrupção dos botões
+// handler de interrupção dos botões: apenas registra a borda com o instante em que ocorreu e o nível do outro botão
+// da combinação A+B, lido agora: no laço principal, após uma renderização longa, ele já pode ter sido solto
 void button_interruption_gpio_irq_handler(uint gpio, uint32_t events)
 {
-    uint32_t current_time = to_us_since_boot(get_absolute_time());
-    // verificar se passou tempo o bastante desde o último evento
-    if (current_time - last_time > 200000) // 200 ms de debouncing
+    uint partner = gpio == BUTTON_A ? BUTTON_B : gpio == BUTTON_B ? BUTTON_A : gpio;
+    uint8_t level = partner == gpio ? 1 : gpio_get(partner);
+    input_queue_push(&input_queue, INPUT_EVENT_BUTTON, (uint8_t)gpio, level, time_us_32());
+    TRACE_MARK(TRACE_BUTTON, gpio);
+    // limpa a interrupção do GPIO, permitindo que novas interrupções sejam detectadas.
+    gpio_acknowledge_irq(gpio, events);
+}
+
+// função que desfaz a ação simples do primeiro botão de uma combinação, aplicada quando ele foi pressionado sozinho
+static void chord_undo_first(uint gpio)
+{
+    if (chord_first_gpio == (int)gpio)
+        new_cursor_size = chord_first_size;
+    chord_first_gpio = -1;
+}
+
+// função que aplica a ação simples de A ou B no modo de tamanho do cursor, guardando o tamanho anterior
+static void chord_single(uint gpio, int size)
+{
+    chord_first_gpio = gpio;
+    chord_first_size = new_cursor_size;
+    new_cursor_size = size;
+}
+
+// função que trata um botão no laço principal, com o instante e o estado do outro botão de A+B (`partner_held`)
+// registrados pela interrupção
+void button_event(uint gpio, bool partner_held, uint32_t event_time)
+{
+    // verificar se passou tempo o bastante desde a última borda aceita deste botão
+    if (gpio < NUM_BANK0_GPIOS && event_time - last_time[gpio] > BUTTON_DEBOUNCE_US)
     {
-        last_time = current_time; // atualiza o tempo do último evento
+        last_time[gpio] = event_time; // atualiza o tempo do último evento do botão
 
-        if (gpio_get(BUTTON_A) == 0) // verifica se o botão A está pressionado (nível lógico baixo).
+        if (gpio == BUTTON_A) // borda de descida do botão A (pressionado, nível lógico baixo).
         {
-            if (cursor_button_status)
+            if (cursor_button_status && partner_held)
             {
-                new_cursor_size++; // se cursor_button_status for verdadeiro, incrementa o tamanho do cursor.
+                // A com B pressionado: alterna o sombreamento, recompondo o frame a partir do campo retido; o
+                // tamanho do cursor alterado por B, pressionado antes, volta ao anterior
+                chord_undo_first(BUTTON_B);
+                shade_mode = (shade_mode + 1) % SHADE_MODE_COUNT;
+                shade_changed = true;
+                console_printf("sombreamento: %s\n", shade_mode_name(shade_mode));
+            }
+            else if (cursor_button_status)
+            {
+                // se cursor_button_status for verdadeiro, incrementa o tamanho do cursor.
+                chord_single(BUTTON_A, new_cursor_size + 1);
             }
             else
             {
-                render_data_count++; // se cursor_button_status for falso, incrementa o contador de ampliações
-                // armazena os valores atuais de real_start, real_end, im_start e im_end no array render_data na posição render_data_count.
-                render_data[render_data_count].real_start = real_start;
-                render_data[render_data_count].real_end = real_end;
-                render_data[render_data_count].im_start = im_start;
-                render_data[render_data_count].im_end = im_end;
-
-                zoom_in(new_x_position, new_y_position, new_width, new_height); // chama a função zoom_in para realizar a ampliação.
+                chord_first_gpio = -1;
+                // se cursor_button_status for falso, amplia a janela (a janela anterior fica registrada no histórico)
+                if (zoom_in(new_x_position, new_y_position, new_width, new_height))
+                {
+                    render_data_t zoomed = {real_start, real_end, im_start, im_end};
+                    speculate_note_zoom(&zoomed); // contabiliza se a janela ampliada havia sido especulada
+                }
             }
         }
 
-        if (gpio_get(BUTTON_B) == 0) // verifica se o botão B está pressionado (nível lógico baixo).
+        if (gpio == BUTTON_B) // borda de descida do botão B.
         {
-            if (cursor_button_status)
+            if (cursor_button_status && partner_held)
+            {
+                // B com A pressionado: alterna a fórmula; a constante de Julia é o centro do cursor (com o tamanho
+                // anterior ao de A, pressionado antes)
+                chord_undo_first(BUTTON_A);
+                escape_formula_t next = (mandelbrot_get_formula() + 1) % ESCAPE_FORMULA_COUNT;
+                float cx = new_x_position + new_cursor_size / 2.0f, cy = new_y_position + new_cursor_size / 2.0f;
+                float k_real = real_start + cx * (real_end - real_start) / SSD1306_WIDTH;
+                float k_imag = im_start + cy * (im_end - im_start) / SSD1306_HEIGHT;
+                mandelbrot_set_formula(next, k_real, k_imag);
+                speculate_cancel();
+                temp_real_start = NAN; // a janela não mudou: força um novo frame
+#if MANDELBROT_DEEP_ZOOM
+                deep_generation++;
+#endif
+                console_printf("formula: %s\n", escape_formula_name(next));
+            }
+            else if (cursor_button_status)
             {
-                new_cursor_size--; // se cursor_button_status for verdadeiro, decrementa o tamanho do cursor.
-                if(new_cursor_size < 0) new_cursor_size = 0;
-                printf("%d\n", new_cursor_size);
+                // se cursor_button_status for verdadeiro, decrementa o tamanho do cursor.
+                chord_single(BUTTON_B, new_cursor_size > 0 ? new_cursor_size - 1 : 0);
+                console_printf("%d\n", new_cursor_size);
             }
             else
             {
+                chord_first_gpio = -1;
                 // chama a função undo_zoom_in para desfazer a ampliação.
-                undo_zoom_in(new_x_position, new_y_position, new_width, new_height);
+                undo_zoom_in();
             }
         }
 
-        if (gpio_get(SW) == 0) // verifica se o botão SW está pressionado (nível lógico baixo).
+        if (gpio == SW) // borda de descida do botão SW.
         {
-            cursor_button_status = !cursor_button_status; // inverte o valor de cursor_button_status.
+            chord_first_gpio = -1;
+            // alterna entre os modos: tamanho do cursor -> ampliação -> ampliação com pan -> tamanho do cursor
+            if (cursor_button_status)
+            {
+                cursor_button_status = false;
+            }
+            else if (!pan_mode)
+            {
+                pan_mode = true; // os botões A e B continuam ampliando e desfazendo no modo pan
+            }
+            else
+            {
+                pan_mode = false;
+                cursor_button_status = true;
+            }
             // indicação visual para ampliação e manipulação do cursor
             // - aceso indica habilitado para ampliação
+            // - piscando indica habilitado para ampliação e deslocamento da janela com o joystick
             // - apagado indica habilitado para manipular tamanho do cursor
-            gpio_put(LED, !gpio_get(LED)); // inverte o estado do LED, fornecendo uma indicação visual se a atual função do botões A e B.
+            gpio_put(LED, !cursor_button_status);
         }
     }
-    // limpa a interrupção do GPIO, permitindo que novas interrupções sejam detectadas.
-    gpio_acknowledge_irq(gpio, events);
 }
 
 int main()
@@ -239,17 +872,42 @@ int main()
     stdio_init_all(); // inicializa as funções de entrada e saída padrão - stdio.h
     setup_general();  // configura as configurações gerais do hardware
     setup_joystick(); // inicializa e configura o joystick
+    axis_filter_reset(&vrx_filter);
+    axis_filter_reset(&vry_filter);
+    joystick_sampling_start(); // amostragem contínua dos eixos por DMA
     setup_i2c();      // inicializa e configura a interface I2C
 
-    render_data = NULL; // garante que o ponteiro não contenha um endereço de memória aleatório ou inválido antes da alocação.
-    // aloca a memória para amazenar os dados do plano complexo utilizados nos cálculos de renderização do conjunto de Mandelbrot
-    render_data = malloc(10 * sizeof(render_data_t));
-    if (render_data == NULL)
-    {
-        // erro de alocação de memória
-        printf("falha ao alocar memória para os dados de renderização\n");
-        return 1;
-    }
+    // o último frame gravado é exibido antes de qualquer cálculo
+    calc_render_area_buflen(&frame_area);
+    flash_store_open(&flash_store, &flash_store_rp2040_backend);
+    render_data_t stored_view;
+    int stored_cap;
+    bool booted_frame = flash_store_load_frame(&flash_store, 0, &stored_view, &stored_cap, buf);
+    if (booted_frame)
+        render(buf, &frame_area);
+    render_platform_init(); // lança o core1, que passa a dividir a renderização dos frames com o core0
+
+#if MANDELBROT_DEEP_ZOOM
+    render_data_t home = {real_start, real_end, im_start, im_end};
+    deep_view_from_render_data(&deep_view, &home);
+#endif
+    zoom_state_t home_state = current_state();
+    zoom_state_t state = home_state;
+    zoom_history_init(&zoom_history, &home_state); // histórico vazio na janela inicial
+
+    // sessão anterior: as ampliações gravadas são reaplicadas e os frames gravados entram no cache
+    if (flash_store_load_session(&flash_store, &zoom_history, &state))
+        set_state(&state);
+    else
+        zoom_history_init(&zoom_history, &home_state); // sessão inválida: recomeça na janela inicial
+    session_dirty = false;
+    for (int i = FLASH_STORE_FRAMES - 1; i >= 0; i--)
+        if (flash_store_load_frame(&flash_store, i, &stored_view, &stored_cap, image_buf))
+            frame_cache_insert(&stored_view, stored_cap, image_buf, NULL); // a flash guarda apenas a imagem
+    console_printf("flash: %u registros descartados, %u setores apagados\n", flash_store.stats.torn,
+                   flash_store.stats.erases);
+
+    input_queue_init(&input_queue); // a fila deve estar vazia antes de habilitar as interrupções produtoras
 
     // habilita a interrupção para os botóes
     gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &button_interruption_gpio_irq_handler);
@@ -259,22 +917,50 @@ int main()
     // inicializa a área de renderização para o frame inteiro (SSD1306_WIDTH pixels por SSD1306_NUM_PAGES páginas)
     calc_render_area_buflen(&frame_area); // chamada sempre que você modificar os parâmetros da área de renderização
 
-    memset(buf, 0, SSD1306_BUF_LEN); // limpa o buffer
-    render(buf, &frame_area);
+    if (!booted_frame)
+    {
+        memset(buf, 0, SSD1306_BUF_LEN); // limpa o buffer
+        render(buf, &frame_area);
+    }
+    SSD1306_tx_init(); // prepara os framebuffers da transmissão assíncrona
 
     struct repeating_timer timer;
     // timer de controle do cursor e controle das renderizações
     add_repeating_timer_ms(48, controller_repeating_timer_callback, NULL, &timer);
 
-    printf("started\n");
+    console_printf("started\n");
 
-    // loop infinito
+    // loop infinito: consome os eventos das interrupções; o tempo livre é usado para pré-renderizar a próxima ampliação (speculate.c)
     while (true)
     {
-        tight_loop_contents(); // função no-op - sem operação
+        input_event_t event;
+        bool tick = false;
+
+        // os botões são tratados na ordem em que ocorreram; as amostras do joystick acumuladas durante uma
+        // renderização longa são agrupadas em uma única leitura e um único redesenho
+        while (input_queue_pop(&input_queue, &event))
+        {
+            if (event.type == INPUT_EVENT_BUTTON)
+                button_event(event.gpio, event.level == 0, event.time_us);
+            tick = true; // um botão também pede redesenho imediato
+        }
+
+        SSD1306_tx_poll(); // observa o fim da transmissão em andamento (instrumentação da I2C)
+#if MANDELBROT_STREAM
+        if (streaming)
+            frame_stream_poll(&frame_stream); // grava apenas o que cabe no buffer da USB, sem esperar
+#endif
+
+        if (tick)
+            controller_tick();
+        else if (!speculate_poll(time_us_64()) && !storage_poll(time_us_64()))
+        {
+#if MANDELBROT_TRACE || MANDELBROT_STREAM
+            if (!console_poll())
+#endif
+                tight_loop_contents(); // função no-op - sem operação
+        }
     }
-    free(render_data);
-    render_data = NULL; // garante que o ponteiro não contenha um endereço de memória pendente após a liberação da memória
 
     return 0; // boas práticas
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "raster.h"
+
+/*!
+ * @brief Retorna a máscara, dentro da página, das linhas no intervalo [y_start, y_end).
+ *
+ * @param page    Página do display.
+ * @param y_start Primeira linha (pode estar antes da página).
+ * @param y_end   Linha final, exclusiva (pode estar depois da página).
+ *
+ * @return uint8_t Bit i = linha `page * 8 + i`; 0 se o intervalo não cruza a página.
+ */
+uint8_t raster_page_mask(int page, int y_start, int y_end)
+{
+    const int height = SSD1306_PAGE_HEIGHT; // com sinal: as linhas podem estar antes da página
+    int first = MAX(y_start - page * height, 0);
+    int last = MIN(y_end - page * height, height); // exclusiva
+    if (first >= last)
+        return 0;
+    return (uint8_t)((0xFF << first) & (0xFF >> (height - last)));
+}
+
+/*!
+ * @brief Aplica a máscara de linhas `mask` às colunas [x_start, x_end) de uma página (já recortadas).
+ */
+static void apply_mask(uint8_t *row, int x_start, int x_end, uint8_t mask, raster_op_t op)
+{
+    if (mask == 0xFF && op != RASTER_XOR)
+    {
+        memset(&row[x_start], op == RASTER_SET ? 0xFF : 0x00, x_end - x_start); // página inteira
+        return;
+    }
+
+    switch (op)
+    {
+    case RASTER_CLEAR:
+        for (int x = x_start; x < x_end; x++)
+            row[x] &= ~mask;
+        break;
+    case RASTER_SET:
+        for (int x = x_start; x < x_end; x++)
+            row[x] |= mask;
+        break;
+    case RASTER_XOR:
+        for (int x = x_start; x < x_end; x++)
+            row[x] ^= mask;
+        break;
+    }
+}
+
+/*!
+ * @brief Aplica a operação ao retângulo de colunas [x_start, x_end) e linhas [y_start, y_end), página a página.
+ */
+static void apply_rect(uint8_t *buf, int x_start, int x_end, int y_start, int y_end, raster_op_t op)
+{
+    x_start = MAX(x_start, 0);
+    x_end = MIN(x_end, SSD1306_WIDTH);
+    y_start = MAX(y_start, 0);
+    y_end = MIN(y_end, SSD1306_HEIGHT);
+    if (x_start >= x_end || y_start >= y_end)
+        return;
+
+    for (int page = y_start / SSD1306_PAGE_HEIGHT; page <= (y_end - 1) / SSD1306_PAGE_HEIGHT; page++)
+        apply_mask(&buf[page * SSD1306_WIDTH], x_start, x_end, raster_page_mask(page, y_start, y_end), op);
+}
+
+/*!
+ * @brief Desenha a linha horizontal [x_start, x_end) na linha `y`: um único bit em cada byte da faixa.
+ */
+void raster_hspan(uint8_t *buf, int x_start, int x_end, int y, raster_op_t op)
+{
+    apply_rect(buf, x_start, x_end, y, y + 1, op);
+}
+
+/*!
+ * @brief Desenha a linha vertical [y_start, y_end) na coluna `x`: um byte por página cruzada.
+ */
+void raster_vspan(uint8_t *buf, int x, int y_start, int y_end, raster_op_t op)
+{
+    apply_rect(buf, x, x + 1, y_start, y_end, op);
+}
+
+/*!
+ * @brief Preenche o retângulo de `width` x `height` pixels com canto superior esquerdo em (left, top).
+ */
+void raster_fill(uint8_t *buf, int left, int top, int width, int height, raster_op_t op)
+{
+    apply_rect(buf, left, left + width, top, top + height, op);
+}
+
+/*!
+ * @brief Desenha o contorno do retângulo de `width` x `height` pixels com canto superior esquerdo em (left, top).
+ *
+ * @details
+ *  - Cada pixel do contorno é coberto exatamente uma vez (os cantos pertencem às bordas horizontais), de forma
+ *    que `RASTER_XOR` desenha o contorno e, aplicado de novo, o apaga.
+ */
+void raster_outline(uint8_t *buf, int left, int top, int width, int height, raster_op_t op)
+{
+    if (width <= 0 || height <= 0)
+        return;
+
+    raster_hspan(buf, left, left + width, top, op);
+    if (height > 1)
+        raster_hspan(buf, left, left + width, top + height - 1, op);
+    if (height > 2)
+    {
+        raster_vspan(buf, left, top + 1, top + height - 1, op);
+        if (width > 1)
+            raster_vspan(buf, left + width - 1, top + 1, top + height - 1, op);
+    }
+}
@@ -0,0 +1,35 @@
+/*!
+ * @file raster.h
+ * @brief Primitivas de desenho no formato de páginas do SSD1306: cada operação escreve bytes inteiros.
+ *
+ * No buffer, o byte `page * SSD1306_WIDTH + x` guarda os 8 pixels verticais da coluna x na página (bit 0 = linha
+ * superior). As primitivas montam a máscara de linhas de cada página uma única vez e a aplicam em cada coluna com
+ * uma leitura e uma escrita, em vez de uma chamada de `set_pixel()` por pixel. As coordenadas fora do display são
+ * recortadas.
+ */
+
+ #ifndef _RASTER_
+ #define _RASTER_
+
+ #include <stdint.h>
+
+ /*!
+  * @brief Operação aplicada aos pixels cobertos pela primitiva.
+  */
+ typedef enum {
+     RASTER_CLEAR, /*!< Apaga. */
+     RASTER_SET,   /*!< Acende. */
+     RASTER_XOR    /*!< Inverte; aplicar duas vezes restaura o buffer. */
+ } raster_op_t;
+
+ uint8_t raster_page_mask(int page, int y_start, int y_end);
+
+ void raster_hspan(uint8_t *buf, int x_start, int x_end, int y, raster_op_t op);
+
+ void raster_vspan(uint8_t *buf, int x, int y_start, int y_end, raster_op_t op);
+
+ void raster_fill(uint8_t *buf, int left, int top, int width, int height, raster_op_t op);
+
+ void raster_outline(uint8_t *buf, int left, int top, int width, int height, raster_op_t op);
+
+ #endif
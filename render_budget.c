@@ -0,0 +1,379 @@
+#include <math.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "render_budget.h"
+#include "viewport.h"
+
+static uint64_t default_clock()
+{
+    return time_us_64();
+}
+
+static budget_clock_fn clock_fn = default_clock;
+static uint32_t budget_us = BUDGET_FRAME_US;
+
+static budget_frame_t last;                        // relatório do último frame registrado
+static uint32_t last_escapes[MANDELBROT_HIST_BINS]; // histograma de escape do último frame registrado
+static bool has_history = false;
+
+static int frame_cap;                       // limite escolhido para o frame em andamento
+static int frame_reached;                   // limite da última passada completa do frame em andamento
+static uint32_t frame_passes;               // passadas executadas no frame em andamento
+static uint64_t frame_us;                   // tempo já gasto no frame em andamento
+static mandelbrot_stats_t frame_total;      // estatísticas das passadas completas do frame em andamento
+static uint8_t before[SSD1306_FRAME_LEN];   // frame antes de um aprofundamento, para desfazê-lo
+static uint64_t deep_deadline;              // prazo do aprofundamento por perturbação em andamento
+
+/*!
+ * @brief Substitui o relógio do orçamento (NULL restaura `time_us_64()`).
+ */
+void budget_set_clock(budget_clock_fn clock)
+{
+    clock_fn = clock ? clock : default_clock;
+}
+
+/*!
+ * @brief Define o orçamento de tempo de cada frame, em microssegundos.
+ */
+void budget_set_limit(uint32_t limit_us)
+{
+    budget_us = limit_us;
+}
+
+/*!
+ * @brief Esquece o frame anterior: o próximo limite depende apenas da profundidade.
+ */
+void budget_reset()
+{
+    memset(&last, 0, sizeof(last));
+    memset(last_escapes, 0, sizeof(last_escapes));
+    has_history = false;
+}
+
+/*!
+ * @brief Escolhe o limite de iterações do próximo frame.
+ *
+ * @param pixel_step Largura de um pixel no plano complexo.
+ *
+ * @return int Limite entre `BUDGET_MIN_ITER` e `MANDELBROT_ITER_LIMIT`.
+ *
+ * @details
+ *  - Profundidade: `BUDGET_BASE_ITER` na janela inicial, mais `BUDGET_ITER_PER_OCTAVE` por oitava de ampliação.
+ *  - Histograma: se muitos pixels do frame anterior escaparam no último quarto do limite alcançado, o limite
+ *    passa a ser pelo menos 1,5 vez esse limite.
+ *  - Tempo: se o frame anterior excedeu o orçamento, o limite é reduzido na mesma proporção.
+ */
+int budget_choose_cap(float pixel_step)
+{
+    render_data_t home = VIEWPORT_HOME;
+    float home_step = (home.real_end - home.real_start) / SSD1306_WIDTH;
+    int octaves = 0;
+
+    if (pixel_step > 0.0f && pixel_step < home_step)
+    {
+        frexpf(home_step / pixel_step, &octaves);
+        octaves--; // frexpf retorna o expoente de uma mantissa em [0.5, 1)
+    }
+    int cap = BUDGET_BASE_ITER + BUDGET_ITER_PER_OCTAVE * octaves;
+
+    if (has_history && last.cap_reached > 0)
+    {
+        uint32_t total = 0, near = 0;
+        int near_bin = (3 * last.cap_reached / 4) / MANDELBROT_HIST_BIN_ITERS;
+        for (int i = 0; i < MANDELBROT_HIST_BINS; i++)
+        {
+            total += last_escapes[i];
+            if (i >= near_bin)
+                near += last_escapes[i];
+        }
+        if (near * BUDGET_NEAR_CAP_SHARE > total)
+            cap = MAX(cap, 3 * last.cap_reached / 2);
+
+        if (last.frame_us > budget_us)
+            cap = MIN(cap, (int)((uint64_t)last.cap_reached * budget_us / last.frame_us));
+    }
+
+    return MAX(BUDGET_MIN_ITER, MIN(cap, MANDELBROT_ITER_LIMIT));
+}
+
+/*!
+ * @brief Registra um frame concluído, cujo histograma e tempo orientam a escolha do próximo limite.
+ *
+ * @param cap_chosen  Limite escolhido para o frame.
+ * @param cap_reached Limite com que o frame foi concluído.
+ * @param escapes     Histograma de escape do frame (`MANDELBROT_HIST_BINS` faixas).
+ * @param frame_us    Tempo de renderização do frame.
+ */
+void budget_record(int cap_chosen, int cap_reached, const uint32_t *escapes, uint64_t frame_us)
+{
+    last.budget_us = budget_us;
+    last.cap_chosen = cap_chosen;
+    last.cap_reached = cap_reached;
+    last.frame_us = frame_us;
+    last.over_budget = cap_reached < cap_chosen;
+    memcpy(last_escapes, escapes, sizeof(last_escapes));
+    has_history = true;
+}
+
+/*!
+ * @brief Desfaz as colunas `[0, x_end)` de uma passada interrompida: os pixels apagados voltam a ficar acesos, com o
+ *        campo de iterações de um ponto que atingiu o limite anterior.
+ */
+static void undo_columns(uint8_t *buf, const uint8_t *before, int x_end)
+{
+    uint8_t *field = mandelbrot_field(buf);
+
+    for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+    {
+        for (int x = 0; x < x_end; x++)
+        {
+            int i = page * SSD1306_WIDTH + x;
+            uint8_t cleared = before[i] & ~buf[i];
+            for (int bit = 0; field && cleared; bit++, cleared >>= 1)
+                if (cleared & 1)
+                    field[(page * SSD1306_PAGE_HEIGHT + bit) * SSD1306_WIDTH + x] = MANDELBROT_FIELD_INSIDE;
+            buf[i] = before[i];
+        }
+    }
+}
+
+/*!
+ * @brief Reavalia, com o limite `cap`, os pixels acesos do frame (que atingiram o limite anterior).
+ *
+ * @return bool Falso se o prazo se esgotou antes do fim; o frame e o campo voltam a ser os do limite anterior.
+ *
+ * @details
+ *  - As coordenadas são calculadas exatamente como em `draw_mandelbrot_block()`.
+ *  - A passada é concluída inteira ou desfeita: uma passada parcial deixaria as colunas da esquerda com o limite
+ *    `cap` e as da direita com o anterior (uma emenda visível no frame).
+ */
+static bool deepen(uint8_t *buf, const render_data_t *view, int cap, uint64_t deadline, mandelbrot_stats_t *stats)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    uint8_t *field = mandelbrot_field(buf);
+
+    memcpy(before, buf, SSD1306_FRAME_LEN);
+    for (int x = 0; x < SSD1306_WIDTH; x++)
+    {
+        if (clock_fn() >= deadline)
+        {
+            undo_columns(buf, before, x);
+            return false;
+        }
+
+        float real = view->real_start + x * stepX;
+        for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+        {
+            uint8_t *byte = &buf[page * SSD1306_WIDTH + x];
+            uint8_t lit = *byte; // pixels que ainda não escaparam; os demais escaparam com um limite menor
+            for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+            {
+                if (!(lit >> bit & 1))
+                    continue;
+                int y = page * SSD1306_PAGE_HEIGHT + bit;
+                float imag = view->im_start + y * stepY;
+                int m = mandelbrot_point(real, imag, stats, NULL);
+                if (m < cap)
+                {
+                    lit &= ~(1 << bit);
+                    if (field)
+                        field[y * SSD1306_WIDTH + x] = (uint8_t)m; // os pixels que seguem acesos mantêm o valor
+                }
+            }
+            *byte = lit;
+        }
+    }
+    return true;
+}
+
+/*!
+ * @brief Encerra o frame em andamento com o último limite completo e o registra.
+ *
+ * @return bool Sempre falso (não há mais passadas).
+ */
+static bool finish_frame()
+{
+    mandelbrot_set_max_iter(frame_reached);
+    budget_record(frame_cap, frame_reached, frame_total.escapes, frame_us);
+    last.passes = frame_passes;
+    last.iterations = frame_total.iterations;
+    return false;
+}
+
+/*!
+ * @brief Inicia um frame renderizado em passadas: a primeira usa até `BUDGET_FIRST_ITER` iterações.
+ *
+ * @param cap Limite escolhido para o frame (`budget_choose_cap()`).
+ *
+ * @return int Limite da primeira passada, já aplicado com `mandelbrot_set_max_iter()`.
+ */
+int budget_start(int cap)
+{
+    frame_cap = cap;
+    frame_reached = MIN(cap, BUDGET_FIRST_ITER);
+    frame_passes = 1;
+    frame_us = 0;
+    memset(&frame_total, 0, sizeof(frame_total));
+    mandelbrot_set_max_iter(frame_reached);
+    return frame_reached;
+}
+
+/*!
+ * @brief Registra a conclusão da primeira passada do frame iniciado por `budget_start()`.
+ *
+ * @param stats      Estatísticas da primeira passada.
+ * @param elapsed_us Tempo gasto na primeira passada.
+ *
+ * @return bool Verdadeiro se o frame deve ser aprofundado com `budget_deepen()`; falso se foi concluído e
+ *              registrado.
+ */
+bool budget_first_done(const mandelbrot_stats_t *stats, uint64_t elapsed_us)
+{
+    frame_total = *stats;
+    frame_us += elapsed_us;
+    return frame_reached < frame_cap ? true : finish_frame();
+}
+
+/*!
+ * @brief Executa uma passada de aprofundamento do frame em andamento, dobrando o limite (até o escolhido).
+ *
+ * @param buf   Frame da última passada completa (com o campo de iterações retido, se houver).
+ * @param view  Limites do plano complexo.
+ * @param stats Estatísticas da passada (pode ser NULL).
+ *
+ * @return bool Verdadeiro se ainda há passadas; falso se o frame foi concluído e registrado, com o limite
+ *              alcançado em `mandelbrot_get_max_iter()`.
+ *
+ * @details O prazo da passada é o que resta do orçamento, descontado o tempo das passadas anteriores do frame,
+ *          de modo que as passadas podem ser intercaladas com a leitura dos controles. Uma passada interrompida
+ *          é desfeita e encerra o frame.
+ */
+bool budget_deepen(uint8_t *buf, const render_data_t *view, mandelbrot_stats_t *stats)
+{
+    int next = MIN(frame_cap, 2 * frame_reached);
+    uint64_t start = clock_fn();
+    uint64_t deadline = start + (frame_us < budget_us ? budget_us - frame_us : 0);
+    mandelbrot_stats_t pass = {0};
+
+    mandelbrot_set_max_iter(next);
+    frame_passes++;
+    bool complete = deepen(buf, view, next, deadline, &pass);
+    frame_us += clock_fn() - start;
+    if (stats)
+        *stats = pass;
+
+    if (!complete)
+    {
+        frame_total.iterations += pass.iterations; // trabalho descartado, mas executado
+        return finish_frame();
+    }
+    mandelbrot_stats_add(&frame_total, &pass);
+    frame_reached = next;
+    if (frame_reached >= frame_cap)
+        return finish_frame();
+    mandelbrot_set_max_iter(frame_reached);
+    return true;
+}
+
+/*!
+ * @brief Renderiza um frame com o limite de iterações escolhido pela política, dentro do orçamento de tempo.
+ *
+ * @param buf  Um ponteiro para o buffer do display.
+ * @param view Limites do plano complexo.
+ *
+ * @return const budget_frame_t* Relatório do frame (também disponível em `budget_last_frame()`).
+ *
+ * @details
+ *  - A primeira passada usa `draw_mandelbrot_frame()` com até `BUDGET_FIRST_ITER` iterações; cada passada
+ *    seguinte dobra o limite (até o escolhido) e reavalia apenas os pixels acesos, já que um pixel que escapou
+ *    com um limite menor escapa com qualquer limite maior.
+ *  - O prazo é verificado entre colunas. Ao se esgotar, a passada em andamento é desfeita e o frame fica com o
+ *    último limite completo, e o limite dos kernels (`mandelbrot_set_max_iter()`) fica nesse valor. O histograma
+ *    registrado é o das passadas completas.
+ *  - Sem o prazo, o resultado é o de `draw_mandelbrot_frame()` com o limite escolhido, exceto pelos pixels que os
+ *    modos de subdivisão não conservadores teriam preenchido de outra forma.
+ */
+const budget_frame_t *budget_render(uint8_t *buf, const render_data_t *view)
+{
+    uint64_t start = clock_fn();
+
+    budget_start(budget_choose_cap((view->real_end - view->real_start) / SSD1306_WIDTH));
+    draw_mandelbrot_frame(buf, view);
+    if (budget_first_done(mandelbrot_frame_stats(), clock_fn() - start))
+        while (budget_deepen(buf, view, NULL))
+            ;
+    return &last;
+}
+
+/*!
+ * @brief Indica se o prazo do aprofundamento por perturbação em andamento se esgotou.
+ */
+static bool deep_expired()
+{
+    return clock_fn() >= deep_deadline;
+}
+
+/*!
+ * @brief Renderiza a janela de precisão estendida com o limite escolhido pela política, dentro do orçamento.
+ *
+ * @param buf   Um ponteiro para o buffer do display.
+ * @param view  Janela em precisão estendida.
+ * @param stats Estatísticas somadas das passadas (pode ser NULL).
+ *
+ * @return const budget_frame_t* Relatório do frame (também disponível em `budget_last_frame()`).
+ *
+ * @details
+ *  - Como em `budget_render()`: a primeira passada avalia todos os pixels com até `BUDGET_FIRST_ITER` iterações
+ *    e cada passada seguinte dobra o limite, reavaliando apenas os pixels acesos.
+ *  - O prazo é verificado entre as órbitas de referência. Na primeira passada, o prazo esgotado encerra a busca
+ *    de referências (os pixels com falha ficam em `unresolved`); num aprofundamento, a passada é desfeita e o
+ *    frame fica com o último limite completo.
+ */
+const budget_frame_t *budget_render_deep(uint8_t *buf, const deep_view_t *view, deep_stats_t *stats)
+{
+    uint64_t start = clock_fn();
+    deep_stats_t total = {0}, pass;
+
+    deep_deadline = start + budget_us;
+    budget_start(budget_choose_cap(ldexpf(view->step_x, view->step_exp)));
+    draw_mandelbrot_deep_pass(buf, view, NULL, false, deep_expired, &total);
+
+    while (frame_reached < frame_cap)
+    {
+        int next = MIN(frame_cap, 2 * frame_reached);
+        mandelbrot_set_max_iter(next);
+        frame_passes++;
+        memcpy(before, buf, SSD1306_FRAME_LEN);
+        bool complete = draw_mandelbrot_deep_pass(buf, view, NULL, true, deep_expired, &pass);
+        total.references += pass.references;
+        total.reference_iterations += pass.reference_iterations;
+        total.iterations += pass.iterations;
+        if (!complete)
+        {
+            undo_columns(buf, before, SSD1306_WIDTH);
+            break;
+        }
+        total.glitched += pass.glitched;
+        total.unresolved += pass.unresolved;
+        for (int i = 0; i < MANDELBROT_HIST_BINS; i++)
+            total.escapes[i] += pass.escapes[i];
+        frame_reached = next;
+    }
+
+    memcpy(frame_total.escapes, total.escapes, sizeof(total.escapes));
+    frame_total.iterations = total.reference_iterations + total.iterations;
+    frame_us = clock_fn() - start;
+    finish_frame();
+    if (stats)
+        *stats = total;
+    return &last;
+}
+
+/*!
+ * @brief Retorna o relatório do último frame registrado.
+ */
+const budget_frame_t *budget_last_frame()
+{
+    return &last;
+}
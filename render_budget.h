@@ -0,0 +1,84 @@
+/*!
+ * @file render_budget.h
+ * @brief Escolha do limite de iterações por frame, com orçamento de tempo.
+ *
+ * O limite de iterações de cada frame é escolhido a partir da profundidade da ampliação e do histograma de
+ * escape do frame anterior: janelas rasas usam poucas iterações (menor latência), e o limite cresce com a
+ * ampliação e quando muitos pixels do frame anterior escaparam perto do limite (a borda se dissolvendo).
+ *
+ * `budget_render()` renderiza o frame com um limite baixo e o aprofunda em passadas sucessivas, dobrando o
+ * limite e reavaliando apenas os pixels que o atingiram. Se o orçamento de tempo se esgota, o frame é
+ * entregue com o limite já alcançado, em vez de atrasar a leitura dos controles. `budget_start()`,
+ * `budget_first_done()` e `budget_deepen()` executam as mesmas passadas uma a uma, para quem renderiza a primeira
+ * passada por conta própria (a renderização progressiva); `budget_render_deep()` aplica o mesmo orçamento à
+ * janela de precisão estendida.
+ */
+
+ #ifndef _RENDER_BUDGET_
+ #define _RENDER_BUDGET_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "render_deep.h"
+
+ /*! @brief Orçamento de tempo padrão de um frame, em microssegundos. */
+ #define BUDGET_FRAME_US 40000
+
+ /*! @brief Limite de iterações da janela inicial. */
+ #define BUDGET_BASE_ITER 48
+
+ /*! @brief Iterações acrescentadas ao limite a cada oitava (divisão da largura por dois) de ampliação. */
+ #define BUDGET_ITER_PER_OCTAVE 8
+
+ /*! @brief Menor limite de iterações escolhido. */
+ #define BUDGET_MIN_ITER 24
+
+ /*! @brief Limite de iterações da primeira passada de `budget_render()`. */
+ #define BUDGET_FIRST_ITER 32
+
+ /*!
+  * @brief O limite é aumentado em 50% quando mais de 1/BUDGET_NEAR_CAP_SHARE dos pixels que escaparam no frame
+  *        anterior o fizeram no último quarto do limite.
+  */
+ #define BUDGET_NEAR_CAP_SHARE 8
+
+ /*! @brief Relógio em microssegundos utilizado pelo orçamento (substituível nos testes). */
+ typedef uint64_t (*budget_clock_fn)(void);
+
+ /*!
+  * @brief Relatório de um frame.
+  */
+ typedef struct {
+     uint32_t budget_us; /*!< Orçamento de tempo vigente. */
+     int cap_chosen;     /*!< Limite de iterações escolhido pela política. */
+     int cap_reached;    /*!< Limite com que todos os pixels foram avaliados. */
+     uint64_t frame_us;  /*!< Tempo de renderização do frame. */
+     uint32_t passes;    /*!< Passadas executadas (a primeira e os aprofundamentos, inclusive o interrompido). */
+     bool over_budget;   /*!< O orçamento se esgotou antes de `cap_chosen`. */
+     uint32_t iterations; /*!< Iterações executadas em todas as passadas. */
+ } budget_frame_t;
+
+ void budget_set_clock(budget_clock_fn clock);
+
+ void budget_set_limit(uint32_t budget_us);
+
+ void budget_reset();
+
+ int budget_choose_cap(float pixel_step);
+
+ void budget_record(int cap_chosen, int cap_reached, const uint32_t *escapes, uint64_t frame_us);
+
+ int budget_start(int cap);
+
+ bool budget_first_done(const mandelbrot_stats_t *stats, uint64_t elapsed_us);
+
+ bool budget_deepen(uint8_t *buf, const render_data_t *view, mandelbrot_stats_t *stats);
+
+ const budget_frame_t *budget_render(uint8_t *buf, const render_data_t *view);
+
+ const budget_frame_t *budget_render_deep(uint8_t *buf, const deep_view_t *view, deep_stats_t *stats);
+
+ const budget_frame_t *budget_last_frame();
+
+ #endif
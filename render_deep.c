@@ -0,0 +1,369 @@
+#include <math.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "render_deep.h"
+
+#define DEEP_NUM_PIXELS (SSD1306_WIDTH * SSD1306_HEIGHT)
+
+/*!
+ * @brief Órbita de referência, reduzida a float para a iteração dos deltas.
+ */
+typedef struct {
+    float re[MANDELBROT_ITER_LIMIT + 1];
+    float im[MANDELBROT_ITER_LIMIT + 1];
+    float mag[MANDELBROT_ITER_LIMIT + 1]; // |Z[n]|^2, para a detecção de falhas
+    int count;                            // número de elementos válidos (a órbita termina ao escapar)
+    int max_iter;                         // limite de iterações do frame (`mandelbrot_get_max_iter()`)
+} reference_t;
+
+static reference_t reference;
+static uint8_t pending[DEEP_NUM_PIXELS / 8]; // pixels ainda sem resultado confiável (bit = pixel)
+
+// ---- aritmética double-double (Dekker / Knuth), sem depender de FMA ----
+
+static dd_t dd_from_double(double a)
+{
+    dd_t r = {a, 0.0};
+    return r;
+}
+
+static dd_t two_sum(double a, double b)
+{
+    double s = a + b;
+    double bb = s - a;
+    dd_t r = {s, (a - (s - bb)) + (b - bb)};
+    return r;
+}
+
+static dd_t quick_two_sum(double a, double b)
+{
+    double s = a + b;
+    dd_t r = {s, b - (s - a)};
+    return r;
+}
+
+static dd_t two_prod(double a, double b)
+{
+    const double split = 134217729.0; // 2^27 + 1
+    double p = a * b;
+    double ta = split * a, tb = split * b;
+    double ahi = ta - (ta - a), alo = a - ahi;
+    double bhi = tb - (tb - b), blo = b - bhi;
+    dd_t r = {p, ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo};
+    return r;
+}
+
+static dd_t dd_add(dd_t a, dd_t b)
+{
+    dd_t s = two_sum(a.hi, b.hi);
+    dd_t t = two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quick_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quick_two_sum(s.hi, s.lo);
+}
+
+static dd_t dd_mul(dd_t a, dd_t b)
+{
+    dd_t p = two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quick_two_sum(p.hi, p.lo);
+}
+
+static dd_t dd_add_double(dd_t a, double b)
+{
+    return dd_add(a, dd_from_double(b));
+}
+
+// ---- janela em precisão estendida ----
+
+/*!
+ * @brief Normaliza as mantissas do passo para [0.5, 1) em step_x, ajustando o expoente comum.
+ */
+static void normalize_step(deep_view_t *deep)
+{
+    int e;
+    deep->step_x = frexpf(deep->step_x, &e);
+    deep->step_y = ldexpf(deep->step_y, -e);
+    deep->step_exp += e;
+}
+
+/*!
+ * @brief Converte uma janela `float` em janela de precisão estendida.
+ *
+ * @details O centro é calculado exatamente, de forma que o pixel (x, y) corresponde ao mesmo ponto que
+ *          `draw_mandelbrot_block()` calcula (a menos do arredondamento em float daquela função).
+ */
+void deep_view_from_render_data(deep_view_t *deep, const render_data_t *view)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+
+    deep->center_re = dd_add(dd_from_double(view->real_start), dd_from_double((double)stepX * (SSD1306_WIDTH / 2)));
+    deep->center_im = dd_add(dd_from_double(view->im_start), dd_from_double((double)stepY * (SSD1306_HEIGHT / 2)));
+    deep->step_x = stepX;
+    deep->step_y = stepY;
+    deep->step_exp = 0;
+    normalize_step(deep);
+}
+
+/*!
+ * @brief Aproxima a janela de precisão estendida por uma janela `float` (exibição, depuração, chaves de cache rasas).
+ */
+void deep_view_to_render_data(const deep_view_t *deep, render_data_t *view)
+{
+    double half_w = ldexp((double)deep->step_x * (SSD1306_WIDTH / 2), deep->step_exp);
+    double half_h = ldexp((double)deep->step_y * (SSD1306_HEIGHT / 2), deep->step_exp);
+    double cr = deep->center_re.hi + deep->center_re.lo;
+    double ci = deep->center_im.hi + deep->center_im.lo;
+
+    view->real_start = (float)(cr - half_w);
+    view->real_end = (float)(cr + half_w);
+    view->im_start = (float)(ci - half_h);
+    view->im_end = (float)(ci + half_h);
+}
+
+/*!
+ * @brief Amplia a janela para a região selecionada pelo cursor, com a mesma geometria de `viewport_zoom_in()`.
+ *
+ * @details
+ *  - O novo centro é o centro do cursor (em pixels inteiros, como em `viewport_zoom_in()`), e o novo
+ *    passo é o passo atual multiplicado por (2 * (width / 2)) / SSD1306_WIDTH.
+ *  - Cursores com menos de 2 pixels, ou ampliações além de `DEEP_MIN_STEP_EXP`, são ignorados.
+ */
+void deep_view_zoom_in(deep_view_t *deep, uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+{
+    int x0 = left + width / 2;
+    int y0 = top + height / 2;
+    int span_x = 2 * (width / 2);
+    int span_y = 2 * (height / 2);
+
+    if (span_x == 0 || span_y == 0)
+        return;
+
+    double offset_re = ldexp((double)deep->step_x * (x0 - SSD1306_WIDTH / 2), deep->step_exp);
+    double offset_im = ldexp((double)deep->step_y * (y0 - SSD1306_HEIGHT / 2), deep->step_exp);
+
+    deep_view_t next = *deep;
+    next.center_re = dd_add_double(deep->center_re, offset_re);
+    next.center_im = dd_add_double(deep->center_im, offset_im);
+    next.step_x = deep->step_x * span_x / SSD1306_WIDTH;
+    next.step_y = deep->step_y * span_y / SSD1306_HEIGHT;
+    normalize_step(&next);
+
+    if (next.step_exp < DEEP_MIN_STEP_EXP)
+        return;
+    *deep = next;
+}
+
+/*!
+ * @brief Indica se o passo de pixel está abaixo da resolução dos kernels `float` / Q3.28.
+ */
+bool deep_view_needs_perturbation(const deep_view_t *deep)
+{
+    return ldexpf(deep->step_x, deep->step_exp) < DEEP_STEP_LIMIT;
+}
+
+// ---- renderização ----
+
+/*!
+ * @brief Calcula a órbita de referência em precisão estendida no ponto (cr, ci).
+ */
+static void compute_reference(dd_t cr, dd_t ci, deep_stats_t *stats)
+{
+    dd_t zr = dd_from_double(0.0), zi = dd_from_double(0.0);
+    int n = 0;
+
+    for (;;)
+    {
+        float fr = (float)(zr.hi + zr.lo), fi = (float)(zi.hi + zi.lo);
+        reference.re[n] = fr;
+        reference.im[n] = fi;
+        reference.mag[n] = fr * fr + fi * fi;
+        if (n == reference.max_iter || zr.hi * zr.hi + zi.hi * zi.hi > 4.0)
+            break;
+
+        // Z = Z^2 + C
+        dd_t zr2 = dd_mul(zr, zr), zi2 = dd_mul(zi, zi), zri = dd_mul(zr, zi);
+        zr = dd_add(dd_add(zr2, (dd_t){-zi2.hi, -zi2.lo}), cr);
+        zi = dd_add(dd_add(zri, zri), ci);
+        n++;
+    }
+    reference.count = n + 1;
+    stats->references++;
+    stats->reference_iterations += n;
+}
+
+/*!
+ * @brief Itera o delta de um pixel em relação à referência.
+ *
+ * @param dcr, dci Diferença entre o ponto do pixel e o ponto da referência.
+ * @param glitch   Recebe verdadeiro se o resultado não é confiável com esta referência.
+ * @param work     Acumula as iterações executadas.
+ *
+ * @return int Número de iterações até o escape (mesma convenção de `mandelbrot()`), ou o limite de iterações.
+ */
+static int iterate_delta(float dcr, float dci, bool *glitch, uint32_t *work)
+{
+    float dr = 0.0f, di = 0.0f;
+    int n = 0;
+
+    *glitch = false;
+    while (n < reference.max_iter)
+    {
+        if (n + 1 >= reference.count)
+        {
+            *glitch = true; // a referência escapou antes do pixel
+            break;
+        }
+
+        float zr = reference.re[n], zi = reference.im[n];
+        float nr = 2.0f * (zr * dr - zi * di) + dcr;
+        float ni = 2.0f * (zr * di + zi * dr) + dci;
+        if (fabsf(dr) + fabsf(di) > DEEP_LINEAR_LIMIT) // abaixo do limite, d^2 está fora da precisão do float
+        {
+            nr += dr * dr - di * di;
+            ni += 2.0f * dr * di;
+        }
+        dr = nr;
+        di = ni;
+        n++;
+
+        float xr = reference.re[n] + dr, xi = reference.im[n] + di;
+        float mag = xr * xr + xi * xi;
+        if (mag > 4.0f)
+            break;
+        if (mag < DEEP_GLITCH_TOLERANCE * reference.mag[n])
+        {
+            *glitch = true;
+            break;
+        }
+    }
+    *work += n;
+    return n;
+}
+
+/*!
+ * @brief Renderiza a janela de precisão estendida por perturbação.
+ *
+ * @param buf    Um ponteiro para o buffer do display.
+ * @param deep   Janela em precisão estendida.
+ * @param counts Recebe o número de iterações de cada pixel, índice y * SSD1306_WIDTH + x (pode ser NULL).
+ * @param stats  Estatísticas do frame (pode ser NULL).
+ *
+ * @details Equivale a `draw_mandelbrot_deep_pass()` sobre todos os pixels, sem prazo.
+ */
+void draw_mandelbrot_deep(uint8_t *buf, const deep_view_t *deep, uint8_t *counts, deep_stats_t *stats)
+{
+    draw_mandelbrot_deep_pass(buf, deep, counts, false, NULL, stats);
+}
+
+/*!
+ * @brief Renderiza os pixels da janela de precisão estendida por perturbação, com um prazo.
+ *
+ * @param buf      Um ponteiro para o buffer do display.
+ * @param deep     Janela em precisão estendida.
+ * @param counts   Recebe o número de iterações de cada pixel avaliado, índice y * SSD1306_WIDTH + x (pode ser NULL).
+ * @param lit_only Avalia apenas os pixels acesos em `buf` (aprofundamento: os demais escaparam com um limite menor).
+ * @param expired  Consultada antes de cada referência (da primeira, só num aprofundamento) (pode ser NULL).
+ * @param stats    Estatísticas da passada (pode ser NULL).
+ *
+ * @return bool Falso se um aprofundamento (`lit_only`) foi interrompido pelo prazo, com parte dos pixels já
+ *              atualizada: cabe a quem chama desfazê-lo.
+ *
+ * @details
+ *  - A primeira referência é o centro da janela; enquanto houver pixels com falha, uma nova referência é
+ *    calculada no pixel com falha mais próximo do meio da lista, até `DEEP_MAX_REFERENCES` referências.
+ *  - Pixels que ainda falham com a última referência mantêm o resultado dela (contados em `unresolved`).
+ *  - Na renderização de todos os pixels, o prazo esgotado torna a próxima referência a última: o frame é
+ *    concluído, com os pixels que ainda falhariam contados em `unresolved`.
+ */
+bool draw_mandelbrot_deep_pass(uint8_t *buf, const deep_view_t *deep, uint8_t *counts, bool lit_only,
+                               deep_expired_fn expired, deep_stats_t *stats)
+{
+    deep_stats_t local = {0};
+    int ref_x = SSD1306_WIDTH / 2, ref_y = SSD1306_HEIGHT / 2;
+    int remaining = DEEP_NUM_PIXELS;
+    uint8_t *field = mandelbrot_field(buf);
+    bool complete = true;
+
+    memset(pending, 0xFF, sizeof(pending));
+    if (lit_only)
+    {
+        remaining = 0;
+        for (int i = 0; i < DEEP_NUM_PIXELS; i++)
+        {
+            int x = i % SSD1306_WIDTH, y = i / SSD1306_WIDTH;
+            if (buf[(y / SSD1306_PAGE_HEIGHT) * SSD1306_WIDTH + x] >> (y % SSD1306_PAGE_HEIGHT) & 1)
+                remaining++;
+            else
+                pending[i / 8] &= ~(1 << (i % 8));
+        }
+    }
+    reference.max_iter = mandelbrot_get_max_iter();
+
+    for (int r = 0; r < DEEP_MAX_REFERENCES && remaining > 0; r++)
+    {
+        bool late = (r > 0 || lit_only) && expired && expired();
+        if (late && lit_only)
+        {
+            complete = false;
+            break;
+        }
+
+        dd_t cr = dd_add_double(deep->center_re, ldexp((double)deep->step_x * (ref_x - SSD1306_WIDTH / 2), deep->step_exp));
+        dd_t ci = dd_add_double(deep->center_im, ldexp((double)deep->step_y * (ref_y - SSD1306_HEIGHT / 2), deep->step_exp));
+        compute_reference(cr, ci, &local);
+
+        bool last = (r == DEEP_MAX_REFERENCES - 1) || late;
+        int glitched = 0, pick = remaining / 2, next_x = ref_x, next_y = ref_y;
+
+        for (int i = 0; i < DEEP_NUM_PIXELS; i++)
+        {
+            if (!(pending[i / 8] & (1 << (i % 8))))
+                continue;
+
+            int x = i % SSD1306_WIDTH, y = i / SSD1306_WIDTH;
+            float dcr = ldexpf(deep->step_x * (float)(x - ref_x), deep->step_exp);
+            float dci = ldexpf(deep->step_y * (float)(y - ref_y), deep->step_exp);
+            bool glitch;
+            int m = iterate_delta(dcr, dci, &glitch, &local.iterations);
+
+            if (glitch && !last)
+            {
+                // escolhe como próxima referência o pixel com falha no meio da lista
+                if (glitched++ == pick || glitched == 1)
+                {
+                    next_x = x;
+                    next_y = y;
+                }
+                local.glitched++;
+                continue;
+            }
+            if (glitch)
+            {
+                local.glitched++;
+                local.unresolved++;
+            }
+
+            pending[i / 8] &= ~(1 << (i % 8));
+            set_pixel(buf, x, y, m == reference.max_iter);
+            if (counts)
+                counts[i] = (uint8_t)m;
+            if (field)
+                field[y * SSD1306_WIDTH + x] = m == reference.max_iter ? MANDELBROT_FIELD_INSIDE : (uint8_t)m;
+            if (m < reference.max_iter)
+                local.escapes[m / MANDELBROT_HIST_BIN_ITERS]++;
+        }
+
+        remaining = glitched;
+        ref_x = next_x;
+        ref_y = next_y;
+        if (last)
+            break;
+    }
+
+    if (stats)
+        *stats = local;
+    return complete;
+}
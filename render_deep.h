@@ -0,0 +1,86 @@
+/*!
+ * @file render_deep.h
+ * @brief Renderização de ampliações profundas por perturbação.
+ *
+ * Abaixo de `DEEP_STEP_LIMIT` por pixel, o `float` (e o Q3.28) já não distinguem pixels vizinhos. A janela
+ * passa a ser representada por um centro em precisão estendida (double-double, ~106 bits) e um passo
+ * de pixel em mantissa + expoente. Uma órbita de referência é calculada em precisão estendida por frame,
+ * e cada pixel itera apenas a diferença (delta) em relação a ela, em `float`:
+ *
+ *     d[n+1] = 2 Z[n] d[n] + d[n]^2 + dc
+ *
+ * Pixels cuja diferença perde precisão (|Z + d| muito menor que |Z|) são marcados como falhas ("glitches")
+ * e recalculados a partir de uma nova referência escolhida entre eles.
+ */
+
+ #ifndef _RENDER_DEEP_
+ #define _RENDER_DEEP_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Passo de pixel abaixo do qual a renderização por perturbação é utilizada. */
+ #define DEEP_STEP_LIMIT 0x1p-20f
+
+ /*! @brief Menor expoente do passo de pixel suportado (limite de precisão do centro double-double). */
+ #define DEEP_MIN_STEP_EXP -104
+
+ /*! @brief Número máximo de referências por frame (a primeira mais as novas bases). */
+ #define DEEP_MAX_REFERENCES 8
+
+ /*! @brief Magnitude do delta abaixo da qual o termo quadrático é desprezado (fase linear). */
+ #define DEEP_LINEAR_LIMIT 0x1p-32f
+
+ /*! @brief Limite de |Z + d|^2 / |Z|^2 abaixo do qual o pixel é considerado uma falha de precisão. */
+ #define DEEP_GLITCH_TOLERANCE 1e-4f
+
+ /*!
+  * @brief Número em precisão estendida, representado pela soma não sobreposta de dois doubles.
+  */
+ typedef struct {
+     double hi, lo;
+ } dd_t;
+
+ /*!
+  * @brief Janela em precisão estendida: centro e passo de pixel.
+  *
+  * O pixel (x, y) corresponde a center + ((x - SSD1306_WIDTH / 2) * step_x, (y - SSD1306_HEIGHT / 2) * step_y) * 2^step_exp.
+  */
+ typedef struct {
+     dd_t center_re, center_im; /*!< Centro da janela. */
+     float step_x, step_y;      /*!< Mantissas do passo de pixel. */
+     int32_t step_exp;          /*!< Expoente comum do passo de pixel. */
+ } deep_view_t;
+
+ /*!
+  * @brief Função consultada entre as órbitas de referência; retorna verdadeiro quando o prazo do frame se esgotou.
+  */
+ typedef bool (*deep_expired_fn)(void);
+
+ /*!
+  * @brief Estatísticas do último frame renderizado por perturbação.
+  */
+ typedef struct {
+     uint32_t references;           /*!< Órbitas de referência calculadas. */
+     uint32_t reference_iterations; /*!< Iterações em precisão estendida. */
+     uint32_t iterations;           /*!< Iterações dos deltas, em float. */
+     uint32_t glitched;             /*!< Detecções de falha (um pixel pode falhar com mais de uma referência). */
+     uint32_t unresolved;           /*!< Pixels que ainda falhavam com a última referência. */
+     uint32_t escapes[MANDELBROT_HIST_BINS]; /*!< Pixels que escaparam, por faixa (como em `mandelbrot_stats_t`). */
+ } deep_stats_t;
+
+ void deep_view_from_render_data(deep_view_t *deep, const render_data_t *view);
+
+ void deep_view_to_render_data(const deep_view_t *deep, render_data_t *view);
+
+ void deep_view_zoom_in(deep_view_t *deep, uint8_t left, uint8_t top, uint8_t width, uint8_t height);
+
+ bool deep_view_needs_perturbation(const deep_view_t *deep);
+
+ void draw_mandelbrot_deep(uint8_t *buf, const deep_view_t *deep, uint8_t *counts, deep_stats_t *stats);
+
+ bool draw_mandelbrot_deep_pass(uint8_t *buf, const deep_view_t *deep, uint8_t *counts, bool lit_only,
+                                deep_expired_fn expired, deep_stats_t *stats);
+
+ #endif
@@ -0,0 +1,150 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "render_pan.h"
+#include "raster.h"
+
+/*!
+ * @brief Desloca o campo de iterações retido como o frame; os pixels expostos ficam para `render_rect()`.
+ */
+static void shift_field(uint8_t *field, int dx, int dy)
+{
+    int width = SSD1306_WIDTH - (dx > 0 ? dx : -dx);
+    int to_x = dx < 0 ? -dx : 0, from_x = dx > 0 ? dx : 0;
+
+    // de cima para baixo quando as linhas vêm de baixo (dy > 0), e vice-versa, sem sobrescrever a origem
+    for (int i = 0; i < SSD1306_HEIGHT; i++)
+    {
+        int y = dy >= 0 ? i : SSD1306_HEIGHT - 1 - i;
+        if (y + dy >= 0 && y + dy < SSD1306_HEIGHT)
+            memmove(&field[y * SSD1306_WIDTH + to_x], &field[(y + dy) * SSD1306_WIDTH + from_x], width);
+    }
+}
+
+/*!
+ * @brief Desloca o conteúdo do frame: o pixel (x, y) passa a conter o antigo pixel (x + dx, y + dy).
+ *
+ * @param buf Um ponteiro para o buffer do display, no formato de páginas do SSD1306.
+ * @param dx  Deslocamento horizontal, em pixels.
+ * @param dy  Deslocamento vertical, em pixels.
+ *
+ * @details
+ *  - O deslocamento horizontal move bytes inteiros de cada página.
+ *  - O deslocamento vertical monta cada coluna como um inteiro de 64 bits (bit y = linha y) e a desloca.
+ *  - Os pixels expostos são apagados.
+ *  - O campo de iterações retido do frame, se houver (ver `mandelbrot_retain_field()`), é deslocado junto.
+ */
+void pan_shift(uint8_t *buf, int dx, int dy)
+{
+    if (dx <= -SSD1306_WIDTH || dx >= SSD1306_WIDTH || dy <= -SSD1306_HEIGHT || dy >= SSD1306_HEIGHT)
+    {
+        memset(buf, 0, SSD1306_FRAME_LEN);
+        return;
+    }
+
+    uint8_t *field = mandelbrot_field(buf);
+    if (field)
+        shift_field(field, dx, dy);
+
+    if (dx != 0)
+    {
+        int n = dx > 0 ? dx : -dx;
+        for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+        {
+            uint8_t *row = &buf[page * SSD1306_WIDTH];
+            if (dx > 0)
+            {
+                memmove(row, row + n, SSD1306_WIDTH - n);
+                memset(row + SSD1306_WIDTH - n, 0, n);
+            }
+            else
+            {
+                memmove(row + n, row, SSD1306_WIDTH - n);
+                memset(row, 0, n);
+            }
+        }
+    }
+
+    if (dy != 0)
+    {
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+        {
+            uint64_t column = 0;
+            for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+                column |= (uint64_t)buf[page * SSD1306_WIDTH + x] << (page * SSD1306_PAGE_HEIGHT);
+
+            column = dy > 0 ? column >> dy : column << -dy;
+
+            for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+                buf[page * SSD1306_WIDTH + x] = (uint8_t)(column >> (page * SSD1306_PAGE_HEIGHT));
+        }
+    }
+}
+
+/*!
+ * @brief Avalia o kernel nos pixels do retângulo [x_start, x_end) x [y_start, y_end) da grade.
+ */
+static void render_rect(uint8_t *buf, const viewport_grid_t *grid, int x_start, int x_end, int y_start, int y_end,
+                        mandelbrot_stats_t *stats)
+{
+    int cap = mandelbrot_get_max_iter();
+    uint8_t *field = mandelbrot_field(buf);
+
+    for (int page = y_start / SSD1306_PAGE_HEIGHT; page * SSD1306_PAGE_HEIGHT < y_end; page++)
+    {
+        uint8_t mask = raster_page_mask(page, y_start, y_end);
+        uint8_t *row = &buf[page * SSD1306_WIDTH];
+        for (int x = x_start; x < x_end; x++)
+        {
+            float real = grid->real_base + (grid->ox + x) * grid->step_x;
+            uint8_t bits = 0;
+            for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+            {
+                if (!(mask >> bit & 1))
+                    continue;
+                int y = page * SSD1306_PAGE_HEIGHT + bit;
+                float imag = grid->im_base + (grid->oy + y) * grid->step_y;
+                int m = mandelbrot_point(real, imag, stats, NULL);
+                if (m == cap)
+                    bits |= 1 << bit;
+                if (field)
+                    field[y * SSD1306_WIDTH + x] = m == cap ? MANDELBROT_FIELD_INSIDE : (uint8_t)m;
+            }
+            row[x] = (row[x] & ~mask) | bits; // um byte por coluna da página
+        }
+    }
+}
+
+/*!
+ * @brief Desloca a janela por pixels inteiros, calculando apenas os pixels expostos.
+ *
+ * @param buf    Frame da posição atual da grade, atualizado para a nova posição.
+ * @param grid   Grade de pixels (ver `viewport_grid_anchor()`), deslocada por (dx, dy).
+ * @param dx     Deslocamento horizontal, em pixels (positivo = para a direita no plano complexo).
+ * @param dy     Deslocamento vertical, em pixels (positivo = para baixo na tela).
+ * @param view   Recebe os limites da nova janela, alinhados à grade.
+ * @param stats  Estatísticas às quais os pixels avaliados são somados.
+ *
+ * @details
+ *  - São avaliados |dx| * SSD1306_HEIGHT + |dy| * (SSD1306_WIDTH - |dx|) pixels; os demais são reaproveitados
+ *    exatamente, pois têm as mesmas coordenadas na grade.
+ */
+void pan_frame(uint8_t *buf, viewport_grid_t *grid, int dx, int dy, render_data_t *view, mandelbrot_stats_t *stats)
+{
+    pan_shift(buf, dx, dy);
+    grid->ox += dx;
+    grid->oy += dy;
+    viewport_grid_window(grid, view);
+
+    int cols = MIN(dx > 0 ? dx : -dx, SSD1306_WIDTH);
+    int rows = MIN(dy > 0 ? dy : -dy, SSD1306_HEIGHT);
+
+    // faixa de colunas expostas, com todas as linhas
+    int col_start = dx > 0 ? SSD1306_WIDTH - cols : 0;
+    render_rect(buf, grid, col_start, col_start + cols, 0, SSD1306_HEIGHT, stats);
+
+    // faixa de linhas expostas, sem o canto já calculado com as colunas
+    int row_start = dy > 0 ? SSD1306_HEIGHT - rows : 0;
+    int x_start = dx > 0 ? 0 : cols;
+    int x_end = dx > 0 ? SSD1306_WIDTH - cols : SSD1306_WIDTH;
+    render_rect(buf, grid, x_start, x_end, row_start, row_start + rows, stats);
+}
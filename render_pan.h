@@ -0,0 +1,20 @@
+/*!
+ * @file render_pan.h
+ * @brief Deslocamento (pan) da janela por pixels inteiros, reaproveitando o frame anterior.
+ *
+ * O frame é deslocado no próprio buffer e o kernel é avaliado apenas nas faixas de colunas e linhas
+ * expostas, de forma que o custo é proporcional à distância percorrida e não ao tamanho da tela.
+ */
+
+ #ifndef _RENDER_PAN_
+ #define _RENDER_PAN_
+
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "viewport.h"
+
+ void pan_shift(uint8_t *buf, int dx, int dy);
+
+ void pan_frame(uint8_t *buf, viewport_grid_t *grid, int dx, int dy, render_data_t *view, mandelbrot_stats_t *stats);
+
+ #endif
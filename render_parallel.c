@@ -0,0 +1,103 @@
+#include <string.h>
+#include "render_parallel.h"
+#include "render_platform.h"
+
+static volatile uint32_t next_unit;     // próxima unidade de trabalho a ser retirada
+static uint8_t *frame_buf;              // buffer do frame em renderização
+static render_data_t frame_view;        // limites do plano complexo do frame em renderização
+static uint64_t frame_skip_rows;        // linhas que não devem ser calculadas (espelhadas)
+static int unit_cols, unit_pages;       // dimensões de uma unidade de trabalho no modo atual
+static uint32_t num_units;              // número de unidades de trabalho do frame
+static mandelbrot_stats_t worker_stats[2]; // estatísticas do kernel por trabalhador
+static render_parallel_stats_t stats;   // estatísticas da última renderização
+static const int worker_ids[2] = {0, 1};
+
+/*!
+ * @brief Trabalhador de renderização, executado por ambos os núcleos.
+ *
+ * @param arg Ponteiro para o identificador do trabalhador (índice em `stats.units`).
+ *
+ * @details
+ *  - Retira unidades do contador compartilhado até esgotá-las; unidades no interior do conjunto custam
+ *    muito mais que as externas, e a distribuição dinâmica mantém os dois núcleos ocupados até o fim.
+ */
+static void render_worker(void *arg)
+{
+    int id = *(const int *)arg;
+    uint32_t unit;
+    uint32_t done = 0;
+
+    int units_per_row = SSD1306_WIDTH / unit_cols;
+
+    while ((unit = render_platform_fetch_add(&next_unit)) < num_units)
+    {
+        int page = (unit / units_per_row) * unit_pages;
+        int x = (unit % units_per_row) * unit_cols;
+        draw_mandelbrot_tile(frame_buf, &frame_view, x, x + unit_cols, page, page + unit_pages, frame_skip_rows, &worker_stats[id]);
+        done++;
+    }
+    stats.units[id] = done;
+}
+
+/*!
+ * @brief Determina as unidades de trabalho do frame no modo de renderização atual.
+ *
+ * @param unit_cols  Recebe a largura, em colunas, de uma unidade.
+ * @param unit_pages Recebe a altura, em páginas, de uma unidade.
+ *
+ * @return int Número de unidades do frame, numeradas da esquerda para a direita e de cima para baixo.
+ *
+ * @note Nos modos de subdivisão, o frame depende da divisão em unidades: quem renderiza um frame por partes (ver
+ *       speculate.c) usa as mesmas unidades para obter o frame de `draw_mandelbrot_frame()`.
+ */
+int render_frame_units(int *unit_cols, int *unit_pages)
+{
+    if (mandelbrot_get_render_mode() == MANDELBROT_RENDER_FULL)
+    {
+        *unit_cols = RENDER_UNIT_COLS;
+        *unit_pages = 1;
+    }
+    else
+    {
+        *unit_cols = RENDER_SUBDIVIDE_UNIT_COLS;
+        *unit_pages = RENDER_SUBDIVIDE_UNIT_PAGES;
+    }
+    return (SSD1306_WIDTH / *unit_cols) * (SSD1306_NUM_PAGES / *unit_pages);
+}
+
+/*!
+ * @brief Renderiza o frame inteiro utilizando os dois trabalhadores.
+ *
+ * @param buf        Um ponteiro para o buffer do display.
+ * @param view       Limites do plano complexo.
+ * @param skip_rows  Máscara de linhas que não devem ser calculadas (ver `draw_mandelbrot_block()`).
+ * @param stats      Estatísticas às quais as dos dois trabalhadores são somadas.
+ *
+ * @note
+ *  - No modo `MANDELBROT_RENDER_FULL`, o resultado é idêntico ao de `draw_mandelbrot_block()` sobre o frame inteiro.
+ *  - Requer `render_platform_init()`.
+ */
+void render_frame_parallel(uint8_t *buf, const render_data_t *view, uint64_t skip_rows, mandelbrot_stats_t *stats)
+{
+    frame_buf = buf;
+    frame_view = *view;
+    frame_skip_rows = skip_rows;
+    num_units = render_frame_units(&unit_cols, &unit_pages);
+    memset(worker_stats, 0, sizeof(worker_stats));
+    next_unit = 0;
+
+    render_platform_start_worker(render_worker, (void *)&worker_ids[1]);
+    render_worker((void *)&worker_ids[0]);
+    render_platform_wait_worker();
+
+    mandelbrot_stats_add(stats, &worker_stats[0]);
+    mandelbrot_stats_add(stats, &worker_stats[1]);
+}
+
+/*!
+ * @brief Retorna as estatísticas da última renderização paralela.
+ */
+const render_parallel_stats_t *render_parallel_stats()
+{
+    return &stats;
+}
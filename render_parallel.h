@@ -0,0 +1,44 @@
+/*!
+ * @file render_parallel.h
+ * @brief Renderização do frame dividida dinamicamente entre dois trabalhadores.
+ *
+ * O frame é dividido em unidades de trabalho (faixas de colunas dentro de uma página do SSD1306),
+ * retiradas de um contador atômico compartilhado pelos dois núcleos. Nos modos de subdivisão as unidades
+ * são maiores, para que os retângulos uniformes possam ser preenchidos sem avaliar o kernel.
+ */
+
+ #ifndef _RENDER_PARALLEL_
+ #define _RENDER_PARALLEL_
+
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Largura, em colunas, de uma unidade de trabalho. */
+ #define RENDER_UNIT_COLS 16
+
+ /*! @brief Número de unidades de trabalho por página. */
+ #define RENDER_UNITS_PER_PAGE (SSD1306_WIDTH / RENDER_UNIT_COLS)
+
+ /*! @brief Número total de unidades de trabalho de um frame. */
+ #define RENDER_NUM_UNITS (RENDER_UNITS_PER_PAGE * SSD1306_NUM_PAGES)
+
+ /*! @brief Largura, em colunas, de uma unidade de trabalho nos modos de subdivisão. */
+ #define RENDER_SUBDIVIDE_UNIT_COLS 32
+
+ /*! @brief Altura, em páginas, de uma unidade de trabalho nos modos de subdivisão. */
+ #define RENDER_SUBDIVIDE_UNIT_PAGES 2
+
+ /*!
+  * @brief Estatísticas da última renderização paralela.
+  */
+ typedef struct {
+     uint32_t units[2]; /*!< Unidades processadas por cada trabalhador (0 = chamador, 1 = segundo trabalhador). */
+ } render_parallel_stats_t;
+
+ int render_frame_units(int *unit_cols, int *unit_pages);
+
+ void render_frame_parallel(uint8_t *buf, const render_data_t *view, uint64_t skip_rows, mandelbrot_stats_t *stats);
+
+ const render_parallel_stats_t *render_parallel_stats();
+
+ #endif
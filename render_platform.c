@@ -0,0 +1,64 @@
+#include "render_platform.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+
+static spin_lock_t *render_lock; // spinlock de hardware que protege o contador de unidades de trabalho
+
+/*!
+ * @brief Laço principal do core1.
+ *
+ * @details
+ *  - Aguarda na FIFO entre núcleos pela função e pelo argumento a executar.
+ *  - Ao terminar, devolve um token pela FIFO para sinalizar a conclusão ao core0.
+ */
+static void core1_entry()
+{
+    while (true)
+    {
+        render_worker_fn fn = (render_worker_fn)(uintptr_t)multicore_fifo_pop_blocking();
+        void *arg = (void *)(uintptr_t)multicore_fifo_pop_blocking();
+        fn(arg);
+        multicore_fifo_push_blocking(0);
+    }
+}
+
+/*!
+ * @brief Reserva o spinlock do contador e lança o core1.
+ */
+void render_platform_init()
+{
+    render_lock = spin_lock_init(spin_lock_claim_unused(true));
+    multicore_launch_core1(core1_entry);
+}
+
+/*!
+ * @brief Envia a função e o argumento ao core1 através da FIFO entre núcleos.
+ */
+void render_platform_start_worker(render_worker_fn fn, void *arg)
+{
+    multicore_fifo_push_blocking((uint32_t)(uintptr_t)fn);
+    multicore_fifo_push_blocking((uint32_t)(uintptr_t)arg);
+}
+
+/*!
+ * @brief Aguarda o token de conclusão enviado pelo core1.
+ */
+void render_platform_wait_worker()
+{
+    multicore_fifo_pop_blocking();
+}
+
+/*!
+ * @brief Incremento atômico do contador.
+ *
+ * @note
+ *  - O Cortex-M0+ não possui instruções LDREX/STREX, por isso o incremento é protegido por um spinlock de hardware.
+ */
+uint32_t render_platform_fetch_add(volatile uint32_t *counter)
+{
+    uint32_t save = spin_lock_blocking(render_lock);
+    uint32_t value = (*counter)++;
+    spin_unlock(render_lock, save);
+    return value;
+}
@@ -0,0 +1,39 @@
+/*!
+ * @file render_platform.h
+ * @brief Interface de plataforma utilizada pela renderização paralela.
+ *
+ * Abstrai o segundo trabalhador (core1 na Pico, uma thread no Linux) e o contador atômico
+ * compartilhado, permitindo que o escalonador de render_parallel.c seja executado e testado fora da placa.
+ */
+
+ #ifndef _RENDER_PLATFORM_
+ #define _RENDER_PLATFORM_
+
+ #include <stdint.h>
+
+ /*! @brief Função executada por um trabalhador de renderização. */
+ typedef void (*render_worker_fn)(void *arg);
+
+ /*!
+  * @brief Inicializa a plataforma (lança o core1 na Pico).
+  *
+  * Deve ser chamada uma única vez, antes da primeira renderização paralela.
+  */
+ void render_platform_init();
+
+ /*!
+  * @brief Inicia a execução de `fn(arg)` no segundo trabalhador e retorna imediatamente.
+  */
+ void render_platform_start_worker(render_worker_fn fn, void *arg);
+
+ /*!
+  * @brief Aguarda o término da função iniciada por `render_platform_start_worker()`.
+  */
+ void render_platform_wait_worker();
+
+ /*!
+  * @brief Incrementa atomicamente o contador e retorna o valor anterior.
+  */
+ uint32_t render_platform_fetch_add(volatile uint32_t *counter);
+
+ #endif
@@ -0,0 +1,273 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "render_progressive.h"
+#include "render_platform.h"
+#include "raster.h"
+
+#define PROGRESSIVE_UNIT_COLS 16 // colunas por unidade de trabalho dentro de uma página
+#define PROGRESSIVE_UNITS_PER_PAGE (SSD1306_WIDTH / PROGRESSIVE_UNIT_COLS)
+#define PROGRESSIVE_NUM_UNITS (PROGRESSIVE_UNITS_PER_PAGE * SSD1306_NUM_PAGES)
+
+static uint8_t image[SSD1306_FRAME_LEN]; // imagem em refinamento (sem o cursor)
+static uint8_t samples[MANDELBROT_SEED_LEN]; // amostras das pré-visualizações, reaproveitadas pela passada final
+static int sample_cap;                   // limite com que as amostras foram avaliadas (-1 = limites diferentes)
+static uint64_t mirrored;                // linhas copiadas da linha simétrica (ver `mandelbrot_mirror_rows()`)
+static int8_t mirror_of[SSD1306_HEIGHT];
+static render_data_t view;               // janela em renderização
+static int block = 0;                    // tamanho do bloco da próxima passada (0 = concluído)
+static int last_block = 0;               // tamanho do bloco da última passada concluída (0 = nenhuma)
+static uint64_t start_us;                // instante de `progressive_start()`
+static progressive_stats_t stats;
+
+static volatile uint32_t next_unit;          // próxima unidade da passada em renderização
+static mandelbrot_stats_t worker_stats[2];   // estatísticas do kernel por trabalhador
+static const int worker_ids[2] = {0, 1};
+
+_Static_assert(MANDELBROT_SEED_STEP == 2, "a última pré-visualização (blocos 2x2) completa as amostras");
+
+/*!
+ * @brief Verifica se as amostras da linha `y` na passada atual são copiadas da linha simétrica, amostrada na
+ *        mesma passada ou em uma anterior.
+ */
+static bool mirrored_row(int y)
+{
+    return (mirrored >> y & 1) && mirror_of[y] % block == 0;
+}
+
+/*!
+ * @brief Desenha uma amostra da passada atual: bloco na imagem, campo de iterações e amostra para a passada final.
+ */
+static void put_sample(int x, int y, uint8_t value)
+{
+    int cap = mandelbrot_get_max_iter();
+    uint8_t *field = mandelbrot_field(image); // cada pixel é amostrado uma única vez ao longo das passadas
+
+    raster_fill(image, x, y, block, block, value >= cap ? RASTER_SET : RASTER_CLEAR); // bloco em uma única página
+    if (field)
+        field[y * SSD1306_WIDTH + x] = value >= cap ? MANDELBROT_FIELD_INSIDE : value;
+    samples[MANDELBROT_SEED_INDEX(x, y)] = value;
+}
+
+/*!
+ * @brief Verifica se o pixel (x, y) é uma nova amostra da passada atual.
+ *
+ * @details Na passada de bloco `b`, as amostras são os pixels com x e y múltiplos de `b`; os que também são
+ *          múltiplos de `2b` já foram avaliados na passada anterior e mantêm o seu bloco.
+ */
+static bool new_sample(int x, int y)
+{
+    return block == PROGRESSIVE_FIRST_BLOCK || x % (2 * block) != 0 || y % (2 * block) != 0;
+}
+
+/*!
+ * @brief Avalia as novas amostras de uma faixa de colunas de uma página (passadas de pré-visualização).
+ *
+ * @details
+ *  - As coordenadas são calculadas exatamente como em `draw_mandelbrot_block()`.
+ *  - As linhas espelhadas são copiadas depois da passada (`mirror_pass()`), como na renderização completa.
+ */
+static void render_columns(int page, int x_start, int x_end, mandelbrot_stats_t *kernel)
+{
+    float stepX = (view.real_end - view.real_start) / SSD1306_WIDTH;
+    float stepY = (view.im_end - view.im_start) / SSD1306_HEIGHT;
+
+    for (int y = page * SSD1306_PAGE_HEIGHT; y < (page + 1) * SSD1306_PAGE_HEIGHT; y += block)
+    {
+        if (mirrored_row(y))
+            continue;
+
+        for (int x = x_start; x < x_end; x += block)
+        {
+            if (!new_sample(x, y))
+                continue;
+
+            float real = view.real_start + x * stepX;
+            float imag = view.im_start + y * stepY;
+            mandelbrot_exit_t exit;
+            int m = mandelbrot_point(real, imag, kernel, &exit);
+            bool proven =
+                exit == MANDELBROT_EXIT_CARDIOID || exit == MANDELBROT_EXIT_BULB || exit == MANDELBROT_EXIT_PERIODIC;
+            put_sample(x, y, proven ? MANDELBROT_SEED_INTERIOR : (uint8_t)m);
+        }
+    }
+}
+
+/*!
+ * @brief Copia as novas amostras das linhas espelhadas a partir das amostras da linha simétrica.
+ */
+static void mirror_pass()
+{
+    for (int y = 0; y < SSD1306_HEIGHT; y += block)
+    {
+        if (!mirrored_row(y))
+            continue;
+
+        for (int x = 0; x < SSD1306_WIDTH; x += block)
+        {
+            if (!new_sample(x, y))
+                continue;
+            put_sample(x, y, samples[MANDELBROT_SEED_INDEX(x, mirror_of[y])]);
+            stats.kernel.mirrored++;
+        }
+    }
+}
+
+/*!
+ * @brief Trabalhador de uma passada, executado por ambos os núcleos (ver `render_frame_parallel()`).
+ */
+static void pass_worker(void *arg)
+{
+    int id = *(const int *)arg;
+    uint32_t unit;
+
+    while ((unit = render_platform_fetch_add(&next_unit)) < PROGRESSIVE_NUM_UNITS)
+    {
+        int x = (unit % PROGRESSIVE_UNITS_PER_PAGE) * PROGRESSIVE_UNIT_COLS;
+        render_columns(unit / PROGRESSIVE_UNITS_PER_PAGE, x, x + PROGRESSIVE_UNIT_COLS, &worker_stats[id]);
+    }
+}
+
+/*!
+ * @brief Renderiza as novas amostras de uma passada de pré-visualização, com uma única sincronização dos núcleos.
+ */
+static void render_pass()
+{
+#if MANDELBROT_DUAL_CORE
+    memset(worker_stats, 0, sizeof(worker_stats));
+    next_unit = 0;
+
+    render_platform_start_worker(pass_worker, (void *)&worker_ids[1]);
+    pass_worker((void *)&worker_ids[0]);
+    render_platform_wait_worker();
+
+    mandelbrot_stats_add(&stats.kernel, &worker_stats[0]);
+    mandelbrot_stats_add(&stats.kernel, &worker_stats[1]);
+#else
+    (void)worker_ids;
+    for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+        render_columns(page, 0, SSD1306_WIDTH, &stats.kernel);
+#endif
+    mirror_pass();
+}
+
+/*!
+ * @brief Inicia a renderização progressiva de uma nova janela, descartando a renderização em andamento.
+ *
+ * @param view_in Limites do plano complexo.
+ *
+ * @note A imagem anterior é mantida até a primeira passada ser concluída, servindo de fundo para o cursor.
+ */
+void progressive_start(const render_data_t *view_in)
+{
+    view = *view_in;
+    block = PROGRESSIVE_FIRST_BLOCK;
+    last_block = 0;
+    sample_cap = mandelbrot_get_max_iter();
+    mirrored = 0;
+#if MANDELBROT_SHORTCUTS
+    mirrored = mandelbrot_mirror_rows(&view, mirror_of);
+#endif
+    memset(&stats, 0, sizeof(stats));
+    start_us = time_us_64();
+}
+
+/*!
+ * @brief Executa a próxima passada da renderização progressiva.
+ *
+ * @return progressive_status_t Situação da renderização após a chamada.
+ *
+ * @details
+ *  - A passada é executada inteira; `progressive_start()` abandona as passadas seguintes.
+ *  - Cada passada divide o trabalho entre os núcleos com uma única sincronização. A passada final (bloco 1x1)
+ *    renderiza o frame inteiro com `draw_mandelbrot_frame()` (linhas espelhadas e subdivisão), sem reavaliar as
+ *    amostras das pré-visualizações (um quarto dos pixels, ver `mandelbrot_seed_samples()`). Se o limite de
+ *    iterações mudou entre as passadas, as amostras são descartadas e o frame é renderizado do início.
+ */
+progressive_status_t progressive_step()
+{
+    if (block == 0)
+        return PROGRESSIVE_FINISHED;
+
+    if (mandelbrot_get_max_iter() != sample_cap)
+        sample_cap = -1;
+
+    if (block == 1)
+    {
+        mandelbrot_seed_samples(image, sample_cap >= 0 ? samples : NULL);
+        draw_mandelbrot_frame(image, &view);
+        mandelbrot_seed_samples(NULL, NULL);
+        mandelbrot_stats_add(&stats.kernel, mandelbrot_frame_stats());
+    }
+    else
+    {
+        render_pass();
+    }
+
+    uint64_t elapsed = time_us_64() - start_us;
+    if (block == PROGRESSIVE_FIRST_BLOCK)
+        stats.preview_us = elapsed;
+    stats.passes++;
+    last_block = block;
+    block /= 2;
+
+    if (block == 0)
+    {
+        stats.final_us = elapsed;
+        return PROGRESSIVE_FINISHED;
+    }
+    return PROGRESSIVE_PASS_DONE;
+}
+
+/*!
+ * @brief Adota um frame já completo como resultado da janela `view_in` (por exemplo, após um deslocamento).
+ *
+ * @param view_in Limites do plano complexo do frame.
+ * @param frame   Frame em resolução completa (`SSD1306_FRAME_LEN` bytes).
+ */
+void progressive_adopt(const render_data_t *view_in, const uint8_t *frame)
+{
+    view = *view_in;
+    memcpy(image, frame, SSD1306_FRAME_LEN);
+    block = 0;
+    last_block = 1;
+}
+
+/*!
+ * @brief Indica se a passada em resolução completa já foi concluída.
+ */
+bool progressive_done()
+{
+    return block == 0;
+}
+
+/*!
+ * @brief Retorna o tamanho do bloco da última passada concluída (1 = resolução completa, 0 = nenhuma).
+ */
+int progressive_block()
+{
+    return last_block;
+}
+
+/*!
+ * @brief Retorna a imagem em refinamento, no formato de páginas do SSD1306 (`SSD1306_FRAME_LEN` bytes).
+ */
+const uint8_t *progressive_image()
+{
+    return image;
+}
+
+/*!
+ * @brief Retorna a janela em renderização.
+ */
+const render_data_t *progressive_view()
+{
+    return &view;
+}
+
+/*!
+ * @brief Retorna as estatísticas da renderização progressiva.
+ */
+const progressive_stats_t *progressive_stats()
+{
+    return &stats;
+}
@@ -0,0 +1,57 @@
+/*!
+ * @file render_progressive.h
+ * @brief Renderização progressiva do frame, da pré-visualização em blocos 8x8 até a resolução completa.
+ *
+ * Cada passada de pré-visualização divide o tamanho do bloco por dois (8x8, 4x4, 2x2) e avalia apenas as amostras
+ * que as passadas anteriores ainda não avaliaram. A passada final (1x1) é a renderização completa do frame
+ * (`draw_mandelbrot_frame()`, com espelhamento e subdivisão), a partir das amostras já avaliadas, e a imagem final
+ * é idêntica à dela.
+ *
+ * Uma passada por chamada, executada inteira: o laço principal chama `progressive_step()` uma vez por amostra do
+ * joystick, depois de tratar os botões pendentes, e uma nova janela (`progressive_start()`) abandona as passadas
+ * restantes. O abandono tem a granularidade de uma passada, e a passada final é a mais longa.
+ */
+
+ #ifndef _RENDER_PROGRESSIVE_
+ #define _RENDER_PROGRESSIVE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Tamanho do bloco da primeira passada (pré-visualização), em pixels. */
+ #define PROGRESSIVE_FIRST_BLOCK 8
+
+ /*! @brief Resultado de `progressive_step()`. */
+ typedef enum {
+     PROGRESSIVE_PASS_DONE, /*!< Uma passada foi concluída; ainda restam passadas mais finas. */
+     PROGRESSIVE_FINISHED   /*!< A passada em resolução completa foi concluída (ou não havia trabalho). */
+ } progressive_status_t;
+
+ /*!
+  * @brief Estatísticas da renderização progressiva em andamento (ou da última concluída).
+  */
+ typedef struct {
+     uint64_t preview_us;        /*!< Tempo desde `progressive_start()` até a conclusão da pré-visualização (0 se pendente). */
+     uint64_t final_us;          /*!< Tempo desde `progressive_start()` até a resolução completa (0 se pendente). */
+     uint32_t passes;            /*!< Passadas concluídas. */
+     mandelbrot_stats_t kernel;  /*!< Estatísticas do kernel somadas sobre todas as passadas. */
+ } progressive_stats_t;
+
+ void progressive_start(const render_data_t *view);
+
+ progressive_status_t progressive_step();
+
+ void progressive_adopt(const render_data_t *view_in, const uint8_t *frame);
+
+ bool progressive_done();
+
+ int progressive_block();
+
+ const uint8_t *progressive_image();
+
+ const render_data_t *progressive_view();
+
+ const progressive_stats_t *progressive_stats();
+
+ #endif
@@ -0,0 +1,201 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "render_subdivide.h"
+#include "raster.h"
+
+#define DWELL_INTERIOR MANDELBROT_SEED_INTERIOR      // ponto comprovadamente interior (cardioide, bulbo ou órbita periódica)
+#define DWELL_UNKNOWN 0xFF                          // ponto ainda não avaliado
+
+_Static_assert(DWELL_INTERIOR < DWELL_UNKNOWN, "MANDELBROT_ITER_LIMIT deve caber em uint8_t");
+
+/*!
+ * @brief Número de iterações de cada pixel já avaliado no frame em renderização.
+ *
+ * Pontos que atingem o limite de iterações por um dos atalhos de `mandelbrot_fixed_ex()` são marcados como `DWELL_INTERIOR`.
+ *
+ * @note Blocos distintos não compartilham pixels, de forma que os dois núcleos podem utilizá-lo simultaneamente.
+ */
+static uint8_t dwell[SSD1306_HEIGHT][SSD1306_WIDTH];
+
+/*!
+ * @brief Contexto de um bloco em subdivisão.
+ */
+typedef struct {
+    uint8_t *buf;
+    uint8_t *field; // campo de iterações retido de `buf` (ver `mandelbrot_retain_field()`), ou NULL
+    float real_start, im_start;
+    float step_x, step_y;
+    bool conservative;
+    int max_iter; // limite de iterações do frame (`mandelbrot_get_max_iter()`)
+    mandelbrot_stats_t *stats;
+} subdivide_ctx_t;
+
+/*!
+ * @brief Avalia (ou consulta) o número de iterações de um pixel e o desenha no buffer.
+ *
+ * @details As coordenadas são calculadas exatamente como em `draw_mandelbrot_block()`.
+ */
+static uint8_t eval(subdivide_ctx_t *ctx, int x, int y)
+{
+    if (dwell[y][x] == DWELL_UNKNOWN)
+    {
+        float real = ctx->real_start + x * ctx->step_x;
+        float imag = ctx->im_start + y * ctx->step_y;
+        mandelbrot_exit_t exit;
+        int m = mandelbrot_point(real, imag, ctx->stats, &exit);
+        bool proven = exit == MANDELBROT_EXIT_CARDIOID || exit == MANDELBROT_EXIT_BULB || exit == MANDELBROT_EXIT_PERIODIC;
+        dwell[y][x] = proven ? DWELL_INTERIOR : (uint8_t)m;
+        set_pixel(ctx->buf, x, y, m == ctx->max_iter);
+        if (ctx->field)
+            ctx->field[y * SSD1306_WIDTH + x] = m == ctx->max_iter ? MANDELBROT_FIELD_INSIDE : (uint8_t)m;
+    }
+    return dwell[y][x];
+}
+
+/*!
+ * @brief Registra um pixel já avaliado (`mandelbrot_seed_samples()`) e o desenha no buffer, como `eval()`.
+ */
+static void seed(subdivide_ctx_t *ctx, int x, int y, uint8_t value)
+{
+    bool inside = value >= ctx->max_iter;
+    dwell[y][x] = value;
+    set_pixel(ctx->buf, x, y, inside);
+    if (ctx->field)
+        ctx->field[y * SSD1306_WIDTH + x] = inside ? MANDELBROT_FIELD_INSIDE : value;
+}
+
+/*!
+ * @brief Verifica se dois pixels pertencem à mesma classe de preenchimento.
+ *
+ * @details
+ *  - No modo conservador, exige o mesmo número de iterações: as regiões {n > k} são conexas e sem buracos,
+ *    logo uma borda de iterações iguais não pode ser atravessada pelo conjunto nem por uma faixa de outra cor.
+ *    Pontos que apenas atingiram o limite de iterações não formam classe (ver `fillable()`).
+ *  - No modo normal, basta a mesma cor, o que também preenche faixas de escape distintas e pode apagar
+ *    filamentos finos do conjunto (ou canais de escape próximos à borda) que não tocam a borda amostrada.
+ */
+static bool same_class(const subdivide_ctx_t *ctx, uint8_t a, uint8_t b)
+{
+    if (ctx->conservative)
+        return a == b;
+    return (a >= ctx->max_iter) == (b >= ctx->max_iter);
+}
+
+/*!
+ * @brief Verifica se um retângulo com borda uniforme da classe de `first` pode ser preenchido.
+ *
+ * @details
+ *  - No modo conservador, uma borda que apenas atingiu o limite de iterações não é preenchida: perto da fronteira, canais
+ *    de escape mais finos que um pixel atravessam a região e só aparecem quando o interior é avaliado.
+ *    Bordas comprovadamente interiores (`DWELL_INTERIOR`) podem ser preenchidas, já que o conjunto não tem buracos.
+ */
+static bool fillable(const subdivide_ctx_t *ctx, uint8_t first)
+{
+    return !(ctx->conservative && first == ctx->max_iter);
+}
+
+/*!
+ * @brief Renderiza recursivamente o retângulo de limites inclusivos (x0, y0)-(x1, y1).
+ */
+static void subdivide(subdivide_ctx_t *ctx, int x0, int y0, int x1, int y1)
+{
+    // retângulos pequenos: avalia todos os pixels
+    if (x1 - x0 - 1 <= SUBDIVIDE_MIN_SIDE || y1 - y0 - 1 <= SUBDIVIDE_MIN_SIDE)
+    {
+        for (int y = y0; y <= y1; y++)
+            for (int x = x0; x <= x1; x++)
+                eval(ctx, x, y);
+        return;
+    }
+
+    // avalia a borda e verifica se é uniforme
+    uint8_t first = eval(ctx, x0, y0);
+    bool uniform = true;
+    for (int x = x0; x <= x1; x++)
+    {
+        uniform &= same_class(ctx, first, eval(ctx, x, y0));
+        uniform &= same_class(ctx, first, eval(ctx, x, y1));
+    }
+    for (int y = y0 + 1; y < y1; y++)
+    {
+        uniform &= same_class(ctx, first, eval(ctx, x0, y));
+        uniform &= same_class(ctx, first, eval(ctx, x1, y));
+    }
+
+    if (uniform && fillable(ctx, first))
+    {
+        // interior preenchido página a página, com bytes inteiros (ver raster.h)
+        raster_fill(ctx->buf, x0 + 1, y0 + 1, x1 - x0 - 1, y1 - y0 - 1,
+                    first >= ctx->max_iter ? RASTER_SET : RASTER_CLEAR);
+        int value = first >= ctx->max_iter ? MANDELBROT_FIELD_INSIDE : first;
+        for (int y = y0 + 1; ctx->field && y < y1; y++)
+            memset(&ctx->field[y * SSD1306_WIDTH + x0 + 1], value, x1 - x0 - 1);
+        ctx->stats->filled += (uint32_t)((x1 - x0 - 1) * (y1 - y0 - 1));
+        return;
+    }
+
+    // divide ao meio pelo lado maior; a linha de divisão é compartilhada e avaliada uma única vez
+    if (x1 - x0 >= y1 - y0)
+    {
+        int xm = (x0 + x1) / 2;
+        subdivide(ctx, x0, y0, xm, y1);
+        subdivide(ctx, xm, y0, x1, y1);
+    }
+    else
+    {
+        int ym = (y0 + y1) / 2;
+        subdivide(ctx, x0, y0, x1, ym);
+        subdivide(ctx, x0, ym, x1, y1);
+    }
+}
+
+/*!
+ * @brief Renderiza um bloco do frame por subdivisão de retângulos.
+ *
+ * @param buf          Um ponteiro para o buffer do display.
+ * @param view         Limites do plano complexo do frame inteiro.
+ * @param x_start      Primeira coluna do bloco.
+ * @param x_end        Coluna final do bloco (exclusiva).
+ * @param page_start   Primeira página do bloco.
+ * @param page_end     Página final do bloco (exclusiva).
+ * @param row_end      Linhas a partir desta não são calculadas (espelhadas depois).
+ * @param conservative Preenche apenas retângulos que o conjunto não pode atravessar (ver `same_class()` e `fillable()`).
+ * @param stats        Estatísticas às quais os pixels avaliados e preenchidos são somados.
+ *
+ * @details
+ *  - Pixels avaliados produzem exatamente o mesmo valor que em `draw_mandelbrot_block()`; apenas os
+ *    pixels preenchidos podem diferir, quando a borda amostrada não revela um detalhe interno.
+ *  - Os pixels com amostra já avaliada (`mandelbrot_seed_samples()`) entram na grade de iterações antes da
+ *    subdivisão e não são reavaliados; os que ficam no interior de um retângulo preenchido são sobrescritos.
+ */
+void draw_mandelbrot_subdivide(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                               int row_end, bool conservative, mandelbrot_stats_t *stats)
+{
+    int y_start = page_start * SSD1306_PAGE_HEIGHT;
+    int y_end = MIN(page_end * SSD1306_PAGE_HEIGHT, row_end);
+    if (y_end <= y_start || x_end <= x_start)
+        return;
+
+    subdivide_ctx_t ctx = {
+        buf : buf,
+        field : mandelbrot_field(buf),
+        real_start : view->real_start,
+        im_start : view->im_start,
+        step_x : (view->real_end - view->real_start) / SSD1306_WIDTH,
+        step_y : (view->im_end - view->im_start) / SSD1306_HEIGHT,
+        conservative : conservative,
+        max_iter : mandelbrot_get_max_iter(),
+        stats : stats,
+    };
+
+    const uint8_t *samples = mandelbrot_samples(buf);
+    for (int y = y_start; y < y_end; y++)
+    {
+        memset(&dwell[y][x_start], DWELL_UNKNOWN, x_end - x_start);
+        for (int x = x_start + x_start % MANDELBROT_SEED_STEP; samples && y % MANDELBROT_SEED_STEP == 0 && x < x_end;
+             x += MANDELBROT_SEED_STEP)
+            seed(&ctx, x, y, samples[MANDELBROT_SEED_INDEX(x, y)]);
+    }
+
+    subdivide(&ctx, x_start, y_start, x_end - 1, y_end - 1);
+}
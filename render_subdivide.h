@@ -0,0 +1,22 @@
+/*!
+ * @file render_subdivide.h
+ * @brief Renderização por subdivisão de retângulos (Mariani–Silver).
+ *
+ * Apenas as bordas dos retângulos são avaliadas; retângulos com borda uniforme têm o interior preenchido
+ * diretamente no buffer de páginas do SSD1306, e os demais são divididos ao meio recursivamente.
+ */
+
+ #ifndef _RENDER_SUBDIVIDE_
+ #define _RENDER_SUBDIVIDE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Retângulos com lado (interior) menor ou igual a este valor são avaliados pixel a pixel. */
+ #define SUBDIVIDE_MIN_SIDE 2
+
+ void draw_mandelbrot_subdivide(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                                int row_end, bool conservative, mandelbrot_stats_t *stats);
+
+ #endif
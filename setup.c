@@ -4,6 +4,7 @@
 #include "hardware/i2c.h"
 #include "hardware/adc.h"
 #include "ssd1306.h"
+#include "ssd1306_transport.h"
 
 /*!
  * @brief Inicializa as configurações gerais do hardware, incluindo o LED.
@@ -37,6 +38,7 @@ void setup_general()
  * @details
  *  - Inicializa o I2C.
  *  - Configura os pinos SDA e SCL.
+ *  - Seleciona o transporte com DMA, que permite transmitir frames em segundo plano.
  *  - Inicializa o display SSD1306 através da função `SSD1306_init()`.
  *
  * @note
@@ -49,6 +51,8 @@ void setup_i2c()
     gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C); // configura o pino SCL para a função I2C.
     gpio_pull_up(I2C_SDA_PIN);                     // ativa o pull-up no pino SDA.
     gpio_pull_up(I2C_SCL_PIN);                     // ativa o pull-up no pino SCL.
+    SSD1306_i2c_dma_init();                        // reserva o canal de DMA que alimenta a FIFO de transmissão da I2C.
+    SSD1306_set_transport(&ssd1306_i2c_dma_transport); // o driver passa a utilizar o transporte com DMA.
     SSD1306_init();                                // executa o processo de inicialização completo do display SSD1306.
 }
 
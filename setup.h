@@ -34,6 +34,12 @@
  
  /*! @brief Canal ADC para o eixo Y do joystick. */
  #define ADC_CHANNEL_1 1
+
+ /*! @brief Deflexão do joystick (em unidades do ADC) abaixo da qual o modo pan não desloca a janela. */
+ #define PAN_DEADZONE 384
+
+ /*! @brief Unidades do ADC por pixel adicional de deslocamento por chamada no modo pan. */
+ #define PAN_PIXELS_DIVISOR 512
  
  /*!
   * @brief Configurações gerais do sistema.
@@ -0,0 +1,128 @@
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "shade.h"
+
+/*! @brief Lado das matrizes de limiar. */
+#define SHADE_MATRIX 16
+
+// matriz de Bayer 16 x 16: postos 0 a 255
+static const uint8_t bayer[SHADE_MATRIX][SHADE_MATRIX] = {
+    {  0, 128,  32, 160,   8, 136,  40, 168,   2, 130,  34, 162,  10, 138,  42, 170},
+    {192,  64, 224,  96, 200,  72, 232, 104, 194,  66, 226,  98, 202,  74, 234, 106},
+    { 48, 176,  16, 144,  56, 184,  24, 152,  50, 178,  18, 146,  58, 186,  26, 154},
+    {240, 112, 208,  80, 248, 120, 216,  88, 242, 114, 210,  82, 250, 122, 218,  90},
+    { 12, 140,  44, 172,   4, 132,  36, 164,  14, 142,  46, 174,   6, 134,  38, 166},
+    {204,  76, 236, 108, 196,  68, 228, 100, 206,  78, 238, 110, 198,  70, 230, 102},
+    { 60, 188,  28, 156,  52, 180,  20, 148,  62, 190,  30, 158,  54, 182,  22, 150},
+    {252, 124, 220,  92, 244, 116, 212,  84, 254, 126, 222,  94, 246, 118, 214,  86},
+    {  3, 131,  35, 163,  11, 139,  43, 171,   1, 129,  33, 161,   9, 137,  41, 169},
+    {195,  67, 227,  99, 203,  75, 235, 107, 193,  65, 225,  97, 201,  73, 233, 105},
+    { 51, 179,  19, 147,  59, 187,  27, 155,  49, 177,  17, 145,  57, 185,  25, 153},
+    {243, 115, 211,  83, 251, 123, 219,  91, 241, 113, 209,  81, 249, 121, 217,  89},
+    { 15, 143,  47, 175,   7, 135,  39, 167,  13, 141,  45, 173,   5, 133,  37, 165},
+    {207,  79, 239, 111, 199,  71, 231, 103, 205,  77, 237, 109, 197,  69, 229, 101},
+    { 63, 191,  31, 159,  55, 183,  23, 151,  61, 189,  29, 157,  53, 181,  21, 149},
+    {255, 127, 223,  95, 247, 119, 215,  87, 253, 125, 221,  93, 245, 117, 213,  85},
+};
+
+// ruído azul 16 x 16 (void-and-cluster, gaussiana toroidal de desvio 1,5): postos 0 a 255
+static const uint8_t blue_noise[SHADE_MATRIX][SHADE_MATRIX] = {
+    {120,  61, 134, 223,  84,  33, 168,  12, 113, 225,  63, 246, 185, 233,  88, 169},
+    { 23, 206, 181,  17, 109, 214,  58, 140, 201,  24, 161,  93,  34, 133,  14, 221},
+    {144,  73, 250,  49, 158, 187,  81, 251, 100,  51, 142, 210, 172,  57, 191, 106},
+    { 42, 167, 101, 126, 220,   3, 121,  40, 170, 231,  82,   8, 114, 255,  80, 232},
+    {212,  11, 195,  31,  72, 239, 152, 196,  16, 127, 188, 222,  45, 157,  26, 128},
+    {154,  87, 235, 143, 179,  94,  54, 108, 237,  65,  29, 105, 139, 207, 184,  66},
+    {248,  47, 115,  62, 209,  20, 164, 217,  79, 146, 178, 243,  69,  90,   0, 118},
+    { 30, 190, 173,   6, 131, 254,  41, 136,  10, 204,  43, 159,  22, 229, 162, 218},
+    { 77, 148,  99, 226,  74, 182, 117, 192,  86, 247, 119,  97, 197, 130,  53, 103},
+    {242,  19, 198,  44, 155,  96,  59, 230,  28, 165,  60,   5, 240,  39, 175, 202},
+    {137,  64, 122, 238,  25, 211,   1, 149, 104, 224, 135, 183, 151,  71, 112,   9},
+    { 91, 213, 166,  85, 186, 111, 249, 174,  48,  75, 208,  32,  89, 205, 236, 160},
+    { 37, 252,  18,  55, 138,  38,  78, 123, 194,  13, 107, 253, 124,  15,  56, 189},
+    { 76, 145, 110, 228, 203, 163, 219,  21, 241, 141, 171,  50, 156, 227, 102, 129},
+    {  2, 199, 176,  68,   7,  98,  52, 150,  92,  36, 215,  83, 200,  27, 177, 216},
+    {244,  95,  35, 153, 245, 125, 193, 234,  70, 180, 132,   4, 116,  67, 147,  46},
+};
+
+// limiar constante dos modos sem pontilhado: acende quando o nível é maior que zero
+static const uint8_t flat[SHADE_MATRIX][SHADE_MATRIX];
+
+/*!
+ * @brief Raiz quadrada inteira (piso).
+ */
+static uint32_t isqrt(uint32_t v)
+{
+    uint32_t root = 0;
+    for (uint32_t bit = 1u << 30; bit; bit >>= 2)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+    }
+    return root;
+}
+
+/*!
+ * @brief Converte o campo de iterações retido na imagem de 1 bit do display.
+ *
+ * @param buf   Recebe o frame, no formato de páginas do SSD1306.
+ * @param field Campo de iterações do frame (`SSD1306_WIDTH * SSD1306_HEIGHT` bytes).
+ * @param cap   Limite de iterações com que o campo foi calculado (escala do nível de cinza).
+ * @param mode  Sombreamento.
+ *
+ * @details
+ *  - O nível de cada valor do campo (0 a 255) vem de uma tabela montada uma vez por chamada; o pixel acende quando o
+ *    nível é maior que o limiar da matriz na posição (x mod 16, y mod 16). Os pontos do conjunto sempre acendem.
+ *  - Nos pontilhados, o nível é 255 * sqrt(n / cap): a maioria dos pontos escapa em poucas iterações, e a raiz
+ *    distribui os tons pela faixa próxima à borda.
+ *  - Cada coluna de página é montada em um byte e escrita uma vez, como em `draw_mandelbrot_block()`. Nenhuma
+ *    iteração do kernel é executada.
+ */
+void shade_frame(uint8_t *buf, const uint8_t *field, int cap, shade_mode_t mode)
+{
+    uint8_t level[256];
+    const uint8_t(*matrix)[SHADE_MATRIX] = mode == SHADE_BAYER ? bayer : mode == SHADE_BLUE_NOISE ? blue_noise : flat;
+
+    cap = MAX(cap, 1);
+    for (int n = 0; n < 256; n++)
+    {
+        if (mode == SHADE_THRESHOLD)
+            level[n] = 0;
+        else if (mode == SHADE_BANDS)
+            level[n] = (n / SHADE_BAND_ITERS) % 2 ? 255 : 0;
+        else
+            level[n] = (uint8_t)MIN(isqrt((uint32_t)MIN(n, cap) * 65025u / cap), 255);
+    }
+
+    for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+    {
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+        {
+            uint8_t bits = 0;
+            for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+            {
+                int y = page * SSD1306_PAGE_HEIGHT + bit;
+                uint8_t n = field[y * SSD1306_WIDTH + x];
+                if (n == MANDELBROT_FIELD_INSIDE || level[n] > matrix[y % SHADE_MATRIX][x % SHADE_MATRIX])
+                    bits |= 1 << bit;
+            }
+            buf[page * SSD1306_WIDTH + x] = bits;
+        }
+    }
+}
+
+/*!
+ * @brief Nome do sombreamento, para as mensagens de depuração.
+ */
+const char *shade_mode_name(shade_mode_t mode)
+{
+    static const char *const names[SHADE_MODE_COUNT] = {"limiar", "faixas", "bayer", "ruido azul"};
+    return mode < SHADE_MODE_COUNT ? names[mode] : "?";
+}
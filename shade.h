@@ -0,0 +1,35 @@
+/*!
+ * @file shade.h
+ * @brief Sombreamento do frame a partir do campo de iterações retido, sem recalcular o kernel.
+ *
+ * O campo guarda, para cada pixel (índice y * SSD1306_WIDTH + x), o número de iterações do escape ou
+ * `MANDELBROT_FIELD_INSIDE` para os pontos que atingiram o limite (ver `mandelbrot_retain_field()`). O sombreamento
+ * deriva dele a imagem de 1 bit: o limiar reproduz exatamente o frame renderizado; as faixas alternam a cor a cada
+ * `SHADE_BAND_ITERS` iterações; os pontilhados ordenados (Bayer e ruído azul, 16 x 16) aproximam tons de cinza
+ * pela distância ao conjunto.
+ */
+
+ #ifndef _SHADE_
+ #define _SHADE_
+
+ #include <stdint.h>
+
+ /*! @brief Largura, em iterações, das faixas de `SHADE_BANDS`. */
+ #define SHADE_BAND_ITERS 2
+
+ /*!
+  * @brief Forma como o campo de iterações é convertido na imagem de 1 bit.
+  */
+ typedef enum {
+     SHADE_THRESHOLD,  /*!< Conjunto aceso, demais pontos apagados (o frame renderizado). */
+     SHADE_BANDS,      /*!< Faixas alternadas de iterações de escape. */
+     SHADE_BAYER,      /*!< Pontilhado ordenado pela matriz de Bayer. */
+     SHADE_BLUE_NOISE, /*!< Pontilhado ordenado por ruído azul (sem a textura em grade do Bayer). */
+     SHADE_MODE_COUNT
+ } shade_mode_t;
+
+ void shade_frame(uint8_t *buf, const uint8_t *field, int cap, shade_mode_t mode);
+
+ const char *shade_mode_name(shade_mode_t mode);
+
+ #endif
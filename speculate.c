@@ -0,0 +1,201 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "speculate.h"
+#include "frame_cache.h"
+#include "render_budget.h"
+#include "render_parallel.h"
+
+
+// alvo atual, escrito pelo controle a cada leitura do joystick
+static render_data_t target;
+static bool target_valid = false;
+static uint64_t target_since_us; // instante em que o cursor parou sobre o alvo
+static uint32_t generation = 0;  // incrementado a cada mudança de alvo (cancela o trabalho em andamento)
+
+// trabalho em andamento
+static bool working = false;
+static uint32_t work_generation;
+static render_data_t work_view;
+static int work_cap;             // limite de iterações do alvo (`budget_choose_cap()`)
+static int unit_cols, unit_pages; // unidades de trabalho de `draw_mandelbrot_frame()` (`render_frame_units()`)
+static int num_units;
+static uint64_t mirrored;         // linhas copiadas da linha simétrica ao fim (`mandelbrot_mirror_rows()`)
+static int8_t mirror_of[SSD1306_HEIGHT];
+static int next_unit;
+static uint64_t work_iterations;
+static uint8_t frame[SSD1306_FRAME_LEN];
+static uint8_t field[SSD1306_WIDTH * SSD1306_HEIGHT]; // iterações do frame, guardadas com ele no cache
+
+// última especulação concluída
+static bool completed_valid = false;
+static bool completed_used = false;
+static render_data_t completed_view;
+static uint64_t completed_iterations;
+
+static speculate_stats_t stats;
+
+/*!
+ * @brief Compara duas janelas exatamente.
+ */
+static bool same_view(const render_data_t *a, const render_data_t *b)
+{
+    return a->real_start == b->real_start && a->real_end == b->real_end && a->im_start == b->im_start &&
+           a->im_end == b->im_end;
+}
+
+/*!
+ * @brief Informa a janela que a próxima ampliação produzirá (chamada pelo controle a cada leitura do cursor).
+ *
+ * @param target_in Janela alvo.
+ * @param now_us    Instante atual, em microssegundos.
+ *
+ * @details Se o alvo mudou, reinicia a contagem do tempo de permanência e cancela o trabalho em andamento.
+ */
+void speculate_request(const render_data_t *target_in, uint64_t now_us)
+{
+    if (target_valid && same_view(&target, target_in))
+        return;
+
+    target = *target_in;
+    target_valid = true;
+    target_since_us = now_us;
+    generation++;
+}
+
+/*!
+ * @brief Descarta o alvo atual (por exemplo, fora do modo de ampliação).
+ */
+void speculate_cancel()
+{
+    if (!target_valid)
+        return;
+    target_valid = false;
+    generation++;
+}
+
+/*!
+ * @brief Contabiliza uma ampliação: acerto se a janela resultante é a última especulação concluída.
+ */
+void speculate_note_zoom(const render_data_t *view)
+{
+    if (completed_valid && !completed_used && same_view(&completed_view, view))
+    {
+        completed_used = true;
+        stats.hits++;
+        stats.useful_iterations += completed_iterations;
+    }
+    else
+    {
+        stats.misses++;
+    }
+}
+
+/*!
+ * @brief Registra uma especulação concluída, contabilizando a anterior como desperdício se não foi usada.
+ */
+static void complete(const render_data_t *view, uint64_t iterations)
+{
+    if (completed_valid && !completed_used)
+        stats.wasted_iterations += completed_iterations;
+
+    completed_valid = true;
+    completed_used = false;
+    completed_view = *view;
+    completed_iterations = iterations;
+}
+
+/*!
+ * @brief Executa uma unidade de trabalho especulativo; chamada repetidamente pelo laço principal.
+ *
+ * @param now_us Instante atual, em microssegundos.
+ *
+ * @return bool Verdadeiro se alguma unidade foi renderizada.
+ *
+ * @details
+ *  - Cada unidade é uma unidade de trabalho de `draw_mandelbrot_frame()` (`render_frame_units()`), renderizada com
+ *    `draw_mandelbrot_tile()`, e as linhas simétricas são copiadas ao fim: o frame é idêntico ao de
+ *    `draw_mandelbrot_frame()` com o limite do alvo, em qualquer modo de renderização.
+ *  - O limite dos kernels passa a ser o do alvo durante cada unidade e é restaurado em seguida, já que o frame
+ *    exibido (e o deslocamento sobre ele) continua usando o próprio limite. Da mesma forma, as iterações retidas
+ *    passam a ser as do frame especulado, guardadas com ele no cache para o sombreamento após a ampliação.
+ *  - Chamada pelo laço principal apenas quando não há eventos de entrada pendentes; cada unidade é curta,
+ *    de forma que um evento espera no máximo uma unidade.
+ */
+bool speculate_poll(uint64_t now_us)
+{
+    uint32_t current = generation;
+    bool valid = target_valid;
+    render_data_t view = target;
+    uint64_t since = target_since_us;
+
+    if (working && work_generation != current)
+    {
+        // o alvo mudou durante a renderização
+        working = false;
+        stats.cancelled++;
+        stats.wasted_iterations += work_iterations;
+    }
+
+    if (!working)
+    {
+        if (!valid || now_us - since < SPECULATE_DWELL_US)
+            return false;
+        if (completed_valid && work_generation == current)
+            return false; // alvo já especulado
+
+        work_generation = current;
+        int cap = budget_choose_cap((view.real_end - view.real_start) / SSD1306_WIDTH);
+        if (frame_cache_contains(&view, cap))
+        {
+            complete(&view, 0); // nada a fazer: a ampliação já será um acerto no cache
+            return false;
+        }
+
+        working = true;
+        work_view = view;
+        work_cap = cap;
+        num_units = render_frame_units(&unit_cols, &unit_pages);
+        mirrored = 0;
+#if MANDELBROT_SHORTCUTS
+        mirrored = mandelbrot_mirror_rows(&view, mirror_of);
+#endif
+        next_unit = 0;
+        work_iterations = 0;
+        stats.started++;
+    }
+
+    int page = (next_unit / (SSD1306_WIDTH / unit_cols)) * unit_pages;
+    int x = (next_unit % (SSD1306_WIDTH / unit_cols)) * unit_cols;
+    bool last_unit = next_unit + 1 == num_units;
+    mandelbrot_stats_t unit_stats = {0};
+    int shown_cap = mandelbrot_get_max_iter();
+    const uint8_t *shown_frame;
+    uint8_t *shown_field;
+    mandelbrot_get_retained_field(&shown_frame, &shown_field);
+    mandelbrot_set_max_iter(work_cap);
+    mandelbrot_retain_field(frame, field);
+    draw_mandelbrot_tile(frame, &work_view, x, x + unit_cols, page, page + unit_pages, mirrored, &unit_stats);
+    if (last_unit)
+        mandelbrot_apply_mirror(frame, mirrored, mirror_of, &unit_stats);
+    mandelbrot_retain_field(shown_frame, shown_field);
+    mandelbrot_set_max_iter(shown_cap);
+    work_iterations += unit_stats.iterations;
+
+    next_unit++;
+    if (last_unit)
+    {
+        working = false;
+        frame_cache_insert(&work_view, work_cap, frame, field);
+        complete(&work_view, work_iterations);
+        stats.completed++;
+    }
+    return true;
+}
+
+/*!
+ * @brief Retorna as estatísticas da especulação.
+ */
+const speculate_stats_t *speculate_stats()
+{
+    return &stats;
+}
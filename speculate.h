@@ -0,0 +1,51 @@
+/*!
+ * @file speculate.h
+ * @brief Pré-renderização especulativa da janela que a próxima ampliação produzirá.
+ *
+ * No modo de ampliação, a janela resultante do botão A é determinada pelo cursor. Quando o cursor fica
+ * parado por `SPECULATE_DWELL_US`, o laço principal renderiza essa janela em segundo plano, em pequenas
+ * unidades de trabalho, e a armazena no cache de frames (frame_cache.h); a ampliação passa a ser um acerto
+ * no cache. Qualquer movimento do cursor cancela a especulação antes da próxima unidade.
+ *
+ * O frame especulado usa o limite de iterações que o orçamento escolhe para a janela alvo (`budget_choose_cap()`),
+ * e não o do frame exibido. Ele é idêntico ao de `draw_mandelbrot_frame()` com esse limite, renderizado unidade a
+ * unidade. Sem especulação, a ampliação chega a esse limite em passadas de aprofundamento (render_budget.h), que nos
+ * modos de subdivisão podem preencher alguns pixels de outra forma.
+ */
+
+ #ifndef _SPECULATE_
+ #define _SPECULATE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Tempo com o cursor parado antes de iniciar a especulação, em microssegundos. */
+ #ifndef SPECULATE_DWELL_US
+ #define SPECULATE_DWELL_US 150000
+ #endif
+
+ /*!
+  * @brief Estatísticas da especulação.
+  */
+ typedef struct {
+     uint32_t started;           /*!< Especulações iniciadas. */
+     uint32_t completed;         /*!< Especulações concluídas e armazenadas no cache. */
+     uint32_t cancelled;         /*!< Especulações abandonadas por movimento do cursor. */
+     uint32_t hits;              /*!< Ampliações cuja janela havia sido especulada. */
+     uint32_t misses;            /*!< Ampliações cuja janela não havia sido especulada. */
+     uint64_t useful_iterations; /*!< Iterações de especulações aproveitadas por uma ampliação. */
+     uint64_t wasted_iterations; /*!< Iterações de especulações canceladas ou substituídas sem uso. */
+ } speculate_stats_t;
+
+ void speculate_request(const render_data_t *target, uint64_t now_us);
+
+ void speculate_cancel();
+
+ void speculate_note_zoom(const render_data_t *view);
+
+ bool speculate_poll(uint64_t now_us);
+
+ const speculate_stats_t *speculate_stats();
+
+ #endif
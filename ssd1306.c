@@ -7,9 +7,77 @@
 #include "hardware/i2c.h"
 #include <complex.h>
 #include "ssd1306.h"
+#include "ssd1306_transport.h"
+#include "raster.h"
+#include "render_parallel.h"
+#include "render_subdivide.h"
+#include "frame_cache.h"
 
-uint8_t mandelbrot_cache[SSD1306_BUF_LEN];
-float cached_real_start, cached_real_end, cached_im_start, cached_im_end;
+static mandelbrot_stats_t frame_stats; // estatísticas do último frame renderizado por `draw_mandelbrot_frame()`
+static volatile mandelbrot_render_mode_t render_mode = MANDELBROT_RENDER_MODE; // forma de calcular os pixels do frame
+static volatile int max_iter = MAX_ITER; // limite de iterações dos kernels (ver `mandelbrot_set_max_iter()`)
+static volatile escape_formula_t formula = ESCAPE_MANDELBROT; // fórmula de iteração (ver `mandelbrot_set_formula()`)
+static escape_kernel_t formula_kernel;    // kernel da fórmula, exceto Mandelbrot (kernel com atalhos)
+static float julia_real, julia_imag;      // constante da fórmula de Julia
+
+_Static_assert(ESCAPE_FRAC_BITS == MANDELBROT_FRAC_BITS, "os kernels genéricos usam o mesmo Q3.28");
+static const uint8_t *field_frame;        // frame cujas iterações são retidas (ver `mandelbrot_retain_field()`)
+static uint8_t *field_counts;             // campo de iterações de `field_frame`
+static const uint8_t *seed_frame;         // frame cujas amostras já foram avaliadas (ver `mandelbrot_seed_samples()`)
+static const uint8_t *seed_values;        // amostras de `seed_frame`
+
+static uint8_t panel_shadow[SSD1306_FRAME_LEN]; // cópia do conteúdo atual da memória de imagem do display
+static bool panel_shadow_valid = false;        // falso enquanto o conteúdo do display for desconhecido
+static uint8_t window_buf[SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN]; // cabeçalho de janela + dados de uma janela suja
+static uint8_t data_buf[SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN];   // cabeçalho + cópia dos dados enviados por `render()` e `SSD1306_send_buf()`
+
+/*!
+ * @brief Escrita bloqueante pela interface I2C.
+ */
+static int i2c_blocking_write(const uint8_t *src, size_t len)
+{
+    return i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, src, len, false);
+}
+
+/*!
+ * @brief Escrita "assíncrona" do transporte bloqueante: conclui antes de retornar.
+ */
+static void i2c_blocking_start_write(const uint8_t *src, size_t len)
+{
+    i2c_blocking_write(src, len);
+}
+
+static bool i2c_blocking_busy()
+{
+    return false;
+}
+
+/*! @brief Transporte padrão: `i2c_write_blocking()`, sem transferências em segundo plano. */
+const ssd1306_transport_t ssd1306_i2c_blocking_transport = {
+    write : i2c_blocking_write,
+    start_write : i2c_blocking_start_write,
+    busy : i2c_blocking_busy,
+};
+
+static const ssd1306_transport_t *transport = &ssd1306_i2c_blocking_transport; // transporte em uso
+
+/*!
+ * @brief Define o transporte utilizado para comunicar com o display.
+ *
+ * @param t Transporte (ver ssd1306_transport.h). Deve ser definido antes de `SSD1306_init()`.
+ */
+void SSD1306_set_transport(const ssd1306_transport_t *t)
+{
+    transport = t;
+}
+
+/*!
+ * @brief Retorna o transporte utilizado para comunicar com o display.
+ */
+const ssd1306_transport_t *SSD1306_get_transport()
+{
+    return transport;
+}
 
 /*!
  * @brief Calcula o tamanho do buffer para uma área de renderização.
@@ -37,7 +105,7 @@ void calc_render_area_buflen(render_area_t *area)
  * @details
  * - A função configura o byte de controle para indicar que um comando está sendo enviado (Co = 1, D/C = 0).
  * - Em seguida, envia o byte de controle e o comando através da interface I2C.
- * - A comunicação I2C é realizada através da função `i2c_write_blocking`.
+ * - A comunicação é realizada através do transporte em uso (por padrão, `i2c_write_blocking`).
  *
  * @note
  * Esta função é utilizada para configurar o display SSD1306, definindo parâmetros como
@@ -46,14 +114,88 @@ void calc_render_area_buflen(render_area_t *area)
 void SSD1306_send_cmd(uint8_t cmd)
 {
     uint8_t buf[2] = {0x80, cmd};
-    i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, buf, 2, false);
+    transport->write(buf, 2);
+}
+
+/*!
+ * @brief Inicia uma sequência de comandos vazia.
+ */
+void SSD1306_cmd_stream_init(ssd1306_cmd_stream_t *stream)
+{
+    stream->num = 0;
+}
+
+/*!
+ * @brief Acrescenta comandos (e seus argumentos) ao final da sequência.
+ *
+ * @param stream Sequência de comandos.
+ * @param cmds   Comandos a acrescentar.
+ * @param num    Número de bytes em `cmds`.
+ */
+void SSD1306_cmd_stream_add(ssd1306_cmd_stream_t *stream, const uint8_t *cmds, int num)
+{
+    assert(stream->num + num <= SSD1306_CMD_STREAM_MAX);
+
+    memcpy(stream->cmds + stream->num, cmds, num);
+    stream->num += num;
+}
+
+/*!
+ * @brief Envia a sequência de comandos em uma única transação.
+ *
+ * @details
+ *  - O byte de controle 0x00 (Co = 0, D/C = 0) indica que todos os bytes seguintes, até o STOP, são comandos.
+ */
+void SSD1306_cmd_stream_send(const ssd1306_cmd_stream_t *stream)
+{
+    uint8_t buf[1 + SSD1306_CMD_STREAM_MAX];
+
+    buf[0] = 0x00;
+    memcpy(buf + 1, stream->cmds, stream->num);
+    transport->write(buf, stream->num + 1);
+}
+
+/*!
+ * @brief Escreve o cabeçalho que permite enviar a sequência de comandos e dados na mesma transação.
+ *
+ * @param stream Sequência de comandos.
+ * @param dst    Destino com `SSD1306_CMD_HEADER_LEN(stream->num)` bytes.
+ *
+ * @return O tamanho do cabeçalho escrito.
+ *
+ * @details
+ *  - Com Co = 0 não é possível voltar a enviar dados na mesma transação, por isso cada comando é precedido
+ *    do byte de controle 0x80 (Co = 1) e o cabeçalho termina com 0x40 (Co = 0, D/C = 1).
+ */
+int SSD1306_cmd_stream_header(const ssd1306_cmd_stream_t *stream, uint8_t *dst)
+{
+    for (int i = 0; i < stream->num; i++)
+    {
+        dst[2 * i] = 0x80;
+        dst[2 * i + 1] = stream->cmds[i];
+    }
+    dst[2 * stream->num] = 0x40;
+    return SSD1306_CMD_HEADER_LEN(stream->num);
+}
+
+/*!
+ * @brief Envia a sequência de comandos seguida de dados para a RAM do display, em uma única transação.
+ *
+ * @param stream Sequência de comandos.
+ * @param buf    Buffer com `SSD1306_CMD_HEADER_LEN(stream->num)` bytes reservados antes dos dados.
+ * @param buflen O número de bytes de dados.
+ */
+void SSD1306_cmd_stream_send_with_data(const ssd1306_cmd_stream_t *stream, uint8_t *buf, int buflen)
+{
+    int header = SSD1306_cmd_stream_header(stream, buf);
+    transport->write(buf, header + buflen);
 }
 
 /*!
  * @brief Envia uma lista de comandos para o display SSD1306.
  *
- * Esta função itera sobre um array de comandos e os envia individualmente para o display SSD1306
- * através da função `SSD1306_send_cmd`.
+ * Os comandos são agrupados em sequências de até `SSD1306_CMD_STREAM_MAX` bytes, cada uma enviada em uma
+ * única transação (ver `SSD1306_cmd_stream_send()`), em vez de uma transação por comando.
  *
  * @param buf   Um ponteiro para o array de comandos a serem enviados.
  * @param num   O número de comandos no array
@@ -65,8 +207,14 @@ void SSD1306_send_cmd(uint8_t cmd)
  */
 void SSD1306_send_cmd_list(uint8_t *buf, int num)
 {
-    for (int i = 0; i < num; i++)
-        SSD1306_send_cmd(buf[i]);
+    ssd1306_cmd_stream_t stream;
+
+    for (int i = 0; i < num; i += SSD1306_CMD_STREAM_MAX)
+    {
+        SSD1306_cmd_stream_init(&stream);
+        SSD1306_cmd_stream_add(&stream, buf + i, MIN(num - i, SSD1306_CMD_STREAM_MAX));
+        SSD1306_cmd_stream_send(&stream);
+    }
 }
 
 /*!
@@ -80,28 +228,34 @@ void SSD1306_send_cmd_list(uint8_t *buf, int num)
  * @param buflen  O tamanho do buffer de dados em bytes.
  *
  * @details
- *  - A função aloca um buffer temporário (`temp_buf`) com tamanho `buflen + 1` para adicionar o byte de controle.
- *  - O primeiro byte de `temp_buf` é definido como `0x40`, indicando que os dados a seguir são dados para a RAM do display.
- *  - Os dados do buffer original (`buf`) são copiados para `temp_buf` a partir do segundo byte.
- *  - A função utiliza `i2c_write_blocking` para enviar o conteúdo de `temp_buf` para o display.
- *  - Após a transmissão, a memória alocada para `temp_buf` é liberada.
+ *  - O byte de controle `0x40` (dados para a RAM do display) e os dados são agrupados no buffer estático `data_buf`,
+ *    sem alocação dinâmica, e enviados em uma única transação pelo transporte em uso.
  *
  * @note
  *  - Esta função é utilizada para atualizar o conteúdo do display SSD1306 com os dados presentes no buffer.
  *  - É importante garantir que o tamanho do buffer (`buflen`) corresponda à área de exibição desejada.
  *  - A função pressupõe que o display esteja configurado no modo de endereçamento horizontal para
  *    o correto funcionamento.
+ *  - Buffers que já reservam o byte de controle devem utilizar `SSD1306_send_data()`, evitando a cópia.
  */
 void SSD1306_send_buf(uint8_t buf[], int buflen)
 {
-    uint8_t *temp_buf = malloc(buflen + 1);
-
-    temp_buf[0] = 0x40;
-    memcpy(temp_buf + 1, buf, buflen);
+    assert(buflen <= SSD1306_FRAME_LEN);
 
-    i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, temp_buf, buflen + 1, false);
+    memcpy(data_buf + 1, buf, buflen);
+    SSD1306_send_data(data_buf, buflen);
+}
 
-    free(temp_buf);
+/*!
+ * @brief Envia um buffer de dados que já reserva o byte de controle na primeira posição.
+ *
+ * @param buf     Buffer com `buflen + 1` bytes; `buf[0]` é sobrescrito com o byte de controle `0x40`.
+ * @param buflen  O número de bytes de dados (sem o byte de controle).
+ */
+void SSD1306_send_data(uint8_t *buf, int buflen)
+{
+    buf[0] = 0x40;
+    transport->write(buf, buflen + 1);
 }
 
 /*!
@@ -151,6 +305,44 @@ void SSD1306_init()
     };
 
     SSD1306_send_cmd_list(cmds, count_of(cmds));
+    SSD1306_invalidate_shadow(); // o conteúdo da memória de imagem após a inicialização é indefinido
+}
+
+/*!
+ * @brief Escreve o cabeçalho que define a janela de colunas e páginas e antecede os dados da janela.
+ *
+ * @param area Área de renderização.
+ * @param dst  Destino com `SSD1306_WINDOW_HEADER_LEN` bytes.
+ *
+ * @return O tamanho do cabeçalho escrito (`SSD1306_WINDOW_HEADER_LEN`).
+ */
+int SSD1306_window_header(const render_area_t *area, uint8_t *dst)
+{
+    uint8_t cmds[] = {
+        SSD1306_SET_COL_ADDR,
+        area->start_col,
+        area->end_col,
+        SSD1306_SET_PAGE_ADDR,
+        area->start_page,
+        area->end_page};
+    ssd1306_cmd_stream_t stream;
+
+    SSD1306_cmd_stream_init(&stream);
+    SSD1306_cmd_stream_add(&stream, cmds, count_of(cmds));
+    return SSD1306_cmd_stream_header(&stream, dst);
+}
+
+/*!
+ * @brief Registra na cópia do conteúdo do display (`panel_shadow`) os dados enviados para uma área.
+ */
+static void update_shadow(const uint8_t *buf, const render_area_t *area)
+{
+    int cols = area->end_col - area->start_col + 1;
+    for (int page = area->start_page; page <= area->end_page; page++)
+        memcpy(&panel_shadow[page * SSD1306_WIDTH + area->start_col], buf + (page - area->start_page) * cols, cols);
+
+    if (area->start_col == 0 && area->end_col == SSD1306_WIDTH - 1 && area->start_page == 0 && area->end_page == SSD1306_NUM_PAGES - 1)
+        panel_shadow_valid = true;
 }
 
 /*!
@@ -163,20 +355,163 @@ void SSD1306_init()
  *  - Esta função é utilizada para atualizar uma parte específica do display SSD1306 com os dados fornecidos no buffer.
  *  - A estrutura `render_area_t` define a região do display que será afetada pela operação de renderização.
  *  - É importante garantir que o tamanho do buffer corresponda à área de renderização definida para evitar erros de exibição.
+ *  - Os comandos de janela e os dados seguem em uma única transação (ver `SSD1306_window_header()`).
+ *  - A cópia do conteúdo do display (`panel_shadow`) é atualizada com a área enviada; após um frame completo ela passa a ser válida.
  */
 void render(uint8_t *buf, render_area_t *area)
 {
-    // atualizar uma parte da exibição com uma área de renderização
-    uint8_t cmds[] = {
-        SSD1306_SET_COL_ADDR,
-        area->start_col,
-        area->end_col,
-        SSD1306_SET_PAGE_ADDR,
-        area->start_page,
-        area->end_page};
+    assert(area->buflen <= SSD1306_FRAME_LEN);
 
-    SSD1306_send_cmd_list(cmds, count_of(cmds));
-    SSD1306_send_buf(buf, area->buflen);
+    int header = SSD1306_window_header(area, data_buf);
+    memcpy(data_buf + header, buf, area->buflen);
+    transport->write(data_buf, header + area->buflen);
+    update_shadow(buf, area);
+}
+
+/*!
+ * @brief Registra o frame completo que o display passa a exibir após uma transferência externa (ver ssd1306_tx.h).
+ */
+void SSD1306_mark_displayed(const uint8_t *frame)
+{
+    memcpy(panel_shadow, frame, SSD1306_FRAME_LEN);
+    panel_shadow_valid = true;
+}
+
+/*!
+ * @brief Retorna a cópia do conteúdo do display (o último frame enviado), ou NULL se for desconhecido.
+ */
+const uint8_t *SSD1306_displayed()
+{
+    return panel_shadow_valid ? panel_shadow : NULL;
+}
+
+/*!
+ * @brief Descarta a cópia do conteúdo do display, forçando o envio do próximo frame completo.
+ */
+void SSD1306_invalidate_shadow()
+{
+    panel_shadow_valid = false;
+}
+
+/*!
+ * @brief Envia uma janela do frame, agrupando os bytes das páginas em `window_buf` (após o cabeçalho da janela).
+ *
+ * @return O número de bytes de imagem enviados.
+ */
+static int render_window(const uint8_t *buf, render_area_t *area)
+{
+    int cols = area->end_col - area->start_col + 1;
+    for (int page = area->start_page; page <= area->end_page; page++)
+        memcpy(window_buf + SSD1306_WINDOW_HEADER_LEN + (page - area->start_page) * cols, &buf[page * SSD1306_WIDTH + area->start_col], cols);
+
+    calc_render_area_buflen(area);
+    SSD1306_window_header(area, window_buf);
+    transport->write(window_buf, SSD1306_WINDOW_HEADER_LEN + area->buflen);
+    update_shadow(window_buf + SSD1306_WINDOW_HEADER_LEN, area);
+    return area->buflen;
+}
+
+/*!
+ * @brief Custo estimado, em bytes, de enviar uma janela (ver `SSD1306_WINDOW_COST`).
+ */
+static int window_cost(int start_col, int end_col, int start_page, int end_page)
+{
+    return SSD1306_WINDOW_COST + (end_col - start_col + 1) * (end_page - start_page + 1);
+}
+
+/*!
+ * @brief Envia ao display apenas as regiões do frame que diferem do conteúdo atual do display.
+ *
+ * @param buf Um ponteiro para o frame completo (`SSD1306_FRAME_LEN` bytes, layout de páginas).
+ *
+ * @return O número de bytes de imagem enviados (0 se o display já exibe o frame).
+ *
+ * @details
+ *  - Compara o frame com `panel_shadow` página a página e forma intervalos de colunas sujas, unindo intervalos
+ *    separados por menos de `SSD1306_WINDOW_COST` colunas limpas.
+ *  - Páginas consecutivas com um único intervalo são unidas em uma janela de várias páginas quando isso é mais barato.
+ *  - Cada janela é enviada com seus próprios comandos `SSD1306_SET_COL_ADDR`/`SSD1306_SET_PAGE_ADDR`, na mesma
+ *    transação que os seus dados.
+ *
+ * @note
+ *  - Enquanto o conteúdo do display for desconhecido (após `SSD1306_init()` ou `SSD1306_invalidate_shadow()`),
+ *    o frame é enviado por completo.
+ */
+int SSD1306_render_dirty(const uint8_t *buf)
+{
+    render_area_t pending;
+    bool has_pending = false;
+    int sent = 0;
+
+    if (!panel_shadow_valid)
+    {
+        pending = (render_area_t){start_col : 0, end_col : SSD1306_WIDTH - 1, start_page : 0, end_page : SSD1306_NUM_PAGES - 1};
+        return render_window(buf, &pending);
+    }
+
+    for (int page = 0; page < SSD1306_NUM_PAGES; page++)
+    {
+        const uint8_t *row = &buf[page * SSD1306_WIDTH];
+        const uint8_t *shadow = &panel_shadow[page * SSD1306_WIDTH];
+        uint8_t span_start[SSD1306_WIDTH], span_end[SSD1306_WIDTH];
+        int spans = 0;
+
+        // intervalos de colunas sujas da página
+        for (int col = 0; col < SSD1306_WIDTH; col++)
+        {
+            if (row[col] == shadow[col])
+                continue;
+
+            int end = col;
+            for (int c = col + 1; c < SSD1306_WIDTH && c - end <= SSD1306_WINDOW_COST; c++)
+                if (row[c] != shadow[c])
+                    end = c;
+
+            span_start[spans] = col;
+            span_end[spans] = end;
+            spans++;
+            col = end;
+        }
+
+        if (spans == 1 && has_pending && pending.end_page == page - 1)
+        {
+            // estende a janela pendente para esta página se a união custar menos que duas janelas
+            int start_col = MIN(pending.start_col, span_start[0]);
+            int end_col = MAX(pending.end_col, span_end[0]);
+            int separate = window_cost(pending.start_col, pending.end_col, pending.start_page, pending.end_page) +
+                           window_cost(span_start[0], span_end[0], page, page);
+            if (window_cost(start_col, end_col, pending.start_page, page) <= separate)
+            {
+                pending.start_col = start_col;
+                pending.end_col = end_col;
+                pending.end_page = page;
+                continue;
+            }
+        }
+
+        if (has_pending)
+        {
+            sent += render_window(buf, &pending);
+            has_pending = false;
+        }
+
+        for (int i = 0; i < spans; i++)
+        {
+            render_area_t area = {start_col : span_start[i], end_col : span_end[i], start_page : page, end_page : page};
+            if (i == spans - 1)
+            {
+                pending = area; // o último intervalo ainda pode ser unido às páginas seguintes
+                has_pending = true;
+            }
+            else
+                sent += render_window(buf, &area);
+        }
+    }
+
+    if (has_pending)
+        sent += render_window(buf, &pending);
+
+    return sent;
 }
 
 /*!
@@ -227,26 +562,16 @@ void set_pixel(uint8_t *buf, int x, int y, bool on)
  * @param on     Um valor booleano indicando se o cursor deve ser desenhado (true) ou apagado (false).
  *
  * @details
- *  - A função itera sobre as bordas superior e inferior do quadrado, definindo ou limpando os pixels correspondentes no buffer.
- *  - Em seguida, itera sobre as bordas esquerda e direita do quadrado, definindo ou limpando os pixels correspondentes no buffer.
- *  - Utiliza a função `set_pixel()` para definir ou limpar cada pixel individualmente.
+ *  - As bordas horizontais são faixas de um bit em cada byte da página; as verticais, um byte por página
+ *    (ver `raster_outline()`).
  *
  * @note
- *  - As coordenadas e dimensões devem estar dentro dos limites do display (0 <= left < SSD1306_WIDTH, 0 <= top < SSD1306_HEIGHT, left + width <= SSD1306_WIDTH, top + height <= SSD1306_HEIGHT).
+ *  - As partes do cursor fora do display são recortadas.
  *  - Essa função é utilizada para destacar uma área específica do display.
  */
 void draw_cursor(uint8_t *buf, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool on)
 {
-    for (uint8_t x = left; x < left + width; ++x)
-    {
-        set_pixel(buf, x, top, on);
-        set_pixel(buf, x, top + height - 1, on);
-    }
-    for (uint8_t y = top; y < top + height; ++y)
-    {
-        set_pixel(buf, left, y, on);
-        set_pixel(buf, left + width - 1, y, on);
-    }
+    raster_outline(buf, left, top, width, height, on ? RASTER_SET : RASTER_CLEAR);
 }
 
 /*!
@@ -259,19 +584,593 @@ void draw_cursor(uint8_t *buf, uint8_t top, uint8_t left, uint8_t width, uint8_t
  * @details
  *  - Implementa o algoritmo para determinar se um ponto complexo pertence ao conjunto de Mandelbrot.
  *  - Inicia com z = 0 e itera z = z^2 + c até que o módulo de z seja maior que 2 ou o número máximo de iterações seja atingido.
+ *  - Utiliza `mandelbrot_ex()`, que também aplica os atalhos para pontos interiores.
  */
 int mandelbrot(float complex c)
 {
+    mandelbrot_result_t result;
+    return mandelbrot_ex(c, &result);
+}
+
+/*!
+ * @brief Versão de `mandelbrot()` que informa como a iteração terminou.
+ *
+ * @param c        Um número complexo representando o ponto a ser testado.
+ * @param result   Recebe o tipo de saída e o número de iterações efetivamente executadas.
+ *
+ * @return int     O número de iterações que o ponto leva para escapar, ou o limite de iterações se o ponto pertence ao conjunto.
+ *
+ * @details
+ *  - Com `MANDELBROT_SHORTCUTS`, pontos da cardioide principal e do bulbo de período 2 são identificados
+ *    analiticamente, e órbitas que repetem exatamente um valor anterior (verificação de Brent) são encerradas,
+ *    pois nunca escapariam. Em todos esses casos o resultado é o limite de iterações, como no laço completo.
+ */
+int mandelbrot_ex(float complex c, mandelbrot_result_t *result)
+{
+    const int cap = max_iter;
+    result->work = 0;
+#if MANDELBROT_SHORTCUTS
+    float cr = crealf(c), ci = cimagf(c);
+    if (cr > -0.75f && cr < 0.375f && ci > -0.66f && ci < 0.66f)
+    {
+        // cardioide principal: q(q + (x - 1/4)) <= y^2 / 4, com q = (x - 1/4)^2 + y^2
+        float xm = cr - 0.25f;
+        float q = xm * xm + ci * ci;
+        if (q * (q + xm) <= 0.25f * ci * ci)
+        {
+            result->exit = MANDELBROT_EXIT_CARDIOID;
+            return cap;
+        }
+    }
+    if ((cr + 1.0f) * (cr + 1.0f) + ci * ci <= 0.0625f) // bulbo de período 2: |c + 1| <= 1/4
+    {
+        result->exit = MANDELBROT_EXIT_BULB;
+        return cap;
+    }
+    float complex check = 0; // valor salvo para a verificação de periodicidade
+    int check_period = 1, since_check = 0;
+#endif
+
     float complex z = 0.0 + 0.0 * I;
     int n = 0;
-    while (cabsf(z) <= 2 && n < MAX_ITER) // a função cabsf() calcula o valor absoluto (magnitude) de um número complexo do tipo float complex
+    while (cabsf(z) <= 2 && n < cap) // a função cabsf() calcula o valor absoluto (magnitude) de um número complexo do tipo float complex
     {
         z = z * z + c;
         n++;
+#if MANDELBROT_SHORTCUTS
+        if (z == check)
+        {
+            result->exit = MANDELBROT_EXIT_PERIODIC;
+            result->work = n;
+            return cap;
+        }
+        if (++since_check == check_period)
+        {
+            since_check = 0;
+            check_period <<= 1;
+            check = z;
+        }
+#endif
     }
+    result->exit = (n == cap) ? MANDELBROT_EXIT_MAX_ITER : MANDELBROT_EXIT_ESCAPED;
+    result->work = n;
     return n;
 }
 
+/*!
+ * @brief Calcula se um ponto pertence ao conjunto de Mandelbrot utilizando aritmética inteira.
+ *
+ * @param c_real   Parte real do ponto, no formato Q3.28 (ver `MANDELBROT_TO_FIXED`).
+ * @param c_imag   Parte imaginária do ponto, no formato Q3.28.
+ *
+ * @return int     O número de iterações que o ponto leva para escapar, ou o limite de iterações se o ponto pertence ao conjunto.
+ */
+int mandelbrot_fixed(int32_t c_real, int32_t c_imag)
+{
+    mandelbrot_result_t result;
+    return mandelbrot_fixed_ex(c_real, c_imag, &result);
+}
+
+/*!
+ * @brief Versão de `mandelbrot_fixed()` que informa como a iteração terminou.
+ *
+ * @param c_real   Parte real do ponto, no formato Q3.28 (ver `MANDELBROT_TO_FIXED`).
+ * @param c_imag   Parte imaginária do ponto, no formato Q3.28.
+ * @param result   Recebe o tipo de saída e o número de iterações efetivamente executadas.
+ *
+ * @return int     O número de iterações que o ponto leva para escapar, ou o limite de iterações se o ponto pertence ao conjunto.
+ *
+ * @details
+ *  - Mesma iteração de `mandelbrot()`, porém sem ponto flutuante: as coordenadas são inteiros de 32 bits
+ *    e os produtos utilizam intermediários de 64 bits.
+ *  - O teste de escape compara |z|^2 > 4 diretamente, dispensando a raiz quadrada de `cabsf()`.
+ *  - Enquanto |z| <= 2, cada componente de z^2 fica limitado a 4 em módulo e, com |Re(c)|, |Im(c)| < 4 (ver abaixo),
+ *    cada componente de z^2 + c fica abaixo de 8, dentro do intervalo (-8, 8) do Q3.28.
+ *  - O termo 2xy é arredondado em direção a zero, de forma que a órbita de conj(c) é exatamente o conjugado
+ *    da órbita de c (necessário para o espelhamento de linhas em `draw_mandelbrot_frame()`).
+ *  - Com `MANDELBROT_SHORTCUTS`, aplica os mesmos atalhos para pontos interiores de `mandelbrot_ex()`;
+ *    a verificação de periodicidade compara valores inteiros exatos.
+ *
+ * @note
+ *  - Pontos com |Re(c)| ou |Im(c)| >= 4 escapam na primeira iteração e são tratados antes do laço,
+ *    o que também protege a conversão para Q3.28 contra estouro.
+ */
+int mandelbrot_fixed_ex(int32_t c_real, int32_t c_imag, mandelbrot_result_t *result)
+{
+    const int cap = max_iter;
+    const int32_t limit = 4 << MANDELBROT_FRAC_BITS;
+    if (c_real >= limit || c_real <= -limit || c_imag >= limit || c_imag <= -limit)
+    {
+        result->exit = MANDELBROT_EXIT_ESCAPED;
+        result->work = 1;
+        return 1;
+    }
+
+    result->work = 0;
+#if MANDELBROT_SHORTCUTS
+    const int32_t one = 1 << MANDELBROT_FRAC_BITS;
+    int64_t ci2 = (int64_t)c_imag * c_imag; // Q6.56
+    if (c_real > -(3 * one / 4) && c_real < 3 * one / 8 && c_imag > -(one * 2 / 3) && c_imag < one * 2 / 3)
+    {
+        // cardioide principal: q(q + (x - 1/4)) <= y^2 / 4, com q = (x - 1/4)^2 + y^2
+        int32_t xm = c_real - one / 4;
+        int32_t q = (int32_t)(((int64_t)xm * xm + ci2) >> MANDELBROT_FRAC_BITS);
+        if ((int64_t)q * (q + xm) <= ci2 / 4)
+        {
+            result->exit = MANDELBROT_EXIT_CARDIOID;
+            return cap;
+        }
+    }
+    int32_t xb = c_real + one;
+    if (xb > -one / 4 && xb < one / 4 && (int64_t)xb * xb + ci2 <= ((int64_t)one * one) / 16) // bulbo de período 2
+    {
+        result->exit = MANDELBROT_EXIT_BULB;
+        return cap;
+    }
+    int32_t check_x = 0, check_y = 0; // valor salvo para a verificação de periodicidade
+    int check_period = 1, since_check = 0;
+#endif
+
+    const int64_t escape = (int64_t)4 << (2 * MANDELBROT_FRAC_BITS); // 4 em Q6.56
+    const int64_t round_to_zero = ((int64_t)1 << (MANDELBROT_FRAC_BITS - 1)) - 1;
+    int32_t x = 0, y = 0;
+    int n = 0;
+    while (n < cap)
+    {
+        int64_t x2 = (int64_t)x * x; // Q6.56
+        int64_t y2 = (int64_t)y * y;
+        if (x2 + y2 > escape) // |z|^2 > 4
+            break;
+        int64_t xy = (int64_t)x * y;
+        x = (int32_t)((x2 - y2) >> MANDELBROT_FRAC_BITS) + c_real;
+        y = (int32_t)((xy + ((xy >> 63) & round_to_zero)) >> (MANDELBROT_FRAC_BITS - 1)) + c_imag; // 2xy
+        n++;
+#if MANDELBROT_SHORTCUTS
+        if (x == check_x && y == check_y)
+        {
+            result->exit = MANDELBROT_EXIT_PERIODIC;
+            result->work = n;
+            return cap;
+        }
+        if (++since_check == check_period)
+        {
+            since_check = 0;
+            check_period <<= 1;
+            check_x = x;
+            check_y = y;
+        }
+#endif
+    }
+    result->exit = (n == cap) ? MANDELBROT_EXIT_MAX_ITER : MANDELBROT_EXIT_ESCAPED;
+    result->work = n;
+    return n;
+}
+
+/*!
+ * @brief Acumula as estatísticas de renderização `src` em `dst`.
+ */
+void mandelbrot_stats_add(mandelbrot_stats_t *dst, const mandelbrot_stats_t *src)
+{
+    dst->evaluated += src->evaluated;
+    dst->iterations += src->iterations;
+    for (int i = 0; i < MANDELBROT_EXIT_COUNT; i++)
+        dst->exits[i] += src->exits[i];
+    dst->mirrored += src->mirrored;
+    dst->filled += src->filled;
+    for (int i = 0; i < MANDELBROT_HIST_BINS; i++)
+        dst->escapes[i] += src->escapes[i];
+}
+
+/*!
+ * @brief Retorna as estatísticas do último frame renderizado por `draw_mandelbrot_frame()`.
+ */
+const mandelbrot_stats_t *mandelbrot_frame_stats()
+{
+    return &frame_stats;
+}
+
+/*!
+ * @brief Avalia o kernel ativo em um ponto do plano complexo.
+ *
+ * @param real   Parte real do ponto.
+ * @param imag   Parte imaginária do ponto.
+ * @param stats  Estatísticas às quais a avaliação é somada.
+ * @param exit   Recebe a forma como a iteração terminou (pode ser NULL).
+ *
+ * @return int   O número de iterações do ponto (`mandelbrot_get_max_iter()` se pertence ao conjunto).
+ */
+int mandelbrot_point(float real, float imag, mandelbrot_stats_t *stats, mandelbrot_exit_t *exit)
+{
+    mandelbrot_result_t result;
+    int m;
+    if (formula != ESCAPE_MANDELBROT)
+    {
+        // motor genérico (escape.hpp): a fórmula é escolhida aqui, uma vez por pixel
+        const int cap = max_iter;
+        m = formula_kernel(real, imag, julia_real, julia_imag, cap);
+        result.exit = (m == cap) ? MANDELBROT_EXIT_MAX_ITER : MANDELBROT_EXIT_ESCAPED;
+        result.work = m;
+    }
+    else
+    {
+#if MANDELBROT_FIXED_POINT
+        m = mandelbrot_fixed_ex(MANDELBROT_TO_FIXED(real), MANDELBROT_TO_FIXED(imag), &result);
+#else
+        float complex c = real + imag * I;
+        m = mandelbrot_ex(c, &result);
+#endif
+    }
+    stats->evaluated++;
+    stats->iterations += result.work;
+    stats->exits[result.exit]++;
+    if (result.exit == MANDELBROT_EXIT_ESCAPED)
+        stats->escapes[m / MANDELBROT_HIST_BIN_ITERS]++;
+    if (exit)
+        *exit = result.exit;
+    return m;
+}
+
+/*!
+ * @brief Seleciona a forma como os próximos frames são calculados.
+ *
+ * @note O cache de frames é esvaziado, já que os modos de subdivisão podem produzir outra imagem.
+ */
+void mandelbrot_set_render_mode(mandelbrot_render_mode_t mode)
+{
+    if (mode != render_mode)
+        frame_cache_clear();
+    render_mode = mode;
+}
+
+/*!
+ * @brief Retorna a forma atual de cálculo dos frames.
+ */
+mandelbrot_render_mode_t mandelbrot_get_render_mode()
+{
+    return render_mode;
+}
+
+/*!
+ * @brief Seleciona a fórmula de iteração dos próximos frames.
+ *
+ * @param formula Fórmula (ver `escape_formula_t`).
+ * @param k_real  Parte real da constante de Julia (ignorada pelas demais fórmulas).
+ * @param k_imag  Parte imaginária da constante de Julia.
+ *
+ * @details
+ *  - Mandelbrot utiliza o kernel com atalhos (`mandelbrot_fixed_ex()` ou `mandelbrot_ex()`); as demais fórmulas,
+ *    o kernel do motor genérico no tipo numérico do build (`escape_kernel()`).
+ *  - O espelhamento de linhas é aplicado apenas às fórmulas simétricas (`escape_formula_mirrored()`), e a
+ *    subdivisão de retângulos apenas às fórmulas conexas (`escape_formula_connected()`).
+ *
+ * @note O cache de frames é esvaziado se a fórmula ou a constante mudar, já que é indexado apenas pela janela.
+ *       Chamada apenas entre frames, pelo laço principal (o core1 lê a fórmula durante a renderização).
+ */
+void mandelbrot_set_formula(escape_formula_t f, float k_real, float k_imag)
+{
+    if (f != formula || (f == ESCAPE_JULIA && (k_real != julia_real || k_imag != julia_imag)))
+        frame_cache_clear();
+    formula_kernel = escape_kernel(f);
+    julia_real = k_real;
+    julia_imag = k_imag;
+    formula = f;
+}
+
+/*!
+ * @brief Retorna a fórmula de iteração atual.
+ */
+escape_formula_t mandelbrot_get_formula()
+{
+    return formula;
+}
+
+/*!
+ * @brief Define o limite de iterações dos kernels, entre 1 e `MANDELBROT_ITER_LIMIT`.
+ *
+ * @note
+ *  - Os pontos que atingem o limite são desenhados como pertencentes ao conjunto; um limite maior revela
+ *    a borda em ampliações profundas, um menor reduz o tempo das janelas rasas (ver render_budget.h).
+ *  - O cache de frames não é esvaziado: um frame guardado mantém o limite com que foi renderizado.
+ */
+void mandelbrot_set_max_iter(int cap)
+{
+    max_iter = cap < 1 ? 1 : cap > MANDELBROT_ITER_LIMIT ? MANDELBROT_ITER_LIMIT : cap;
+}
+
+/*!
+ * @brief Retorna o limite de iterações atual dos kernels.
+ */
+int mandelbrot_get_max_iter()
+{
+    return max_iter;
+}
+
+/*!
+ * @brief Retém as iterações dos pixels renderizados em um frame, além da imagem de 1 bit.
+ *
+ * @param buf   Frame cujas iterações são retidas (NULL encerra a retenção).
+ * @param field Recebe, para cada pixel de `buf` calculado (índice y * SSD1306_WIDTH + x), o número de iterações do
+ *              escape ou `MANDELBROT_FIELD_INSIDE` quando o ponto atinge o limite. Os pixels preenchidos, deslocados
+ *              ou espelhados recebem o valor do pixel de origem.
+ *
+ * @note Os renderizadores consultam `mandelbrot_field()` com o próprio buffer de destino: frames de outros buffers
+ *       (especulação, benchmark) não alteram o campo.
+ */
+void mandelbrot_retain_field(const uint8_t *buf, uint8_t *field)
+{
+    field_frame = buf;
+    field_counts = field;
+}
+
+/*!
+ * @brief Retorna o campo de iterações retido de `buf`, ou NULL se as iterações de `buf` não são retidas.
+ */
+uint8_t *mandelbrot_field(const uint8_t *buf)
+{
+    return buf != NULL && buf == field_frame ? field_counts : NULL;
+}
+
+/*!
+ * @brief Retorna o frame e o campo retidos, para restaurá-los após renderizar outro frame com o próprio campo.
+ */
+void mandelbrot_get_retained_field(const uint8_t **buf, uint8_t **field)
+{
+    *buf = field_frame;
+    *field = field_counts;
+}
+
+/*!
+ * @brief Fornece as amostras de um frame já avaliadas com o limite de iterações atual, que a próxima renderização de
+ *        `buf` não reavalia.
+ *
+ * @param buf     Frame a renderizar (NULL encerra o fornecimento).
+ * @param samples Para cada pixel com x e y múltiplos de `MANDELBROT_SEED_STEP` (`MANDELBROT_SEED_INDEX()`), o número
+ *                de iterações retornado por `mandelbrot_point()`, ou `MANDELBROT_SEED_INTERIOR` se o ponto é
+ *                comprovadamente interior.
+ *
+ * @details
+ *  - O frame renderizado é idêntico ao renderizado sem as amostras, inclusive nos modos de subdivisão, em que cada
+ *    amostra entra na grade de iterações como se a borda de um retângulo a tivesse avaliado.
+ *  - As amostras não entram nas estatísticas do frame: já foram somadas às de quem as avaliou.
+ */
+void mandelbrot_seed_samples(const uint8_t *buf, const uint8_t *samples)
+{
+    seed_frame = buf;
+    seed_values = samples;
+}
+
+/*!
+ * @brief Retorna as amostras já avaliadas de `buf`, ou NULL se não foram fornecidas.
+ */
+const uint8_t *mandelbrot_samples(const uint8_t *buf)
+{
+    return buf != NULL && buf == seed_frame ? seed_values : NULL;
+}
+
+/*!
+ * @brief Renderiza um bloco retangular do conjunto de Mandelbrot no buffer do display.
+ *
+ * @param buf        Um ponteiro para o buffer do display.
+ * @param view       Limites do plano complexo do frame inteiro.
+ * @param x_start    Primeira coluna do bloco.
+ * @param x_end      Coluna final do bloco (exclusiva).
+ * @param page_start Primeira página do bloco.
+ * @param page_end   Página final do bloco (exclusiva).
+ * @param skip_rows  Máscara de linhas (bit y = linha y) que não devem ser calculadas, por serem espelhadas depois.
+ * @param stats      Estatísticas acumuladas pelo bloco (pode ser NULL).
+ *
+ * @details
+ *  - Os incrementos são calculados a partir do frame inteiro, de forma que qualquer divisão do frame em
+ *    blocos produz exatamente os mesmos pixels que a renderização do frame de uma só vez.
+ *  - Blocos alinhados às páginas não compartilham bytes do buffer, podendo ser renderizados em paralelo.
+ *  - Os 8 pixels de uma coluna da página são montados em um byte e escritos de uma vez; os bits das linhas de
+ *    `skip_rows` mantêm o valor anterior.
+ *  - Os pixels com amostra já avaliada (`mandelbrot_seed_samples()`) não são reavaliados.
+ */
+void draw_mandelbrot_block(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                           uint64_t skip_rows, mandelbrot_stats_t *stats)
+{
+    float stepX = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    int cap = max_iter;
+    mandelbrot_stats_t local = {0};
+    uint8_t *field = mandelbrot_field(buf);
+    const uint8_t *samples = mandelbrot_samples(buf);
+
+    for (int page = page_start; page < page_end; page++)
+    {
+        uint8_t mask = (uint8_t)~(skip_rows >> (page * SSD1306_PAGE_HEIGHT)); // linhas calculadas da página
+        uint8_t *row = &buf[page * SSD1306_WIDTH];
+        float imag[SSD1306_PAGE_HEIGHT];
+        for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+        {
+            int y = page * SSD1306_PAGE_HEIGHT + bit;
+            imag[bit] = view->im_start + y * stepY;
+        }
+
+        for (int x = x_start; x < x_end; x++)
+        {
+            // os 8 pixels verticais da coluna formam um byte, montado em registrador e escrito uma vez
+            float real = view->real_start + x * stepX;
+            uint8_t bits = 0;
+            bool sampled_column = samples && x % MANDELBROT_SEED_STEP == 0;
+            for (int bit = 0; bit < SSD1306_PAGE_HEIGHT; bit++)
+            {
+                if (!(mask >> bit & 1))
+                    continue;
+                int y = page * SSD1306_PAGE_HEIGHT + bit;
+                int m;
+                if (sampled_column && y % MANDELBROT_SEED_STEP == 0)
+                    m = MIN(samples[MANDELBROT_SEED_INDEX(x, y)], cap); // amostra já avaliada
+                else
+                    m = mandelbrot_point(real, imag[bit], &local, NULL);
+                if (m == cap)
+                    bits |= 1 << bit; // o ponto atingiu o limite de iterações
+                if (field)
+                    field[y * SSD1306_WIDTH + x] = m == cap ? MANDELBROT_FIELD_INSIDE : (uint8_t)m;
+            }
+            row[x] = (row[x] & ~mask) | bits;
+        }
+    }
+
+    if (stats)
+        mandelbrot_stats_add(stats, &local);
+}
+
+/*!
+ * @brief Renderiza um bloco do frame no modo selecionado por `mandelbrot_set_render_mode()`.
+ *
+ * @details
+ *  - Mesmos parâmetros de `draw_mandelbrot_block()`.
+ *  - Nos modos de subdivisão, apenas o sufixo contínuo de linhas espelhadas é omitido; as demais linhas
+ *    de `skip_rows` são calculadas e depois sobrescritas com o mesmo valor pelo espelhamento.
+ *  - Fórmulas sem regiões de iterações conexas (`escape_formula_connected()`) avaliam todos os pixels em qualquer
+ *    modo: a subdivisão poderia preencher ilhas que não tocam a borda amostrada.
+ */
+void draw_mandelbrot_tile(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                          uint64_t skip_rows, mandelbrot_stats_t *stats)
+{
+    mandelbrot_render_mode_t mode = render_mode;
+    if (mode == MANDELBROT_RENDER_FULL || !escape_formula_connected(formula))
+    {
+        draw_mandelbrot_block(buf, view, x_start, x_end, page_start, page_end, skip_rows, stats);
+        return;
+    }
+
+    int row_end = SSD1306_HEIGHT;
+    while (row_end > 0 && (skip_rows & ((uint64_t)1 << (row_end - 1))))
+        row_end--;
+
+    mandelbrot_stats_t local = {0};
+    draw_mandelbrot_subdivide(buf, view, x_start, x_end, page_start, page_end, row_end,
+                              mode == MANDELBROT_RENDER_SUBDIVIDE_CONSERVATIVE, &local);
+    if (stats)
+        mandelbrot_stats_add(stats, &local);
+}
+
+/*!
+ * @brief Determina as linhas do frame que podem ser copiadas da linha simétrica em relação ao eixo real.
+ *
+ * @param view      Limites do plano complexo.
+ * @param mirror_of Recebe, para cada linha espelhada, a linha de origem.
+ *
+ * @return Máscara das linhas espelhadas (bit y = linha y).
+ *
+ * @details
+ *  - O conjunto é simétrico em relação ao eixo real, e os kernels preservam essa simetria exatamente; as fórmulas
+ *    sem essa simetria (`escape_formula_mirrored()`) não espelham nenhuma linha.
+ *  - Uma linha com parte imaginária positiva é espelhada apenas quando existe outra linha cuja parte imaginária,
+ *    calculada da mesma forma que em `draw_mandelbrot_block()`, é exatamente o seu oposto; assim o resultado é
+ *    idêntico ao de calcular a linha.
+ */
+uint64_t mandelbrot_mirror_rows(const render_data_t *view, int8_t *mirror_of)
+{
+    float stepY = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    uint64_t rows = 0;
+
+    if (!(view->im_start < 0.0f && view->im_end > 0.0f) || stepY <= 0.0f ||
+        !escape_formula_mirrored(formula, julia_imag))
+        return 0;
+
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+    {
+        float imag = view->im_start + y * stepY;
+        if (imag <= 0.0f)
+            continue;
+
+        int partner = (int)((-imag - view->im_start) / stepY + 0.5f);
+        if (partner >= 0 && partner < SSD1306_HEIGHT && view->im_start + partner * stepY == -imag)
+        {
+            mirror_of[y] = partner;
+            rows |= (uint64_t)1 << y;
+        }
+    }
+    return rows;
+}
+
+/*!
+ * @brief Copia as linhas espelhadas (`mandelbrot_mirror_rows()`) a partir das suas linhas de origem, já renderizadas.
+ */
+void mandelbrot_apply_mirror(uint8_t *buf, uint64_t rows, const int8_t *mirror_of, mandelbrot_stats_t *stats)
+{
+    uint8_t *field = mandelbrot_field(buf);
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+    {
+        if (!(rows & ((uint64_t)1 << y)))
+            continue;
+
+        int src = mirror_of[y];
+        const uint8_t *from = &buf[(src / SSD1306_PAGE_HEIGHT) * SSD1306_WIDTH];
+        uint8_t *to = &buf[(y / SSD1306_PAGE_HEIGHT) * SSD1306_WIDTH];
+        int from_bit = src % SSD1306_PAGE_HEIGHT, to_bit = y % SSD1306_PAGE_HEIGHT;
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+            to[x] = (to[x] & ~(1 << to_bit)) | ((from[x] >> from_bit & 1) << to_bit);
+        if (field)
+            memcpy(&field[y * SSD1306_WIDTH], &field[src * SSD1306_WIDTH], SSD1306_WIDTH);
+        stats->mirrored += SSD1306_WIDTH;
+    }
+}
+
+/*!
+ * @brief Renderiza o frame inteiro do conjunto de Mandelbrot, sem consultar o cache.
+ *
+ * @param buf  Um ponteiro para o buffer do display.
+ * @param view Limites do plano complexo.
+ *
+ * @details
+ *  - Com `MANDELBROT_SHORTCUTS`, as linhas simétricas em relação ao eixo real são calculadas uma única vez
+ *    e copiadas (ver `mandelbrot_mirror_rows()`).
+ *  - Com `MANDELBROT_DUAL_CORE`, o frame é dividido entre os dois núcleos por `render_frame_parallel()`;
+ *    caso contrário, as mesmas unidades de trabalho (`render_frame_units()`) são renderizadas em sequência, de
+ *    forma que o frame é o mesmo com um ou dois núcleos, também nos modos de subdivisão.
+ *  - As estatísticas do frame ficam disponíveis em `mandelbrot_frame_stats()`.
+ */
+void draw_mandelbrot_frame(uint8_t *buf, const render_data_t *view)
+{
+    int8_t mirror_of[SSD1306_HEIGHT];
+    uint64_t mirrored = 0;
+
+    memset(&frame_stats, 0, sizeof(frame_stats));
+#if MANDELBROT_SHORTCUTS
+    mirrored = mandelbrot_mirror_rows(view, mirror_of);
+#endif
+
+#if MANDELBROT_DUAL_CORE
+    render_frame_parallel(buf, view, mirrored, &frame_stats);
+#else
+    int unit_cols, unit_pages;
+    int units = render_frame_units(&unit_cols, &unit_pages);
+    for (int unit = 0; unit < units; unit++)
+    {
+        int page = (unit / (SSD1306_WIDTH / unit_cols)) * unit_pages;
+        int x = (unit % (SSD1306_WIDTH / unit_cols)) * unit_cols;
+        draw_mandelbrot_tile(buf, view, x, x + unit_cols, page, page + unit_pages, mirrored, &frame_stats);
+    }
+#endif
+
+    mandelbrot_apply_mirror(buf, mirrored, mirror_of, &frame_stats);
+}
+
 /*!
  * @brief Renderiza o conjunto de Mandelbrot no buffer do display.
  *
@@ -282,43 +1181,26 @@ int mandelbrot(float complex c)
  * @param im_end     O limite imaginário final do plano complexo.
  *
  * @details
- *  - Otimiza a renderização através do uso de cache.
- *  - Calcula o incremento para os eixos X e Y.
- *  - Itera sobre cada pixel do display, calculando a parte real e imaginária do ponto correspondente no plano complexo.
- *  - Utiliza a função `mandelbrot()` para determinar se o ponto pertence ao conjunto.
+ *  - Otimiza a renderização através do uso de cache (ver frame_cache.h), que guarda os frames das
+ *    janelas usadas mais recentemente, com o limite de iterações atual e o campo de iterações retido de `buf`.
+ *  - Utiliza `draw_mandelbrot_frame()` quando a janela não está em cache.
  *  - Atualiza o cache para uso futuro
  */
 void draw_mandelbrot(uint8_t *buf, float real_start, float real_end, float im_start, float im_end)
 {
-    // verifica se os dados estão em cache
-    if (real_start == cached_real_start && real_end == cached_real_end && im_start == cached_im_start && im_end == cached_im_end)
+    render_data_t view = {real_start, real_end, im_start, im_end};
+
+    // verifica se os dados estão em cache (com o campo de iterações, se retido e guardado)
+    uint8_t *field = mandelbrot_field(buf);
+    if (frame_cache_lookup(&view, max_iter, buf))
     {
-        // utiliza os dados de renderização em cache
-        memcpy(buf, mandelbrot_cache, SSD1306_BUF_LEN);
+        if (field)
+            frame_cache_field(&view, max_iter, field);
         return;
     }
-    float stepX = (real_end - real_start) / SSD1306_WIDTH;
-    float stepY = (im_end - im_start) / SSD1306_HEIGHT;
-
-    // printf("stepX: %.2f\t stepY: %.2f\n", stepX, stepY);
 
-    for (int x = 0; x < SSD1306_WIDTH; x++)
-    {
-        for (int y = 0; y < SSD1306_HEIGHT; y++)
-        {
-            float real = real_start + x * stepX;
-            float imag = im_start + y * stepY;
-            float complex c = real + imag * I;
-            int m = mandelbrot(c);
-            bool pixelOn = (m == MAX_ITER); // ajuste MAX_ITER conforme necessário
+    draw_mandelbrot_frame(buf, &view);
 
-            set_pixel(buf, x, y, pixelOn); // define o pixel no buffer
-        }
-    }
     // atualiza o cache
-    cached_real_start = real_start;
-    cached_real_end = real_end;
-    cached_im_start = im_start;
-    cached_im_end = im_end;
-    memcpy(mandelbrot_cache, buf, SSD1306_BUF_LEN);
+    frame_cache_insert(&view, max_iter, buf, field);
 }
@@ -11,6 +11,7 @@
  #include <complex.h>
  #include "pico/stdlib.h"
  #include <stdio.h>
+ #include "escape.h"
  
  /*! @brief Altura do display SSD1306 em pixels. */
  #define SSD1306_HEIGHT 64
@@ -27,6 +28,30 @@
  /*! @brief Define o tamanho do buffer utilizado para armazenar os dados do display SSD1306.. */
  #define SSD1306_BUF_LEN (SSD1306_NUM_PAGES * SSD1306_WIDTH * 2)
 
+ /*! @brief Tamanho, em bytes, da memória de imagem do display (uma página de 8 linhas por byte). */
+ #define SSD1306_FRAME_LEN (SSD1306_NUM_PAGES * SSD1306_WIDTH)
+
+ /*!
+  * @brief Custo fixo estimado, em bytes, de cada janela enviada por `SSD1306_render_dirty()`.
+  *
+  * Corresponde aos comandos de endereçamento de coluna/página e ao cabeçalho da transferência de dados.
+  * Intervalos sujos separados por menos colunas limpas que este valor são enviados juntos.
+  */
+ #define SSD1306_WINDOW_COST 15
+
+ /*! @brief Número máximo de comandos em uma sequência de comandos (`ssd1306_cmd_stream_t`). */
+ #define SSD1306_CMD_STREAM_MAX 32
+
+ /*!
+  * @brief Tamanho do cabeçalho que antecede os dados quando comandos e dados seguem na mesma transação.
+  *
+  * Cada comando é precedido do byte de controle 0x80 (Co = 1) e o cabeçalho termina com 0x40 (dados).
+  */
+ #define SSD1306_CMD_HEADER_LEN(num_cmds) (2 * (num_cmds) + 1)
+
+ /*! @brief Tamanho do cabeçalho de uma janela: comandos de coluna e página (6 bytes) seguidos do byte de dados. */
+ #define SSD1306_WINDOW_HEADER_LEN SSD1306_CMD_HEADER_LEN(6)
+
  /*! @brief Pino SDA para a comunicação I2C. */
  #define I2C_SDA_PIN 14
  
@@ -115,8 +140,95 @@
  /*! @brief Modo de leitura. */
  #define SSD1306_READ_MODE _u(0xFF)
  
- /*! @brief Número máximo de iterações. */
+ /*! @brief Número máximo de iterações inicial (ver `mandelbrot_set_max_iter()`). */
  #define MAX_ITER 80
+
+ /*! @brief Maior limite de iterações aceito em tempo de execução (as contagens por pixel são guardadas em uint8_t). */
+ #define MANDELBROT_ITER_LIMIT 250
+
+ /*! @brief Valor do campo de iterações retido para os pontos que atingiram o limite (`mandelbrot_retain_field()`). */
+ #define MANDELBROT_FIELD_INSIDE 255
+
+ /*! @brief Espaçamento, em pixels, das amostras já avaliadas de um frame (`mandelbrot_seed_samples()`). */
+ #define MANDELBROT_SEED_STEP 2
+
+ /*! @brief Número de amostras já avaliadas de um frame (pixels com x e y múltiplos de `MANDELBROT_SEED_STEP`). */
+ #define MANDELBROT_SEED_LEN ((SSD1306_WIDTH / MANDELBROT_SEED_STEP) * (SSD1306_HEIGHT / MANDELBROT_SEED_STEP))
+
+ /*! @brief Posição da amostra do pixel (x, y) em `mandelbrot_seed_samples()`. */
+ #define MANDELBROT_SEED_INDEX(x, y) \
+     ((y) / MANDELBROT_SEED_STEP * (SSD1306_WIDTH / MANDELBROT_SEED_STEP) + (x) / MANDELBROT_SEED_STEP)
+
+ /*! @brief Amostra de um ponto comprovadamente interior (cardioide, bulbo ou órbita periódica). */
+ #define MANDELBROT_SEED_INTERIOR (MANDELBROT_ITER_LIMIT + 1)
+
+ /*! @brief Largura, em iterações, de cada faixa do histograma de escape (`mandelbrot_stats_t::escapes`). */
+ #define MANDELBROT_HIST_BIN_ITERS 16
+
+ /*! @brief Número de faixas do histograma de escape. */
+ #define MANDELBROT_HIST_BINS (MANDELBROT_ITER_LIMIT / MANDELBROT_HIST_BIN_ITERS + 1)
+
+ /*!
+  * @brief Seleciona o kernel de iteração utilizado por `draw_mandelbrot()`.
+  *
+  * 1 = kernel inteiro em ponto fixo (Q3.28), 0 = kernel `float complex` de referência.
+  * O RP2040 não possui FPU, portanto o kernel em ponto fixo é o padrão.
+  */
+ #ifndef MANDELBROT_FIXED_POINT
+ #define MANDELBROT_FIXED_POINT 1
+ #endif
+
+ /*!
+  * @brief Habilita a renderização do frame em paralelo nos dois núcleos (ver render_parallel.h).
+  *
+  * 1 = core0 e core1 dividem o frame dinamicamente, 0 = renderização em um único núcleo.
+  */
+ #ifndef MANDELBROT_DUAL_CORE
+ #define MANDELBROT_DUAL_CORE 1
+ #endif
+
+ /*!
+  * @brief Habilita os atalhos para pontos interiores: teste analítico da cardioide principal e do bulbo de
+  *        período 2, detecção de periodicidade da órbita e espelhamento das linhas simétricas ao eixo real.
+  *
+  * Os atalhos não alteram a imagem: apenas evitam iterações cujo resultado já é conhecido.
+  */
+ #ifndef MANDELBROT_SHORTCUTS
+ #define MANDELBROT_SHORTCUTS 1
+ #endif
+
+ /*!
+  * @brief Habilita a renderização progressiva no laço de controle: pré-visualização em blocos 8x8 refinada
+  *        até a resolução completa, uma passada por chamada (ver render_progressive.h).
+  */
+ #ifndef MANDELBROT_PROGRESSIVE
+ #define MANDELBROT_PROGRESSIVE 1
+ #endif
+
+ /*!
+  * @brief Habilita a ampliação profunda: abaixo da resolução do kernel, os frames passam a ser renderizados
+  *        por perturbação a partir de uma janela em precisão estendida (ver render_deep.h).
+  */
+ #ifndef MANDELBROT_DEEP_ZOOM
+ #define MANDELBROT_DEEP_ZOOM 1
+ #endif
+
+ /*!
+  * @brief Modo de renderização inicial (ver `mandelbrot_render_mode_t`); pode ser trocado em tempo de execução
+  *        por `mandelbrot_set_render_mode()`.
+  */
+ #ifndef MANDELBROT_RENDER_MODE
+ #define MANDELBROT_RENDER_MODE MANDELBROT_RENDER_SUBDIVIDE_CONSERVATIVE
+ #endif
+
+ /*! @brief Número de bits fracionários do formato de ponto fixo (Q3.28). */
+ #define MANDELBROT_FRAC_BITS 28
+
+ /*! @brief Converte um valor float para o formato de ponto fixo do kernel, saturando em +-4 (escape imediato). */
+ #define MANDELBROT_TO_FIXED(v)                                  \
+     ((v) >= 4.0f ? (4 << MANDELBROT_FRAC_BITS)                  \
+      : (v) <= -4.0f ? -(4 << MANDELBROT_FRAC_BITS)              \
+      : (int32_t)((v) * (float)(1 << MANDELBROT_FRAC_BITS)))
  
  /*!
   * @brief Estrutura para definir a área de renderização.
@@ -129,6 +241,55 @@
      int buflen;           /*!< Comprimento do buffer. */
  } render_area_t;
   
+ /*!
+  * @brief Sequência de comandos enviada ao display em uma única transação.
+  */
+ typedef struct {
+     uint8_t cmds[SSD1306_CMD_STREAM_MAX]; /*!< Comandos e argumentos, na ordem de envio. */
+     int num;                              /*!< Número de bytes em `cmds`. */
+ } ssd1306_cmd_stream_t;
+
+/*!
+ * @brief Forma como a iteração de um ponto terminou.
+ */
+ typedef enum {
+     MANDELBROT_EXIT_ESCAPED,  /*!< |z| ultrapassou 2. */
+     MANDELBROT_EXIT_MAX_ITER, /*!< Atingiu MAX_ITER iterações. */
+     MANDELBROT_EXIT_CARDIOID, /*!< Dentro da cardioide principal (sem iterar). */
+     MANDELBROT_EXIT_BULB,     /*!< Dentro do bulbo de período 2 (sem iterar). */
+     MANDELBROT_EXIT_PERIODIC, /*!< A órbita repetiu um valor anterior. */
+     MANDELBROT_EXIT_COUNT
+ } mandelbrot_exit_t;
+
+/*!
+ * @brief Resultado detalhado da iteração de um ponto.
+ */
+ typedef struct {
+     mandelbrot_exit_t exit; /*!< Forma como a iteração terminou. */
+     int work;               /*!< Iterações efetivamente executadas. */
+ } mandelbrot_result_t;
+
+/*!
+ * @brief Estatísticas de renderização de um frame (ou de parte dele).
+ */
+ typedef struct {
+     uint32_t evaluated;                      /*!< Pixels avaliados pelo kernel. */
+     uint32_t iterations;                     /*!< Iterações efetivamente executadas. */
+     uint32_t exits[MANDELBROT_EXIT_COUNT];   /*!< Pixels por forma de saída (`mandelbrot_exit_t`). */
+     uint32_t mirrored;                       /*!< Pixels copiados da linha simétrica. */
+     uint32_t filled;                         /*!< Pixels preenchidos pela subdivisão sem avaliar o kernel. */
+     uint32_t escapes[MANDELBROT_HIST_BINS];  /*!< Pixels que escaparam, por faixa de `MANDELBROT_HIST_BIN_ITERS` iterações. */
+ } mandelbrot_stats_t;
+
+/*!
+ * @brief Forma como os pixels de um frame são calculados.
+ */
+ typedef enum {
+     MANDELBROT_RENDER_FULL,                    /*!< Avalia o kernel em todos os pixels. */
+     MANDELBROT_RENDER_SUBDIVIDE,               /*!< Subdivisão de retângulos; preenche retângulos com borda de mesma cor. */
+     MANDELBROT_RENDER_SUBDIVIDE_CONSERVATIVE   /*!< Subdivisão; preenche apenas retângulos que o conjunto não pode atravessar. */
+ } mandelbrot_render_mode_t;
+
 /*!
  * @brief Estrutura de dados utilizada para armazenar os limites do plano complexo
  *        durante a renderização do conjunto de Mandelbrot.
@@ -146,18 +307,86 @@ void SSD1306_send_cmd(uint8_t cmd);
 
 void SSD1306_send_cmd_list(uint8_t *buf, int num);
 
+void SSD1306_cmd_stream_init(ssd1306_cmd_stream_t *stream);
+
+void SSD1306_cmd_stream_add(ssd1306_cmd_stream_t *stream, const uint8_t *cmds, int num);
+
+void SSD1306_cmd_stream_send(const ssd1306_cmd_stream_t *stream);
+
+int SSD1306_cmd_stream_header(const ssd1306_cmd_stream_t *stream, uint8_t *dst);
+
+void SSD1306_cmd_stream_send_with_data(const ssd1306_cmd_stream_t *stream, uint8_t *buf, int buflen);
+
+int SSD1306_window_header(const render_area_t *area, uint8_t *dst);
+
 void SSD1306_send_buf(uint8_t buf[], int buflen);
 
+void SSD1306_send_data(uint8_t *buf, int buflen);
+
 void SSD1306_init();
 
 void render(uint8_t *buf, render_area_t *area);
 
+void SSD1306_invalidate_shadow();
+
+void SSD1306_mark_displayed(const uint8_t *frame);
+
+const uint8_t *SSD1306_displayed();
+
+int SSD1306_render_dirty(const uint8_t *buf);
+
 void set_pixel(uint8_t *buf, int x, int y, bool on);
 
 void draw_cursor(uint8_t *buf, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool on);
 
 int mandelbrot(float complex c);
 
+int mandelbrot_ex(float complex c, mandelbrot_result_t *result);
+
+int mandelbrot_fixed(int32_t c_real, int32_t c_imag);
+
+int mandelbrot_fixed_ex(int32_t c_real, int32_t c_imag, mandelbrot_result_t *result);
+
+void mandelbrot_stats_add(mandelbrot_stats_t *dst, const mandelbrot_stats_t *src);
+
+const mandelbrot_stats_t *mandelbrot_frame_stats();
+
+int mandelbrot_point(float real, float imag, mandelbrot_stats_t *stats, mandelbrot_exit_t *exit);
+
+void mandelbrot_set_render_mode(mandelbrot_render_mode_t mode);
+
+mandelbrot_render_mode_t mandelbrot_get_render_mode();
+
+void mandelbrot_set_formula(escape_formula_t formula, float k_real, float k_imag);
+
+escape_formula_t mandelbrot_get_formula();
+
+void mandelbrot_set_max_iter(int max_iter);
+
+int mandelbrot_get_max_iter();
+
+void mandelbrot_retain_field(const uint8_t *buf, uint8_t *field);
+
+uint8_t *mandelbrot_field(const uint8_t *buf);
+
+void mandelbrot_get_retained_field(const uint8_t **buf, uint8_t **field);
+
+void mandelbrot_seed_samples(const uint8_t *buf, const uint8_t *samples);
+
+const uint8_t *mandelbrot_samples(const uint8_t *buf);
+
+void draw_mandelbrot_block(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                           uint64_t skip_rows, mandelbrot_stats_t *stats);
+
+void draw_mandelbrot_tile(uint8_t *buf, const render_data_t *view, int x_start, int x_end, int page_start, int page_end,
+                          uint64_t skip_rows, mandelbrot_stats_t *stats);
+
+uint64_t mandelbrot_mirror_rows(const render_data_t *view, int8_t *mirror_of);
+
+void mandelbrot_apply_mirror(uint8_t *buf, uint64_t rows, const int8_t *mirror_of, mandelbrot_stats_t *stats);
+
+void draw_mandelbrot_frame(uint8_t *buf, const render_data_t *view);
+
 void draw_mandelbrot(uint8_t *buf, float real_start, float real_end, float im_Start, float im_end);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+
+static int dma_chan = -1;                           // canal de DMA que alimenta a FIFO de transmissão da I2C
+static dma_channel_config dma_cfg;                  // configuração do canal
+static uint16_t dma_words[SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN]; // palavras de DATA_CMD (byte + bits de controle) em transmissão
+static bool dma_pending = false;                    // verdadeiro desde o início da transferência até o STOP
+
+/*!
+ * @brief Reserva e configura o canal de DMA do transporte.
+ *
+ * @details
+ *  - Transferências de 16 bits, lendo com incremento e escrevendo sempre no registrador IC_DATA_CMD.
+ *  - O ritmo é dado pelo DREQ de transmissão da I2C (a `i2c_init()` do SDK já habilita os sinais de DMA).
+ *
+ * @note
+ *  - Deve ser chamada após `i2c_init()` e antes de `SSD1306_set_transport(&ssd1306_i2c_dma_transport)`.
+ */
+void SSD1306_i2c_dma_init()
+{
+    dma_chan = dma_claim_unused_channel(true);
+    dma_cfg = dma_channel_get_default_config(dma_chan);
+    channel_config_set_transfer_data_size(&dma_cfg, DMA_SIZE_16);
+    channel_config_set_read_increment(&dma_cfg, true);
+    channel_config_set_write_increment(&dma_cfg, false);
+    channel_config_set_dreq(&dma_cfg, i2c_get_dreq(I2C_INST, true));
+}
+
+/*!
+ * @brief Verifica se ainda há uma transferência em segundo plano em andamento.
+ *
+ * @details
+ *  - A transferência termina quando o DMA esvaziou o buffer e o controlador I2C gerou o STOP após o último byte.
+ */
+static bool i2c_dma_busy()
+{
+    if (!dma_pending)
+        return false;
+
+    i2c_hw_t *hw = i2c_get_hw(I2C_INST);
+    if (dma_channel_is_busy(dma_chan) || !(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+        return true;
+
+    (void)hw->clr_stop_det;
+    (void)hw->clr_tx_abrt;
+    dma_pending = false;
+    return false;
+}
+
+/*!
+ * @brief Inicia uma escrita em segundo plano.
+ *
+ * @details
+ *  - Escritas de 8 bits nos registradores do RP2040 são replicadas nos quatro bytes da palavra, o que ativaria
+ *    os bits CMD/STOP/RESTART de IC_DATA_CMD. Por isso cada byte é expandido para uma palavra de 16 bits no
+ *    buffer estático `dma_words`, com o bit STOP no último byte.
+ *  - O endereço de destino é programado com o controlador desabilitado, como em `i2c_write_blocking()`.
+ */
+static void i2c_dma_start_write(const uint8_t *src, size_t len)
+{
+    while (i2c_dma_busy())
+        tight_loop_contents();
+
+    for (size_t i = 0; i < len; i++)
+        dma_words[i] = src[i];
+    dma_words[len - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+    i2c_hw_t *hw = i2c_get_hw(I2C_INST);
+    hw->enable = 0;
+    hw->tar = SSD1306_I2C_ADDR;
+    hw->enable = 1;
+    (void)hw->clr_stop_det;
+
+    dma_pending = true;
+    dma_channel_configure(dma_chan, &dma_cfg, &hw->data_cmd, dma_words, len, true);
+}
+
+/*!
+ * @brief Escrita bloqueante; aguarda a transferência em segundo plano antes de utilizar o barramento.
+ */
+static int i2c_dma_write(const uint8_t *src, size_t len)
+{
+    while (i2c_dma_busy())
+        tight_loop_contents();
+    return i2c_write_blocking(I2C_INST, SSD1306_I2C_ADDR, src, len, false);
+}
+
+/*! @brief Transporte I2C com DMA alimentando a FIFO de transmissão. */
+const ssd1306_transport_t ssd1306_i2c_dma_transport = {
+    write : i2c_dma_write,
+    start_write : i2c_dma_start_write,
+    busy : i2c_dma_busy,
+};
@@ -0,0 +1,40 @@
+/*!
+ * @file ssd1306_transport.h
+ * @brief Interface de transporte utilizada pelo driver do display SSD1306.
+ *
+ * O driver não acessa o barramento diretamente: toda escrita passa pelo transporte em uso, o que permite
+ * trocar a I2C bloqueante pela I2C com DMA (ssd1306_i2c_dma.c) ou por um substituto no build nativo (host/).
+ */
+
+ #ifndef _SSD1306_TRANSPORT_
+ #define _SSD1306_TRANSPORT_
+
+ #include <stdbool.h>
+ #include <stddef.h>
+ #include <stdint.h>
+
+ /*!
+  * @brief Tabela de funções de um transporte.
+  *
+  * Cada chamada a `write` ou `start_write` corresponde a uma transação completa (START, endereço, bytes, STOP),
+  * cujo primeiro byte é o byte de controle do SSD1306.
+  */
+ typedef struct {
+     int (*write)(const uint8_t *src, size_t len);        /*!< Escrita bloqueante; aguarda transferências em andamento. */
+     void (*start_write)(const uint8_t *src, size_t len); /*!< Inicia uma escrita em segundo plano; `src` deve permanecer válido até `busy()` retornar falso. */
+     bool (*busy)();                                      /*!< Verdadeiro enquanto houver uma escrita em segundo plano em andamento. */
+ } ssd1306_transport_t;
+
+ /*! @brief Transporte padrão: `i2c_write_blocking()`, sem transferências em segundo plano. */
+ extern const ssd1306_transport_t ssd1306_i2c_blocking_transport;
+
+ /*! @brief Transporte I2C com DMA alimentando a FIFO de transmissão (somente na Pico). */
+ extern const ssd1306_transport_t ssd1306_i2c_dma_transport;
+
+ void SSD1306_i2c_dma_init();
+
+ void SSD1306_set_transport(const ssd1306_transport_t *t);
+
+ const ssd1306_transport_t *SSD1306_get_transport();
+
+ #endif
@@ -0,0 +1,99 @@
+#include <assert.h>
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "ssd1306_transport.h"
+#include "ssd1306_tx.h"
+#include "trace.h"
+
+static uint8_t tx_frames[2][SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN]; // cabeçalho de janela + pixels de cada framebuffer
+static int back = 0;                                // índice do buffer de trás (pertence à CPU)
+static int in_flight = -1;                          // índice do buffer em transmissão, -1 se nenhum
+#if MANDELBROT_TRACE
+static uint32_t in_flight_start;                    // instante da submissão em andamento (instrumentação, trace.h)
+#endif
+
+/*!
+ * @brief Inicializa os framebuffers com o cabeçalho de janela do display inteiro.
+ */
+void SSD1306_tx_init()
+{
+    render_area_t full = {start_col : 0, end_col : SSD1306_WIDTH - 1, start_page : 0, end_page : SSD1306_NUM_PAGES - 1};
+
+    SSD1306_window_header(&full, tx_frames[0]);
+    SSD1306_window_header(&full, tx_frames[1]);
+    back = 0;
+    in_flight = -1;
+}
+
+/*!
+ * @brief Retorna os pixels do buffer de trás, onde a CPU pode desenhar o próximo frame.
+ *
+ * @note
+ *  - Se o buffer de trás ainda estiver em transmissão (submissão sem `SSD1306_tx_swap()`), aguarda o seu término.
+ */
+uint8_t *SSD1306_tx_back()
+{
+    if (in_flight == back)
+        SSD1306_tx_wait();
+    return tx_frames[back] + SSD1306_WINDOW_HEADER_LEN;
+}
+
+/*!
+ * @brief Inicia a transmissão do buffer de trás para o display inteiro.
+ *
+ * @details
+ *  - Os comandos de janela e os pixels seguem em uma única transação em segundo plano, a partir do próprio
+ *    framebuffer, que já contém o cabeçalho (ver `SSD1306_window_header()`).
+ *  - O transporte aguarda a transmissão anterior antes de iniciar a próxima.
+ *  - A cópia do conteúdo do display do driver passa a refletir o frame submetido.
+ */
+void SSD1306_tx_submit()
+{
+    SSD1306_tx_wait();
+    SSD1306_get_transport()->start_write(tx_frames[back], SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN);
+#if MANDELBROT_TRACE
+    in_flight_start = trace_now();
+#endif
+    in_flight = back;
+    SSD1306_mark_displayed(tx_frames[back] + SSD1306_WINDOW_HEADER_LEN);
+}
+
+/*!
+ * @brief Troca os buffers: o buffer submetido passa a ser o da frente e o outro passa a pertencer à CPU.
+ *
+ * @note
+ *  - O novo buffer de trás nunca está em transmissão: só existe uma transmissão por vez, e `SSD1306_tx_submit()`
+ *    aguarda a anterior antes de iniciar a próxima.
+ */
+void SSD1306_tx_swap()
+{
+    back = 1 - back;
+    assert(in_flight != back);
+}
+
+/*!
+ * @brief Verifica se a transmissão em andamento terminou.
+ *
+ * @return true se não houver transmissão em andamento.
+ *
+ * @note A duração registrada na instrumentação (`TRACE_I2C`) vai da submissão até a verificação que observa o
+ *       término; o laço principal também chama esta função quando está ocioso.
+ */
+bool SSD1306_tx_poll()
+{
+    if (in_flight >= 0 && !SSD1306_get_transport()->busy())
+    {
+        TRACE_END(TRACE_I2C, in_flight_start, SSD1306_WINDOW_HEADER_LEN + SSD1306_FRAME_LEN);
+        in_flight = -1;
+    }
+    return in_flight < 0;
+}
+
+/*!
+ * @brief Aguarda o término da transmissão em andamento.
+ */
+void SSD1306_tx_wait()
+{
+    while (!SSD1306_tx_poll())
+        tight_loop_contents();
+}
@@ -0,0 +1,35 @@
+/*!
+ * @file ssd1306_tx.h
+ * @brief Transmissão assíncrona de frames completos com buffer duplo.
+ *
+ * O motor mantém dois framebuffers estáticos que já reservam, antes dos pixels, o cabeçalho com os comandos de
+ * janela e o byte de controle `0x40`, de forma que cada frame é enviado em uma única transação.
+ * Enquanto o buffer da frente é transmitido em segundo plano, a CPU desenha no buffer de trás:
+ *
+ *     uint8_t *frame = SSD1306_tx_back();   // buffer de trás, pertence à CPU
+ *     ...desenha em frame...
+ *     SSD1306_tx_submit();                  // inicia a transmissão do buffer de trás
+ *     SSD1306_tx_swap();                    // o buffer transmitido passa a ser o da frente
+ *
+ * Nenhuma alocação dinâmica é feita; a transmissão utiliza o transporte em uso (ver ssd1306_transport.h).
+ */
+
+ #ifndef _SSD1306_TX_
+ #define _SSD1306_TX_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+
+ void SSD1306_tx_init();
+
+ uint8_t *SSD1306_tx_back();
+
+ void SSD1306_tx_submit();
+
+ void SSD1306_tx_swap();
+
+ bool SSD1306_tx_poll();
+
+ void SSD1306_tx_wait();
+
+ #endif
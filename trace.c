@@ -0,0 +1,272 @@
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include "trace.h"
+
+#if MANDELBROT_TRACE
+
+static trace_event_t ring[TRACE_RING_SIZE];          // eventos mais recentes, indexados por `seq`
+static volatile uint32_t ring_head = 0;              // próximo número de sequência
+static trace_stage_stats_t stage_stats[TRACE_STAGE_COUNT];
+
+/*!
+ * @brief Instante atual em microssegundos, truncado a 32 bits (as durações são calculadas módulo 2^32).
+ */
+uint32_t trace_now()
+{
+    return (uint32_t)time_us_64();
+}
+
+/*!
+ * @brief Descarta os eventos do anel e zera as estatísticas.
+ */
+void trace_reset()
+{
+    uint32_t status = save_and_disable_interrupts();
+    memset(ring, 0, sizeof(ring));
+    memset(stage_stats, 0, sizeof(stage_stats));
+    ring_head = 0;
+    restore_interrupts(status);
+}
+
+/*!
+ * @brief Faixa do histograma de uma duração: valores exatos até `TRACE_HIST_STEPS`, depois
+ *        `TRACE_HIST_STEPS` faixas por oitava.
+ */
+static int hist_bin(uint32_t duration_us)
+{
+    if (duration_us < TRACE_HIST_STEPS)
+        return (int)duration_us;
+    int octave = 31 - __builtin_clz(duration_us); // >= 2
+    int step = (int)(duration_us >> (octave - 2)) & (TRACE_HIST_STEPS - 1);
+    return MIN((octave - 1) * TRACE_HIST_STEPS + step, TRACE_HIST_BINS - 1);
+}
+
+/*!
+ * @brief Maior duração contida em uma faixa do histograma.
+ */
+static uint32_t hist_upper(int bin)
+{
+    if (bin < TRACE_HIST_STEPS)
+        return (uint32_t)bin;
+    int octave = bin / TRACE_HIST_STEPS + 1;
+    uint32_t lower = (uint32_t)(TRACE_HIST_STEPS + bin % TRACE_HIST_STEPS) << (octave - 2);
+    return lower + (1u << (octave - 2)) - 1;
+}
+
+/*!
+ * @brief Grava um evento no anel, sobrescrevendo o mais antigo.
+ *
+ * @details
+ *  - A posição é reservada com as interrupções desabilitadas apenas durante o incremento de `ring_head`: uma
+ *    interrupção que grave um evento no meio da escrita de outro recebe a posição seguinte.
+ *  - `seq` é escrito por último; a leitura descarta os eventos cujo `seq` não corresponde à posição.
+ */
+static void ring_push(trace_stage_t stage, uint32_t start_us, uint32_t duration_us, uint32_t value)
+{
+    uint32_t status = save_and_disable_interrupts();
+    uint32_t seq = ring_head++;
+    restore_interrupts(status);
+
+    trace_event_t *event = &ring[seq & (TRACE_RING_SIZE - 1)];
+    __atomic_store_n(&event->seq, UINT32_MAX, __ATOMIC_RELAXED); // incompleto até a escrita de `seq`
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event->start_us = start_us;
+    event->duration_us = duration_us;
+    event->value = value;
+    event->stage = (uint8_t)stage;
+    __atomic_store_n(&event->seq, seq, __ATOMIC_RELEASE);
+}
+
+/*!
+ * @brief Registra um evento instantâneo no anel (seguro nas interrupções do core0; não altera as estatísticas).
+ */
+void trace_mark(trace_stage_t stage, uint32_t value)
+{
+    ring_push(stage, trace_now(), 0, value);
+}
+
+/*!
+ * @brief Registra uma etapa já medida: grava o evento e atualiza as estatísticas da etapa.
+ *
+ * @param stage       Etapa.
+ * @param start_us    Instante de início (`trace_now()`).
+ * @param duration_us Duração.
+ * @param value       Dado da etapa (ver `trace_stage_t`).
+ *
+ * @note Apenas o laço principal do core0 registra durações (ver trace.h).
+ */
+void trace_record(trace_stage_t stage, uint32_t start_us, uint32_t duration_us, uint32_t value)
+{
+    trace_stage_stats_t *stats = &stage_stats[stage];
+
+    ring_push(stage, start_us, duration_us, value);
+
+    if (stats->count == 0 || duration_us < stats->min_us)
+        stats->min_us = duration_us;
+    if (stats->count == 0 || value < stats->value_min)
+        stats->value_min = value;
+    stats->max_us = MAX(stats->max_us, duration_us);
+    stats->value_max = MAX(stats->value_max, value);
+    stats->total_us += duration_us;
+    stats->value_total += value;
+    stats->hist[hist_bin(duration_us)]++;
+    stats->count++;
+}
+
+/*!
+ * @brief Registra a etapa iniciada em `start_us` e concluída agora.
+ */
+void trace_span(trace_stage_t stage, uint32_t start_us, uint32_t value)
+{
+    trace_record(stage, start_us, trace_now() - start_us, value);
+}
+
+/*!
+ * @brief Retorna as estatísticas de uma etapa.
+ */
+const trace_stage_stats_t *trace_stats(trace_stage_t stage)
+{
+    return &stage_stats[stage];
+}
+
+/*!
+ * @brief Percentil das durações de uma etapa.
+ *
+ * @return uint32_t O limite superior da faixa do histograma que contém o percentil (no máximo a maior duração
+ *         observada), com erro de até 1/`TRACE_HIST_STEPS` de oitava; 0 se não houver eventos.
+ */
+uint32_t trace_percentile(trace_stage_t stage, int percent)
+{
+    const trace_stage_stats_t *stats = &stage_stats[stage];
+    uint64_t rank = ((uint64_t)stats->count * (uint64_t)percent + 99) / 100; // posição, arredondada para cima
+    uint64_t seen = 0;
+
+    for (int bin = 0; bin < TRACE_HIST_BINS && stats->count; bin++)
+    {
+        seen += stats->hist[bin];
+        if (seen >= rank)
+            return MIN(hist_upper(bin), stats->max_us);
+    }
+    return 0;
+}
+
+/*!
+ * @brief Copia os eventos mais recentes do anel, do mais antigo ao mais recente.
+ *
+ * @param events Recebe os eventos.
+ * @param max    Capacidade de `events`.
+ * @param lost   Recebe (se não for NULL) o número de eventos gravados e não copiados: sobrescritos, incompletos
+ *               (em escrita durante a cópia) ou além de `max`.
+ *
+ * @return int O número de eventos copiados.
+ *
+ * @details
+ *  - A cópia começa pelo evento mais recente: se os escritores gravarem durante a cópia, os eventos perdidos são
+ *    os mais antigos, que seriam sobrescritos em seguida de qualquer forma.
+ */
+int trace_snapshot(trace_event_t *events, int max, uint32_t *lost)
+{
+    uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+    uint32_t first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+    int count = 0;
+
+    for (uint32_t seq = head; seq != first && count < max; seq--)
+    {
+        const trace_event_t *event = &ring[(seq - 1) & (TRACE_RING_SIZE - 1)];
+        if (__atomic_load_n(&event->seq, __ATOMIC_ACQUIRE) != seq - 1)
+            continue; // sobrescrito ou em escrita
+        events[max - 1 - count] = *event;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&event->seq, __ATOMIC_RELAXED) == seq - 1) // não foi sobrescrito durante a cópia
+            count++;
+    }
+    memmove(events, &events[max - count], (size_t)count * sizeof(events[0]));
+    if (lost)
+        *lost = head - (uint32_t)count;
+    return count;
+}
+
+/*!
+ * @brief Nome da etapa (sem espaços: também identifica a etapa no despejo).
+ */
+const char *trace_stage_name(trace_stage_t stage)
+{
+    static const char *const names[TRACE_STAGE_COUNT] = {"entrada", "kernel", "composicao", "i2c",
+                                                         "cache",   "frame",  "botao"};
+    return stage < TRACE_STAGE_COUNT ? names[stage] : "?";
+}
+
+/*!
+ * @brief Escreve as estatísticas de todas as etapas com eventos.
+ */
+void trace_print_stats(FILE *out)
+{
+    fprintf(out, "%-10s %8s %8s %8s %8s %8s %12s %10s %10s\n", "etapa", "n", "min(us)", "med(us)", "p99(us)",
+            "max(us)", "valor med", "valor min", "valor max");
+    for (int stage = 0; stage < TRACE_STAGE_COUNT; stage++)
+    {
+        const trace_stage_stats_t *stats = &stage_stats[stage];
+        if (stats->count == 0)
+            continue;
+        fprintf(out, "%-10s %8lu %8lu %8lu %8lu %8lu %12lu %10lu %10lu\n", trace_stage_name((trace_stage_t)stage),
+                (unsigned long)stats->count, (unsigned long)stats->min_us,
+                (unsigned long)(stats->total_us / stats->count),
+                (unsigned long)trace_percentile((trace_stage_t)stage, 99), (unsigned long)stats->max_us,
+                (unsigned long)(stats->value_total / stats->count), (unsigned long)stats->value_min,
+                (unsigned long)stats->value_max);
+    }
+}
+
+/*!
+ * @brief Escreve os eventos do anel, um por linha, no formato lido por host/trace_decode.c:
+ *
+ *     trace begin <agora_us> <eventos> <perdidos>
+ *     T <seq> <inicio_us> <duracao_us> <etapa> <valor>
+ *     trace end
+ */
+void trace_dump(FILE *out)
+{
+    static trace_event_t events[TRACE_RING_SIZE];
+    uint32_t lost;
+    int count = trace_snapshot(events, TRACE_RING_SIZE, &lost);
+
+    fprintf(out, "trace begin %lu %d %lu\n", (unsigned long)trace_now(), count, (unsigned long)lost);
+    for (int i = 0; i < count; i++)
+        fprintf(out, "T %lu %lu %lu %s %lu\n", (unsigned long)events[i].seq, (unsigned long)events[i].start_us,
+                (unsigned long)events[i].duration_us, trace_stage_name((trace_stage_t)events[i].stage),
+                (unsigned long)events[i].value);
+    fprintf(out, "trace end\n");
+}
+
+/*!
+ * @brief Executa um comando de um caractere recebido pela USB (stdio).
+ *
+ * @details
+ *  - `s`: estatísticas por etapa; `d`: despejo do anel; `r`: zera o anel e as estatísticas; `?`: ajuda.
+ *
+ * @return bool Falso se o caractere não é um comando.
+ */
+bool trace_command(int c)
+{
+    switch (c)
+    {
+    case 's':
+        trace_print_stats(stdout);
+        return true;
+    case 'd':
+        trace_dump(stdout);
+        return true;
+    case 'r':
+        trace_reset();
+        printf("trace: zerado\n");
+        return true;
+    case '?':
+        printf("trace: s = estatisticas, d = despejo do anel, r = zerar\n");
+        return true;
+    default:
+        return false;
+    }
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*!
+ * @file trace.h
+ * @brief Instrumentação de desempenho na placa: anel de eventos com instante e duração e estatísticas por etapa.
+ *
+ * Os pontos de medição ficam em torno das etapas do laço principal (amostragem da entrada, kernel, composição do
+ * frame, transferência I2C, consultas ao cache) e das interrupções dos botões. Cada medição grava um evento em um
+ * anel de tamanho fixo, sobrescrevendo os mais antigos, e as durações alimentam contadores por etapa (mínimo,
+ * média, p99 e máximo). Os dados são lidos pela USB (stdio) com os comandos de `trace_command()`, e o despejo do
+ * anel é convertido em uma linha do tempo por host/trace_decode.c.
+ *
+ * Com `MANDELBROT_TRACE` igual a 0, as macros `TRACE_*` não geram código nem avaliam os seus argumentos.
+ *
+ * @note
+ *  - `TRACE_MARK()` pode ser chamada nas interrupções do core0; a reserva da posição no anel é a única seção
+ *    crítica (poucas instruções com as interrupções desabilitadas) e nenhuma trava é mantida durante a escrita.
+ *  - As durações (`TRACE_END()`, `TRACE_RECORD()`) atualizam as estatísticas e devem ser registradas apenas pelo
+ *    laço principal do core0, seu único escritor.
+ */
+
+ #ifndef _TRACE_
+ #define _TRACE_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include <stdio.h>
+
+ /*! @brief Habilita a instrumentação (0 remove todos os pontos de medição na compilação). */
+ #ifndef MANDELBROT_TRACE
+ #define MANDELBROT_TRACE 1
+ #endif
+
+ /*! @brief Capacidade do anel, em eventos (potência de 2). */
+ #define TRACE_RING_SIZE 256
+
+ /*! @brief Subdivisões de cada oitava no histograma de durações (resolução do p99: 1/4 de oitava). */
+ #define TRACE_HIST_STEPS 4
+
+ /*! @brief Faixas do histograma de durações: até 2^24 us (16 s); durações maiores ficam na última faixa. */
+ #define TRACE_HIST_BINS (24 * TRACE_HIST_STEPS)
+
+ _Static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE deve ser potência de 2");
+
+ /*!
+  * @brief Etapa medida; o significado de `value` depende da etapa.
+  */
+ typedef enum {
+     TRACE_INPUT,    /*!< Leitura e filtragem do joystick. */
+     TRACE_KERNEL,   /*!< Renderização (kernel e montagem das páginas); `value` = iterações. */
+     TRACE_COMPOSE,  /*!< Composição do frame exibido (cópia ou sombreamento). */
+     TRACE_I2C,      /*!< Transferência ao display, da submissão ao término; `value` = bytes. */
+     TRACE_CACHE,    /*!< Consulta ao cache de frames; `value` = 1 se encontrado. */
+     TRACE_FRAME,    /*!< Frame concluído; duração = renderização (soma das passadas), `value` = iterações. */
+     TRACE_BUTTON,   /*!< Borda de botão na interrupção (instantâneo); `value` = pino. */
+     TRACE_STAGE_COUNT
+ } trace_stage_t;
+
+ /*!
+  * @brief Evento do anel.
+  */
+ typedef struct {
+     uint32_t seq;         /*!< Número de sequência do evento, escrito por último (detecta eventos incompletos). */
+     uint32_t start_us;    /*!< Instante de início (`time_us_64()` truncado a 32 bits). */
+     uint32_t duration_us; /*!< Duração (0 nos eventos instantâneos). */
+     uint32_t value;       /*!< Dado da etapa. */
+     uint8_t stage;        /*!< `trace_stage_t`. */
+ } trace_event_t;
+
+ /*!
+  * @brief Contadores de uma etapa.
+  */
+ typedef struct {
+     uint32_t count;                 /*!< Eventos registrados. */
+     uint32_t min_us, max_us;        /*!< Menor e maior duração. */
+     uint64_t total_us;              /*!< Soma das durações. */
+     uint64_t value_total;           /*!< Soma de `value`. */
+     uint32_t value_min, value_max;  /*!< Menor e maior `value`. */
+     uint32_t hist[TRACE_HIST_BINS]; /*!< Histograma logarítmico das durações (ver `trace_percentile()`). */
+ } trace_stage_stats_t;
+
+ uint32_t trace_now();
+
+ void trace_reset();
+
+ void trace_mark(trace_stage_t stage, uint32_t value);
+
+ void trace_record(trace_stage_t stage, uint32_t start_us, uint32_t duration_us, uint32_t value);
+
+ void trace_span(trace_stage_t stage, uint32_t start_us, uint32_t value);
+
+ const trace_stage_stats_t *trace_stats(trace_stage_t stage);
+
+ uint32_t trace_percentile(trace_stage_t stage, int percent);
+
+ int trace_snapshot(trace_event_t *events, int max, uint32_t *lost);
+
+ const char *trace_stage_name(trace_stage_t stage);
+
+ void trace_print_stats(FILE *out);
+
+ void trace_dump(FILE *out);
+
+ bool trace_command(int c);
+
+ #if MANDELBROT_TRACE
+ /*! @brief Marca o início de uma etapa na variável local `t`. */
+ #define TRACE_BEGIN(t) uint32_t t = trace_now()
+ /*! @brief Registra a etapa iniciada por `TRACE_BEGIN(t)`. */
+ #define TRACE_END(stage, t, value) trace_span(stage, t, value)
+ /*! @brief Registra uma etapa medida por outro relógio (início e duração em us). */
+ #define TRACE_RECORD(stage, start, duration, value) trace_record(stage, start, duration, value)
+ /*! @brief Registra um evento instantâneo (seguro nas interrupções do core0). */
+ #define TRACE_MARK(stage, value) trace_mark(stage, value)
+ #else
+ #define TRACE_BEGIN(t)
+ #define TRACE_END(stage, t, value) ((void)0)
+ #define TRACE_RECORD(stage, start, duration, value) ((void)0)
+ #define TRACE_MARK(stage, value) ((void)0)
+ #endif
+
+ #endif
@@ -0,0 +1,71 @@
+#include "viewport.h"
+
+/*!
+ * @brief Amplia a janela do plano complexo para a região selecionada pelo cursor.
+ *
+ * @param view   Janela atual, atualizada com a janela ampliada.
+ * @param left   Coluna do canto superior esquerdo do cursor.
+ * @param top    Linha do canto superior esquerdo do cursor.
+ * @param width  Largura do cursor em pixels.
+ * @param height Altura do cursor em pixels.
+ *
+ * @details
+ *  - Calcula o centro do cursor e uma região com metade das suas dimensões em torno dele.
+ *  - Converte os limites da região (em pixels) para o plano complexo da janela atual.
+ */
+void viewport_zoom_in(render_data_t *view, uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+{
+    // calcula o centro do cursor
+    uint8_t x0 = left + width / 2;
+    uint8_t y0 = top + height / 2;
+
+    int new_height_zoom = height / 2;
+    int new_width_zoom = width / 2;
+
+    float real_range = view->real_end - view->real_start;
+    float im_range = view->im_end - view->im_start;
+
+    float left_point = x0 - new_width_zoom;
+    float right_point = x0 + new_width_zoom;
+    float top_point = y0 - new_height_zoom;
+    float bottom_point = y0 + new_height_zoom;
+
+    view->real_start = view->real_start + (real_range * left_point / SSD1306_WIDTH);
+    view->real_end = view->real_start + (right_point - left_point) * real_range / SSD1306_WIDTH;
+    view->im_start = view->im_start + (im_range * top_point / SSD1306_HEIGHT);
+    view->im_end = view->im_start + (bottom_point - top_point) * im_range / SSD1306_HEIGHT;
+}
+
+/*!
+ * @brief Ancora a grade de pixels na janela atual.
+ *
+ * @param grid Grade a inicializar.
+ * @param view Janela atual.
+ *
+ * @details
+ *  - Com deslocamento zero, as coordenadas da grade são calculadas pelas mesmas operações de
+ *    `draw_mandelbrot_block()`, de forma que o frame já exibido pode ser reaproveitado sem diferenças.
+ */
+void viewport_grid_anchor(viewport_grid_t *grid, const render_data_t *view)
+{
+    grid->real_base = view->real_start;
+    grid->im_base = view->im_start;
+    grid->step_x = (view->real_end - view->real_start) / SSD1306_WIDTH;
+    grid->step_y = (view->im_end - view->im_start) / SSD1306_HEIGHT;
+    grid->ox = 0;
+    grid->oy = 0;
+}
+
+/*!
+ * @brief Calcula os limites da janela correspondente à posição atual da grade.
+ *
+ * @param grid Grade de pixels.
+ * @param view Recebe os limites da janela, alinhados à grade.
+ */
+void viewport_grid_window(const viewport_grid_t *grid, render_data_t *view)
+{
+    view->real_start = grid->real_base + grid->ox * grid->step_x;
+    view->real_end = grid->real_base + (grid->ox + SSD1306_WIDTH) * grid->step_x;
+    view->im_start = grid->im_base + grid->oy * grid->step_y;
+    view->im_end = grid->im_base + (grid->oy + SSD1306_HEIGHT) * grid->step_y;
+}
@@ -0,0 +1,36 @@
+/*!
+ * @file viewport.h
+ * @brief Header file contendo as operações sobre a janela do plano complexo exibida no display.
+ *
+ * As funções deste arquivo não dependem do hardware e são compartilhadas entre o firmware e o build nativo (host/).
+ */
+
+ #ifndef _VIEWPORT_
+ #define _VIEWPORT_
+
+ #include <stdint.h>
+ #include "ssd1306.h"
+
+ /*! @brief Janela inicial do plano complexo (visão completa do conjunto). */
+ #define VIEWPORT_HOME {-2.0f, 1.0f, -1.5f, 1.5f}
+
+ /*!
+  * @brief Grade de pixels fixa sobre o plano complexo, utilizada pelo deslocamento (pan) da janela.
+  *
+  * O pixel (x, y) da janela deslocada corresponde ao ponto
+  * (real_base + (ox + x) * step_x, im_base + (oy + y) * step_y). Como a base e o passo não mudam durante o
+  * deslocamento, um pixel reaproveitado tem exatamente as mesmas coordenadas em que foi calculado.
+  */
+ typedef struct {
+     float real_base, im_base; /*!< Canto da janela em que a grade foi ancorada. */
+     float step_x, step_y;     /*!< Dimensões de um pixel no plano complexo. */
+     int32_t ox, oy;           /*!< Deslocamento acumulado, em pixels. */
+ } viewport_grid_t;
+
+ void viewport_zoom_in(render_data_t *view, uint8_t left, uint8_t top, uint8_t width, uint8_t height);
+
+ void viewport_grid_anchor(viewport_grid_t *grid, const render_data_t *view);
+
+ void viewport_grid_window(const viewport_grid_t *grid, render_data_t *view);
+
+ #endif
@@ -0,0 +1,186 @@
+#include <string.h>
+#include "zoom_history.h"
+
+/*!
+ * @brief Amplia a janela para a área do cursor.
+ *
+ * @details Com a ampliação profunda, a janela estendida acompanha a janela float; abaixo da resolução do float,
+ *          a janela float passa a ser apenas uma aproximação da estendida.
+ */
+void zoom_state_zoom_in(zoom_state_t *state, uint8_t left, uint8_t top, uint8_t width, uint8_t height)
+{
+#if MANDELBROT_DEEP_ZOOM
+    deep_view_zoom_in(&state->deep, left, top, width, height);
+    if (deep_view_needs_perturbation(&state->deep))
+        deep_view_to_render_data(&state->deep, &state->view);
+    else
+        viewport_zoom_in(&state->view, left, top, width, height);
+#else
+    viewport_zoom_in(&state->view, left, top, width, height);
+#endif
+}
+
+// aplica o deslocamento acumulado da grade ancorada na janela atual
+static void state_pan(zoom_state_t *state, const viewport_grid_t *grid)
+{
+    viewport_grid_window(grid, &state->view);
+#if MANDELBROT_DEEP_ZOOM
+    deep_view_from_render_data(&state->deep, &state->view);
+#endif
+}
+
+static void state_apply(zoom_state_t *state, const zoom_op_t *op)
+{
+    if (op->kind == ZOOM_OP_ZOOM)
+    {
+        zoom_state_zoom_in(state, (uint8_t)op->x, (uint8_t)op->y, op->size, op->size);
+    }
+    else
+    {
+        viewport_grid_t grid;
+        viewport_grid_anchor(&grid, &state->view);
+        grid.ox = op->x;
+        grid.oy = op->y;
+        state_pan(state, &grid);
+    }
+}
+
+// reserva a próxima operação, guardando o quadro-chave quando ela inicia um intervalo
+static zoom_op_t *push(zoom_history_t *history, const zoom_state_t *state)
+{
+    if (history->count >= ZOOM_HISTORY_OPS)
+        return NULL;
+    if (history->count % ZOOM_HISTORY_KEY_INTERVAL == 0)
+        history->keys[history->count / ZOOM_HISTORY_KEY_INTERVAL] = *state;
+    return &history->ops[history->count++];
+}
+
+/*!
+ * @brief Inicializa o histórico vazio na janela inicial.
+ */
+void zoom_history_init(zoom_history_t *history, const zoom_state_t *home)
+{
+    memset(history, 0, sizeof(*history));
+    history->keys[0] = *home;
+}
+
+/*!
+ * @brief Registra uma ampliação e a aplica à janela atual.
+ *
+ * @param history Histórico.
+ * @param state Janela atual; recebe a janela ampliada.
+ * @param left Coluna do canto superior esquerdo do cursor.
+ * @param top Linha do canto superior esquerdo do cursor.
+ * @param size Lado do cursor, em pixels.
+ *
+ * @return bool Falso se o histórico está cheio (a janela não é alterada).
+ */
+bool zoom_history_zoom(zoom_history_t *history, zoom_state_t *state, uint8_t left, uint8_t top, uint8_t size)
+{
+    zoom_op_t *op = push(history, state);
+    if (op == NULL)
+        return false;
+    *op = (zoom_op_t){kind : ZOOM_OP_ZOOM, size : size, x : left, y : top};
+    history->panning = false;
+    zoom_state_zoom_in(state, left, top, size, size);
+    return true;
+}
+
+/*!
+ * @brief Retorna a grade a deslocar com pan_frame(), iniciando uma sessão de pan se necessário.
+ *
+ * @details Deslocamentos seguidos acumulam na mesma operação e na mesma grade; uma ampliação ou um desfazer
+ *          encerra a sessão, e o próximo deslocamento ancora uma nova grade na janela de então.
+ *
+ * @return viewport_grid_t* Grade ancorada, ou NULL se o histórico está cheio.
+ */
+viewport_grid_t *zoom_history_pan_begin(zoom_history_t *history, const zoom_state_t *state)
+{
+    viewport_grid_t *grid = &history->pan_grid;
+
+    // o deslocamento acumulado é guardado em 16 bits: uma sessão muito longa é encerrada e outra iniciada
+    if (history->panning && (grid->ox < INT16_MIN / 2 || grid->ox > INT16_MAX / 2 ||
+                             grid->oy < INT16_MIN / 2 || grid->oy > INT16_MAX / 2))
+        history->panning = false;
+
+    if (!history->panning)
+    {
+        zoom_op_t *op = push(history, state);
+        if (op == NULL)
+            return NULL;
+        *op = (zoom_op_t){kind : ZOOM_OP_PAN, size : 0, x : 0, y : 0};
+        viewport_grid_anchor(grid, &state->view);
+        history->panning = true;
+    }
+    return grid;
+}
+
+/*!
+ * @brief Registra o deslocamento da grade retornada por zoom_history_pan_begin() e o aplica à janela atual.
+ */
+void zoom_history_pan_end(zoom_history_t *history, zoom_state_t *state)
+{
+    zoom_op_t *op = &history->ops[history->count - 1];
+    op->x = (int16_t)history->pan_grid.ox;
+    op->y = (int16_t)history->pan_grid.oy;
+    state_pan(state, &history->pan_grid);
+}
+
+/*!
+ * @brief Desfaz a última ampliação, restaurando a janela exibida antes dela.
+ *
+ * @details Os deslocamentos feitos após a ampliação são descartados com ela; a janela é reconstruída a partir
+ *          do quadro-chave anterior, reaplicando no máximo `ZOOM_HISTORY_KEY_INTERVAL - 1` operações.
+ *
+ * @return bool Falso se não há ampliação a desfazer (a janela não é alterada).
+ */
+bool zoom_history_undo(zoom_history_t *history, zoom_state_t *state)
+{
+    int count = history->count;
+    while (count > 0 && history->ops[count - 1].kind != ZOOM_OP_ZOOM)
+        count--;
+    if (count == 0)
+        return false;
+    history->count = (uint16_t)(count - 1);
+    history->panning = false;
+
+    int key = history->count / ZOOM_HISTORY_KEY_INTERVAL;
+    *state = history->keys[key];
+    for (int i = key * ZOOM_HISTORY_KEY_INTERVAL; i < history->count; i++)
+        state_apply(state, &history->ops[i]);
+    return true;
+}
+
+/*!
+ * @brief Reaplica operações gravadas (flash_store.c) a partir da janela atual, reconstruindo os quadros-chave.
+ *
+ * @return bool Falso se uma operação é inválida ou o histórico encheu.
+ */
+bool zoom_history_replay(zoom_history_t *history, zoom_state_t *state, const zoom_op_t *ops, int count)
+{
+    history->panning = false;
+    for (int i = 0; i < count; i++)
+    {
+        zoom_op_t op;
+        memcpy(&op, &ops[i], sizeof(op)); // origem possivelmente desalinhada
+        if (op.kind != ZOOM_OP_ZOOM && op.kind != ZOOM_OP_PAN)
+            return false;
+        zoom_op_t *slot = push(history, state);
+        if (slot == NULL)
+            return false;
+        *slot = op;
+        state_apply(state, &op);
+    }
+    return true;
+}
+
+/*!
+ * @brief Retorna o número de ampliações no histórico.
+ */
+int zoom_history_depth(const zoom_history_t *history)
+{
+    int depth = 0;
+    for (int i = 0; i < history->count; i++)
+        depth += history->ops[i].kind == ZOOM_OP_ZOOM;
+    return depth;
+}
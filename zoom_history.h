@@ -0,0 +1,84 @@
+/*!
+ * @file zoom_history.h
+ * @brief Histórico das ampliações em memória fixa, com cada nível codificado pela posição e tamanho do cursor.
+ *
+ * Em vez de uma cópia da janela por nível, o histórico guarda as operações que levaram à janela atual: a
+ * ampliação (célula e tamanho do cursor) e o deslocamento no modo pan (pixels da grade). A cada
+ * `ZOOM_HISTORY_KEY_INTERVAL` operações é guardada uma janela completa (quadro-chave); desfazer uma ampliação
+ * reaplica, a partir do quadro-chave anterior, as mesmas operações em ponto flutuante que produziram cada
+ * janela, de forma que a janela restaurada é idêntica, bit a bit, à exibida antes da ampliação.
+ *
+ * Sem alocação dinâmica. Utilizado apenas pelo laço principal (as interrupções só registram eventos,
+ * input_queue.h), portanto sem seções críticas. Independente do hardware: compartilhado com o build nativo (host/).
+ */
+
+ #ifndef _ZOOM_HISTORY_
+ #define _ZOOM_HISTORY_
+
+ #include <stdbool.h>
+ #include <stdint.h>
+ #include "ssd1306.h"
+ #include "viewport.h"
+ #include "render_deep.h"
+
+ /*! @brief Operações armazenadas (ampliações e sessões de pan); a profundidade útil é limitada antes pela precisão numérica. */
+ #define ZOOM_HISTORY_OPS 256
+
+ /*! @brief Operações entre quadros-chave (máximo de operações reaplicadas ao desfazer). */
+ #define ZOOM_HISTORY_KEY_INTERVAL 16
+
+ /*!
+  * @brief Janela atual: janela float e, com a ampliação profunda, a janela em precisão estendida.
+  */
+ typedef struct {
+     render_data_t view;
+ #if MANDELBROT_DEEP_ZOOM
+     deep_view_t deep;
+ #endif
+ } zoom_state_t;
+
+ /*!
+  * @brief Tipo de uma operação do histórico.
+  */
+ typedef enum {
+     ZOOM_OP_ZOOM, /*!< Ampliação: cursor em (x, y) com lado `size`. */
+     ZOOM_OP_PAN   /*!< Deslocamento de (x, y) pixels da grade ancorada na janela anterior. */
+ } zoom_op_kind_t;
+
+ /*!
+  * @brief Operação codificada (6 bytes).
+  */
+ typedef struct {
+     uint8_t kind; /*!< `zoom_op_kind_t`. */
+     uint8_t size; /*!< Lado do cursor (ampliação). */
+     int16_t x, y; /*!< Canto do cursor (ampliação) ou deslocamento acumulado (pan). */
+ } zoom_op_t;
+
+ /*!
+  * @brief Histórico das ampliações.
+  */
+ typedef struct {
+     zoom_op_t ops[ZOOM_HISTORY_OPS];
+     zoom_state_t keys[ZOOM_HISTORY_OPS / ZOOM_HISTORY_KEY_INTERVAL + 1]; /*!< keys[k]: janela antes da operação k * INTERVAL. */
+     uint16_t count;           /*!< Operações armazenadas. */
+     bool panning;             /*!< A última operação é um pan ainda em andamento (grade em `pan_grid`). */
+     viewport_grid_t pan_grid; /*!< Grade do pan em andamento, ancorada na janela anterior a ele. */
+ } zoom_history_t;
+
+ void zoom_state_zoom_in(zoom_state_t *state, uint8_t left, uint8_t top, uint8_t width, uint8_t height);
+
+ void zoom_history_init(zoom_history_t *history, const zoom_state_t *home);
+
+ bool zoom_history_zoom(zoom_history_t *history, zoom_state_t *state, uint8_t left, uint8_t top, uint8_t size);
+
+ viewport_grid_t *zoom_history_pan_begin(zoom_history_t *history, const zoom_state_t *state);
+
+ void zoom_history_pan_end(zoom_history_t *history, zoom_state_t *state);
+
+ bool zoom_history_undo(zoom_history_t *history, zoom_state_t *state);
+
+ bool zoom_history_replay(zoom_history_t *history, zoom_state_t *state, const zoom_op_t *ops, int count);
+
+ int zoom_history_depth(const zoom_history_t *history);
+
+ #endif